@@ -382,7 +382,9 @@ static int SHA224_256Reset(SHA256Context *context, uint32_t *H0)
  *   single character names, were used because those were the
  *   names used in the Secure Hash Standard.
  */
-static void SHA224_256ProcessMessageBlock(SHA256Context *context)
+/* 'Generic' appended to the function name by Qt: SHA224_256ProcessMessageBlock is */
+/* defined by qcryptographichash.cpp so it can dispatch to hardware implementations */
+static void SHA224_256ProcessMessageBlockGeneric(SHA256Context *context)
 {
   /* Constants defined in FIPS 180-3, section 4.2.2 */
   static const uint32_t K[64] = {
@@ -138,7 +138,11 @@ static inline void sha1Round4(Sha1Chunk *chunk, const uint position,
     w = rol32(w, 30);
 }
 
-static inline void sha1ProcessChunk(Sha1State *state, const unsigned char *buffer)
+// Defined by the file including this one, so that it can dispatch to a
+// hardware-accelerated implementation when the CPU has one.
+static void sha1ProcessChunk(Sha1State *state, const unsigned char *buffer);
+
+static inline void sha1ProcessChunkGeneric(Sha1State *state, const unsigned char *buffer)
 {
     // Copy state[] to working vars
     quint32 a = state->h0;
@@ -96,7 +96,7 @@ public:
           reducer(OrderedReduce)
     { }
 
-    bool runIteration(typename Sequence::const_iterator it, int index, T *)
+    bool runIteration(typename Sequence::const_iterator it, int index, T *) Q_DECL_OVERRIDE
     {
         IntermediateResults<typename Sequence::value_type> results;
         results.begin = index;
@@ -109,7 +109,7 @@ public:
             return false;
     }
 
-    bool runIterations(typename Sequence::const_iterator sequenceBeginIterator, int begin, int end, T *)
+    bool runIterations(typename Sequence::const_iterator sequenceBeginIterator, int begin, int end, T *) Q_DECL_OVERRIDE
     {
         IntermediateResults<typename Sequence::value_type> results;
         results.begin = begin;
@@ -129,22 +129,32 @@ public:
         return false;
     }
 
-    void finish()
+    void finish() Q_DECL_OVERRIDE
     {
         reducer.finish(reduce, reducedResult);
         sequence = reducedResult;
     }
 
-    inline bool shouldThrottleThread()
+    inline bool shouldThrottleThread() Q_DECL_OVERRIDE
     {
         return IterateKernelType::shouldThrottleThread() || reducer.shouldThrottle();
     }
 
-    inline bool shouldStartThread()
+    inline bool shouldStartThread() Q_DECL_OVERRIDE
     {
         return IterateKernelType::shouldStartThread() && reducer.shouldStartThread();
     }
 
+    inline int maximumBlockSize() const Q_DECL_OVERRIDE
+    {
+        return reducer.maximumBlockSize();
+    }
+
+    inline bool orderedIterations() const Q_DECL_OVERRIDE
+    {
+        return reducer.isOrdered();
+    }
+
     typedef void ReturnType;
     typedef void ResultType;
 };
@@ -183,7 +193,7 @@ public:
     { }
 #endif
 
-    bool runIteration(Iterator it, int index, ReducedResultType *)
+    bool runIteration(Iterator it, int index, ReducedResultType *) Q_DECL_OVERRIDE
     {
         IntermediateResults<typename qValueType<Iterator>::value_type> results;
         results.begin = index;
@@ -196,7 +206,7 @@ public:
         return false;
     }
 
-    bool runIterations(Iterator sequenceBeginIterator, int begin, int end, ReducedResultType *)
+    bool runIterations(Iterator sequenceBeginIterator, int begin, int end, ReducedResultType *) Q_DECL_OVERRIDE
     {
         IntermediateResults<typename qValueType<Iterator>::value_type> results;
         results.begin = begin;
@@ -215,24 +225,34 @@ public:
         return false;
     }
 
-    void finish()
+    void finish() Q_DECL_OVERRIDE
     {
         reducer.finish(reduce, reducedResult);
     }
 
-    inline bool shouldThrottleThread()
+    inline bool shouldThrottleThread() Q_DECL_OVERRIDE
     {
         return IterateKernelType::shouldThrottleThread() || reducer.shouldThrottle();
     }
 
-    inline bool shouldStartThread()
+    inline bool shouldStartThread() Q_DECL_OVERRIDE
     {
         return IterateKernelType::shouldStartThread() && reducer.shouldStartThread();
     }
 
+    inline int maximumBlockSize() const Q_DECL_OVERRIDE
+    {
+        return reducer.maximumBlockSize();
+    }
+
+    inline bool orderedIterations() const Q_DECL_OVERRIDE
+    {
+        return reducer.isOrdered();
+    }
+
     typedef ReducedResultType ReturnType;
     typedef ReducedResultType ResultType;
-    ReducedResultType *result()
+    ReducedResultType *result() Q_DECL_OVERRIDE
     {
         return &reducedResult;
     }
@@ -255,14 +275,14 @@ public:
         : IterateKernelType(begin, end), keep(_keep)
     { }
 
-    void start()
+    void start() Q_DECL_OVERRIDE
     {
         if (this->futureInterface)
             this->futureInterface->setFilterMode(true);
         IterateKernelType::start();
     }
 
-    bool runIteration(Iterator it, int index, T *)
+    bool runIteration(Iterator it, int index, T *) Q_DECL_OVERRIDE
     {
         if (keep(*it))
             this->reportResult(&(*it), index);
@@ -271,7 +291,7 @@ public:
         return false;
     }
 
-    bool runIterations(Iterator sequenceBeginIterator, int begin, int end, T *)
+    bool runIterations(Iterator sequenceBeginIterator, int begin, int end, T *) Q_DECL_OVERRIDE
     {
         const int count = end - begin;
         IntermediateResults<typename qValueType<Iterator>::value_type> results;
@@ -40,6 +40,9 @@
 #include "qtconcurrentiteratekernel.h"
 
 #include <qdeadlinetimer.h>
+#include <qmutex.h>
+
+#include <limits.h>
 #include "private/qfunctions_p.h"
 
 
@@ -169,6 +172,168 @@ int BlockSizeManagerV2::blockSize()
     return m_blockSize;
 }
 
+// A range of iterations. It is only modified with the mutex locked, but
+// other threads look at its size without locking to find one to steal from.
+struct IterationScheduler::Range
+{
+    Range() : blockSize(0), begin(0), end(0), owned(0) { }
+
+    int size() const
+    {
+        return end.load() - begin.load();
+    }
+
+    QMutex mutex;
+    int blockSize;
+    QAtomicInt begin;
+    QAtomicInt end;
+    QAtomicInt owned;
+};
+
+/*! \internal
+
+    Splits \a iterationCount iterations evenly between \a threadCount
+    ranges. There is one more range for the thread that starts a blocking
+    call. If \a ordered is true, there is a single range that all threads
+    share.
+*/
+IterationScheduler::IterationScheduler(int iterationCount, int threadCount,
+                                       const IterationHints &hints, bool ordered)
+    : rangeCount(ordered ? 1 : qMax(threadCount, 1) + 1),
+      grainSize(qMax(hints.grainSize(), 1)),
+      divisor(4),
+      ordered(ordered)
+{
+    switch (hints.cost()) {
+    case IterationHints::UniformCost:
+        // static partitioning: a few large blocks per thread, just
+        // enough to still react to cancellation and to slow threads
+        divisor = 2;
+        break;
+    case IterationHints::VaryingCost:
+        divisor = 16;
+        break;
+    case IterationHints::UnknownCost:
+        break;
+    }
+
+    ranges = new Range[rangeCount];
+    for (int i = 0; i < rangeCount; ++i)
+        ranges[i].blockSize = grainSize;
+    const int partitions = ordered ? 1 : rangeCount - 1;
+    for (int i = 0; i < partitions; ++i) {
+        ranges[i].begin.store(int(qint64(iterationCount) * i / partitions));
+        ranges[i].end.store(int(qint64(iterationCount) * (i + 1) / partitions));
+    }
+}
+
+IterationScheduler::~IterationScheduler()
+{
+    delete [] ranges;
+}
+
+// Returns a range for the calling thread to work on, preferably one with
+// iterations left, or -1 if all ranges are taken.
+int IterationScheduler::acquireRange()
+{
+    if (ordered)
+        return 0;
+
+    int unused = -1;
+    for (int i = 0; i < rangeCount; ++i) {
+        if (ranges[i].owned.load())
+            continue;
+        if (ranges[i].size() <= 0) {
+            if (unused < 0)
+                unused = i;
+            continue;
+        }
+        if (ranges[i].owned.testAndSetAcquire(0, 1))
+            return i;
+    }
+    for (int i = unused; i >= 0 && i < rangeCount; ++i) {
+        if (ranges[i].owned.testAndSetAcquire(0, 1))
+            return i;
+    }
+    return -1;
+}
+
+void IterationScheduler::releaseRange(int range)
+{
+    if (!ordered)
+        ranges[range].owned.storeRelease(0);
+}
+
+// Reserves the next block of iterations for the thread owning \a range.
+// Returns false when there is nothing left to do. The first block of a
+// range has the grain size, every following one is twice as large, up to
+// a fraction of what is left: the first results come quickly, but the
+// cost per block ends up negligible even for very cheap map functions.
+bool IterationScheduler::nextBlock(int range, int maximumBlockSize, int *beginIndex, int *endIndex)
+{
+    Range &own = ranges[range];
+    forever {
+        {
+            QMutexLocker locker(&own.mutex);
+            const int begin = own.begin.load();
+            const int remaining = own.end.load() - begin;
+            if (remaining > 0) {
+                int blockSize = qMin(own.blockSize, qMax(remaining / divisor, grainSize));
+                blockSize = qMax(qMin(qMin(blockSize, maximumBlockSize), remaining), 1);
+                if (own.blockSize <= INT_MAX / 2)
+                    own.blockSize *= 2;
+                own.begin.store(begin + blockSize);
+                *beginIndex = begin;
+                *endIndex = begin + blockSize;
+                return true;
+            }
+        }
+
+        if (!steal(range))
+            return false;
+    }
+}
+
+// Moves the back half of the largest range into \a range, or all of it if
+// nobody is working on it.
+bool IterationScheduler::steal(int range)
+{
+    Range &own = ranges[range];
+    forever {
+        Range *victim = Q_NULLPTR;
+        int largest = 0;
+        for (Range *other = ranges; other != ranges + rangeCount; ++other) {
+            const int size = other->size();
+            if (other != &own && size > largest) {
+                victim = other;
+                largest = size;
+            }
+        }
+        if (!victim)
+            return false;
+
+        int begin, end;
+        {
+            QMutexLocker locker(&victim->mutex);
+            begin = victim->begin.load();
+            end = victim->end.load();
+            if (begin >= end)
+                continue; // emptied in the meantime, look again
+            if (victim->owned.load() && end - begin > grainSize)
+                begin += (end - begin) / 2;
+            victim->end.store(begin);
+        }
+
+        // the stolen items might be the expensive ones, start with small
+        // blocks again
+        QMutexLocker locker(&own.mutex);
+        own.blockSize = grainSize;
+        own.begin.store(begin);
+        own.end.store(end);
+        return true;
+    }
+}
+
 } // namespace QtConcurrent
 
 QT_END_NAMESPACE
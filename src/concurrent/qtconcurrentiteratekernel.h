@@ -45,6 +45,7 @@
 #ifndef QT_NO_CONCURRENT
 
 #include <QtCore/qatomic.h>
+#include <QtCore/qscopedpointer.h>
 #include <QtConcurrent/qtconcurrentmedian.h>
 #include <QtConcurrent/qtconcurrentthreadengine.h>
 
@@ -53,6 +54,36 @@
 QT_BEGIN_NAMESPACE
 
 
+namespace QtConcurrent {
+
+class IterationHints
+{
+public:
+    enum Cost {
+        UnknownCost,
+        UniformCost,
+        VaryingCost
+    };
+
+    explicit IterationHints(int grainSize = 0, Cost cost = UnknownCost) Q_DECL_NOTHROW
+        : m_grainSize(grainSize), m_cost(cost)
+    { }
+
+    int grainSize() const Q_DECL_NOTHROW { return m_grainSize; }
+    void setGrainSize(int grainSize) Q_DECL_NOTHROW { m_grainSize = grainSize; }
+
+    Cost cost() const Q_DECL_NOTHROW { return m_cost; }
+    void setCost(Cost cost) Q_DECL_NOTHROW { m_cost = cost; }
+
+private:
+    int m_grainSize;
+    Cost m_cost;
+};
+
+} // namespace QtConcurrent
+
+Q_DECLARE_TYPEINFO(QtConcurrent::IterationHints, Q_PRIMITIVE_TYPE);
+
 #ifndef Q_QDOC
 
 namespace QtConcurrent {
@@ -114,6 +145,43 @@ private:
     Q_DISABLE_COPY(BlockSizeManagerV2)
 };
 
+/*
+    The IterationScheduler class splits the iterations of a for-loop
+    between the threads. Every thread owns a range of iterations and
+    processes it a block at a time, from the front. A thread that has run
+    out of work steals the back half of the largest remaining range. No
+    timing is involved: blocks double in size from the grain size on, up
+    to a fraction of what is left of the range.
+
+    When the results have to be reduced in order, all threads take their
+    blocks from the front of a single shared range instead. The results
+    then arrive close to input order, so the ordered reduction only has to
+    keep a few blocks waiting at any time.
+*/
+class Q_CONCURRENT_EXPORT IterationScheduler
+{
+public:
+    IterationScheduler(int iterationCount, int threadCount, const IterationHints &hints,
+                       bool ordered = false);
+    ~IterationScheduler();
+
+    int acquireRange();
+    void releaseRange(int range);
+    bool nextBlock(int range, int maximumBlockSize, int *beginIndex, int *endIndex);
+
+private:
+    bool steal(int range);
+
+    struct Range;
+    Range *ranges;
+    int rangeCount;
+    int grainSize;
+    int divisor;
+    bool ordered;
+
+    Q_DISABLE_COPY(IterationScheduler)
+};
+
 template <typename T>
 class ResultReporter
 {
@@ -196,12 +264,26 @@ public:
         { Q_UNUSED(it); Q_UNUSED(index); Q_UNUSED(result); return false; }
     virtual bool runIterations(Iterator _begin, int beginIndex, int endIndex, T *results)
         { Q_UNUSED(_begin); Q_UNUSED(beginIndex); Q_UNUSED(endIndex); Q_UNUSED(results); return false; }
+    // the largest number of iterations a thread reserves at a time
+    virtual int maximumBlockSize() const
+        { return iterationCount; }
+    // whether the results are consumed in input order
+    virtual bool orderedIterations() const
+        { return false; }
+
+    void setIterationHints(const IterationHints &_hints)
+    {
+        hints = _hints;
+    }
 
     void start()
     {
         progressReportingEnabled = this->isProgressReportingEnabled();
         if (progressReportingEnabled && iterationCount > 0)
             this->setProgressRange(0, iterationCount);
+        if (forIteration)
+            scheduler.reset(new IterationScheduler(iterationCount, this->threadPool->maxThreadCount(),
+                                                   hints, orderedIterations()));
     }
 
     bool shouldStartThread()
@@ -222,39 +304,43 @@ public:
 
     ThreadFunctionResult forThreadFunction()
     {
-        BlockSizeManagerV2 blockSizeManager(iterationCount);
+        // gives the range back when the thread is throttled, or when the
+        // user code throws
+        struct RangeHolder {
+            IterationScheduler *scheduler;
+            const int range;
+            RangeHolder(IterationScheduler *_scheduler)
+                : scheduler(_scheduler), range(_scheduler->acquireRange()) { }
+            ~RangeHolder() { if (range >= 0) scheduler->releaseRange(range); }
+        } holder(scheduler.data());
+
+        if (holder.range < 0)
+            return ThreadFinished; // more threads than the pool had when we started
+
         ResultReporter<T> resultReporter(this);
 
         for(;;) {
             if (this->isCanceled())
                 break;
 
-            const int currentBlockSize = blockSizeManager.blockSize();
-
-            if (currentIndex.load() >= iterationCount)
-                break;
-
-            // Atomically reserve a block of iterationCount for this thread.
-            const int beginIndex = currentIndex.fetchAndAddRelease(currentBlockSize);
-            const int endIndex = qMin(beginIndex + currentBlockSize, iterationCount);
-
-            if (beginIndex >= endIndex) {
+            // Reserve a block of iterations for this thread.
+            int beginIndex, endIndex;
+            if (!scheduler->nextBlock(holder.range, maximumBlockSize(), &beginIndex, &endIndex)) {
                 // No more work
                 break;
             }
+            const int finalBlockSize = endIndex - beginIndex;
+            currentIndex.fetchAndAddRelaxed(finalBlockSize);
 
             this->waitForResume(); // (only waits if the qfuture is paused.)
 
             if (shouldStartThread())
                 this->startThread();
 
-            const int finalBlockSize = endIndex - beginIndex; // block size adjusted for possible end-of-range
             resultReporter.reserveSpace(finalBlockSize);
 
             // Call user code with the current iteration range.
-            blockSizeManager.timeBeforeUser();
             const bool resultsAvailable = this->runIterations(begin, beginIndex, endIndex, resultReporter.getPointer());
-            blockSizeManager.timeAfterUser();
 
             if (resultsAvailable)
                 resultReporter.reportResults(beginIndex);
@@ -319,6 +405,9 @@ public:
 
     bool progressReportingEnabled;
     QAtomicInt completed;
+
+    IterationHints hints;
+    QScopedPointer<IterationScheduler> scheduler;
 };
 
 } // namespace QtConcurrent
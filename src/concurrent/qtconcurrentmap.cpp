@@ -61,8 +61,13 @@
     \value OrderedReduce Reduction is done in the order of the
     original sequence.
     \value SequentialReduce Reduction is done sequentially: only one
-    thread will enter the reduce function at a time. (Parallel reduction
-    might be supported in a future version of Qt Concurrent.)
+    thread will enter the reduce function at a time.
+    \value [since 5.8] ParallelReduce Each thread reduces its results into
+    a partial result of its own, without waiting for the other threads, and
+    the partial results are reduced into the final result at the end. The
+    order of the reduction is arbitrary. This requires the reduce function
+    to be associative and its result type to be the same as the type of
+    the intermediate results; otherwise UnorderedReduce is used instead.
 */
 
 /*!
@@ -155,6 +160,16 @@
     undefined, while QtConcurrent::OrderedReduce ensures that the reduction
     is done in the order of the original sequence.
 
+    The intermediate results that are waiting to be reduced are kept in
+    memory. When the reduce function can't keep up with the map function,
+    fewer threads are used for mapping until the reduction has caught up,
+    so that the memory use stays bounded. If the reduce function is
+    associative and its result type is the same as the type of the
+    intermediate results, for instance when summing up numbers,
+    QtConcurrent::ParallelReduce lets every thread reduce into a partial
+    result of its own. No intermediate results are kept then, and the
+    partial results are combined with the reduce function at the end.
+
     \section1 Additional API Features
 
     \section2 Using Iterators instead of Sequence
@@ -227,6 +242,92 @@
     becomes:
 
     \snippet code/src_concurrent_qtconcurrentmap.cpp 13
+
+    \section2 Splitting up the Work
+
+    For sequences with random access iterators, each thread starts with an
+    equal share of the items and processes it a block at a time. Threads
+    that are done take over half of the remaining items of another thread.
+    QtConcurrent::map() and QtConcurrent::blockingMap() accept a
+    QtConcurrent::IterationHints argument that tells how many items should
+    at least be processed at a time, and whether processing an item always
+    takes about the same time:
+
+    \code
+    QVector<float> samples = ...;
+    QtConcurrent::blockingMap(samples, normalize,
+                              QtConcurrent::IterationHints(4096, QtConcurrent::IterationHints::UniformCost));
+    \endcode
+*/
+
+/*!
+    \class QtConcurrent::IterationHints
+    \inmodule QtConcurrent
+    \since 5.8
+    \brief The IterationHints class describes the work done by a map function.
+
+    Passing hints to QtConcurrent::map() or QtConcurrent::blockingMap()
+    tunes how the items of a sequence with random access iterators are
+    split up between the threads. Hints are ignored for other sequences,
+    whose items are processed one at a time.
+
+    \sa {Concurrent Map and Map-Reduce}
+*/
+
+/*!
+    \enum QtConcurrent::IterationHints::Cost
+
+    This enum describes how much the time needed to process an item varies.
+
+    \value UnknownCost Nothing is known about the time needed per item.
+    \value UniformCost Every item takes about the same time. The items are
+    processed in few, large blocks.
+    \value VaryingCost Some items take much longer than others. The items
+    are processed in small blocks, so that the threads can share the work
+    evenly.
+*/
+
+/*!
+    \fn QtConcurrent::IterationHints::IterationHints(int grainSize, Cost cost)
+
+    Constructs hints for processing at least \a grainSize items at a time,
+    where processing an item has the given \a cost. A \a grainSize of 0
+    lets QtConcurrent choose.
+*/
+
+/*!
+    \fn int QtConcurrent::IterationHints::grainSize() const
+
+    Returns the smallest number of items processed at a time, or 0 if
+    QtConcurrent chooses.
+
+    \sa setGrainSize()
+*/
+
+/*!
+    \fn void QtConcurrent::IterationHints::setGrainSize(int grainSize)
+
+    Sets the smallest number of items processed at a time to \a grainSize.
+    Use a grain size that takes some microseconds to process for very cheap
+    map functions.
+
+    \sa grainSize()
+*/
+
+/*!
+    \fn QtConcurrent::IterationHints::Cost QtConcurrent::IterationHints::cost() const
+
+    Returns how much the time needed to process an item varies.
+
+    \sa setCost()
+*/
+
+/*!
+    \fn void QtConcurrent::IterationHints::setCost(Cost cost)
+
+    Sets how much the time needed to process an item varies to \a cost.
+
+    \sa cost()
 */
 
 /*!
@@ -249,6 +350,22 @@
     \sa {Concurrent Map and Map-Reduce}
 */
 
+/*!
+    \fn QFuture<void> QtConcurrent::map(Sequence &sequence, MapFunction function, const QtConcurrent::IterationHints &hints)
+    \since 5.8
+    \overload
+
+    Splits up the work according to \a hints.
+*/
+
+/*!
+    \fn QFuture<void> QtConcurrent::map(Iterator begin, Iterator end, MapFunction function, const QtConcurrent::IterationHints &hints)
+    \since 5.8
+    \overload
+
+    Splits up the work according to \a hints.
+*/
+
 /*!
     \fn QFuture<T> QtConcurrent::mapped(const Sequence &sequence, MapFunction function)
 
@@ -326,6 +443,22 @@
   \sa map(), {Concurrent Map and Map-Reduce}
 */
 
+/*!
+  \fn void QtConcurrent::blockingMap(Sequence &sequence, MapFunction function, const QtConcurrent::IterationHints &hints)
+  \since 5.8
+  \overload
+
+  Splits up the work according to \a hints.
+*/
+
+/*!
+  \fn void QtConcurrent::blockingMap(Iterator begin, Iterator end, MapFunction function, const QtConcurrent::IterationHints &hints)
+  \since 5.8
+  \overload
+
+  Splits up the work according to \a hints.
+*/
+
 /*!
   \fn T QtConcurrent::blockingMapped(const Sequence &sequence, MapFunction function)
 
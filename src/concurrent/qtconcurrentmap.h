@@ -58,6 +58,8 @@ namespace QtConcurrent {
 
     QFuture<void> map(Sequence &sequence, MapFunction function);
     QFuture<void> map(Iterator begin, Iterator end, MapFunction function);
+    QFuture<void> map(Sequence &sequence, MapFunction function, const QtConcurrent::IterationHints &hints);
+    QFuture<void> map(Iterator begin, Iterator end, MapFunction function, const QtConcurrent::IterationHints &hints);
 
     template <typename T>
     QFuture<T> mapped(const Sequence &sequence, MapFunction function);
@@ -78,6 +80,8 @@ namespace QtConcurrent {
 
     void blockingMap(Sequence &sequence, MapFunction function);
     void blockingMap(Iterator begin, Iterator end, MapFunction function);
+    void blockingMap(Sequence &sequence, MapFunction function, const QtConcurrent::IterationHints &hints);
+    void blockingMap(Iterator begin, Iterator end, MapFunction function, const QtConcurrent::IterationHints &hints);
 
     template <typename T>
     T blockingMapped(const Sequence &sequence, MapFunction function);
@@ -116,6 +120,20 @@ QFuture<void> map(Iterator begin, Iterator end, MapFunctor map)
     return startMap(begin, end, QtPrivate::createFunctionWrapper(map));
 }
 
+// map() on sequences, with hints for splitting up the work
+template <typename Sequence, typename MapFunctor>
+QFuture<void> map(Sequence &sequence, MapFunctor map, const IterationHints &hints)
+{
+    return startMap(sequence.begin(), sequence.end(), QtPrivate::createFunctionWrapper(map), hints);
+}
+
+// map() on iterators, with hints for splitting up the work
+template <typename Iterator, typename MapFunctor>
+QFuture<void> map(Iterator begin, Iterator end, MapFunctor map, const IterationHints &hints)
+{
+    return startMap(begin, end, QtPrivate::createFunctionWrapper(map), hints);
+}
+
 // mappedReduced() for sequences.
 template <typename ResultType, typename Sequence, typename MapFunctor, typename ReduceFunctor>
 QFuture<ResultType> mappedReduced(const Sequence &sequence,
@@ -200,6 +218,20 @@ void blockingMap(Iterator begin, Iterator end, MapFunctor map)
     startMap(begin, end, QtPrivate::createFunctionWrapper(map)).startBlocking();
 }
 
+// blockingMap() for sequences, with hints for splitting up the work
+template <typename Sequence, typename MapFunctor>
+void blockingMap(Sequence &sequence, MapFunctor map, const IterationHints &hints)
+{
+    startMap(sequence.begin(), sequence.end(), QtPrivate::createFunctionWrapper(map), hints).startBlocking();
+}
+
+// blockingMap() for iterator ranges, with hints for splitting up the work
+template <typename Iterator, typename MapFunctor>
+void blockingMap(Iterator begin, Iterator end, MapFunctor map, const IterationHints &hints)
+{
+    startMap(begin, end, QtPrivate::createFunctionWrapper(map), hints).startBlocking();
+}
+
 // blockingMappedReduced() for sequences
 template <typename ResultType, typename Sequence, typename MapFunctor, typename ReduceFunctor>
 ResultType blockingMappedReduced(const Sequence &sequence,
@@ -64,13 +64,13 @@ public:
         : IterateKernel<Iterator, void>(begin, end), map(_map)
     { }
 
-    bool runIteration(Iterator it, int, void *)
+    bool runIteration(Iterator it, int, void *) Q_DECL_OVERRIDE
     {
         map(*it);
         return false;
     }
 
-    bool runIterations(Iterator sequenceBeginIterator, int beginIndex, int endIndex, void *)
+    bool runIterations(Iterator sequenceBeginIterator, int beginIndex, int endIndex, void *) Q_DECL_OVERRIDE
     {
         Iterator it = sequenceBeginIterator;
         std::advance(it, beginIndex);
@@ -108,7 +108,7 @@ public:
         : reducedResult(initialValue), map(_map), reduce(_reduce)
     { }
 
-    bool runIteration(Iterator it, int index, ReducedResultType *)
+    bool runIteration(Iterator it, int index, ReducedResultType *) Q_DECL_OVERRIDE
     {
         IntermediateResults<typename MapFunctor::result_type> results;
         results.begin = index;
@@ -119,7 +119,7 @@ public:
         return false;
     }
 
-    bool runIterations(Iterator sequenceBeginIterator, int begin, int end, ReducedResultType *)
+    bool runIterations(Iterator sequenceBeginIterator, int begin, int end, ReducedResultType *) Q_DECL_OVERRIDE
     {
         IntermediateResults<typename MapFunctor::result_type> results;
         results.begin = begin;
@@ -137,23 +137,33 @@ public:
         return false;
     }
 
-    void finish()
+    void finish() Q_DECL_OVERRIDE
     {
         reducer.finish(reduce, reducedResult);
     }
 
-    bool shouldThrottleThread()
+    bool shouldThrottleThread() Q_DECL_OVERRIDE
     {
         return IterateKernel<Iterator, ReducedResultType>::shouldThrottleThread() || reducer.shouldThrottle();
     }
 
-    bool shouldStartThread()
+    bool shouldStartThread() Q_DECL_OVERRIDE
     {
         return IterateKernel<Iterator, ReducedResultType>::shouldStartThread() && reducer.shouldStartThread();
     }
 
+    int maximumBlockSize() const Q_DECL_OVERRIDE
+    {
+        return reducer.maximumBlockSize();
+    }
+
+    bool orderedIterations() const Q_DECL_OVERRIDE
+    {
+        return reducer.isOrdered();
+    }
+
     typedef ReducedResultType ResultType;
-    ReducedResultType *result()
+    ReducedResultType *result() Q_DECL_OVERRIDE
     {
         return &reducedResult;
     }
@@ -171,13 +181,13 @@ public:
     MappedEachKernel(Iterator begin, Iterator end, MapFunctor _map)
         : IterateKernel<Iterator, T>(begin, end), map(_map) { }
 
-    bool runIteration(Iterator it, int,  T *result)
+    bool runIteration(Iterator it, int,  T *result) Q_DECL_OVERRIDE
     {
         *result = map(*it);
         return true;
     }
 
-    bool runIterations(Iterator sequenceBeginIterator, int begin, int end, T *results)
+    bool runIterations(Iterator sequenceBeginIterator, int begin, int end, T *results) Q_DECL_OVERRIDE
     {
 
         Iterator it = sequenceBeginIterator;
@@ -197,6 +207,15 @@ inline ThreadEngineStarter<void> startMap(Iterator begin, Iterator end, Functor
     return startThreadEngine(new MapKernel<Iterator, Functor>(begin, end, functor));
 }
 
+template <typename Iterator, typename Functor>
+inline ThreadEngineStarter<void> startMap(Iterator begin, Iterator end, Functor functor,
+                                          const IterationHints &hints)
+{
+    MapKernel<Iterator, Functor> *kernel = new MapKernel<Iterator, Functor>(begin, end, functor);
+    kernel->setIterationHints(hints);
+    return startThreadEngine(kernel);
+}
+
 template <typename T, typename Iterator, typename Functor>
 inline ThreadEngineStarter<T> startMapped(Iterator begin, Iterator end, Functor functor)
 {
@@ -216,7 +235,7 @@ struct SequenceHolder1 : public Base
 
     Sequence sequence;
 
-    void finish()
+    void finish() Q_DECL_OVERRIDE
     {
         Base::finish();
         // Clear the sequence to make sure all temporaries are destroyed
@@ -65,10 +65,18 @@ namespace QtConcurrent {
     reduce blocks in the queue exceeds ReduceQueueStartLimit,
     MapReduce won't start any new threads, and when it exceeds
     ReduceQueueThrottleLimit running threads will be stopped.
+
+    The number of intermediate results waiting in the queue is limited
+    the same way, by ReduceResultsStartLimit and ReduceResultsThrottleLimit
+    per thread, and no block holds more than ReduceResultsStartLimit
+    results. This keeps the memory used for a reducer that is slower than
+    the map or filter functor bounded, whatever the size of the input.
 */
 enum {
     ReduceQueueStartLimit = 20,
-    ReduceQueueThrottleLimit = 30
+    ReduceQueueThrottleLimit = 30,
+    ReduceResultsStartLimit = 512,
+    ReduceResultsThrottleLimit = 1024
 };
 
 // IntermediateResults holds a block of intermediate results from a
@@ -87,26 +95,46 @@ public:
 enum ReduceOption {
     UnorderedReduce = 0x1,
     OrderedReduce = 0x2,
-    SequentialReduce = 0x4
-    // ParallelReduce = 0x8
+    SequentialReduce = 0x4,
+    ParallelReduce = 0x8
 };
 Q_DECLARE_FLAGS(ReduceOptions, ReduceOption)
 Q_DECLARE_OPERATORS_FOR_FLAGS(ReduceOptions)
 
 #ifndef Q_QDOC
 
-// supports both ordered and out-of-order reduction
+// supports both ordered and out-of-order reduction, and parallel
+// reduction into partial results when the reduce functor combines values
+// of the result type
 template <typename ReduceFunctor, typename ReduceResultType, typename T>
 class ReduceKernel
 {
     typedef QMap<int, IntermediateResults<T> > ResultsMap;
+    typedef std::is_same<ReduceResultType, T> CanReduceInParallel;
 
     const ReduceOptions reduceOptions;
 
     QMutex mutex;
-    int progress, resultsMapSize, threadCount;
+    int progress, resultsMapSize, resultsCount, threadCount;
     ResultsMap resultsMap;
 
+    // ParallelReduce: every partial result is reduced into by one thread
+    // at a time, the idle ones are kept for the next block
+    QVector<ReduceResultType *> partialResults;
+    QVector<ReduceResultType *> idlePartialResults;
+
+    Q_DISABLE_COPY(ReduceKernel)
+
+    static ReduceOptions supportedOptions(ReduceOptions options)
+    {
+        // reducing in parallel needs to combine the partial results
+        // with the reduce functor; fall back to an unordered reduction
+        // if it can't do that
+        if ((options & ParallelReduce) && !CanReduceInParallel::value)
+            options = (options & ~ReduceOptions(ParallelReduce)) | UnorderedReduce;
+        return options;
+    }
+
     bool canReduce(int begin) const
     {
         return (((reduceOptions & UnorderedReduce)
@@ -135,19 +163,72 @@ class ReduceKernel
         }
     }
 
+    void reduceInParallel(ReduceFunctor &reduce,
+                          const IntermediateResults<T> &result,
+                          std::true_type)
+    {
+        if (result.vector.isEmpty())
+            return;
+
+        QMutexLocker locker(&mutex);
+        if (idlePartialResults.isEmpty()) {
+            // start a new partial result from the first value, so that
+            // reductions without an identity element work as well
+            locker.unlock();
+            ReduceResultType *partialResult = new ReduceResultType(result.vector.at(0));
+            for (int i = 1; i < result.vector.size(); ++i)
+                reduce(*partialResult, result.vector.at(i));
+            locker.relock();
+            partialResults.append(partialResult);
+            idlePartialResults.append(partialResult);
+            return;
+        }
+
+        ReduceResultType *partialResult = idlePartialResults.takeLast();
+        locker.unlock();
+        reduceResult(reduce, *partialResult, result);
+        locker.relock();
+        idlePartialResults.append(partialResult);
+    }
+
+    void reduceInParallel(ReduceFunctor &, const IntermediateResults<T> &, std::false_type)
+    {
+        Q_UNREACHABLE();
+    }
+
+    void reducePartialResults(ReduceFunctor &reduce, ReduceResultType &r, std::true_type)
+    {
+        for (int i = 0; i < partialResults.size(); ++i)
+            reduce(r, *partialResults.at(i));
+    }
+
+    void reducePartialResults(ReduceFunctor &, ReduceResultType &, std::false_type)
+    { }
+
 public:
     ReduceKernel(ReduceOptions _reduceOptions)
-        : reduceOptions(_reduceOptions), progress(0), resultsMapSize(0),
-          threadCount(QThreadPool::globalInstance()->maxThreadCount())
+        : reduceOptions(supportedOptions(_reduceOptions)), progress(0), resultsMapSize(0),
+          resultsCount(0), threadCount(QThreadPool::globalInstance()->maxThreadCount())
     { }
 
+    ~ReduceKernel()
+    {
+        qDeleteAll(partialResults);
+    }
+
     void runReduce(ReduceFunctor &reduce,
                    ReduceResultType &r,
                    const IntermediateResults<T> &result)
     {
+        if (reduceOptions & ParallelReduce) {
+            reduceInParallel(reduce, result, CanReduceInParallel());
+            return;
+        }
+
         QMutexLocker locker(&mutex);
         if (!canReduce(result.begin)) {
             ++resultsMapSize;
+            resultsCount += result.vector.size();
             resultsMap.insert(result.begin, result);
             return;
         }
@@ -171,6 +252,8 @@ public:
                 locker.relock();
 
                 resultsMapSize -= resultsMapCopy.size();
+                for (typename ResultsMap::const_iterator it = resultsMapCopy.cbegin(); it != resultsMapCopy.cend(); ++it)
+                    resultsCount -= it.value().vector.size();
             }
 
             progress = 0;
@@ -194,6 +277,7 @@ public:
                 locker.relock();
 
                 --resultsMapSize;
+                resultsCount -= it.value().vector.size();
                 progress += it.value().end - it.value().begin;
                 it = resultsMap.erase(it);
             }
@@ -204,16 +288,29 @@ public:
     void finish(ReduceFunctor &reduce, ReduceResultType &r)
     {
         reduceResults(reduce, r, resultsMap);
+        reducePartialResults(reduce, r, CanReduceInParallel());
     }
 
     inline bool shouldThrottle()
     {
-        return (resultsMapSize > (ReduceQueueThrottleLimit * threadCount));
+        return (resultsMapSize > (ReduceQueueThrottleLimit * threadCount)
+                || resultsCount > (ReduceResultsThrottleLimit * threadCount));
     }
 
     inline bool shouldStartThread()
     {
-        return (resultsMapSize <= (ReduceQueueStartLimit * threadCount));
+        return (resultsMapSize <= (ReduceQueueStartLimit * threadCount)
+                && resultsCount <= (ReduceResultsStartLimit * threadCount));
+    }
+
+    inline int maximumBlockSize() const
+    {
+        return ReduceResultsStartLimit;
+    }
+
+    inline bool isOrdered() const
+    {
+        return !(reduceOptions & (UnorderedReduce | ParallelReduce));
     }
 };
 
@@ -259,6 +259,164 @@ static inline bool simdDecodeAscii(ushort *, const uchar *, const uchar *, const
 }
 #endif
 
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3) && !defined(QT_BOOTSTRAPPED)
+#include <tmmintrin.h>
+
+// For every 8-bit mask of UTF-16 lanes to keep, the PSHUFB control that moves
+// those lanes to the front of the register (0x80 clears the unused ones), and
+// the number of lanes kept.
+static Q_DECL_CONSTEXPR int nthSetBit(uint mask, int n, int bit = 0)
+{
+    return bit == 8 ? -1
+            : !(mask & (1U << bit)) ? nthSetBit(mask, n, bit + 1)
+            : n ? nthSetBit(mask, n - 1, bit + 1)
+            : bit;
+}
+
+static Q_DECL_CONSTEXPR uchar compressShuffleByte(uint mask, int i)
+{
+    return nthSetBit(mask, i / 2) < 0 ? 0x80 : uchar(2 * nthSetBit(mask, i / 2) + (i & 1));
+}
+
+#define COMPRESS_SHUFFLE(m) \
+    { compressShuffleByte(m, 0), compressShuffleByte(m, 1), compressShuffleByte(m, 2), \
+      compressShuffleByte(m, 3), compressShuffleByte(m, 4), compressShuffleByte(m, 5), \
+      compressShuffleByte(m, 6), compressShuffleByte(m, 7), compressShuffleByte(m, 8), \
+      compressShuffleByte(m, 9), compressShuffleByte(m, 10), compressShuffleByte(m, 11), \
+      compressShuffleByte(m, 12), compressShuffleByte(m, 13), compressShuffleByte(m, 14), \
+      compressShuffleByte(m, 15) }
+#define COMPRESS_COUNT(m)   uchar(qPopulationCount(quint8(m)))
+#define COMPRESS_ROW4(R, m)     R(m), R(m + 1), R(m + 2), R(m + 3)
+#define COMPRESS_ROW16(R, m)    COMPRESS_ROW4(R, m), COMPRESS_ROW4(R, m + 4), COMPRESS_ROW4(R, m + 8), COMPRESS_ROW4(R, m + 12)
+#define COMPRESS_ROW64(R, m)    COMPRESS_ROW16(R, m), COMPRESS_ROW16(R, m + 16), COMPRESS_ROW16(R, m + 32), COMPRESS_ROW16(R, m + 48)
+#define COMPRESS_TABLE(R)       COMPRESS_ROW64(R, 0), COMPRESS_ROW64(R, 64), COMPRESS_ROW64(R, 128), COMPRESS_ROW64(R, 192)
+static const uchar compressShuffle[256][16] = { COMPRESS_TABLE(COMPRESS_SHUFFLE) };
+static const uchar compressCount[256] = { COMPRESS_TABLE(COMPRESS_COUNT) };
+#undef COMPRESS_TABLE
+#undef COMPRESS_ROW64
+#undef COMPRESS_ROW16
+#undef COMPRESS_ROW4
+#undef COMPRESS_COUNT
+#undef COMPRESS_SHUFFLE
+
+// Decodes blocks of sixteen bytes made only of well-formed one-, two- and
+// three-byte sequences. A sequence starting at the end of a block is decoded
+// with that block, and its continuation bytes are then skipped at the start of
+// the next. The first block containing anything else -- four-byte sequences,
+// malformed input, or fewer than 18 bytes left -- is left to the scalar
+// decoder, so errors are reported exactly as before.
+QT_FUNCTION_TARGET(SSSE3)
+static bool simdDecodeNonAscii_ssse3(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask3f = _mm_set1_epi8(0x3f);
+    ushort *d = dst;
+    const uchar *s = src;
+    uint carry = 0;     // continuation bytes of the previous block's last character
+
+    while (end - s >= 18) {
+        const __m128i b0 = _mm_loadu_si128((const __m128i *)s);
+        if (!_mm_movemask_epi8(b0)) {
+            // all ASCII (so there's no carry either)
+            _mm_storeu_si128((__m128i *)d, _mm_unpacklo_epi8(b0, zero));
+            _mm_storeu_si128(1 + (__m128i *)d, _mm_unpackhi_epi8(b0, zero));
+            s += 16;
+            d += 16;
+            continue;
+        }
+        const __m128i b1 = _mm_loadu_si128((const __m128i *)(s + 1));
+        const __m128i b2 = _mm_loadu_si128((const __m128i *)(s + 2));
+
+        // classify the bytes; as signed chars, 0x80 to 0xff are negative
+        const __m128i ascii = _mm_cmpgt_epi8(b0, _mm_set1_epi8(-1));
+        const __m128i cont0 = _mm_cmplt_epi8(b0, _mm_set1_epi8(char(0xc0)));
+        const __m128i lead2 = _mm_and_si128(_mm_cmpgt_epi8(b0, _mm_set1_epi8(char(0xc1))),
+                                            _mm_cmplt_epi8(b0, _mm_set1_epi8(char(0xe0))));
+        const __m128i lead3 = _mm_and_si128(_mm_cmpgt_epi8(b0, _mm_set1_epi8(char(0xdf))),
+                                            _mm_cmplt_epi8(b0, _mm_set1_epi8(char(0xf0))));
+        const __m128i known = _mm_or_si128(_mm_or_si128(ascii, cont0), _mm_or_si128(lead2, lead3));
+
+        const uint c0 = _mm_movemask_epi8(cont0);
+        const uint c1 = _mm_movemask_epi8(_mm_cmplt_epi8(b1, _mm_set1_epi8(char(0xc0))));
+        const uint c2 = _mm_movemask_epi8(_mm_cmplt_epi8(b2, _mm_set1_epi8(char(0xc0))));
+        const uint l2 = _mm_movemask_epi8(lead2);
+        const uint l3 = _mm_movemask_epi8(lead3);
+        const uint leads = l2 | l3;
+        const uint expected = leads << 1 | l3 << 2 | carry;
+
+        // reject overlong three-byte sequences (E0 80-9F) and surrogates (ED A0-BF)
+        const __m128i low1 = _mm_cmplt_epi8(b1, _mm_set1_epi8(char(0xa0)));
+        const __m128i e0 = _mm_cmpeq_epi8(b0, _mm_set1_epi8(char(0xe0)));
+        const __m128i ed = _mm_cmpeq_epi8(b0, _mm_set1_epi8(char(0xed)));
+        const uint badThree = _mm_movemask_epi8(_mm_or_si128(_mm_and_si128(e0, low1), _mm_andnot_si128(low1, ed)));
+
+        // every lead byte must be followed by the right number of continuation
+        // bytes, and every continuation byte in the block must belong to one
+        if ((_mm_movemask_epi8(known) ^ 0xffff) | (leads & ~c1) | (l3 & ~c2)
+                | ((c0 ^ expected) & 0xffff) | badThree)
+            break;
+
+        // compute the low and high bytes of a character at every position, as
+        // if each one started a sequence (there are no byte shifts, so shift
+        // 16-bit lanes and mask off what crossed from the neighbouring byte):
+        //   ASCII  0xxxxxxx                 -> 00000000 0xxxxxxx
+        //   2-byte 110yyyyy 10xxxxxx        -> 00000yyy yyxxxxxx
+        //   3-byte 1110zzzz 10yyyyyy 10xxxxxx -> zzzzyyyy yyxxxxxx
+        const __m128i top2 = _mm_set1_epi8(char(0xc0));
+        const __m128i low2 = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(b0, 6), top2), _mm_and_si128(b1, mask3f));
+        const __m128i low3 = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(b1, 6), top2), _mm_and_si128(b2, mask3f));
+        const __m128i high2 = _mm_and_si128(_mm_srli_epi16(b0, 2), _mm_set1_epi8(0x07));
+        const __m128i high3 = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(b0, 4), _mm_set1_epi8(char(0xf0))),
+                                           _mm_and_si128(_mm_srli_epi16(b1, 2), _mm_set1_epi8(0x0f)));
+        const __m128i low = _mm_or_si128(_mm_and_si128(ascii, b0),
+                                         _mm_or_si128(_mm_and_si128(lead2, low2), _mm_and_si128(lead3, low3)));
+        const __m128i high = _mm_or_si128(_mm_and_si128(lead2, high2), _mm_and_si128(lead3, high3));
+
+        // then drop the positions holding continuation bytes
+        const uint keep = ~c0;
+        const __m128i lo = _mm_shuffle_epi8(_mm_unpacklo_epi8(low, high),
+                                            _mm_loadu_si128((const __m128i *)compressShuffle[keep & 0xff]));
+        const __m128i hi = _mm_shuffle_epi8(_mm_unpackhi_epi8(low, high),
+                                            _mm_loadu_si128((const __m128i *)compressShuffle[(keep >> 8) & 0xff]));
+        _mm_storeu_si128((__m128i *)d, lo);
+        d += compressCount[keep & 0xff];
+        _mm_storeu_si128((__m128i *)d, hi);
+        d += compressCount[(keep >> 8) & 0xff];
+
+        // don't make the next load wait for the carry: it's only needed for
+        // the validation
+        carry = expected >> 16;
+        s += 16;
+    }
+    dst = d;
+    src = s + (carry & 1) + (carry >> 1);
+    return src == end;
+}
+#endif
+
+// Decodes non-ASCII UTF-8 in SIMD if the CPU supports it. If it stops before
+// the end, nextAscii is moved past the block that the scalar code must handle;
+// if it couldn't decode anything at all (say, text full of emoji), further
+// past it, so we don't keep retrying.
+static inline bool simdDecodeNonAscii(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3) && !defined(QT_BOOTSTRAPPED)
+    if (qCpuHasFeature(SSSE3)) {
+        const uchar *start = src;
+        if (simdDecodeNonAscii_ssse3(dst, src, end))
+            return true;
+        const int skip = src == start ? 64 : 16;
+        nextAscii = qMax(nextAscii, end - src > skip ? src + skip : end);
+    }
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(nextAscii);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+    return false;
+}
+
 QPair<QByteArray, bool> QUtf8::convertFromUnicode(const QChar *uc, int len)
 {
     // create a QByteArray with the worst case scenario size
@@ -421,6 +579,8 @@ QPair<QChar *, bool> QUtf8::convertToUnicode(QChar *buffer, const char *chars, i
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            if (simdDecodeNonAscii(dst, nextAscii, src, end))
+                break;
 
             do {
                 uchar b = *src++;
@@ -511,8 +671,13 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     const uchar *nextAscii = src;
     const uchar *start = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            // the BOM check below needs the first character decoded by the scalar code
+            if (headerdone && simdDecodeNonAscii(dst, nextAscii, src, end))
+                break;
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -350,4 +350,32 @@ while (i.hasNext()) {
 //! [30]
 }
 
+{
+QStringList lines;
+//! [31]
+QRegularExpressionMatcher matcher(QRegularExpression("^(\\d+)-(\\d+)-(\\d+) "));
+for (const QString &line : lines) {
+    if (matcher.match(line)) {
+        QStringRef year = matcher.capturedRef(1);
+        // ...
+    }
+}
+//! [31]
+}
+
+{
+QStringList lines;
+//! [32]
+QRegularExpressionSet set;
+set.add(QRegularExpression("error|fatal"));          // 0
+set.add(QRegularExpression("timeout after \\d+ms")); // 1
+set.add(QRegularExpression("user=(\\w+)"));          // 2
+
+for (const QString &line : lines) {
+    const QVector<int> matching = set.match(line);
+    // matching contains the indexes of the patterns that match line
+}
+//! [32]
+}
+
 }
@@ -18,6 +18,7 @@ HEADERS +=  \
         global/qtypetraits.h \
         global/qflags.h \
         global/qhooks_p.h \
+        global/qtrace_p.h \
         global/qversiontagging.h
 
 SOURCES += \
@@ -28,7 +29,8 @@ SOURCES += \
 	global/qmalloc.cpp \
         global/qnumeric.cpp \
         global/qlogging.cpp \
-        global/qhooks.cpp
+        global/qhooks.cpp \
+        global/qtrace.cpp
 
 VERSIONTAGGING_SOURCES = global/qversiontagging.cpp
 
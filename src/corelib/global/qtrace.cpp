@@ -0,0 +1,345 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qtrace_p.h"
+
+#include <qcoreapplication.h>
+#include <qdeadlinetimer.h>
+#include <qthread.h>
+
+#include <new>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcTraceCoreEvents, "qt.trace.core.events", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcTraceCoreThreads, "qt.trace.core.threads", QtInfoMsg)
+
+QBasicAtomicInt QTraceRecorder::active = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+namespace {
+
+struct TraceRecord
+{
+    qint64 timestamp;
+    const char *category;
+    const char *name;
+    quint64 argument;
+    char phase;
+    int thread;
+};
+
+// Written only by the thread that owns it; the head counts all records ever
+// written. Every owner gets a thread number of its own for the trace.
+struct TraceBuffer
+{
+    TraceBuffer *next;
+    QBasicAtomicPointer<void> threadId;
+    QBasicAtomicInt owned;
+    QBasicAtomicInt thread;
+    uint mask;
+    QBasicAtomicInteger<uint> head;
+    TraceRecord records[1];
+};
+
+// Buffers are never freed, a trace can be written at any time. New ones
+// are pushed onto the list without locking. When a thread exits, its
+// buffer is handed to the next thread that needs one, so the memory used
+// is bounded by the number of threads running at the same time.
+QBasicAtomicPointer<TraceBuffer> traceBuffers = Q_BASIC_ATOMIC_INITIALIZER(Q_NULLPTR);
+QBasicAtomicInt traceThreadCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+QBasicAtomicInt traceBufferSize = Q_BASIC_ATOMIC_INITIALIZER(QTraceRecorder::DefaultBufferSize);
+
+#if defined(Q_COMPILER_THREAD_LOCAL)
+thread_local TraceBuffer *threadTraceBuffer = Q_NULLPTR;
+thread_local bool threadTraceBufferReleased = false;
+
+// Gives the buffer of a thread back when the thread exits. It is separate
+// from threadTraceBuffer so that record() doesn't pay for the destructor.
+struct TraceBufferReleaser
+{
+    ~TraceBufferReleaser()
+    {
+        if (threadTraceBuffer)
+            threadTraceBuffer->owned.storeRelease(0);
+        threadTraceBuffer = Q_NULLPTR;
+        threadTraceBufferReleased = true;
+    }
+};
+#else
+// without thread-local storage there is no way to tell when a thread
+// exits, the buffers are not reused
+TraceBuffer *findTraceBuffer(Qt::HANDLE threadId)
+{
+    for (TraceBuffer *buffer = traceBuffers.loadAcquire(); buffer; buffer = buffer->next) {
+        if (buffer->threadId.load() == threadId)
+            return buffer;
+    }
+    return Q_NULLPTR;
+}
+#endif
+
+qint64 traceTimestamp()
+{
+    return QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+}
+
+void appendRecord(TraceBuffer *buffer, const char *category, const char *name,
+                  char phase, quint64 argument)
+{
+    const uint head = buffer->head.load();
+    TraceRecord &record = buffer->records[head & buffer->mask];
+    record.timestamp = traceTimestamp();
+    record.category = category;
+    record.name = name;
+    record.argument = argument;
+    record.phase = phase;
+    record.thread = buffer->thread.load();
+    buffer->head.storeRelease(head + 1);
+}
+
+TraceBuffer *createTraceBuffer(Qt::HANDLE threadId)
+{
+    uint size = 1;
+    while (size < uint(traceBufferSize.load()))
+        size *= 2;
+
+    // take over the buffer of a thread that has exited; its records are
+    // kept, followed by the name of that thread, until they are overwritten
+    for (TraceBuffer *buffer = traceBuffers.loadAcquire(); buffer; buffer = buffer->next) {
+        if (buffer->mask == size - 1 && buffer->owned.load() == 0
+                && buffer->owned.testAndSetAcquire(0, 1)) {
+            appendRecord(buffer, "__metadata", "thread_name", 'M',
+                         quint64(quintptr(buffer->threadId.load())));
+            buffer->threadId.store(threadId);
+            buffer->thread.storeRelease(traceThreadCount.fetchAndAddRelaxed(1) + 1);
+            return buffer;
+        }
+    }
+
+    void *memory = ::malloc(sizeof(TraceBuffer) + (size - 1) * sizeof(TraceRecord));
+    if (!memory)
+        return Q_NULLPTR;
+    TraceBuffer *buffer = new (memory) TraceBuffer;
+    buffer->threadId.store(threadId);
+    buffer->owned.store(1);
+    buffer->thread.store(traceThreadCount.fetchAndAddRelaxed(1) + 1);
+    buffer->mask = size - 1;
+    buffer->head.store(0);
+
+    TraceBuffer *next = traceBuffers.loadAcquire();
+    do {
+        buffer->next = next;
+    } while (!traceBuffers.testAndSetOrdered(next, buffer, next));
+    return buffer;
+}
+
+TraceBuffer *currentTraceBuffer()
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    if (Q_LIKELY(threadTraceBuffer))
+        return threadTraceBuffer;
+    if (threadTraceBufferReleased)
+        return Q_NULLPTR; // the thread is exiting
+    static thread_local TraceBufferReleaser releaser;
+    Q_UNUSED(releaser);
+    threadTraceBuffer = createTraceBuffer(QThread::currentThreadId());
+    return threadTraceBuffer;
+#else
+    const Qt::HANDLE threadId = QThread::currentThreadId();
+    if (TraceBuffer *buffer = findTraceBuffer(threadId))
+        return buffer;
+    return createTraceBuffer(threadId);
+#endif
+}
+
+void appendTimestamp(QByteArray &trace, qint64 nsecs)
+{
+    // microseconds with three decimals
+    trace += QByteArray::number(nsecs / 1000);
+    trace += '.';
+    const int fraction = int(nsecs % 1000);
+    if (fraction < 100)
+        trace += '0';
+    if (fraction < 10)
+        trace += '0';
+    trace += QByteArray::number(fraction);
+}
+
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Starts recording tracepoints into ring buffers of \a bufferSize records
+    per thread. The size of buffers created earlier doesn't change.
+*/
+void QTraceRecorder::start(int bufferSize)
+{
+    traceBufferSize.store(qMax(bufferSize, 1));
+    active.storeRelease(1);
+}
+
+/*!
+    \internal
+
+    Stops recording tracepoints. What has been recorded so far is kept.
+*/
+void QTraceRecorder::stop()
+{
+    active.storeRelease(0);
+}
+
+/*!
+    \internal
+
+    Records the tracepoint \a name of \a category in the current thread's
+    ring buffer. \a phase is a Chrome trace event phase: 'B' and 'E' for
+    the begin and the end of a scope, 'i' for an instant and 'b' and 'e' for
+    the begin and the end of an asynchronous operation whose id is
+    \a argument.
+*/
+void QTraceRecorder::record(const QLoggingCategory &category, const char *name,
+                            char phase, quint64 argument) Q_DECL_NOTHROW
+{
+    TraceBuffer *buffer = currentTraceBuffer();
+    if (Q_UNLIKELY(!buffer))
+        return;
+    appendRecord(buffer, category.categoryName(), name, phase, argument);
+}
+
+/*!
+    \internal
+
+    Returns the records of all threads in the Chrome trace event format.
+    Records written while this function runs may come out garbled; stop()
+    recording first for a consistent trace.
+*/
+QByteArray QTraceRecorder::chromeTrace()
+{
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray trace("{\"traceEvents\":[");
+    bool first = true;
+    for (TraceBuffer *buffer = traceBuffers.loadAcquire(); buffer; buffer = buffer->next) {
+        const uint head = buffer->head.loadAcquire();
+        const uint count = qMin(head, buffer->mask + 1);
+
+        if (!first)
+            trace += ',';
+        first = false;
+        trace += "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid
+                + ",\"tid\":" + QByteArray::number(buffer->thread.loadAcquire())
+                + ",\"args\":{\"name\":\"0x"
+                + QByteArray::number(quintptr(buffer->threadId.load()), 16) + "\"}}";
+
+        for (uint i = head - count; i != head; ++i) {
+            const TraceRecord &record = buffer->records[i & buffer->mask];
+            const QByteArray tid = QByteArray::number(record.thread);
+            if (record.phase == 'M') {
+                // the name of a thread that used this buffer before
+                trace += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid
+                        + ",\"tid\":" + tid + ",\"args\":{\"name\":\"0x"
+                        + QByteArray::number(record.argument, 16) + "\"}}";
+                continue;
+            }
+            trace += ",\n{\"name\":\"";
+            trace += record.name;
+            trace += "\",\"cat\":\"";
+            trace += record.category;
+            trace += "\",\"ph\":\"";
+            trace += record.phase;
+            trace += "\",\"ts\":";
+            appendTimestamp(trace, record.timestamp);
+            trace += ",\"pid\":" + pid + ",\"tid\":" + tid;
+            switch (record.phase) {
+            case 'B':
+            case 'i':
+                trace += ",\"args\":{\"value\":" + QByteArray::number(record.argument) + '}';
+                if (record.phase == 'i')
+                    trace += ",\"s\":\"t\"";
+                break;
+            case 'b':
+            case 'e':
+                trace += ",\"id\":\"0x" + QByteArray::number(record.argument, 16) + '"';
+                break;
+            }
+            trace += '}';
+        }
+    }
+    trace += "\n]}\n";
+    return trace;
+}
+
+static QByteArray traceFileName()
+{
+    return qgetenv("QT_TRACE_FILE");
+}
+
+static void startTracingFromEnvironment()
+{
+    if (traceFileName().isEmpty())
+        return;
+    bool ok;
+    const int bufferSize = qEnvironmentVariableIntValue("QT_TRACE_BUFFER_SIZE", &ok);
+    QTraceRecorder::start(ok && bufferSize > 0 ? bufferSize : int(QTraceRecorder::DefaultBufferSize));
+}
+Q_CONSTRUCTOR_FUNCTION(startTracingFromEnvironment)
+
+static void writeTraceFile()
+{
+    const QByteArray fileName = traceFileName();
+    if (fileName.isEmpty())
+        return;
+    QTraceRecorder::stop();
+
+    // QFile may not be usable any more this late
+    const QByteArray trace = QTraceRecorder::chromeTrace();
+    if (FILE *file = ::fopen(fileName.constData(), "w")) {
+        ::fwrite(trace.constData(), 1, trace.size(), file);
+        ::fclose(file);
+    } else {
+        qWarning("QTraceRecorder: cannot write the trace to %s", fileName.constData());
+    }
+}
+Q_DESTRUCTOR_FUNCTION(writeTraceFile)
+
+QT_END_NAMESPACE
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QTRACE_P_H
+#define QTRACE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qloggingcategory.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Tracepoints record what Qt is doing, with little enough overhead to be
+    left on in production builds. While no trace is being recorded, a
+    tracepoint costs a load and a branch that is predicted not taken.
+
+    Tracepoints belong to logging categories created with QtInfoMsg as
+    their severity level, named qt.trace.<module>.<area>. A category's
+    tracepoints are recorded while its info messages are enabled, so the
+    usual logging rules select what goes into a trace, e.g.
+    QT_LOGGING_RULES="qt.trace.core.*.info=false".
+
+    Every thread records into a ring buffer of its own without locking;
+    when a ring buffer is full the oldest records are overwritten. The
+    buffer of a thread that has exited is reused by the next new thread,
+    whose records follow the exited thread's ones. Setting
+    QT_TRACE_FILE starts recording when QtCore is loaded, and writes the
+    trace to that file in the Chrome trace event format (chrome://tracing,
+    Perfetto) when it is unloaded. QT_TRACE_BUFFER_SIZE sets the number
+    of records per thread.
+
+    Defining QT_NO_TRACE compiles the tracepoints out.
+*/
+class Q_CORE_EXPORT QTraceRecorder
+{
+public:
+    enum { DefaultBufferSize = 65536 };
+
+    static void start(int bufferSize = DefaultBufferSize);
+    static void stop();
+    static bool isActive() Q_DECL_NOTHROW { return active.load() != 0; }
+
+    static void record(const QLoggingCategory &category, const char *name,
+                       char phase, quint64 argument) Q_DECL_NOTHROW;
+    static QByteArray chromeTrace();
+
+    static QBasicAtomicInt active;
+};
+
+class QTraceScope
+{
+public:
+    // category is null while no trace is being recorded
+    QTraceScope(const QLoggingCategory *category, const char *name, quint64 argument) Q_DECL_NOTHROW
+        : m_category(category && category->isInfoEnabled() ? category : Q_NULLPTR), m_name(name)
+    {
+        if (Q_UNLIKELY(m_category))
+            QTraceRecorder::record(*m_category, m_name, 'B', argument);
+    }
+    ~QTraceScope()
+    {
+        if (Q_UNLIKELY(m_category))
+            QTraceRecorder::record(*m_category, m_name, 'E', 0);
+    }
+
+private:
+    Q_DISABLE_COPY(QTraceScope)
+    const QLoggingCategory *m_category;
+    const char *m_name;
+};
+
+#if defined(QT_BOOTSTRAPPED) && !defined(QT_NO_TRACE)
+#  define QT_NO_TRACE
+#endif
+
+#define Q_TRACE_CONCAT_HELPER(a, b) a ## b
+#define Q_TRACE_CONCAT(a, b) Q_TRACE_CONCAT_HELPER(a, b)
+
+#ifndef QT_NO_TRACE
+
+// Records the time spent in the enclosing scope. The argument is evaluated
+// even while no trace is being recorded, so it must be cheap.
+#  define Q_TRACE_SCOPE(category, name, argument) \
+    QTraceScope Q_TRACE_CONCAT(qt_trace_scope_, __LINE__)( \
+        Q_UNLIKELY(QTraceRecorder::isActive()) ? &category() : Q_NULLPTR, name, quint64(argument))
+
+#  define Q_TRACE_RECORD(category, name, phase, argument) \
+    do { \
+        if (Q_UNLIKELY(QTraceRecorder::isActive()) && category().isInfoEnabled()) \
+            QTraceRecorder::record(category(), name, phase, quint64(argument)); \
+    } while (false)
+
+#else
+
+#  define Q_TRACE_SCOPE(category, name, argument) do { } while (false)
+#  define Q_TRACE_RECORD(category, name, phase, argument) do { } while (false)
+
+#endif // QT_NO_TRACE
+
+// Records a point in time.
+#define Q_TRACE_INSTANT(category, name, argument) Q_TRACE_RECORD(category, name, 'i', argument)
+// Record the start and the end of an operation identified by id, which
+// can start and end in different threads.
+#define Q_TRACE_ASYNC_BEGIN(category, name, id) Q_TRACE_RECORD(category, name, 'b', id)
+#define Q_TRACE_ASYNC_END(category, name, id) Q_TRACE_RECORD(category, name, 'e', id)
+
+Q_DECLARE_LOGGING_CATEGORY(lcTraceCoreEvents)
+Q_DECLARE_LOGGING_CATEGORY(lcTraceCoreThreads)
+
+QT_END_NAMESPACE
+
+#endif // QTRACE_P_H
@@ -172,6 +172,7 @@ QIODevicePrivate::QIODevicePrivate()
       readBufferChunkSize(QIODEVICE_BUFFERSIZE),
       writeBufferChunkSize(0),
       transactionPos(0),
+      currentWriteChunk(nullptr),
       transactionStarted(false)
        , baseReadLineDataCalled(false)
        , accessMode(Unset)
@@ -777,6 +778,21 @@ bool QIODevicePrivate::allWriteBuffersEmpty() const
     return true;
 }
 
+/*!
+    \internal
+
+    Appends \a size bytes from \a data to the current write buffer. When
+    called from write(const QByteArray &) with that array's data, a shallow
+    copy of the array is appended instead.
+*/
+void QIODevicePrivate::write(const char *data, qint64 size)
+{
+    if (isWriteChunkCached(data, size))
+        writeBuffer.append(*currentWriteChunk);
+    else
+        writeBuffer.append(data, size);
+}
+
 /*!
     Opens the device and sets its OpenMode to \a mode. Returns \c true if successful;
     otherwise returns \c false. This function should be called from any
@@ -1713,8 +1729,7 @@ qint64 QIODevice::write(const char *data)
     return write(data, qstrlen(data));
 }
 
-/*! \fn qint64 QIODevice::write(const QByteArray &byteArray)
-
+/*!
     \overload
 
     Writes the content of \a byteArray to the device. Returns the number of
@@ -1722,6 +1737,23 @@ qint64 QIODevice::write(const char *data)
 
     \sa read(), writeData()
 */
+qint64 QIODevice::write(const QByteArray &byteArray)
+{
+    Q_D(QIODevice);
+
+    // Let a buffered writeData() reimplementation take a shallow copy of
+    // large blocks instead of copying them into its write buffer. Small
+    // blocks are still copied, so they coalesce into the buffer's chunks.
+    // So are arrays from QByteArray::fromRawData(), which have no capacity:
+    // the caller may change or free their data as soon as write() returns.
+    if (byteArray.size() >= QRINGBUFFER_CHUNKSIZE && byteArray.capacity() != 0)
+        d->currentWriteChunk = &byteArray;
+
+    const qint64 ret = write(byteArray.constData(), byteArray.size());
+
+    d->currentWriteChunk = nullptr;
+    return ret;
+}
 
 /*!
     Puts the character \a c back into the device, and decrements the
@@ -113,6 +113,7 @@ public:
         inline void setChunkSize(int size) { Q_ASSERT(m_buf); m_buf->setChunkSize(size); }
         inline int chunkSize() const { Q_ASSERT(m_buf); return m_buf->chunkSize(); }
         inline qint64 nextDataBlockSize() const { return (m_buf ? m_buf->nextDataBlockSize() : Q_INT64_C(0)); }
+        inline int blockCount() const { return (m_buf ? m_buf->blockCount() : 0); }
         inline const char *readPointer() const { return (m_buf ? m_buf->readPointer() : Q_NULLPTR); }
         inline const char *readPointerAtPosition(qint64 pos, qint64 &length) const { Q_ASSERT(m_buf); return m_buf->readPointerAtPosition(pos, length); }
         inline void free(qint64 bytes) { Q_ASSERT(m_buf); m_buf->free(bytes); }
@@ -131,6 +132,7 @@ public:
         inline qint64 read(char *data, qint64 maxLength) { return (m_buf ? m_buf->read(data, maxLength) : Q_INT64_C(0)); }
         inline QByteArray read() { return (m_buf ? m_buf->read() : QByteArray()); }
         inline qint64 peek(char *data, qint64 maxLength, qint64 pos = 0) const { return (m_buf ? m_buf->peek(data, maxLength, pos) : Q_INT64_C(0)); }
+        inline int readPointers(const char **data, qint64 *lengths, int maxCount, qint64 maxLength) const { return (m_buf ? m_buf->readPointers(data, lengths, maxCount, maxLength) : 0); }
         inline void append(const char *data, qint64 size) { Q_ASSERT(m_buf); m_buf->append(data, size); }
         inline void append(const QByteArray &qba) { Q_ASSERT(m_buf); m_buf->append(qba); }
         inline qint64 skip(qint64 length) { return (m_buf ? m_buf->skip(length) : Q_INT64_C(0)); }
@@ -149,6 +151,7 @@ public:
     int readBufferChunkSize;
     int writeBufferChunkSize;
     qint64 transactionPos;
+    const QByteArray *currentWriteChunk;
     bool transactionStarted;
     bool baseReadLineDataCalled;
 
@@ -174,6 +177,14 @@ public:
     }
     bool allWriteBuffersEmpty() const;
 
+    inline bool isWriteChunkCached(const char *data, qint64 size) const
+    {
+        return currentWriteChunk != nullptr
+               && currentWriteChunk->constData() == data
+               && currentWriteChunk->size() == size;
+    }
+    void write(const char *data, qint64 size);
+
     void seekBuffer(qint64 newPos);
 
     inline void setCurrentReadChannel(int channel)
@@ -39,6 +39,7 @@
 
 #include "qjson_p.h"
 #include <qalgorithms.h>
+#include <qfile.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -55,6 +56,13 @@ static const Base emptyArray = { { Q_TO_LITTLE_ENDIAN(sizeof(Base)) }, { 0 }, {
 static const Base emptyObject = { { Q_TO_LITTLE_ENDIAN(sizeof(Base)) }, { 0 }, { 0 } };
 
 
+Data::~Data()
+{
+    if (ownsData)
+        free(rawData);
+    delete mappedFile;
+}
+
 void Data::compact()
 {
     Q_ASSERT(sizeof(Value) == sizeof(offset));
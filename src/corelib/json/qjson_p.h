@@ -68,6 +68,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QFile;
+
 /*
   This defines a binary data structure for Json data. The data structure is optimised for fast reading
   and minimum allocations. The whole data structure can be mmap'ed and used directly.
@@ -826,13 +828,15 @@ public:
     };
     uint compactionCounter : 31;
     uint ownsData : 1;
+    // keeps the mapping of a document created by fromMappedFile() alive
+    QFile *mappedFile;
 
     inline Data(char *raw, int a)
-        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true)
+        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true), mappedFile(0)
     {
     }
     inline Data(int reserved, QJsonValue::Type valueType)
-        : rawData(0), compactionCounter(0), ownsData(true)
+        : rawData(0), compactionCounter(0), ownsData(true), mappedFile(0)
     {
         Q_ASSERT(valueType == QJsonValue::Array || valueType == QJsonValue::Object);
 
@@ -847,8 +851,7 @@ public:
         b->tableOffset = sizeof(Base);
         b->length = 0;
     }
-    inline ~Data()
-    { if (ownsData) free(rawData); }
+    ~Data();
 
     uint offsetOf(const void *ptr) const { return (uint)(((char *)ptr - rawData)); }
 
@@ -865,7 +868,8 @@ public:
     Data *clone(Base *b, int reserve = 0)
     {
         int size = sizeof(Header) + b->size;
-        if (b == header->root() && ref.load() == 1 && alloc >= size + reserve)
+        // data we don't own is read-only, changes always go to a copy of the modified container
+        if (ownsData && b == header->root() && ref.load() == 1 && alloc >= size + reserve)
             return this;
 
         if (reserve) {
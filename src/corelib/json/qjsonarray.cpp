@@ -1188,7 +1188,7 @@ bool QJsonArray::detach2(uint reserve)
         d->ref.ref();
         return true;
     }
-    if (reserve == 0 && d->ref.load() == 1)
+    if (reserve == 0 && d->ref.load() == 1 && d->ownsData)
         return true;
 
     QJsonPrivate::Data *x = d->clone(a, reserve);
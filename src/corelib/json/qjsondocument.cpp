@@ -41,6 +41,7 @@
 #include <qjsonobject.h>
 #include <qjsonvalue.h>
 #include <qjsonarray.h>
+#include <qfile.h>
 #include <qstringlist.h>
 #include <qvariant.h>
 #include <qdebug.h>
@@ -73,8 +74,8 @@ QT_BEGIN_NAMESPACE
     and isObject(). The array or object contained in the document can be retrieved using
     array() or object() and then read or manipulated.
 
-    A document can also be created from a stored binary representation using fromBinaryData() or
-    fromRawData().
+    A document can also be created from a stored binary representation using fromBinaryData(),
+    fromRawData() or fromMappedFile().
 
     \sa {JSON Support in Qt}, {JSON Save Game Example}
 */
@@ -170,6 +171,8 @@ QJsonDocument &QJsonDocument::operator =(const QJsonDocument &other)
  The created document does not take ownership of \a data and the caller
  has to guarantee that \a data will not be deleted or modified as long as
  any QJsonDocument, QJsonObject or QJsonArray still references the data.
+ Modifying the document copies the object or array being changed, \a data
+ itself is never written to.
 
  \a data has to be aligned to a 4 byte boundary.
 
@@ -256,6 +259,70 @@ QJsonDocument QJsonDocument::fromBinaryData(const QByteArray &data, DataValidati
     return QJsonDocument(d);
 }
 
+/*!
+ \since 5.8
+
+ Creates a QJsonDocument that uses the binary encoded JSON document
+ stored in the file \a fileName directly, without reading it into memory.
+
+ The file is mapped read-only with QFile::map(), so the pages holding it
+ are loaded on demand and shared by all processes mapping the same file.
+ The mapping is kept until the last QJsonDocument, QJsonObject, QJsonArray
+ or QJsonValue referencing the data is destroyed. The file must not be
+ modified during that time.
+
+ Modifying the document or any of its contents never writes to the file.
+ Instead, the object or array being changed is copied into memory, just
+ as it would be for a document shared with another copy, and the rest of
+ the document stays mapped.
+
+ \a validation decides whether the data is checked for validity before being used.
+ By default the data is validated, which reads the complete file once. If the file
+ cannot be mapped or the data is not valid, the method returns a null document.
+
+ \sa fromRawData(), fromBinaryData(), toBinaryData(), isNull(), DataValidation
+ */
+QJsonDocument QJsonDocument::fromMappedFile(const QString &fileName, DataValidation validation)
+{
+    QFile *file = new QFile(fileName);
+    if (!file->open(QIODevice::ReadOnly)) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    const qint64 fileSize = file->size();
+    const qint64 minSize = sizeof(QJsonPrivate::Header) + sizeof(QJsonPrivate::Base);
+    uchar *raw = 0;
+    if (fileSize >= minSize && fileSize <= INT_MAX)
+        raw = file->map(0, fileSize);
+    // the mapping stays valid until the file object is destroyed
+    file->close();
+    if (!raw) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    QJsonPrivate::Header *h = reinterpret_cast<QJsonPrivate::Header *>(raw);
+    QJsonPrivate::Base *root = h->root();
+    if (h->tag != QJsonDocument::BinaryFormatTag || h->version != 1u ||
+        sizeof(QJsonPrivate::Header) + root->size > quint64(fileSize)) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    QJsonPrivate::Data *d = new QJsonPrivate::Data(reinterpret_cast<char *>(raw),
+                                                   sizeof(QJsonPrivate::Header) + root->size);
+    d->ownsData = false;
+    d->mappedFile = file;
+
+    if (validation != BypassValidation && !d->valid()) {
+        delete d;
+        return QJsonDocument();
+    }
+
+    return QJsonDocument(d);
+}
+
 /*!
  Creates a QJsonDocument from the QVariant \a variant.
 
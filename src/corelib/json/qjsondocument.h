@@ -67,7 +67,8 @@ struct Q_CORE_EXPORT QJsonParseError
         MissingObject,
         DeepNesting,
         DocumentTooLarge,
-        GarbageAtEnd
+        GarbageAtEnd,
+        PrematureEndOfDocument
     };
 
     QString    errorString() const;
@@ -104,6 +105,8 @@ public:
     static QJsonDocument fromBinaryData(const QByteArray &data, DataValidation validation  = Validate);
     QByteArray toBinaryData() const;
 
+    static QJsonDocument fromMappedFile(const QString &fileName, DataValidation validation = Validate);
+
     static QJsonDocument fromVariant(const QVariant &variant);
     QVariant toVariant() const;
 
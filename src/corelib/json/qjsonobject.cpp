@@ -1209,7 +1209,7 @@ bool QJsonObject::detach2(uint reserve)
         d->ref.ref();
         return true;
     }
-    if (reserve == 0 && d->ref.load() == 1)
+    if (reserve == 0 && d->ref.load() == 1 && d->ownsData)
         return true;
 
     QJsonPrivate::Data *x = d->clone(o, reserve);
@@ -44,7 +44,8 @@
 #include <qdebug.h>
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
-#include "private/qutfcodec_p.h"
+#include "private/qlocale_tools_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -78,6 +79,7 @@ QT_BEGIN_NAMESPACE
 #define JSONERR_DEEP_NEST   QT_TRANSLATE_NOOP("QJsonParseError", "too deeply nested document")
 #define JSONERR_DOC_LARGE   QT_TRANSLATE_NOOP("QJsonParseError", "too large document")
 #define JSONERR_GARBAGEEND  QT_TRANSLATE_NOOP("QJsonParseError", "garbage at the end of the document")
+#define JSONERR_PREMATURE   QT_TRANSLATE_NOOP("QJsonParseError", "premature end of document")
 
 /*!
     \class QJsonParseError
@@ -112,6 +114,9 @@ QT_BEGIN_NAMESPACE
     \value DeepNesting              The JSON document is too deeply nested for the parser to parse it
     \value DocumentTooLarge         The JSON document is too large for the parser to parse it
     \value GarbageAtEnd             The parsed document contains additional garbage characters at the end
+    \value PrematureEndOfDocument   The input ended in the middle of a value. This error is only
+                                    reported by QJsonStreamReader, which can continue once more
+                                    data is available. This value was introduced in Qt 5.8.
 
 */
 
@@ -187,6 +192,9 @@ QString QJsonParseError::errorString() const
     case GarbageAtEnd:
         sz = JSONERR_GARBAGEEND;
         break;
+    case PrematureEndOfDocument:
+        sz = JSONERR_PREMATURE;
+        break;
     }
 #ifndef QT_BOOTSTRAPPED
     return QCoreApplication::translate("QJsonParseError", sz);
@@ -267,10 +275,45 @@ bool Parser::eatSpace()
             *json != Return)
             break;
         ++json;
+#ifdef __SSE2__
+        // indentation comes in runs, skip the rest of this one 16 bytes at a time
+        const __m128i space = _mm_set1_epi8(Space);
+        const __m128i tab = _mm_set1_epi8(Tab);
+        const __m128i lineFeed = _mm_set1_epi8(LineFeed);
+        const __m128i carriageReturn = _mm_set1_epi8(Return);
+        while (end - json >= 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+            const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                                            _mm_or_si128(_mm_cmpeq_epi8(chunk, lineFeed), _mm_cmpeq_epi8(chunk, carriageReturn)));
+            const uint mask = ~uint(_mm_movemask_epi8(ws)) & 0xffff;
+            if (mask) {
+                json += qCountTrailingZeroBits(mask);
+                return true;
+            }
+            json += 16;
+        }
+#endif
     }
     return (json < end);
 }
 
+#ifdef __SSE2__
+/*
+    Returns the number of bytes at the start of the 16 bytes at \a json that
+    can be copied into a string as they are: everything but quotation marks,
+    backslashes and the bytes of multi-byte UTF-8 sequences.
+*/
+static inline uint plainStringBytes(const char *json, __m128i *chunk)
+{
+    *chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+    const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(*chunk, _mm_set1_epi8('"')),
+                                         _mm_cmpeq_epi8(*chunk, _mm_set1_epi8('\\')));
+    // the high bit of each byte of the chunk marks non-ASCII
+    const uint mask = uint(_mm_movemask_epi8(_mm_or_si128(special, *chunk)));
+    return mask ? qCountTrailingZeroBits(mask) : 16;
+}
+#endif
+
 char Parser::nextToken()
 {
     if (!eatSpace())
@@ -717,87 +760,57 @@ bool Parser::parseValue(QJsonPrivate::Value *val, int baseOffset)
 
 
 
-/*
-        number = [ minus ] int [ frac ] [ exp ]
-        decimal-point = %x2E       ; .
-        digit1-9 = %x31-39         ; 1-9
-        e = %x65 / %x45            ; e E
-        exp = e [ minus / plus ] 1*DIGIT
-        frac = decimal-point 1*DIGIT
-        int = zero / ( digit1-9 *DIGIT )
-        minus = %x2D               ; -
-        plus = %x2B                ; +
-        zero = %x30                ; 0
-
-*/
-
 bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 {
     BEGIN << "parseNumber" << json;
     val->type = QJsonValue::Double;
 
     const char *start = json;
-    bool isInt = true;
-
-    // minus
-    if (json < end && *json == '-')
-        ++json;
-
-    // int = zero / ( digit1-9 *DIGIT )
-    if (json < end && *json == '0') {
-        ++json;
-    } else {
-        while (json < end && *json >= '0' && *json <= '9')
-            ++json;
-    }
-
-    // frac = decimal-point 1*DIGIT
-    if (json < end && *json == '.') {
-        isInt = false;
-        ++json;
-        while (json < end && *json >= '0' && *json <= '9')
-            ++json;
-    }
-
-    // exp = e [ minus / plus ] 1*DIGIT
-    if (json < end && (*json == 'e' || *json == 'E')) {
-        isInt = false;
-        ++json;
-        if (json < end && (*json == '-' || *json == '+'))
-            ++json;
-        while (json < end && *json >= '0' && *json <= '9')
-            ++json;
-    }
+    bool isInt = scanNumber(json, end);
 
     if (json >= end) {
         lastError = QJsonParseError::TerminationByNumber;
         return false;
     }
 
-    QByteArray number(start, json - start);
-    DEBUG << "numberstring" << number;
+    DEBUG << "numberstring" << QByteArray(start, json - start);
 
-    if (isInt) {
-        bool ok;
-        int n = number.toInt(&ok);
-        if (ok && n < (1<<25) && n > -(1<<25)) {
+    union {
+        quint64 ui;
+        double d;
+    };
+
+    // integers of up to 9 digits are converted here, without allocating
+    const bool negative = (*start == '-');
+    const char *digit = start + negative;
+    if (isInt && json > digit && json - digit <= 9) {
+        int n = 0;
+        for ( ; digit < json; ++digit)
+            n = n * 10 + (*digit - '0');
+        if (negative)
+            n = -n;
+        if (n < (1<<25) && n > -(1<<25)) {
             val->int_value = n;
             val->latinOrIntValue = true;
             END;
             return true;
         }
-    }
+        d = n;
+    } else {
+        // asciiToDouble() needs a terminating null
+        const int length = json - start;
+        QVarLengthArray<char, 64> number(length + 1);
+        memcpy(number.data(), start, length);
+        number[length] = '\0';
 
-    bool ok;
-    union {
-        quint64 ui;
-        double d;
-    };
-    d = number.toDouble(&ok);
+        bool ok;
+        int processed;
+        d = asciiToDouble(number.constData(), length, ok, processed);
 
-    if (!ok) {
-        lastError = QJsonParseError::IllegalNumber;
-        return false;
+        if (!ok) {
+            lastError = QJsonParseError::IllegalNumber;
+            return false;
+        }
     }
 
     int pos = reserveSpace(sizeof(double));
@@ -815,102 +828,6 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
     return true;
 }
 
-/*
-
-        string = quotation-mark *char quotation-mark
-
-        char = unescaped /
-               escape (
-                   %x22 /          ; "    quotation mark  U+0022
-                   %x5C /          ; \    reverse solidus U+005C
-                   %x2F /          ; /    solidus         U+002F
-                   %x62 /          ; b    backspace       U+0008
-                   %x66 /          ; f    form feed       U+000C
-                   %x6E /          ; n    line feed       U+000A
-                   %x72 /          ; r    carriage return U+000D
-                   %x74 /          ; t    tab             U+0009
-                   %x75 4HEXDIG )  ; uXXXX                U+XXXX
-
-        escape = %x5C              ; \
-
-        quotation-mark = %x22      ; "
-
-        unescaped = %x20-21 / %x23-5B / %x5D-10FFFF
- */
-static inline bool addHexDigit(char digit, uint *result)
-{
-    *result <<= 4;
-    if (digit >= '0' && digit <= '9')
-        *result |= (digit - '0');
-    else if (digit >= 'a' && digit <= 'f')
-        *result |= (digit - 'a') + 10;
-    else if (digit >= 'A' && digit <= 'F')
-        *result |= (digit - 'A') + 10;
-    else
-        return false;
-    return true;
-}
-
-static inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
-{
-    ++json;
-    if (json >= end)
-        return false;
-
-    DEBUG << "scan escape" << (char)*json;
-    uint escaped = *json++;
-    switch (escaped) {
-    case '"':
-        *ch = '"'; break;
-    case '\\':
-        *ch = '\\'; break;
-    case '/':
-        *ch = '/'; break;
-    case 'b':
-        *ch = 0x8; break;
-    case 'f':
-        *ch = 0xc; break;
-    case 'n':
-        *ch = 0xa; break;
-    case 'r':
-        *ch = 0xd; break;
-    case 't':
-        *ch = 0x9; break;
-    case 'u': {
-        *ch = 0;
-        if (json > end - 4)
-            return false;
-        for (int i = 0; i < 4; ++i) {
-            if (!addHexDigit(*json, ch))
-                return false;
-            ++json;
-        }
-        return true;
-    }
-    default:
-        // this is not as strict as one could be, but allows for more Json files
-        // to be parsed correctly.
-        *ch = escaped;
-        return true;
-    }
-    return true;
-}
-
-static inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
-{
-    const uchar *&src = reinterpret_cast<const uchar *&>(json);
-    const uchar *uend = reinterpret_cast<const uchar *>(end);
-    uchar b = *src++;
-    int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, result, src, uend);
-    if (res < 0) {
-        // decoding error, backtrack the character we read above
-        --json;
-        return false;
-    }
-
-    return true;
-}
-
 bool Parser::parseString(bool *latin1)
 {
     *latin1 = true;
@@ -926,6 +843,25 @@ bool Parser::parseString(bool *latin1)
 
     BEGIN << "parse string stringPos=" << stringPos << json;
     while (json < end) {
+#ifdef __SSE2__
+        // copy runs of plain ASCII 16 bytes at a time
+        while (end - json >= 16 && json - start < 0x8000 - 16) {
+            __m128i chunk;
+            const uint n = plainStringBytes(json, &chunk);
+            if (!n)
+                break;
+            int pos = reserveSpace(16);
+            if (pos < 0)
+                return false;
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(data + pos), chunk);
+            current -= 16 - n;
+            json += n;
+            if (n < 16)
+                break;
+        }
+        if (json >= end)
+            break;
+#endif
         uint ch = 0;
         if (*json == '"')
             break;
@@ -978,6 +914,27 @@ bool Parser::parseString(bool *latin1)
     current = outStart + sizeof(int);
 
     while (json < end) {
+#if defined(__SSE2__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        // widen runs of plain ASCII to UTF-16 16 bytes at a time
+        while (end - json >= 16) {
+            __m128i chunk;
+            const uint n = plainStringBytes(json, &chunk);
+            if (!n)
+                break;
+            int pos = reserveSpace(32);
+            if (pos < 0)
+                return false;
+            const __m128i zero = _mm_setzero_si128();
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(data + pos), _mm_unpacklo_epi8(chunk, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(data + pos + 16), _mm_unpackhi_epi8(chunk, zero));
+            current -= 2 * (16 - n);
+            json += n;
+            if (n < 16)
+                break;
+        }
+        if (json >= end)
+            break;
+#endif
         uint ch = 0;
         if (*json == '"')
             break;
@@ -0,0 +1,1405 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstream.h"
+
+#include <qiodevice.h>
+#include <qjsonarray.h>
+#include <qjsonobject.h>
+#include <qlocale.h>
+#include <qvarlengtharray.h>
+#include <qvector.h>
+
+#include "qjsonparser_p.h"
+#include "qjsonwriter_p.h"
+#include "private/qlocale_tools_p.h"
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+// how much data to request from the device at a time
+static const int readChunkSize = 64 * 1024;
+// how much output to collect before writing it to the device
+static const int writeChunkSize = 64 * 1024;
+// same as in QJsonPrivate::Parser
+static const int nestingLimit = 1024;
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.8
+
+    \brief The QJsonStreamReader class provides a fast parser for reading
+    JSON text one token at a time.
+
+    QJsonDocument::fromJson() builds the complete document in memory before
+    returning it. QJsonStreamReader instead reads from a QIODevice, or from
+    data passed to addData(), in chunks, and reports the structure of the
+    input as a sequence of tokens. Its memory use is bounded by the size of
+    the largest single token rather than by the size of the input, which
+    makes it suitable for very large files and for streams of
+    newline-delimited JSON documents.
+
+    The basic concept is a loop calling readNext() and acting on the
+    returned token type:
+
+    \code
+    QJsonStreamReader reader(&file);
+    while (reader.readNext() == QJsonStreamReader::StartObject) {
+        // one document per line
+        const QJsonObject record = reader.readValue().toObject();
+        ...
+    }
+    if (reader.hasError())
+        ...
+    \endcode
+
+    The reader accepts any number of JSON values, separated by whitespace,
+    at the top level. Each top-level value may be a scalar as well as an
+    object or an array. When the input is exhausted between two values,
+    readNext() returns EndDocument. readValue() converts the value starting
+    at the current token into a QJsonValue, so that only the part of the
+    input that is of interest needs to be held in memory at once;
+    skipCurrentValue() discards it.
+
+    The reader checks the input with the same rules as
+    QJsonDocument::fromJson() and reports problems through error() and
+    errorString(). If the input ends in the middle of a value, the error is
+    QJsonParseError::PrematureEndOfDocument. This error is recoverable:
+    once more data has been added with addData(), or has arrived on a
+    sequential device, calling readNext() continues where the reader left
+    off. Since a number can only end where its input ends, a number at the
+    very end is only complete once the device has closed its read channel,
+    or endData() has been called after the last addData().
+
+    \sa QJsonStreamWriter, QJsonDocument, {JSON Support in Qt}
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken The reader has not yet read anything.
+    \value Invalid An error has occurred, reported in error() and errorString().
+    \value EndDocument The input is exhausted and the reader is not inside a value.
+    \value StartArray The reader reached the start of an array.
+    \value EndArray The reader reached the end of an array.
+    \value StartObject The reader reached the start of an object.
+    \value EndObject The reader reached the end of an object.
+    \value Name The reader read the name of an object member; it is available in text().
+    \value String The reader read a string value; it is available in text().
+    \value Number The reader read a number; it is available in toDouble().
+    \value Bool The reader read \c true or \c false; it is available in toBool().
+    \value Null The reader read \c null.
+*/
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State {
+        TopLevel,           // between top-level values
+        ValueOrEndArray,    // after [
+        NameOrEndObject,    // after {
+        ArrayValue,         // after , in an array
+        MemberName,         // after , in an object
+        NameSeparator,      // after a member name
+        MemberValue,        // after :
+        SeparatorOrEnd      // after a value inside an array or object
+    };
+
+    enum Scan { Done, NeedData, Failed };
+
+    QJsonStreamReaderPrivate()
+        : device(Q_NULLPTR), pos(0), bufferOffset(0), tokenOffset(0), stringScanned(0),
+          valueStart(-1), state(TopLevel), type(QJsonStreamReader::NoToken),
+          resumeType(QJsonStreamReader::NoToken),
+          error(QJsonParseError::NoError), number(0), boolean(false),
+          inputComplete(false), readChannelFinished(false), bomChecked(false)
+    {}
+    ~QJsonStreamReaderPrivate()
+    {
+        QObject::disconnect(readChannelConnection);
+    }
+
+    QJsonStreamReader::TokenType readNext();
+    QJsonValue readValue();
+    QJsonValue value() const;
+
+    void discardConsumed();
+    bool fill();
+    bool isInputComplete() const;
+    QJsonStreamReader::TokenType raiseError(QJsonParseError::ParseError e);
+    QJsonStreamReader::TokenType needData();
+    QJsonStreamReader::TokenType readValueToken();
+    QJsonStreamReader::TokenType endContainer(char open);
+    void valueDone();
+    Scan scanString();
+    Scan scanLiteral(const char *literal, int length);
+    Scan scanNumber();
+
+    QIODevice *device;
+    QByteArray buffer;
+    int pos;                // first unconsumed byte in buffer
+    qint64 bufferOffset;    // position of buffer[0] in the input
+    qint64 tokenOffset;
+    int stringScanned;      // bytes of the current string known not to end it
+    qint64 valueStart;      // input position readValue() goes back to, or -1
+    QVarLengthArray<char, 64> containers;
+    State state;
+
+    QJsonStreamReader::TokenType type;
+    QJsonStreamReader::TokenType resumeType; // token readValue() starts again from
+    QJsonParseError::ParseError error;
+    QString text;
+    double number;
+    bool boolean;
+
+    bool inputComplete;
+    bool readChannelFinished;
+    QMetaObject::Connection readChannelConnection;
+    bool bomChecked;
+};
+
+static inline bool isSpace(char c)
+{
+    return c == 0x20 || c == 0x09 || c == 0x0a || c == 0x0d;
+}
+
+/*!
+    \internal
+
+    Discards the bytes that were already consumed, except for those of a
+    value that readValue() may have to read again.
+*/
+void QJsonStreamReaderPrivate::discardConsumed()
+{
+    int consumed = pos;
+    if (valueStart >= 0)
+        consumed = qMin(consumed, int(valueStart - bufferOffset));
+    if (consumed) {
+        buffer.remove(0, consumed);
+        bufferOffset += consumed;
+        pos -= consumed;
+    }
+}
+
+/*!
+    \internal
+
+    Appends the next chunk of input to the buffer, first discarding the
+    bytes that were already consumed. Returns false if there is no more
+    data right now.
+*/
+bool QJsonStreamReaderPrivate::fill()
+{
+    if (!device)
+        return false;
+
+    discardConsumed();
+
+    const int oldSize = buffer.size();
+    buffer.resize(oldSize + readChunkSize);
+    const qint64 read = device->read(buffer.data() + oldSize, readChunkSize);
+    buffer.resize(oldSize + int(qMax(read, qint64(0))));
+    return read > 0;
+}
+
+/*!
+    \internal
+
+    Returns true if no more data can arrive after the buffer runs out. A
+    number that ends the input is then complete. A sequential device is
+    complete once its read channel has been closed and everything has been
+    read from it.
+*/
+bool QJsonStreamReaderPrivate::isInputComplete() const
+{
+    if (device) {
+        if (!device->atEnd())
+            return false;
+        return !device->isSequential() || readChannelFinished || !device->isReadable();
+    }
+    return inputComplete;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::raiseError(QJsonParseError::ParseError e)
+{
+    error = e;
+    text.clear();
+    return type = QJsonStreamReader::Invalid;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::needData()
+{
+    return raiseError(QJsonParseError::PrematureEndOfDocument);
+}
+
+void QJsonStreamReaderPrivate::valueDone()
+{
+    state = containers.isEmpty() ? TopLevel : SeparatorOrEnd;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::endContainer(char open)
+{
+    Q_ASSERT(!containers.isEmpty() && containers.last() == open);
+    ++pos;
+    containers.removeLast();
+    valueDone();
+    return type = (open == '[' ? QJsonStreamReader::EndArray : QJsonStreamReader::EndObject);
+}
+
+/*!
+    \internal
+
+    Decodes the string starting at the quotation mark at pos into text.
+    The whole string must be in the buffer, so the closing quotation mark
+    is located first; only then are escape sequences and UTF-8 decoded,
+    with the same rules as QJsonPrivate::Parser. A search that runs out of
+    data resumes where it stopped once more data has arrived.
+*/
+QJsonStreamReaderPrivate::Scan QJsonStreamReaderPrivate::scanString()
+{
+    const char *data = buffer.constData();
+    const char *begin = data + pos + 1;
+    const char *end = data + buffer.size();
+
+    // find the closing quotation mark, which is not preceded by an odd
+    // number of backslashes
+    const char *close = begin + stringScanned;
+    bool simple = true;
+    forever {
+        close = static_cast<const char *>(memchr(close, '"', end - close));
+        if (!close) {
+            stringScanned = int(end - begin);
+            return NeedData;
+        }
+        const char *backslash = close;
+        while (backslash > begin && backslash[-1] == '\\')
+            --backslash;
+        if (((close - backslash) & 1) == 0)
+            break;
+        ++close;
+    }
+    stringScanned = 0;
+
+    for (const char *p = begin; p < close; ++p) {
+        if (uchar(*p) >= 0x80 || *p == '\\') {
+            simple = false;
+            break;
+        }
+    }
+
+    if (simple) {
+        // reuses the previous token's storage unless the user kept a copy
+        text.resize(close - begin);
+        ushort *out = reinterpret_cast<ushort *>(text.data());
+        for (const char *p = begin; p < close; ++p)
+            *out++ = uchar(*p);
+    } else {
+        text.resize(close - begin);
+        ushort *out = reinterpret_cast<ushort *>(text.data());
+        const ushort *outStart = out;
+        const char *json = begin;
+        while (json < close) {
+            uint ch = 0;
+            if (*json == '\\') {
+                if (!QJsonPrivate::scanEscapeSequence(json, close, &ch)) {
+                    pos = json - data;
+                    error = QJsonParseError::IllegalEscapeSequence;
+                    return Failed;
+                }
+            } else if (!QJsonPrivate::scanUtf8Char(json, close, &ch)) {
+                pos = json - data;
+                error = QJsonParseError::IllegalUTF8String;
+                return Failed;
+            }
+            if (QChar::requiresSurrogates(ch)) {
+                *out++ = QChar::highSurrogate(ch);
+                *out++ = QChar::lowSurrogate(ch);
+            } else {
+                *out++ = ushort(ch);
+            }
+        }
+        text.resize(out - outStart);
+    }
+
+    pos = close + 1 - data;
+    return Done;
+}
+
+QJsonStreamReaderPrivate::Scan QJsonStreamReaderPrivate::scanLiteral(const char *literal, int length)
+{
+    if (buffer.size() - pos < length)
+        return NeedData;
+    if (memcmp(buffer.constData() + pos, literal, length) != 0) {
+        error = QJsonParseError::IllegalValue;
+        return Failed;
+    }
+    pos += length;
+    return Done;
+}
+
+QJsonStreamReaderPrivate::Scan QJsonStreamReaderPrivate::scanNumber()
+{
+    const char *data = buffer.constData();
+    const char *start = data + pos;
+    const char *end = data + buffer.size();
+    const char *json = start;
+    const bool isInt = QJsonPrivate::scanNumber(json, end);
+
+    // the number might continue in the next chunk
+    if (json == end && !isInputComplete())
+        return NeedData;
+
+    // integers of up to 15 digits convert exactly without asciiToDouble()
+    const bool negative = (*start == '-');
+    const char *digit = start + negative;
+    if (isInt && json > digit && json - digit <= 15) {
+        qint64 n = 0;
+        for ( ; digit < json; ++digit)
+            n = n * 10 + (*digit - '0');
+        number = negative ? -double(n) : double(n);
+        pos = json - data;
+        return Done;
+    }
+
+    // asciiToDouble() needs a terminating null
+    QVarLengthArray<char, 64> digits(int(json - start) + 1);
+    memcpy(digits.data(), start, json - start);
+    digits[int(json - start)] = '\0';
+
+    bool ok;
+    int processed;
+    number = asciiToDouble(digits.constData(), int(json - start), ok, processed);
+    if (!ok) {
+        error = QJsonParseError::IllegalNumber;
+        return Failed;
+    }
+    pos = json - data;
+    return Done;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readValueToken()
+{
+    Scan result;
+    const char c = buffer.at(pos);
+    switch (c) {
+    case '[':
+    case '{':
+        if (containers.size() >= nestingLimit)
+            return raiseError(QJsonParseError::DeepNesting);
+        ++pos;
+        containers.append(c);
+        state = (c == '[' ? ValueOrEndArray : NameOrEndObject);
+        return type = (c == '[' ? QJsonStreamReader::StartArray : QJsonStreamReader::StartObject);
+    case '"':
+        while ((result = scanString()) == NeedData) {
+            if (!fill())
+                return needData();
+        }
+        if (result == Failed)
+            return raiseError(error);
+        valueDone();
+        return type = QJsonStreamReader::String;
+    case 't':
+    case 'f':
+        while ((result = c == 't' ? scanLiteral("true", 4) : scanLiteral("false", 5)) == NeedData) {
+            if (!fill())
+                return needData();
+        }
+        if (result == Failed)
+            return raiseError(error);
+        boolean = (c == 't');
+        valueDone();
+        return type = QJsonStreamReader::Bool;
+    case 'n':
+        while ((result = scanLiteral("null", 4)) == NeedData) {
+            if (!fill())
+                return needData();
+        }
+        if (result == Failed)
+            return raiseError(error);
+        valueDone();
+        return type = QJsonStreamReader::Null;
+    case ',':
+        return raiseError(QJsonParseError::IllegalValue);
+    case ']':
+    case '}':
+        return raiseError(QJsonParseError::MissingObject);
+    default:
+        while ((result = scanNumber()) == NeedData) {
+            if (!fill())
+                return needData();
+        }
+        if (result == Failed)
+            return raiseError(error);
+        valueDone();
+        return type = QJsonStreamReader::Number;
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNext()
+{
+    if (type == QJsonStreamReader::Invalid && error != QJsonParseError::PrematureEndOfDocument)
+        return type;
+    error = QJsonParseError::NoError;
+    resumeType = QJsonStreamReader::NoToken;
+
+    if (!bomChecked) {
+        // eat the UTF-8 byte order mark
+        static const char bom[] = "\xef\xbb\xbf";
+        while (buffer.size() - pos < 3 && fill())
+            ;
+        const int available = qMin(buffer.size() - pos, 3);
+        if (available < 3 && !isInputComplete() && memcmp(buffer.constData() + pos, bom, available) == 0) {
+            // could still be the start of a byte order mark
+            if (available)
+                return needData();
+        } else {
+            if (available == 3 && memcmp(buffer.constData() + pos, bom, 3) == 0)
+                pos += 3;
+            bomChecked = true;
+        }
+    }
+
+    forever {
+        const char *data = buffer.constData();
+        const int size = buffer.size();
+        while (pos < size && isSpace(data[pos]))
+            ++pos;
+        if (pos == size) {
+            if (fill())
+                continue;
+            if (state == TopLevel) {
+                tokenOffset = bufferOffset + pos;
+                text.clear();
+                return type = QJsonStreamReader::EndDocument;
+            }
+            return needData();
+        }
+
+        tokenOffset = bufferOffset + pos;
+        const char c = data[pos];
+        switch (state) {
+        case ValueOrEndArray:
+            if (c == ']')
+                return endContainer('[');
+            Q_FALLTHROUGH();
+        case TopLevel:
+        case ArrayValue:
+        case MemberValue:
+            return readValueToken();
+        case NameOrEndObject:
+        case MemberName:
+            if (c == '"') {
+                Scan result;
+                while ((result = scanString()) == NeedData) {
+                    if (!fill())
+                        return needData();
+                }
+                if (result == Failed)
+                    return raiseError(error);
+                state = NameSeparator;
+                return type = QJsonStreamReader::Name;
+            }
+            if (c == '}') {
+                if (state == MemberName)
+                    return raiseError(QJsonParseError::MissingObject);
+                return endContainer('{');
+            }
+            return raiseError(QJsonParseError::UnterminatedObject);
+        case NameSeparator:
+            if (c != ':')
+                return raiseError(QJsonParseError::MissingNameSeparator);
+            ++pos;
+            state = MemberValue;
+            break;
+        case SeparatorOrEnd:
+            if (containers.last() == '[') {
+                if (c == ',') {
+                    ++pos;
+                    state = ArrayValue;
+                } else if (c == ']') {
+                    return endContainer('[');
+                } else {
+                    return raiseError(QJsonParseError::MissingValueSeparator);
+                }
+            } else {
+                if (c == ',') {
+                    ++pos;
+                    state = MemberName;
+                } else if (c == '}') {
+                    return endContainer('{');
+                } else {
+                    return raiseError(QJsonParseError::UnterminatedObject);
+                }
+            }
+            break;
+        }
+    }
+}
+
+/*!
+    \internal
+
+    Builds the value that starts at the current token; see
+    QJsonStreamReader::readValue().
+*/
+QJsonValue QJsonStreamReaderPrivate::readValue()
+{
+    if (type == QJsonStreamReader::Name)
+        readNext();
+
+    switch (type) {
+    case QJsonStreamReader::StartArray: {
+        QJsonArray array;
+        while (readNext() != QJsonStreamReader::EndArray) {
+            const QJsonValue v = readValue();
+            if (type == QJsonStreamReader::Invalid)
+                return QJsonValue(QJsonValue::Undefined);
+            array.append(v);
+        }
+        return array;
+    }
+    case QJsonStreamReader::StartObject: {
+        QJsonObject object;
+        while (readNext() == QJsonStreamReader::Name) {
+            const QString name = text;
+            const QJsonValue v = readValue();
+            if (type == QJsonStreamReader::Invalid)
+                return QJsonValue(QJsonValue::Undefined);
+            object.insert(name, v);
+        }
+        if (type != QJsonStreamReader::EndObject)
+            return QJsonValue(QJsonValue::Undefined);
+        return object;
+    }
+    default:
+        return value();
+    }
+}
+
+QJsonValue QJsonStreamReaderPrivate::value() const
+{
+    switch (type) {
+    case QJsonStreamReader::String:
+        return QJsonValue(text);
+    case QJsonStreamReader::Number:
+        return QJsonValue(number);
+    case QJsonStreamReader::Bool:
+        return QJsonValue(boolean);
+    case QJsonStreamReader::Null:
+        return QJsonValue(QJsonValue::Null);
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+/*!
+    Constructs a stream reader without input. Use setDevice() or addData()
+    to provide it.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Constructs a stream reader that reads from \a device. The device must
+    be open for reading.
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Constructs a stream reader that reads the complete JSON text in \a data.
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    Q_D(QJsonStreamReader);
+    d->buffer = data;
+    d->inputComplete = true;
+}
+
+/*!
+    Destroys the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device and resets the reader to its
+    initial state. The reader does not take ownership of the device.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    clear();
+    Q_D(QJsonStreamReader);
+    d->device = device;
+    if (device && device->isSequential()) {
+        d->readChannelConnection = QObject::connect(device, &QIODevice::readChannelFinished,
+                                                    [d]() { d->readChannelFinished = true; });
+    }
+}
+
+/*!
+    Returns the current device, or a null pointer if none is set.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->device;
+}
+
+/*!
+    Appends \a data to the input. If the reader stopped with
+    QJsonParseError::PrematureEndOfDocument or returned EndDocument, it
+    continues with the new data on the next call to readNext().
+
+    It is an error to call this function while a device is set.
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    Q_D(QJsonStreamReader);
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    d->discardConsumed();
+    d->buffer += data;
+    d->inputComplete = false;
+}
+
+/*!
+    Tells the reader that no more data will be added with addData(). A
+    number at the end of the input is then complete instead of causing
+    QJsonParseError::PrematureEndOfDocument.
+
+    \sa addData()
+*/
+void QJsonStreamReader::endData()
+{
+    Q_D(QJsonStreamReader);
+    if (d->device) {
+        qWarning("QJsonStreamReader: endData() with device()");
+        return;
+    }
+    d->inputComplete = true;
+}
+
+/*!
+    Removes any device() or data from the reader and resets its internal
+    state to the initial state.
+
+    \sa addData()
+*/
+void QJsonStreamReader::clear()
+{
+    d_ptr.reset(new QJsonStreamReaderPrivate);
+}
+
+/*!
+    Returns \c true if the reader has read until the end of its input, or
+    if an error() has occurred and reading has been aborted. Otherwise it
+    returns \c false.
+
+    If more data arrives after atEnd() returned true because of
+    QJsonParseError::PrematureEndOfDocument or EndDocument, reading can
+    continue with readNext().
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == EndDocument || d->type == Invalid;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    Once an error() other than QJsonParseError::PrematureEndOfDocument has
+    been reported, reading cannot continue and readNext() keeps returning
+    Invalid.
+
+    \sa tokenType()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    Q_D(QJsonStreamReader);
+    return d->readNext();
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa readNext()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type;
+}
+
+/*!
+    Returns the number of arrays and objects that enclose the current
+    position. It is 0 between top-level values, 1 after the StartArray or
+    StartObject of a top-level value, and 0 again after its EndArray or
+    EndObject.
+*/
+int QJsonStreamReader::depth() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->containers.size();
+}
+
+/*!
+    Returns the position of the current token in the input, in bytes.
+    If an error has occurred, this is where the token that failed starts.
+*/
+qint64 QJsonStreamReader::offset() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->tokenOffset;
+}
+
+/*!
+    Returns the member name if the current token is a Name, or the string
+    if it is a String. Otherwise returns an empty string.
+*/
+QString QJsonStreamReader::text() const
+{
+    Q_D(const QJsonStreamReader);
+    if (d->type == Name || d->type == String)
+        return d->text;
+    return QString();
+}
+
+/*!
+    Returns the number if the current token is a Number, and 0 otherwise.
+*/
+double QJsonStreamReader::toDouble() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Number ? d->number : 0;
+}
+
+/*!
+    Returns the value if the current token is a Bool, and \c false
+    otherwise.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Bool && d->boolean;
+}
+
+/*!
+    Returns the current token as a QJsonValue if it is a String, Number,
+    Bool or Null. Otherwise returns QJsonValue::Undefined.
+
+    \sa readValue()
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->value();
+}
+
+/*!
+    Reads the value that starts at the current token and returns it. If
+    the current token is a Name, the member's value is read. For a
+    StartArray or StartObject token, the whole array or object is read and
+    the current token afterwards is the matching EndArray or EndObject.
+
+    Returns QJsonValue::Undefined if the current token does not start a
+    value or if an error occurs while reading it.
+
+    If the input ends in the middle of the value, the error is
+    QJsonParseError::PrematureEndOfDocument and the reader goes back to the
+    start of the value, whose input it keeps in memory. Once more data has
+    arrived, calling readValue() again reads the whole value.
+
+    \sa value(), skipCurrentValue()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    Q_D(QJsonStreamReader);
+    if (d->type == Invalid && d->error == QJsonParseError::PrematureEndOfDocument
+            && d->resumeType != NoToken) {
+        d->type = d->resumeType;
+        d->error = QJsonParseError::NoError;
+        d->resumeType = NoToken;
+    }
+    if (d->type != Name && d->type != StartArray && d->type != StartObject)
+        return d->value();
+
+    // remember where the value starts, to read it again from there if the
+    // input ends in the middle of it
+    const TokenType startType = d->type;
+    const QString startText = d->text;
+    const qint64 startOffset = d->tokenOffset;
+    const QJsonStreamReaderPrivate::State startState = d->state;
+    const int startDepth = d->containers.size();
+    d->valueStart = d->bufferOffset + d->pos;
+
+    const QJsonValue v = d->readValue();
+    if (d->type == Invalid && d->error == QJsonParseError::PrematureEndOfDocument) {
+        d->pos = int(d->valueStart - d->bufferOffset);
+        d->stringScanned = 0;
+        d->state = startState;
+        d->containers.resize(startDepth);
+        d->text = startText;
+        d->tokenOffset = startOffset;
+        d->resumeType = startType;
+    }
+    d->valueStart = -1;
+    return v;
+}
+
+/*!
+    Skips the value that starts at the current token. If the current token
+    is a Name, the member's value is skipped. For a StartArray or
+    StartObject token, the reader is moved to the matching EndArray or
+    EndObject.
+*/
+void QJsonStreamReader::skipCurrentValue()
+{
+    Q_D(QJsonStreamReader);
+    if (d->type == Name)
+        d->readNext();
+    if (d->type != StartArray && d->type != StartObject)
+        return;
+
+    const int target = d->containers.size() - 1;
+    while (d->readNext() != Invalid) {
+        if ((d->type == EndArray || d->type == EndObject) && d->containers.size() == target)
+            return;
+    }
+}
+
+/*!
+    Returns the type of the current error, or QJsonParseError::NoError if
+    no error occurred.
+
+    \sa errorString(), hasError()
+*/
+QJsonParseError::ParseError QJsonStreamReader::error() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Invalid ? d->error : QJsonParseError::NoError;
+}
+
+/*!
+    Returns the human-readable message for the current error.
+
+    \sa error()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    QJsonParseError e;
+    e.offset = int(offset());
+    e.error = error();
+    return e.errorString();
+}
+
+/*!
+    \fn bool QJsonStreamReader::hasError() const
+
+    Returns \c true if an error has occurred, otherwise \c false.
+
+    \sa error()
+*/
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.8
+
+    \brief The QJsonStreamWriter class writes JSON text incrementally.
+
+    QJsonDocument::toJson() produces the whole document as a single
+    QByteArray. QJsonStreamWriter writes to a QIODevice, or appends to a
+    QByteArray, as the structure is described to it, passing the output to
+    the device in chunks. Its memory use does not depend on the size of
+    the output.
+
+    Arrays and objects are opened with writeStartArray() and
+    writeStartObject() and closed with writeEndArray() and
+    writeEndObject(). Members of objects are written with writeName()
+    followed by a value, or with writeMember(). writeValue() writes any
+    QJsonValue, including complete arrays and objects:
+
+    \code
+    QJsonStreamWriter writer(&file);
+    writer.writeStartArray();
+    for (const Record &r : records) {
+        writer.writeStartObject();
+        writer.writeMember(QStringLiteral("id"), r.id);
+        writer.writeMember(QStringLiteral("name"), r.name);
+        writer.writeEndObject();
+    }
+    writer.writeEndArray();
+    \endcode
+
+    Each complete top-level value is followed by a newline, so that writing
+    several documents in the QJsonDocument::Compact format produces
+    newline-delimited JSON. In the QJsonDocument::Indented format, the
+    output for a single document is identical to what
+    QJsonDocument::toJson() produces.
+
+    \sa QJsonStreamReader, QJsonDocument, {JSON Support in Qt}
+*/
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Container {
+        bool isObject;
+        bool isEmpty;
+    };
+
+    QJsonStreamWriterPrivate()
+        : device(Q_NULLPTR), out(&buffer), compact(true), hasName(false), hasError(false)
+    {}
+
+    void startValue();
+    void endValue();
+    void indent(int level);
+    void writeString(const QString &s);
+    void writeScalar(const QJsonValue &value);
+    void writeStart(bool object);
+    void writeEnd(bool object);
+    void flushIfNeeded();
+    bool flush();
+
+    QIODevice *device;
+    QByteArray *out;
+    QByteArray buffer;
+    QVarLengthArray<Container, 64> containers;
+    bool compact;
+    bool hasName;
+    bool hasError;
+};
+
+void QJsonStreamWriterPrivate::indent(int level)
+{
+    if (!compact)
+        out->append(QByteArray(4 * level, ' '));
+}
+
+void QJsonStreamWriterPrivate::writeString(const QString &s)
+{
+    // most strings need no escaping and can be copied directly
+    const ushort *src = reinterpret_cast<const ushort *>(s.constData());
+    const int size = s.size();
+    int i = 0;
+    while (i < size && src[i] < 0x80 && src[i] >= 0x20 && src[i] != '"' && src[i] != '\\')
+        ++i;
+
+    if (i < size) {
+        out->append('"');
+        out->append(QJsonPrivate::Writer::escapedString(s));
+        out->append('"');
+        return;
+    }
+
+    const int oldSize = out->size();
+    out->resize(oldSize + size + 2);
+    char *dst = out->data() + oldSize;
+    *dst++ = '"';
+    for (i = 0; i < size; ++i)
+        *dst++ = char(src[i]);
+    *dst = '"';
+}
+
+/*!
+    \internal
+
+    Writes the separator and indentation that precede a value.
+*/
+void QJsonStreamWriterPrivate::startValue()
+{
+    if (containers.isEmpty())
+        return;
+
+    Container &c = containers.last();
+    if (c.isObject) {
+        if (!hasName)
+            qWarning("QJsonStreamWriter: writing an object member without a name");
+        hasName = false;
+        return;
+    }
+    if (!c.isEmpty)
+        out->append(compact ? "," : ",\n");
+    c.isEmpty = false;
+    indent(containers.size());
+}
+
+void QJsonStreamWriterPrivate::endValue()
+{
+    if (containers.isEmpty())
+        out->append('\n');
+    flushIfNeeded();
+}
+
+void QJsonStreamWriterPrivate::writeScalar(const QJsonValue &value)
+{
+    startValue();
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        out->append(value.toBool() ? "true" : "false");
+        break;
+    case QJsonValue::Double: {
+        const double d = value.toDouble();
+        if (qIsFinite(d))
+            out->append(QByteArray::number(d, 'g', QLocale::FloatingPointShortest));
+        else
+            out->append("null"); // +INF || -INF || NaN (see RFC4627#section2.4)
+        break;
+    }
+    case QJsonValue::String:
+        writeString(value.toString());
+        break;
+    default:
+        out->append("null");
+        break;
+    }
+    endValue();
+}
+
+void QJsonStreamWriterPrivate::writeStart(bool object)
+{
+    startValue();
+    out->append(object ? '{' : '[');
+    if (!compact)
+        out->append('\n');
+    const Container c = { object, true };
+    containers.append(c);
+}
+
+void QJsonStreamWriterPrivate::writeEnd(bool object)
+{
+    if (containers.isEmpty() || containers.last().isObject != object) {
+        qWarning(object ? "QJsonStreamWriter: writeEndObject() without matching writeStartObject()"
+                        : "QJsonStreamWriter: writeEndArray() without matching writeStartArray()");
+        return;
+    }
+    if (hasName) {
+        qWarning("QJsonStreamWriter: object member without a value");
+        hasName = false;
+    }
+    if (!compact && !containers.last().isEmpty)
+        out->append('\n');
+    containers.removeLast();
+    indent(containers.size());
+    out->append(object ? '}' : ']');
+    endValue();
+}
+
+void QJsonStreamWriterPrivate::flushIfNeeded()
+{
+    if (device && out->size() >= writeChunkSize)
+        flush();
+}
+
+bool QJsonStreamWriterPrivate::flush()
+{
+    if (!device || buffer.isEmpty())
+        return !hasError;
+    if (device->write(buffer) != buffer.size())
+        hasError = true;
+    buffer.resize(0);
+    return !hasError;
+}
+
+/*!
+    Constructs a stream writer without a device. Use setDevice() to set one.
+*/
+QJsonStreamWriter::QJsonStreamWriter()
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+}
+
+/*!
+    Constructs a stream writer that writes to \a device. The device must
+    be open for writing.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Constructs a stream writer that appends to \a array.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *array)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    Q_D(QJsonStreamWriter);
+    d->out = array;
+}
+
+/*!
+    Destroys the writer, writing any pending output to the device.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    Q_D(QJsonStreamWriter);
+    d->flush();
+}
+
+/*!
+    Sets the current device to \a device, after writing any pending output
+    to the previous one. The writer does not take ownership of the device.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamWriter);
+    if (d->out == &d->buffer)
+        d->flush();
+    d->device = device;
+    d->out = &d->buffer;
+    d->buffer.reserve(writeChunkSize + writeChunkSize / 4);
+}
+
+/*!
+    Returns the current device, or a null pointer if none is set.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->device;
+}
+
+/*!
+    Sets the output format to \a format. The default is
+    QJsonDocument::Compact.
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    Q_D(QJsonStreamWriter);
+    d->compact = (format == QJsonDocument::Compact);
+}
+
+/*!
+    Returns the output format.
+
+    \sa setFormat()
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+}
+
+/*!
+    Opens an array. Subsequent values are its elements until
+    writeEndArray() is called.
+*/
+void QJsonStreamWriter::writeStartArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeStart(false);
+}
+
+/*!
+    Closes the array opened by the matching writeStartArray().
+*/
+void QJsonStreamWriter::writeEndArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeEnd(false);
+}
+
+/*!
+    Opens an object. Subsequent calls to writeName() and writeValue(), or
+    to writeMember(), add its members until writeEndObject() is called.
+*/
+void QJsonStreamWriter::writeStartObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeStart(true);
+}
+
+/*!
+    Closes the object opened by the matching writeStartObject().
+*/
+void QJsonStreamWriter::writeEndObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeEnd(true);
+}
+
+/*!
+    Writes \a name as the name of the next member of the current object.
+    It must be followed by a value.
+
+    \sa writeMember()
+*/
+void QJsonStreamWriter::writeName(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    if (d->containers.isEmpty() || !d->containers.last().isObject) {
+        qWarning("QJsonStreamWriter: writeName() outside of an object");
+        return;
+    }
+    if (d->hasName) {
+        qWarning("QJsonStreamWriter: writeName() without a value for the previous name");
+        return;
+    }
+    QJsonStreamWriterPrivate::Container &c = d->containers.last();
+    if (!c.isEmpty)
+        d->out->append(d->compact ? "," : ",\n");
+    c.isEmpty = false;
+    d->indent(d->containers.size());
+    d->writeString(name);
+    d->out->append(d->compact ? ":" : ": ");
+    d->hasName = true;
+}
+
+/*!
+    Writes \a value. Arrays and objects are written completely, in the
+    same order as QJsonDocument::toJson() writes them.
+    QJsonValue::Undefined is written as \c null.
+*/
+void QJsonStreamWriter::writeValue(const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    switch (value.type()) {
+    case QJsonValue::Array: {
+        const QJsonArray array = value.toArray();
+        d->writeStart(false);
+        for (QJsonArray::const_iterator it = array.constBegin(), end = array.constEnd(); it != end; ++it)
+            writeValue(*it);
+        d->writeEnd(false);
+        break;
+    }
+    case QJsonValue::Object: {
+        const QJsonObject object = value.toObject();
+        d->writeStart(true);
+        for (QJsonObject::const_iterator it = object.constBegin(), end = object.constEnd(); it != end; ++it) {
+            writeName(it.key());
+            writeValue(it.value());
+        }
+        d->writeEnd(true);
+        break;
+    }
+    default:
+        d->writeScalar(value);
+        break;
+    }
+}
+
+/*!
+    Writes a member of the current object with the name \a name and the
+    value \a value. This is the same as calling writeName() followed by
+    writeValue().
+*/
+void QJsonStreamWriter::writeMember(const QString &name, const QJsonValue &value)
+{
+    writeName(name);
+    writeValue(value);
+}
+
+/*!
+    Writes the array or object contained in \a document. Nothing is written
+    for a null document.
+*/
+void QJsonStreamWriter::writeDocument(const QJsonDocument &document)
+{
+    if (document.isArray())
+        writeValue(document.array());
+    else if (document.isObject())
+        writeValue(document.object());
+}
+
+/*!
+    Returns the number of arrays and objects that are currently open.
+*/
+int QJsonStreamWriter::depth() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->containers.size();
+}
+
+/*!
+    Writes any pending output to the device. The writer does this by itself
+    whenever enough output has accumulated and when it is destroyed.
+    Returns \c false if writing to the device failed.
+
+    \sa hasError()
+*/
+bool QJsonStreamWriter::flush()
+{
+    Q_D(QJsonStreamWriter);
+    return d->flush();
+}
+
+/*!
+    Returns \c true if writing to the device failed, otherwise \c false.
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->hasError;
+}
+
+QT_END_NAMESPACE
@@ -41,6 +41,7 @@
 #include <qlocale.h>
 #include "qjsonwriter_p.h"
 #include "qjson_p.h"
+#include "private/qlocale_p.h"
 #include "private/qutfcodec_p.h"
 
 QT_BEGIN_NAMESPACE
@@ -55,7 +56,7 @@ static inline uchar hexdig(uint u)
     return (u < 0xa ? '0' + u : 'a' + u - 0xa);
 }
 
-static QByteArray escapedString(const QString &s)
+QByteArray Writer::escapedString(const QString &s)
 {
     const uchar replacement = '?';
     QByteArray ba(s.length(), Qt::Uninitialized);
@@ -129,15 +130,22 @@ static void valueToJson(const QJsonPrivate::Base *b, const QJsonPrivate::Value &
         break;
     case QJsonValue::Double: {
         const double d = v.toDouble(b);
-        if (qIsFinite(d)) // +2 to format to ensure the expected precision
-            json += QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
-        else
+        if (qIsFinite(d)) { // +2 to format to ensure the expected precision
+            char buf[64];
+            const int length = QLocaleData::doubleToCLocaleChars(d, QLocale::FloatingPointShortest,
+                                                                 QLocaleData::DFSignificantDigits,
+                                                                 QLocaleData::ZeroPadExponent,
+                                                                 buf, int(sizeof buf));
+            Q_ASSERT(length <= int(sizeof buf));
+            json.append(buf, length);
+        } else {
             json += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+        }
         break;
     }
     case QJsonValue::String:
         json += '"';
-        json += escapedString(v.toString(b));
+        json += Writer::escapedString(v.toString(b));
         json += '"';
         break;
     case QJsonValue::Array:
@@ -193,7 +201,7 @@ static void objectContentToJson(const QJsonPrivate::Object *o, QByteArray &json,
         QJsonPrivate::Entry *e = o->entryAt(i);
         json += indentString;
         json += '"';
-        json += escapedString(e->key());
+        json += Writer::escapedString(e->key());
         json += compact ? "\":" : "\": ";
         valueToJson(o, e->value, json, indent, compact);
 
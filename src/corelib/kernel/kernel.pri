@@ -156,6 +156,13 @@ unix|integrity {
     qtConfig(poll_ppoll): DEFINES += QT_HAVE_POLL QT_HAVE_PPOLL
     qtConfig(poll_pollts): DEFINES += QT_HAVE_POLL QT_HAVE_POLLTS
 
+    qtConfig(epoll) {
+        SOURCES += \
+            kernel/qeventdispatcher_epoll.cpp
+        HEADERS += \
+            kernel/qeventdispatcher_epoll_p.h
+    }
+
     qtConfig(glib) {
         SOURCES += \
             kernel/qeventdispatcher_glib.cpp
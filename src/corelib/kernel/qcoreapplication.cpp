@@ -69,12 +69,16 @@
 #include <private/qfunctions_p.h>
 #include <private/qlocale_p.h>
 #include <private/qhooks_p.h>
+#include <private/qtrace_p.h>
 
 #ifndef QT_NO_QOBJECT
 #if defined(Q_OS_UNIX)
 # if defined(Q_OS_DARWIN)
 #  include "qeventdispatcher_cf_p.h"
 # else
+#  if QT_CONFIG(epoll)
+#   include "qeventdispatcher_epoll_p.h"
+#  endif
 #  if !defined(QT_NO_GLIB)
 #   include "qeventdispatcher_glib_p.h"
 #  endif
@@ -313,7 +317,8 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
-    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
+    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset
+            + (currentThreadData->postEventList.incoming.loadAcquire() ? 1 : 0);
 }
 
 QAbstractEventDispatcher *QCoreApplicationPrivate::eventDispatcher = 0;
@@ -466,6 +471,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
         QVector<QPostEvent> list;
         {
             QMutexLocker locker(&threadData->postEventList.mutex);
+            threadData->flushIncomingEvents();
 
             // part 1: clean up with the post event mutex locked
             for (int i = 0; i < threadData->postEventList.size(); ++i) {
@@ -503,12 +509,18 @@ void QCoreApplicationPrivate::createEventDispatcher()
         eventDispatcher = new QEventDispatcherCoreFoundation(q);
     else
         eventDispatcher = new QEventDispatcherUNIX(q);
-#  elif !defined(QT_NO_GLIB)
+#  else
+#    if QT_CONFIG(epoll)
+    QEventDispatcherEpoll::TriggerMode mode;
+    if (QEventDispatcherEpoll::isRequested(&mode))
+        eventDispatcher = new QEventDispatcherEpoll(mode, q);
+    else
+#    endif
+#    if !defined(QT_NO_GLIB)
     if (qEnvironmentVariableIsEmpty("QT_NO_GLIB") && QEventDispatcherGlib::versionSupported())
         eventDispatcher = new QEventDispatcherGlib(q);
     else
-        eventDispatcher = new QEventDispatcherUNIX(q);
-#  else
+#    endif
         eventDispatcher = new QEventDispatcherUNIX(q);
 #  endif
 #elif defined(Q_OS_WINRT)
@@ -989,6 +1001,8 @@ bool QCoreApplication::notifyInternal2(QObject *receiver, QEvent *event)
         return result;
     }
 
+    Q_TRACE_SCOPE(lcTraceCoreEvents, "QCoreApplication::notify", event->type());
+
     // Qt enforces the rule that events can only be sent to objects in
     // the current thread, so receiver->d_func()->threadData is
     // equivalent to QThreadData::current(), just without the function
@@ -1386,6 +1400,28 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    if (event->type() == QEvent::MetaCall) {
+        // Queued slot invocations are never compressed, so they bypass the
+        // mutex. Only the post that finds the queue empty wakes the
+        // receiving thread up: a burst of posts costs a single wakeup.
+        // The receiver's postedEvents count is updated when the queue is
+        // flushed, with the mutex locked; if the receiver has moved to
+        // another thread by then, the event is passed on to that thread.
+        // Once the event is published the receiver may already have been
+        // deleted, so only the thread data, kept alive here, is used.
+        QPostEventList::IncomingEvent *ev = new QPostEventList::IncomingEvent;
+        ev->postEvent = QPostEvent(receiver, event, priority);
+        event->posted = true;
+        data->ref();
+        if (data->postEventList.pushIncomingEvent(ev)) {
+            QAbstractEventDispatcher* dispatcher = data->eventDispatcher.loadAcquire();
+            if (dispatcher)
+                dispatcher->wakeUp();
+        }
+        data->deref();
+        return;
+    }
+
     // lock the post event mutex
     data->postEventList.mutex.lock();
 
@@ -1405,6 +1441,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QMutexUnlocker locker(&data->postEventList.mutex);
 
+    // keep the order with the events posted without the mutex
+    data->flushIncomingEvents();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1532,6 +1571,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->flushIncomingEvents();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1692,6 +1732,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     QThreadData *data = receiver ? receiver->d_func()->threadData : QThreadData::current();
     QMutexLocker locker(&data->postEventList.mutex);
+    data->flushIncomingEvents();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1757,6 +1798,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->flushIncomingEvents();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
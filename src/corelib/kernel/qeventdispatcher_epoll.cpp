@@ -0,0 +1,553 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qplatformdefs.h"
+
+#include "qcoreapplication.h"
+#include "qsocketnotifier.h"
+#include "qthread.h"
+
+#include "qeventdispatcher_epoll_p.h"
+#include <private/qthread_p.h>
+#include <private/qcoreapplication_p.h>
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+QT_BEGIN_NAMESPACE
+
+// maximum number of events harvested per epoll_wait() call; anything
+// beyond that stays in the kernel's ready list for the next iteration
+enum { MaxEpollEvents = 256 };
+
+static const char *socketType(QSocketNotifier::Type type)
+{
+    switch (type) {
+    case QSocketNotifier::Read:
+        return "Read";
+    case QSocketNotifier::Write:
+        return "Write";
+    case QSocketNotifier::Exception:
+        return "Exception";
+    }
+
+    Q_UNREACHABLE();
+}
+
+static uint32_t epollEventsFromPollEvents(short events)
+{
+    uint32_t result = 0;
+    if (events & POLLIN)
+        result |= EPOLLIN;
+    if (events & POLLOUT)
+        result |= EPOLLOUT;
+    if (events & POLLPRI)
+        result |= EPOLLPRI;
+    return result;
+}
+
+static bool addToEpoll(int epfd, int fd)
+{
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+QEventDispatcherEpollPrivate::QEventDispatcherEpollPrivate(QEventDispatcherEpoll::TriggerMode mode)
+    : triggerMode(mode),
+      epollFd(-1),
+      controlEpollFd(-1),
+      timerFd(-1),
+      armedDeadline(QDeadlineTimer::Forever)
+{
+    if (Q_UNLIKELY(threadPipe.init() == false))
+        qFatal("QEventDispatcherEpollPrivate(): Can not continue without a thread pipe");
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    controlEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (Q_UNLIKELY(epollFd == -1 || controlEpollFd == -1 || timerFd == -1))
+        qFatal("QEventDispatcherEpollPrivate(): Can not create the epoll or timer descriptors: %s",
+               qPrintable(qt_error_string(errno)));
+
+    // the thread pipe and the timer are always level-triggered
+    const int pipeFd = threadPipe.fds[0];
+    if (Q_UNLIKELY(!addToEpoll(epollFd, pipeFd) || !addToEpoll(controlEpollFd, pipeFd)
+                   || !addToEpoll(epollFd, timerFd) || !addToEpoll(controlEpollFd, timerFd)))
+        qFatal("QEventDispatcherEpollPrivate(): Can not watch the thread pipe: %s",
+               qPrintable(qt_error_string(errno)));
+}
+
+QEventDispatcherEpollPrivate::~QEventDispatcherEpollPrivate()
+{
+    qt_safe_close(timerFd);
+    qt_safe_close(controlEpollFd);
+    qt_safe_close(epollFd);
+
+    // cleanup timers
+    qDeleteAll(timerList);
+}
+
+/*
+    Brings the kernel's interest set for \a fd in line with the notifiers
+    registered for it. This is O(1): at most two epoll_ctl() calls.
+*/
+void QEventDispatcherEpollPrivate::updateSocketNotifierSet(int fd, short oldEvents, short newEvents)
+{
+    if (oldEvents == newEvents)
+        return;
+
+    epoll_event ev;
+    ev.events = epollEventsFromPollEvents(newEvents);
+    if (triggerMode == QEventDispatcherEpoll::EdgeTriggered)
+        ev.events |= EPOLLET;
+    ev.data.fd = fd;
+
+    if (!newEvents) {
+        // the descriptor may have been closed already, in which case the
+        // kernel has dropped it from the set on its own
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, &ev);
+        return;
+    }
+
+    int ret;
+    if (!oldEvents) {
+        ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        // a closed descriptor whose number got reused before we noticed
+        if (ret == -1 && errno == EEXIST)
+            ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+    } else {
+        ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+        if (ret == -1 && errno == ENOENT)
+            ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    if (ret == -1)
+        qErrnoWarning("QEventDispatcherEpoll: Unable to watch socket %d", fd);
+}
+
+void QEventDispatcherEpollPrivate::armTimerFd(QDeadlineTimer deadline)
+{
+    if (deadline == armedDeadline)
+        return;
+
+    itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (!deadline.isForever()) {
+        // a zero it_value would disarm the timer, so fire overdue timers "now"
+        const qint64 nsecs = qMax(deadline.remainingTimeNSecs(), Q_INT64_C(1));
+        spec.it_value.tv_sec = nsecs / (1000 * 1000 * 1000);
+        spec.it_value.tv_nsec = nsecs % (1000 * 1000 * 1000);
+    }
+
+    if (timerfd_settime(timerFd, 0, &spec, 0) == -1) {
+        qErrnoWarning("QEventDispatcherEpoll: Unable to arm the timer descriptor");
+        return;
+    }
+    armedDeadline = deadline;
+}
+
+void QEventDispatcherEpollPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+
+    if (pendingNotifiers.contains(notifier))
+        return;
+
+    pendingNotifiers << notifier;
+}
+
+/*
+    Waits on \a fd (either the full set or the control set) and dispatches
+    the ready descriptors. The cost is proportional to the number of ready
+    descriptors, not to the number of registered notifiers.
+*/
+int QEventDispatcherEpollPrivate::processEpollEvents(int fd, bool wait, bool includeNotifiers)
+{
+    epoll_event events[MaxEpollEvents];
+    int count;
+    EINTR_LOOP(count, epoll_wait(fd, events, MaxEpollEvents, wait ? -1 : 0));
+    if (count == -1) {
+        perror("epoll_wait");
+        return 0;
+    }
+
+    static const struct {
+        QSocketNotifier::Type type;
+        uint32_t flags;
+    } notifierTypes[] = {
+        { QSocketNotifier::Read,      EPOLLIN  | EPOLLHUP | EPOLLERR },
+        { QSocketNotifier::Write,     EPOLLOUT | EPOLLHUP | EPOLLERR },
+        { QSocketNotifier::Exception, EPOLLPRI | EPOLLHUP | EPOLLERR }
+    };
+
+    int nevents = 0;
+    for (int i = 0; i < count; ++i) {
+        const epoll_event &ev = events[i];
+
+        if (ev.data.fd == threadPipe.fds[0]) {
+            pollfd pfd = qt_make_pollfd(ev.data.fd, POLLIN);
+            pfd.revents = POLLIN;
+            nevents += threadPipe.check(pfd);
+            continue;
+        }
+
+        if (ev.data.fd == timerFd) {
+            quint64 expirations;
+            while (::read(timerFd, &expirations, sizeof(expirations)) > 0) {}
+            // a relative timerfd disarms itself after expiring
+            armedDeadline = QDeadlineTimer(QDeadlineTimer::Forever);
+            continue;
+        }
+
+        if (!includeNotifiers)
+            continue;
+
+        auto it = socketNotifiers.constFind(ev.data.fd);
+        if (it == socketNotifiers.constEnd())
+            continue;
+
+        const QSocketNotifierSetUNIX &sn_set = it.value();
+        for (const auto &n : notifierTypes) {
+            QSocketNotifier *notifier = sn_set.notifiers[n.type];
+            if (notifier && (ev.events & n.flags))
+                setSocketNotifierPending(notifier);
+        }
+    }
+
+    return nevents;
+}
+
+int QEventDispatcherEpollPrivate::activateSocketNotifiers()
+{
+    if (pendingNotifiers.isEmpty())
+        return 0;
+
+    int n_activated = 0;
+    QEvent event(QEvent::SockAct);
+
+    while (!pendingNotifiers.isEmpty()) {
+        QSocketNotifier *notifier = pendingNotifiers.takeFirst();
+        QCoreApplication::sendEvent(notifier, &event);
+        ++n_activated;
+    }
+
+    return n_activated;
+}
+
+/*!
+    \internal
+    \class QEventDispatcherEpoll
+
+    An event dispatcher for Linux built on epoll(7) and timerfd(2). Unlike
+    QEventDispatcherUNIX, which rebuilds and scans a pollfd array on every
+    iteration, it keeps the interest set in the kernel: registering or
+    unregistering a socket notifier is O(1) and a wakeup costs O(ready
+    descriptors).
+
+    It is selected by setting the environment variable QT_EVENT_DISPATCHER
+    to \c epoll (level-triggered) or \c epoll-et (edge-triggered). In
+    edge-triggered mode a socket notifier is activated only when the
+    descriptor becomes ready again, so its owner must drain the socket
+    before returning to the event loop.
+*/
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate(LevelTriggered), parent)
+{ }
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(TriggerMode mode, QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate(mode), parent)
+{ }
+
+QEventDispatcherEpoll::~QEventDispatcherEpoll()
+{ }
+
+QEventDispatcherEpoll::TriggerMode QEventDispatcherEpoll::triggerMode() const
+{
+    Q_D(const QEventDispatcherEpoll);
+    return d->triggerMode;
+}
+
+/*!
+    \internal
+    Returns \c true if QT_EVENT_DISPATCHER requests the epoll dispatcher,
+    storing the requested trigger mode in \a mode if it is not null.
+*/
+bool QEventDispatcherEpoll::isRequested(TriggerMode *mode)
+{
+    const QByteArray name = qgetenv("QT_EVENT_DISPATCHER");
+    TriggerMode requested;
+    if (name == "epoll")
+        requested = LevelTriggered;
+    else if (name == "epoll-et")
+        requested = EdgeTriggered;
+    else
+        return false;
+
+    if (mode)
+        *mode = requested;
+    return true;
+}
+
+/*!
+    \internal
+*/
+void QEventDispatcherEpoll::registerTimer(int timerId, int interval, Qt::TimerType timerType, QObject *obj)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1 || interval < 0 || !obj) {
+        qWarning("QEventDispatcherEpoll::registerTimer: invalid arguments");
+        return;
+    } else if (obj->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::registerTimer: timers cannot be started from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    d->timerList.registerTimer(timerId, interval, timerType, obj);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimer(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: invalid argument");
+        return false;
+    } else if (thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimer(timerId);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimers(QObject *object)
+{
+#ifndef QT_NO_DEBUG
+    if (!object) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: invalid argument");
+        return false;
+    } else if (object->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimers(object);
+}
+
+QList<QEventDispatcherEpoll::TimerInfo>
+QEventDispatcherEpoll::registeredTimers(QObject *object) const
+{
+    if (!object) {
+        qWarning("QEventDispatcherEpoll:registeredTimers: invalid argument");
+        return QList<TimerInfo>();
+    }
+
+    Q_D(const QEventDispatcherEpoll);
+    return d->timerList.registeredTimers(object);
+}
+
+void QEventDispatcherEpoll::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be enabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    QSocketNotifierSetUNIX &sn_set = d->socketNotifiers[sockfd];
+    const short oldEvents = sn_set.events();
+
+    if (sn_set.notifiers[type] && sn_set.notifiers[type] != notifier)
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+
+    sn_set.notifiers[type] = notifier;
+    d->updateSocketNotifierSet(sockfd, oldEvents, sn_set.events());
+}
+
+void QEventDispatcherEpoll::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifier (fd %d) cannot be disabled from another thread.\n"
+                "(Notifier's thread is %s(%p), event dispatcher's thread is %s(%p), current thread is %s(%p))",
+                sockfd,
+                notifier->thread() ? notifier->thread()->metaObject()->className() : "QThread", notifier->thread(),
+                thread() ? thread()->metaObject()->className() : "QThread", thread(),
+                QThread::currentThread() ? QThread::currentThread()->metaObject()->className() : "QThread", QThread::currentThread());
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+
+    d->pendingNotifiers.removeOne(notifier);
+
+    auto i = d->socketNotifiers.find(sockfd);
+    if (i == d->socketNotifiers.end())
+        return;
+
+    QSocketNotifierSetUNIX &sn_set = i.value();
+
+    if (sn_set.notifiers[type] == nullptr)
+        return;
+
+    if (sn_set.notifiers[type] != notifier) {
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+        return;
+    }
+
+    const short oldEvents = sn_set.events();
+    sn_set.notifiers[type] = nullptr;
+    d->updateSocketNotifierSet(sockfd, oldEvents, sn_set.events());
+
+    if (sn_set.isEmpty())
+        d->socketNotifiers.erase(i);
+}
+
+bool QEventDispatcherEpoll::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.store(0);
+
+    // we are awake, broadcast it
+    emit awake();
+    QCoreApplicationPrivate::sendPostedEvents(0, 0, d->threadData);
+
+    const bool include_timers = (flags & QEventLoop::X11ExcludeTimers) == 0;
+    const bool include_notifiers = (flags & QEventLoop::ExcludeSocketNotifiers) == 0;
+    const bool wait_for_events = flags & QEventLoop::WaitForMoreEvents;
+
+    const bool canWait = (d->threadData->canWaitLocked()
+                          && !d->interrupt.load()
+                          && wait_for_events);
+
+    if (canWait)
+        emit aboutToBlock();
+
+    if (d->interrupt.load())
+        return false;
+
+    bool wait = canWait;
+    if (canWait) {
+        // the timer descriptor wakes us up for the next timer, so we can
+        // block in epoll_wait() without computing a timeout
+        QDeadlineTimer deadline = include_timers ? d->timerList.nextDeadline()
+                                                 : QDeadlineTimer(QDeadlineTimer::Forever);
+        if (!deadline.isForever() && deadline.hasExpired())
+            wait = false;
+        else
+            d->armTimerFd(deadline);
+    }
+
+    int nevents = d->processEpollEvents(include_notifiers ? d->epollFd : d->controlEpollFd,
+                                        wait, include_notifiers);
+
+    if (include_notifiers)
+        nevents += d->activateSocketNotifiers();
+
+    if (include_timers)
+        nevents += d->timerList.activateTimers();
+
+    // return true if we handled events, false otherwise
+    return (nevents > 0);
+}
+
+bool QEventDispatcherEpoll::hasPendingEvents()
+{
+    extern uint qGlobalPostedEventsCount(); // from qapplication.cpp
+    return qGlobalPostedEventsCount();
+}
+
+int QEventDispatcherEpoll::remainingTime(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::remainingTime: invalid argument");
+        return -1;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.timerRemainingTime(timerId);
+}
+
+void QEventDispatcherEpoll::wakeUp()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->threadPipe.wakeUp();
+}
+
+void QEventDispatcherEpoll::interrupt()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.store(1);
+    wakeUp();
+}
+
+void QEventDispatcherEpoll::flush()
+{ }
+
+QT_END_NAMESPACE
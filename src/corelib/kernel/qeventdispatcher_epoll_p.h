@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QEVENTDISPATCHER_EPOLL_P_H
+#define QEVENTDISPATCHER_EPOLL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qabstracteventdispatcher.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qvector.h"
+#include "private/qabstracteventdispatcher_p.h"
+#include "private/qeventdispatcher_unix_p.h"
+#include "private/qtimerinfo_unix_p.h"
+
+QT_REQUIRE_CONFIG(epoll);
+
+QT_BEGIN_NAMESPACE
+
+class QEventDispatcherEpollPrivate;
+
+class Q_CORE_EXPORT QEventDispatcherEpoll : public QAbstractEventDispatcher
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QEventDispatcherEpoll)
+
+public:
+    enum TriggerMode {
+        LevelTriggered,
+        EdgeTriggered
+    };
+
+    explicit QEventDispatcherEpoll(QObject *parent = 0);
+    explicit QEventDispatcherEpoll(TriggerMode mode, QObject *parent = 0);
+    ~QEventDispatcherEpoll();
+
+    TriggerMode triggerMode() const;
+
+    bool processEvents(QEventLoop::ProcessEventsFlags flags) Q_DECL_OVERRIDE;
+    bool hasPendingEvents() Q_DECL_OVERRIDE;
+
+    void registerSocketNotifier(QSocketNotifier *notifier) Q_DECL_FINAL;
+    void unregisterSocketNotifier(QSocketNotifier *notifier) Q_DECL_FINAL;
+
+    void registerTimer(int timerId, int interval, Qt::TimerType timerType, QObject *object) Q_DECL_FINAL;
+    bool unregisterTimer(int timerId) Q_DECL_FINAL;
+    bool unregisterTimers(QObject *object) Q_DECL_FINAL;
+    QList<TimerInfo> registeredTimers(QObject *object) const Q_DECL_FINAL;
+
+    int remainingTime(int timerId) Q_DECL_FINAL;
+
+    void wakeUp() Q_DECL_FINAL;
+    void interrupt() Q_DECL_FINAL;
+    void flush() Q_DECL_OVERRIDE;
+
+    static bool isRequested(TriggerMode *mode = 0);
+};
+
+class Q_CORE_EXPORT QEventDispatcherEpollPrivate : public QAbstractEventDispatcherPrivate
+{
+    Q_DECLARE_PUBLIC(QEventDispatcherEpoll)
+
+public:
+    explicit QEventDispatcherEpollPrivate(QEventDispatcherEpoll::TriggerMode mode);
+    ~QEventDispatcherEpollPrivate();
+
+    void updateSocketNotifierSet(int fd, short oldEvents, short newEvents);
+    void armTimerFd(QDeadlineTimer deadline);
+
+    int processEpollEvents(int fd, bool wait, bool includeNotifiers);
+    int activateSocketNotifiers();
+    void setSocketNotifierPending(QSocketNotifier *notifier);
+
+    QEventDispatcherEpoll::TriggerMode triggerMode;
+
+    // epollFd watches the socket notifiers, the thread pipe and the timer fd;
+    // controlEpollFd watches only the latter two, so that processEvents() can
+    // block while excluding socket notifiers
+    int epollFd;
+    int controlEpollFd;
+    int timerFd;
+    QDeadlineTimer armedDeadline;
+
+    QThreadPipe threadPipe;
+
+    QHash<int, QSocketNotifierSetUNIX> socketNotifiers;
+    QVector<QSocketNotifier *> pendingNotifiers;
+
+    QTimerInfoList timerList;
+    QAtomicInt interrupt; // bool
+};
+
+QT_END_NAMESPACE
+
+#endif // QEVENTDISPATCHER_EPOLL_P_H
@@ -142,7 +142,7 @@ static gboolean timerSourceCheckHelper(GTimerSource *src)
         || (src->processEventsFlags & QEventLoop::X11ExcludeTimers))
         return false;
 
-    if (src->timerList.currentTime() < src->timerList.constFirst()->deadline)
+    if (src->timerList.currentTime() < src->timerList.nextDeadline())
         return false;
 
     return true;
@@ -47,6 +47,7 @@
 #include "qobject_p.h"
 #include "qeventloop_p.h"
 #include <private/qthread_p.h>
+#include <private/qtrace_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -131,6 +132,7 @@ bool QEventLoop::processEvents(ProcessEventsFlags flags)
     Q_D(QEventLoop);
     if (!d->threadData->eventDispatcher.load())
         return false;
+    Q_TRACE_SCOPE(lcTraceCoreEvents, "QEventLoop::processEvents", int(flags));
     return d->threadData->eventDispatcher.load()->processEvents(flags);
 }
 
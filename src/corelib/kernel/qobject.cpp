@@ -62,6 +62,7 @@
 
 #include <private/qorderedmutexlocker_p.h>
 #include <private/qhooks_p.h>
+#include <private/qtrace_p.h>
 
 #include <new>
 
@@ -203,7 +204,8 @@ QMetaObject *QObjectData::dynamicMetaObject() const
 }
 
 QObjectPrivate::QObjectPrivate(int version)
-    : threadData(0), connectionLists(0), senders(0), currentSender(0), currentChildBeingDeleted(0)
+    : threadData(0), connectionLists(0), signalSnapshots(0), senders(0), currentSender(0),
+      currentChildBeingDeleted(0)
 {
 #ifdef QT_BUILD_INTERNAL
     // Don't check the version parameter in internal builds.
@@ -247,7 +249,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || threadData->postEventList.incoming.loadAcquire())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     threadData->deref();
@@ -313,6 +315,244 @@ public:
     }
 };
 
+/*
+    QObjectSignalSnapshot is an immutable copy of the connections of one
+    signal, built on demand by QMetaObject::activate(). When all the
+    receivers live in one thread and are connected directly or
+    automatically, the signal is emitted from that thread using the
+    snapshot, without locking the signalSlotLock(), which is shared with
+    unrelated objects through the mutex pool. The snapshot holds a
+    reference on each connection and slot object.
+
+    Snapshots are published in the sender's QObjectSignalSnapshots and
+    replaced with the signalSlotLock() locked whenever a connection of the
+    sender changes. A replaced snapshot may still be used by an ongoing
+    emission, so it is retired and only released two epochs later, once
+    the emissions that could have seen it have finished.
+*/
+struct QObjectSignalSnapshot
+{
+    struct Entry {
+        QObjectPrivate::Connection *connection;
+        QtPrivate::QSlotObjectBase *slotObj;
+        QObjectPrivate::StaticMetaCallFunction callFunction;
+        ushort method_offset;
+        ushort method_relative;
+    };
+
+    QObjectSignalSnapshot *nextRetired;
+    uint retiredEpoch;
+    Qt::HANDLE threadId; // the thread all receivers lived in when the snapshot was built, or 0
+    int generation;      // the generation of the sender's snapshots when this one was built
+    bool directOnly;     // can be emitted without locking; entries is empty otherwise
+    QVector<Entry> entries;
+
+    // must not be called with the signalSlotLock() locked, unless all the slot
+    // objects are still referenced by their connections
+    void releaseEntries()
+    {
+        for (const Entry &e : qAsConst(entries)) {
+            if (e.slotObj)
+                e.slotObj->destroyIfLastRef();
+            e.connection->deref();
+        }
+        entries.clear();
+    }
+
+    static void release(QObjectSignalSnapshot *snapshot)
+    {
+        while (snapshot) {
+            QObjectSignalSnapshot *next = snapshot->nextRetired;
+            snapshot->releaseEntries();
+            delete snapshot;
+            snapshot = next;
+        }
+    }
+};
+
+class QObjectSignalSnapshots
+{
+public:
+    enum { Orphaned = 0x40000000, BucketCount = 8 };
+
+    // holds the current snapshot of one signal; only deleted with the sender
+    struct Slot {
+        int signal;
+        QAtomicPointer<QObjectSignalSnapshot> snapshot;
+        Slot *next;
+    };
+
+    QAtomicInt state;        // number of emissions using the snapshots, plus Orphaned once the sender is destroyed
+    QAtomicInt generation;   // changed when a receiver moves to another thread
+    QAtomicInt epoch;
+    QAtomicInt emissions[2]; // emissions in progress, by the parity of the epoch they started in
+    QAtomicPointer<QObjectSignalSnapshot> retired; // newest first, changed with the signalSlotLock() locked
+    QAtomicPointer<Slot> buckets[BucketCount];
+
+    QObjectSignalSnapshots()
+        : state(0), generation(0), epoch(0), retired(0)
+    {
+        emissions[0].store(0);
+        emissions[1].store(0);
+        for (int i = 0; i < BucketCount; ++i)
+            buckets[i].store(0);
+    }
+
+    ~QObjectSignalSnapshots()
+    {
+        for (int i = 0; i < BucketCount; ++i) {
+            Slot *slot = buckets[i].load();
+            while (slot) {
+                Slot *next = slot->next;
+                QObjectSignalSnapshot::release(slot->snapshot.load());
+                delete slot;
+                slot = next;
+            }
+        }
+        QObjectSignalSnapshot::release(retired.load());
+    }
+
+    bool isOrphaned() const { return state.load() & Orphaned; }
+
+    Slot *find(int signal) const
+    {
+        for (Slot *slot = buckets[signal % BucketCount].loadAcquire(); slot; slot = slot->next) {
+            if (slot->signal == signal)
+                return slot;
+        }
+        return 0;
+    }
+
+    // called with the signalSlotLock() of the sender locked
+    Slot *findOrInsert(int signal)
+    {
+        if (Slot *slot = find(signal))
+            return slot;
+        Slot *slot = new Slot;
+        slot->signal = signal;
+        slot->snapshot.store(0);
+        slot->next = buckets[signal % BucketCount].load();
+        buckets[signal % BucketCount].storeRelease(slot);
+        return slot;
+    }
+
+    // counts an emission in; returns the epoch it started in
+    int enter()
+    {
+        forever {
+            const int current = epoch.load();
+            emissions[current & 1].ref();
+            // if the epoch moved on, it may not have waited for us
+            if (epoch.testAndSetOrdered(current, current))
+                return current;
+            emissions[current & 1].deref();
+        }
+    }
+
+    // counts an emission that started in \a startEpoch out
+    void leave(int startEpoch)
+    {
+        emissions[startEpoch & 1].deref();
+    }
+
+    // called with the signalSlotLock() of the sender locked, before the
+    // snapshot's connections or their slot objects can go away
+    void retire(Slot *slot)
+    {
+        QObjectSignalSnapshot *snapshot = slot->snapshot.fetchAndStoreOrdered(0);
+        if (!snapshot)
+            return;
+        if (state.fetchAndAddOrdered(0) == 0) {
+            // no emission in progress, and new ones no longer find it
+            QObjectSignalSnapshot::release(snapshot);
+        } else {
+            snapshot->retiredEpoch = epoch.load();
+            snapshot->nextRetired = retired.load();
+            retired.storeRelease(snapshot);
+        }
+    }
+
+    // Called with the signalSlotLock() of the sender locked. Advances the
+    // epoch as far as the emissions in progress allow, and unlinks the
+    // retired snapshots that were retired at least two epochs ago. The
+    // caller releases them after unlocking.
+    QObjectSignalSnapshot *reclaim()
+    {
+        for (int i = 0; i < 2; ++i) {
+            const int current = epoch.load();
+            // all emissions of the previous epoch must have finished
+            if (emissions[(current + 1) & 1].fetchAndAddOrdered(0) != 0)
+                break;
+            epoch.fetchAndAddOrdered(1);
+        }
+
+        const uint current = epoch.load();
+        QObjectSignalSnapshot *previous = 0;
+        QObjectSignalSnapshot *snapshot = retired.load();
+        while (snapshot && current - snapshot->retiredEpoch < 2) {
+            previous = snapshot;
+            snapshot = snapshot->nextRetired;
+        }
+        if (previous)
+            previous->nextRetired = 0;
+        else
+            retired.storeRelease(0);
+        return snapshot;
+    }
+
+    // called with the signalSlotLock() of the sender locked; returns \c true
+    // if the caller has to delete this object
+    bool orphan()
+    {
+        return state.fetchAndOrOrdered(Orphaned) == 0;
+    }
+
+private:
+    Q_DISABLE_COPY(QObjectSignalSnapshots)
+};
+
+/*
+    Must be called with the signalSlotLock() of \a sender locked, before the
+    connections of \a signal (or of all signals, if \a signal is -1) change
+    and before the slot objects of disconnected connections are destroyed.
+*/
+static void invalidateSignalSnapshots(QObject *sender, int signal = -1)
+{
+    QObjectSignalSnapshots *snapshots = QObjectPrivate::get(sender)->signalSnapshots.load();
+    if (!snapshots)
+        return;
+    if (signal >= 0) {
+        if (QObjectSignalSnapshots::Slot *slot = snapshots->find(signal))
+            snapshots->retire(slot);
+    } else {
+        for (int i = 0; i < QObjectSignalSnapshots::BucketCount; ++i) {
+            for (QObjectSignalSnapshots::Slot *slot = snapshots->buckets[i].load(); slot; slot = slot->next)
+                snapshots->retire(slot);
+        }
+    }
+}
+
+/*
+    Makes the snapshots of the signals connected to \a object and its
+    children stale after they moved to another thread, so that emissions
+    stop calling them directly.
+*/
+static void invalidateSenderSignalSnapshots(QObject *object)
+{
+    QObjectPrivate *d = QObjectPrivate::get(object);
+    {
+        QMutexLocker locker(signalSlotLock(object));
+        // the senders cannot finish being destroyed while their connections
+        // to object are still listed here
+        for (QObjectPrivate::Connection *c = d->senders; c; c = c->next) {
+            if (QObjectSignalSnapshots *snapshots = QObjectPrivate::get(c->sender)->signalSnapshots.load())
+                snapshots->generation.ref();
+        }
+    }
+    for (QObject *child : qAsConst(d->children))
+        invalidateSenderSignalSnapshots(child);
+}
+
 // Used by QAccessibleWidget
 bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
 {
@@ -382,6 +622,7 @@ QObjectList QObjectPrivate::senderList() const
 void QObjectPrivate::addConnection(int signal, Connection *c)
 {
     Q_ASSERT(c->sender == q_ptr);
+    invalidateSignalSnapshots(q_ptr, signal);
     if (!connectionLists)
         connectionLists = new QObjectConnectionListVector();
     if (signal >= connectionLists->count())
@@ -1013,6 +1254,7 @@ QObject::~QObject()
                 continue;
             }
             node->receiver = 0;
+            invalidateSignalSnapshots(sender);
             QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists;
             if (senderLists)
                 senderLists->dirty = true;
@@ -1037,6 +1279,16 @@ QObject::~QObject()
         }
     }
 
+    if (QObjectSignalSnapshots *snapshots = d->signalSnapshots.load()) {
+        d->signalSnapshots.store(0);
+        QMutexLocker locker(signalSlotLock(this));
+        const bool unused = snapshots->orphan();
+        locker.unlock();
+        // otherwise the last emission using the snapshots deletes them
+        if (unused)
+            delete snapshots;
+    }
+
     if (!d->children.isEmpty())
         d->deleteChildren();
 
@@ -1538,6 +1790,9 @@ void QObject::moveToThread(QThread *targetThread)
 
     locker.unlock();
 
+    // snapshots of connections to the moved objects are no longer direct-only
+    invalidateSenderSignalSnapshots(this);
+
     // now currentData can commit suicide if it wants to
     currentData->deref();
 }
@@ -1559,6 +1814,7 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
 
     // move posted events
     int eventsMoved = 0;
+    currentData->flushIncomingEvents();
     for (int i = 0; i < currentData->postEventList.size(); ++i) {
         const QPostEvent &pe = currentData->postEventList.at(i);
         if (!pe.event)
@@ -3360,6 +3616,7 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
                 receiverMutex->unlock();
 
             c->receiver = 0;
+            invalidateSignalSnapshots(c->sender);
 
             if (c->isSlotObject) {
                 c->isSlotObject = false;
@@ -3598,6 +3855,290 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     QCoreApplication::postEvent(c->receiver, ev);
 }
 
+/*!
+    \internal
+
+    Calls or queues the slot of the connection \a c for an emission of the
+    signal \a signal_index of \a sender. \a locker holds the signalSlotLock()
+    of \a sender, which is unlocked while the slot is called.
+*/
+static void activate_connection(QObject *sender, int signal_index, QObjectPrivate::Connection *c,
+                                void **argv, Qt::HANDLE currentThreadId, QMutexLocker &locker)
+{
+    if (!c->receiver)
+        return;
+
+    QObject * const receiver = c->receiver;
+    const bool receiverInSameThread = currentThreadId == QObjectPrivate::get(receiver)->threadData->threadId;
+
+    // determine if this connection should be sent immediately or
+    // put into the event queue
+    if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
+        || (c->connectionType == Qt::QueuedConnection)) {
+        queued_activate(sender, signal_index, c, argv, locker);
+        return;
+#ifndef QT_NO_THREAD
+    } else if (c->connectionType == Qt::BlockingQueuedConnection) {
+        if (receiverInSameThread) {
+            qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
+            "Sender is %s(%p), receiver is %s(%p)",
+            sender->metaObject()->className(), sender,
+            receiver->metaObject()->className(), receiver);
+        }
+        QSemaphore semaphore;
+        QMetaCallEvent *ev = c->isSlotObject ?
+            new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv, &semaphore) :
+            new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv, &semaphore);
+        QCoreApplication::postEvent(receiver, ev);
+        locker.unlock();
+        semaphore.acquire();
+        locker.relock();
+        return;
+#endif
+    }
+
+    QConnectionSenderSwitcher sw;
+
+    if (receiverInSameThread) {
+        sw.switchSender(receiver, sender, signal_index);
+    }
+    if (c->isSlotObject) {
+        c->slotObj->ref();
+        QScopedPointer<QtPrivate::QSlotObjectBase, QSlotObjectBaseDeleter> obj(c->slotObj);
+        locker.unlock();
+        obj->call(receiver, argv);
+
+        // Make sure the slot object gets destroyed before the mutex is locked again, as the
+        // destructor of the slot object might also lock a mutex from the signalSlotLock() mutex pool,
+        // and that would deadlock if the pool happens to return the same mutex.
+        obj.reset();
+
+        locker.relock();
+    } else if (c->callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
+        //we compare the vtable to make sure we are not in the destructor of the object.
+        const int methodIndex = c->method();
+        const int method_relative = c->method_relative;
+        const auto callFunction = c->callFunction;
+        locker.unlock();
+        if (qt_signal_spy_callback_set.slot_begin_callback != 0)
+            qt_signal_spy_callback_set.slot_begin_callback(receiver, methodIndex, argv);
+
+        callFunction(receiver, QMetaObject::InvokeMetaMethod, method_relative, argv);
+
+        if (qt_signal_spy_callback_set.slot_end_callback != 0)
+            qt_signal_spy_callback_set.slot_end_callback(receiver, methodIndex);
+        locker.relock();
+    } else {
+        const int method = c->method_relative + c->method_offset;
+        locker.unlock();
+
+        if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
+            qt_signal_spy_callback_set.slot_begin_callback(receiver,
+                                                        method,
+                                                        argv);
+        }
+
+        QMetaObject::metacall(receiver, QMetaObject::InvokeMetaMethod, method, argv);
+
+        if (qt_signal_spy_callback_set.slot_end_callback != 0)
+            qt_signal_spy_callback_set.slot_end_callback(receiver, method);
+
+        locker.relock();
+    }
+}
+
+/*!
+    \internal
+
+    Returns the snapshot of the connections of \a signal_index, building a
+    new one if there is none or if a receiver moved to another thread since
+    it was built. The caller is counted in the state of \a snapshots.
+*/
+static QObjectSignalSnapshot *signalSnapshot(QObject *sender, QObjectSignalSnapshots *snapshots,
+                                             int signal_index)
+{
+    QObjectSignalSnapshots::Slot *slot = snapshots->find(signal_index);
+    QObjectSignalSnapshot *snapshot = slot ? slot->snapshot.loadAcquire() : 0;
+    if (snapshot && snapshot->generation == snapshots->generation.load())
+        return snapshot;
+
+    QMutexLocker locker(signalSlotLock(sender));
+    slot = snapshots->findOrInsert(signal_index);
+    snapshot = slot->snapshot.load();
+    if (snapshot) {
+        if (snapshot->generation == snapshots->generation.load())
+            return snapshot;
+        // we are using the snapshots, so this only retires it
+        snapshots->retire(slot);
+    }
+
+    snapshot = new QObjectSignalSnapshot;
+    snapshot->nextRetired = 0;
+    snapshot->retiredEpoch = 0;
+    snapshot->threadId = 0;
+    // read before the receivers' threads, see invalidateSenderSignalSnapshots()
+    snapshot->generation = snapshots->generation.loadAcquire();
+    snapshot->directOnly = true;
+
+    if (QObjectConnectionListVector *connectionLists = QObjectPrivate::get(sender)->connectionLists) {
+        const QObjectPrivate::ConnectionList *list;
+        if (signal_index < connectionLists->count())
+            list = &connectionLists->at(signal_index);
+        else
+            list = &connectionLists->allsignals;
+
+        do {
+            for (QObjectPrivate::Connection *c = list->first; c; c = c->nextConnectionList) {
+                QObject * const receiver = c->receiver;
+                if (!receiver)
+                    continue;
+                // a receiver in a thread that was not started yet is never called directly
+                const Qt::HANDLE receiverThreadId = QObjectPrivate::get(receiver)->threadData->threadId;
+                if ((c->connectionType != Qt::AutoConnection && c->connectionType != Qt::DirectConnection)
+                    || !receiverThreadId
+                    || (snapshot->threadId && snapshot->threadId != receiverThreadId)) {
+                    snapshot->directOnly = false;
+                    break;
+                }
+                snapshot->threadId = receiverThreadId;
+                QObjectSignalSnapshot::Entry e;
+                c->ref();
+                e.connection = c;
+                if (c->isSlotObject) {
+                    c->slotObj->ref();
+                    e.slotObj = c->slotObj;
+                    e.callFunction = 0;
+                } else {
+                    e.slotObj = 0;
+                    e.callFunction = c->callFunction;
+                }
+                e.method_offset = c->method_offset;
+                e.method_relative = c->method_relative;
+                snapshot->entries.append(e);
+            }
+        } while (snapshot->directOnly && list != &connectionLists->allsignals &&
+                 ((list = &connectionLists->allsignals), true));
+    }
+
+    // don't keep anything alive for a snapshot that is never emitted from
+    if (!snapshot->directOnly)
+        snapshot->releaseEntries();
+
+    slot->snapshot.storeRelease(snapshot);
+    return snapshot;
+}
+
+/*!
+    \internal
+
+    Ends the use of \a snapshots by an emission of \a sender that started in
+    \a startEpoch. Releases the retired snapshots that no emission can be
+    using any more, or all of them if \a sender was destroyed.
+*/
+static void releaseSignalSnapshots(QObject *sender, QObjectSignalSnapshots *snapshots, int startEpoch)
+{
+    snapshots->leave(startEpoch);
+
+    QObjectSignalSnapshot *reclaimed = 0;
+    int state;
+    if (snapshots->retired.loadAcquire()) {
+        // the sender cannot finish being destroyed while we hold its lock
+        QMutexLocker locker(signalSlotLock(sender));
+        state = snapshots->state.fetchAndSubOrdered(1) - 1;
+        if (state != QObjectSignalSnapshots::Orphaned)
+            reclaimed = snapshots->reclaim();
+    } else {
+        state = snapshots->state.fetchAndSubOrdered(1) - 1;
+    }
+
+    if (state == QObjectSignalSnapshots::Orphaned)
+        delete snapshots;
+    QObjectSignalSnapshot::release(reclaimed);
+}
+
+/*!
+    \internal
+
+    Emits the signal \a signal_index of \a sender without locking the
+    signalSlotLock(), if all connected receivers live in the current thread.
+    Returns \c false if the signal has to be emitted the regular way.
+*/
+static bool activate_direct(QObject *sender, int signal_index, void **argv)
+{
+    QObjectPrivate *sp = QObjectPrivate::get(sender);
+    if (sp->wasDeleted) // only emits destroyed() once more, not worth a snapshot
+        return false;
+
+    QObjectSignalSnapshots *snapshots = sp->signalSnapshots.loadAcquire();
+    if (!snapshots) {
+        QMutexLocker locker(signalSlotLock(sender));
+        snapshots = sp->signalSnapshots.load();
+        if (!snapshots) {
+            snapshots = new QObjectSignalSnapshots;
+            sp->signalSnapshots.storeRelease(snapshots);
+        }
+    }
+
+    // released even if a slot throws
+    struct SignalSnapshotsRef {
+        QObject *sender;
+        QObjectSignalSnapshots *snapshots;
+        int startEpoch;
+        SignalSnapshotsRef(QObject *sender, QObjectSignalSnapshots *snapshots)
+            : sender(sender), snapshots(snapshots)
+        {
+            snapshots->state.ref();
+            startEpoch = snapshots->enter();
+        }
+        ~SignalSnapshotsRef()
+        {
+            releaseSignalSnapshots(sender, snapshots, startEpoch);
+        }
+    };
+    SignalSnapshotsRef snapshotsRef(sender, snapshots);
+
+    const QObjectSignalSnapshot *snapshot = signalSnapshot(sender, snapshots, signal_index);
+    if (!snapshot->directOnly)
+        return false;
+    const Qt::HANDLE currentThreadId = QThread::currentThreadId();
+    if (snapshot->threadId && snapshot->threadId != currentThreadId)
+        return false;
+
+    const int count = snapshot->entries.size();
+    for (int i = 0; i < count; ++i) {
+        const QObjectSignalSnapshot::Entry &e = snapshot->entries.at(i);
+        // a disconnect in another thread may clear the receiver
+        QObject * const receiver = e.connection->receiver.loadAcquire();
+        if (!receiver)
+            continue;
+
+        if (Q_UNLIKELY(snapshot->generation != snapshots->generation.load())) {
+            // a slot moved a receiver to another thread: deliver the rest
+            // the regular way
+            QMutexLocker locker(signalSlotLock(sender));
+            for (; i < count && !snapshots->isOrphaned(); ++i)
+                activate_connection(sender, signal_index, snapshot->entries.at(i).connection,
+                                    argv, currentThreadId, locker);
+            break;
+        }
+
+        QConnectionSenderSwitcher sw(receiver, sender, signal_index);
+        if (e.slotObj) {
+            e.slotObj->call(receiver, argv);
+        } else if (e.callFunction && e.method_offset <= receiver->metaObject()->methodOffset()) {
+            //we compare the vtable to make sure we are not in the destructor of the object.
+            e.callFunction(receiver, QMetaObject::InvokeMetaMethod, e.method_relative, argv);
+        } else {
+            QMetaObject::metacall(receiver, QMetaObject::InvokeMetaMethod, e.method_offset + e.method_relative, argv);
+        }
+
+        if (snapshots->isOrphaned())
+            break;
+    }
+
+    return true;
+}
+
 /*!
     \internal
  */
@@ -3630,12 +4171,22 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
         return;
     }
 
+    Q_TRACE_SCOPE(lcTraceCoreEvents, "QMetaObject::activate", signal_index);
+
     void *empty_argv[] = { 0 };
     if (qt_signal_spy_callback_set.signal_begin_callback != 0) {
         qt_signal_spy_callback_set.signal_begin_callback(sender, signal_index,
                                                          argv ? argv : empty_argv);
     }
 
+    if (!qt_signal_spy_callback_set.slot_begin_callback
+        && !qt_signal_spy_callback_set.slot_end_callback
+        && activate_direct(sender, signal_index, argv ? argv : empty_argv)) {
+        if (qt_signal_spy_callback_set.signal_end_callback != 0)
+            qt_signal_spy_callback_set.signal_end_callback(sender, signal_index);
+        return;
+    }
+
     {
     QMutexLocker locker(signalSlotLock(sender));
     struct ConnectionListsRef {
@@ -3684,86 +4235,7 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
         QObjectPrivate::Connection *last = list->last;
 
         do {
-            if (!c->receiver)
-                continue;
-
-            QObject * const receiver = c->receiver;
-            const bool receiverInSameThread = currentThreadId == receiver->d_func()->threadData->threadId;
-
-            // determine if this connection should be sent immediately or
-            // put into the event queue
-            if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
-                || (c->connectionType == Qt::QueuedConnection)) {
-                queued_activate(sender, signal_index, c, argv ? argv : empty_argv, locker);
-                continue;
-#ifndef QT_NO_THREAD
-            } else if (c->connectionType == Qt::BlockingQueuedConnection) {
-                if (receiverInSameThread) {
-                    qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
-                    "Sender is %s(%p), receiver is %s(%p)",
-                    sender->metaObject()->className(), sender,
-                    receiver->metaObject()->className(), receiver);
-                }
-                QSemaphore semaphore;
-                QMetaCallEvent *ev = c->isSlotObject ?
-                    new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
-                    new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
-                QCoreApplication::postEvent(receiver, ev);
-                locker.unlock();
-                semaphore.acquire();
-                locker.relock();
-                continue;
-#endif
-            }
-
-            QConnectionSenderSwitcher sw;
-
-            if (receiverInSameThread) {
-                sw.switchSender(receiver, sender, signal_index);
-            }
-            if (c->isSlotObject) {
-                c->slotObj->ref();
-                QScopedPointer<QtPrivate::QSlotObjectBase, QSlotObjectBaseDeleter> obj(c->slotObj);
-                locker.unlock();
-                obj->call(receiver, argv ? argv : empty_argv);
-
-                // Make sure the slot object gets destroyed before the mutex is locked again, as the
-                // destructor of the slot object might also lock a mutex from the signalSlotLock() mutex pool,
-                // and that would deadlock if the pool happens to return the same mutex.
-                obj.reset();
-
-                locker.relock();
-            } else if (c->callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
-                //we compare the vtable to make sure we are not in the destructor of the object.
-                const int methodIndex = c->method();
-                const int method_relative = c->method_relative;
-                const auto callFunction = c->callFunction;
-                locker.unlock();
-                if (qt_signal_spy_callback_set.slot_begin_callback != 0)
-                    qt_signal_spy_callback_set.slot_begin_callback(receiver, methodIndex, argv ? argv : empty_argv);
-
-                callFunction(receiver, QMetaObject::InvokeMetaMethod, method_relative, argv ? argv : empty_argv);
-
-                if (qt_signal_spy_callback_set.slot_end_callback != 0)
-                    qt_signal_spy_callback_set.slot_end_callback(receiver, methodIndex);
-                locker.relock();
-            } else {
-                const int method = c->method_relative + c->method_offset;
-                locker.unlock();
-
-                if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
-                    qt_signal_spy_callback_set.slot_begin_callback(receiver,
-                                                                method,
-                                                                argv ? argv : empty_argv);
-                }
-
-                metacall(receiver, QMetaObject::InvokeMetaMethod, method, argv ? argv : empty_argv);
-
-                if (qt_signal_spy_callback_set.slot_end_callback != 0)
-                    qt_signal_spy_callback_set.slot_end_callback(receiver, method);
-
-                locker.relock();
-            }
+            activate_connection(sender, signal_index, c, argv ? argv : empty_argv, currentThreadId, locker);
 
             if (connectionLists->orphaned)
                 break;
@@ -4040,11 +4512,11 @@ void QObject::dumpObjectInfo()
                     c = c->nextConnectionList;
                     continue;
                 }
-                const QMetaObject *receiverMetaObject = c->receiver->metaObject();
+                const QMetaObject *receiverMetaObject = c->receiver.load()->metaObject();
                 const QMetaMethod method = receiverMetaObject->method(c->method());
                 qDebug("          --> %s::%s %s",
                        receiverMetaObject->className(),
-                       c->receiver->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver->objectName()),
+                       c->receiver.load()->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver.load()->objectName()),
                        method.methodSignature().constData());
                 c = c->nextConnectionList;
             }
@@ -4843,6 +5315,7 @@ bool QObject::disconnect(const QMetaObject::Connection &connection)
         if (c->next)
             c->next->prev = c->prev;
         c->receiver = 0;
+        invalidateSignalSnapshots(c->sender);
     }
 
     // destroy the QSlotObject, if possible
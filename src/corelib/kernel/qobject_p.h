@@ -67,6 +67,7 @@ QT_BEGIN_NAMESPACE
 class QVariant;
 class QThreadData;
 class QObjectConnectionListVector;
+class QObjectSignalSnapshots;
 namespace QtSharedPointer { struct ExternalRefCountData; }
 
 /* for Qt Test */
@@ -127,7 +128,7 @@ public:
     struct Connection
     {
         QObject *sender;
-        QObject *receiver;
+        QAtomicPointer<QObject> receiver;
         union {
             StaticMetaCallFunction callFunction;
             QtPrivate::QSlotObjectBase *slotObj;
@@ -232,6 +233,7 @@ public:
     QThreadData *threadData; // id of the thread that owns the object
 
     QObjectConnectionListVector *connectionLists;
+    QAtomicPointer<QObjectSignalSnapshots> signalSnapshots; // used by QMetaObject::activate()
 
     Connection *senders;     // linked list of connections connected to this object
     Sender *currentSender;   // object currently activating the object
@@ -48,6 +48,8 @@
 
 #include <sys/times.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
@@ -57,9 +59,20 @@ Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
  * timerBitVec array is used for keeping track of timer identifiers.
  */
 
+static inline qint64 tickOf(QDeadlineTimer deadline)
+{
+    return deadline.deadlineNSecs() / (1000 * 1000);
+}
+
 QTimerInfoList::QTimerInfoList()
+    : wheelTime(tickOf(QDeadlineTimer::current(Qt::PreciseTimer))),
+      levelFirstValid(~0u),
+      expiredHead(0), expiredTail(&expiredHead), expiredCount(0),
+      insertCounter(0), activeTimers(0)
 {
-    firstTimerInfo = 0;
+    memset(buckets, 0, sizeof(buckets));
+    memset(occupied, 0, sizeof(occupied));
+    memset(levelFirst, 0, sizeof(levelFirst));
 }
 
 QDeadlineTimer QTimerInfoList::currentTime()
@@ -68,17 +81,186 @@ QDeadlineTimer QTimerInfoList::currentTime()
 }
 
 /*
-  insert timer info into list
+  insert timer info into the wheel bucket matching its deadline
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->deadline < t->deadline))
+    qint64 tick = qMax(tickOf(ti->deadline), wheelTime);
+    const qint64 delta = tick - wheelTime;
+
+    int level = 0;
+    while (level < WheelLevels - 1 && (delta >> ((level + 1) * WheelBits)))
+        ++level;
+    if (delta >> (WheelLevels * WheelBits)) {
+        // beyond the range of the wheel: park it in the farthest bucket,
+        // it is filed again when that bucket is cascaded
+        tick = wheelTime + (Q_INT64_C(1) << (WheelLevels * WheelBits)) - 1;
+    }
+
+    const int index = int(tick >> (level * WheelBits)) & WheelMask;
+    const int bucket = level * WheelSize + index;
+    ti->bucket = bucket;
+    ti->next = buckets[bucket];
+    if (ti->next)
+        ti->next->pprev = &ti->next;
+    ti->pprev = &buckets[bucket];
+    buckets[bucket] = ti;
+    occupied[level] |= Q_UINT64_C(1) << index;
+
+    if ((levelFirstValid & (1u << level))
+            && (!levelFirst[level] || ti->deadline < levelFirst[level]->deadline))
+        levelFirst[level] = ti;
+}
+
+/*
+  remove timer info from its wheel bucket or from the expired list
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *ti)
+{
+    *ti->pprev = ti->next;
+    if (ti->next)
+        ti->next->pprev = ti->pprev;
+
+    if (ti->bucket < 0) {
+        if (expiredTail == &ti->next)
+            expiredTail = ti->pprev;
+        --expiredCount;
+        return;
+    }
+
+    const int level = ti->bucket >> WheelBits;
+    if (!buckets[ti->bucket])
+        occupied[level] &= ~(Q_UINT64_C(1) << (ti->bucket & WheelMask));
+    if (levelFirst[level] == ti)
+        levelFirstValid &= ~(1u << level);
+}
+
+/*
+  move the timers of a level 0 bucket that have expired by \a now (in
+  nanoseconds) to \a expired
+*/
+void QTimerInfoList::collectBucket(int index, qint64 now, QVarLengthArray<QTimerInfo *, 32> &expired)
+{
+    QTimerInfo *t = buckets[index];
+    while (t) {
+        QTimerInfo *next = t->next;
+        if (t->deadline.deadlineNSecs() <= now) {
+            timerRemove(t);
+            expired.append(t);
+        }
+        t = next;
+    }
+}
+
+/*
+  file the timers of a bucket again now that the wheel has reached it,
+  which moves them to a lower level
+*/
+void QTimerInfoList::cascadeBucket(int level, int index)
+{
+    const int bucket = level * WheelSize + index;
+    QTimerInfo *t = buckets[bucket];
+    buckets[bucket] = 0;
+    occupied[level] &= ~(Q_UINT64_C(1) << index);
+    levelFirstValid &= ~(1u << level);
+
+    while (t) {
+        QTimerInfo *next = t->next;
+        timerInsert(t);
+        t = next;
+    }
+}
+
+/*
+  turn the wheel up to \a currentTime and append the timers that have
+  expired to the expired list, in deadline order
+*/
+void QTimerInfoList::collectExpiredTimers(QDeadlineTimer currentTime)
+{
+    const qint64 nowNSecs = currentTime.deadlineNSecs();
+    const qint64 now = nowNSecs / (1000 * 1000);
+    QVarLengthArray<QTimerInfo *, 32> expired;
+
+    for (;;) {
+        int level = 0;
+        while (level < WheelLevels && !occupied[level])
+            ++level;
+        if (level == WheelLevels) {
+            wheelTime = qMax(wheelTime, now);
             break;
+        }
+
+        // the next tick at which a bucket of the lowest non-empty level is
+        // cascaded; all levels below it are empty, so skip straight to it
+        const int shift = qMax(level, 1) * WheelBits;
+        const qint64 boundary = ((wheelTime >> shift) + 1) << shift;
+
+        if (level == 0) {
+            const qint64 last = qMin(now, boundary - 1);
+            for (qint64 tick = wheelTime; tick <= last; ++tick) {
+                const int index = int(tick) & WheelMask;
+                if (occupied[0] & (Q_UINT64_C(1) << index))
+                    collectBucket(index, nowNSecs, expired);
+            }
+        }
+
+        if (now < boundary) {
+            wheelTime = qMax(wheelTime, now);
+            break;
+        }
+
+        wheelTime = boundary;
+        for (level = 1; level < WheelLevels; ++level) {
+            const int index = int(wheelTime >> (level * WheelBits)) & WheelMask;
+            if (occupied[level] & (Q_UINT64_C(1) << index))
+                cascadeBucket(level, index);
+            if (index)
+                break;
+        }
+    }
+
+    std::sort(expired.begin(), expired.end(), [](const QTimerInfo *t1, const QTimerInfo *t2) {
+        return t1->deadline < t2->deadline
+                || (t1->deadline == t2->deadline && t1->sequence < t2->sequence);
+    });
+    for (QTimerInfo *t : qAsConst(expired)) {
+        t->bucket = -1;
+        t->next = 0;
+        t->pprev = expiredTail;
+        *expiredTail = t;
+        expiredTail = &t->next;
+        ++expiredCount;
+    }
+}
+
+/*
+  returns the earliest timer of \a level, optionally ignoring the timers
+  that are being activated
+*/
+QTimerInfo *QTimerInfoList::firstTimerOfLevel(int level, bool skipActive) const
+{
+    // buckets of level 0 start at the current tick, those of the levels
+    // above it at the next bucket, since the current one was cascaded
+    const int start = int((wheelTime >> (level * WheelBits)) + (level ? 1 : 0)) & WheelMask;
+    quint64 pending = occupied[level];
+    if (start)
+        pending = (pending >> start) | (pending << (WheelSize - start));
+
+    while (pending) {
+        const int index = (start + int(qCountTrailingZeroBits(pending))) & WheelMask;
+        pending &= pending - 1;
+
+        QTimerInfo *first = 0;
+        for (QTimerInfo *t = buckets[level * WheelSize + index]; t; t = t->next) {
+            if (skipActive && t->activateRef)
+                continue;
+            if (!first || t->deadline < first->deadline)
+                first = t;
+        }
+        if (first)
+            return first;
     }
-    insert(index+1, ti);
+    return 0;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -139,17 +321,34 @@ static void calculateNextTimeout(QTimerInfo *t, QDeadlineTimer currentTime)
 QDeadlineTimer QTimerInfoList::nextDeadline() const
 {
     // Find first waiting timer not already active
-    QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
+    for (const QTimerInfo *t = expiredHead; t; t = t->next) {
+        if (!t->activateRef)
+            return t->deadline;
+    }
+
+    const QTimerInfo *first = 0;
+    for (int level = 0; level < WheelLevels; ++level) {
+        if (!occupied[level])
+            continue;
+
+        const QTimerInfo *t;
+        if (activeTimers) {
+            // rare: only while a timer event is being delivered
+            t = firstTimerOfLevel(level, true);
+        } else {
+            if (!(levelFirstValid & (1u << level))) {
+                levelFirst[level] = firstTimerOfLevel(level, false);
+                levelFirstValid |= 1u << level;
+            }
+            t = levelFirst[level];
         }
+        if (t && (!first || t->deadline < first->deadline))
+            first = t;
     }
 
-    if (!t)
+    if (!first)
         return QDeadlineTimer::Forever;
-    return t->deadline;
+    return first->deadline;
 }
 
 /*
@@ -159,11 +358,8 @@ QDeadlineTimer QTimerInfoList::nextDeadline() const
 */
 int QTimerInfoList::timerRemainingTime(int timerId)
 {
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId)
-            return t->deadline.remainingTime();
-    }
+    if (const QTimerInfo *t = timers.value(timerId))
+        return t->deadline.remainingTime();
 
 #ifndef QT_NO_DEBUG
     qWarning("QTimerInfoList::timerRemainingTime: timer id %i not found", timerId);
@@ -180,6 +376,11 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = 0;
+    t->sequence = ++insertCounter;
+
+    // the wheel only turns while there are timers, catch up with the clock
+    if (timers.isEmpty())
+        wheelTime = qMax(wheelTime, tickOf(currentTime()));
 
     switch (timerType) {
     case Qt::PreciseTimer:
@@ -218,6 +419,7 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
         t->deadline = now + (interval + (x > 500 ? 1000 : 0) - x);
     }
 
+    timers.insert(timerId, t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -233,39 +435,33 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
-    }
-    // id not found
-    return false;
+    QTimerInfo *t = timers.take(timerId);
+    if (!t)
+        return false; // id not found
+
+    timerRemove(t);
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
+    QHash<int, QTimerInfo *>::iterator it = timers.begin();
+    while (it != timers.end()) {
+        QTimerInfo *t = it.value();
         if (t->obj == object) {
             // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
+            it = timers.erase(it);
+            timerRemove(t);
             if (t->activateRef)
                 *(t->activateRef) = 0;
             delete t;
-            // move back one so that we don't skip the new current item
-            --i;
+        } else {
+            ++it;
         }
     }
     return true;
@@ -274,8 +470,8 @@ bool QTimerInfoList::unregisterTimers(QObject *object)
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
+    for (const_iterator it = timers.constBegin(); it != timers.constEnd(); ++it) {
+        const QTimerInfo * const t = it.value();
         if (t->obj == object) {
             list << QAbstractEventDispatcher::TimerInfo(t->id,
                                                         t->interval,
@@ -293,45 +489,26 @@ int QTimerInfoList::activateTimers()
     if (qt_disable_lowpriority_timers || isEmpty())
         return 0; // nothing to do
 
-    int n_act = 0, maxCount = 0;
-    firstTimerInfo = 0;
-
     QDeadlineTimer currentTime = this->currentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
 
-    // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->deadline)
-            break;
-        maxCount++;
-    }
+    // Find out which timers have expired; a nested call from one of the
+    // timer events below picks up where we stopped
+    collectExpiredTimers(currentTime);
+    int n_act = 0, maxCount = expiredCount;
 
     //fire the timers.
-    while (maxCount--) {
-        if (isEmpty())
-            break;
-
-        QTimerInfo *currentTimerInfo = constFirst();
-        if (currentTime < currentTimerInfo->deadline)
-            break; // no timer has expired
-
-        if (!firstTimerInfo) {
-            firstTimerInfo = currentTimerInfo;
-        } else if (firstTimerInfo == currentTimerInfo) {
-            // avoid sending the same timer multiple times
-            break;
-        } else if (currentTimerInfo->interval <  firstTimerInfo->interval
-                   || currentTimerInfo->interval == firstTimerInfo->interval) {
-            firstTimerInfo = currentTimerInfo;
-        }
+    while (maxCount-- && expiredHead) {
+        QTimerInfo *currentTimerInfo = expiredHead;
 
         // remove from list
-        removeFirst();
+        timerRemove(currentTimerInfo);
 
         // determine next timeout time
         calculateNextTimeout(currentTimerInfo, currentTime);
 
         // reinsert timer
+        currentTimerInfo->sequence = ++insertCounter;
         timerInsert(currentTimerInfo);
         if (currentTimerInfo->interval > 0)
             n_act++;
@@ -339,16 +516,17 @@ int QTimerInfoList::activateTimers()
         if (!currentTimerInfo->activateRef) {
             // send event, but don't allow it to recurse
             currentTimerInfo->activateRef = &currentTimerInfo;
+            ++activeTimers;
 
             QTimerEvent e(currentTimerInfo->id);
             QCoreApplication::sendEvent(currentTimerInfo->obj, &e);
 
+            --activeTimers;
             if (currentTimerInfo)
                 currentTimerInfo->activateRef = 0;
         }
     }
 
-    firstTimerInfo = 0;
     // qDebug() << "Thread" << QThread::currentThreadId() << "activated" << n_act << "timers";
     return n_act;
 }
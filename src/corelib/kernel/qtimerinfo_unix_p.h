@@ -57,6 +57,8 @@
 
 #include "qabstracteventdispatcher.h"
 #include "qdeadlinetimer.h"
+#include "qhash.h"
+#include "qvarlengtharray.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -71,6 +73,12 @@ struct QTimerInfo {
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
 
+    // timer wheel linkage, maintained by QTimerInfoList
+    QTimerInfo *next;
+    QTimerInfo **pprev;
+    quint64 sequence; // - insertion order, keeps equal deadlines stable
+    int bucket;       // - wheel bucket, or -1 when on the expired list
+
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
     float cumulativeError;
@@ -78,18 +86,33 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+/*
+    The timers are kept in a hierarchical timing wheel with millisecond
+    ticks: level 0 has one bucket per millisecond for the next 64 ms, each
+    bucket of level N covers 64 buckets of level N - 1. Inserting,
+    restarting and removing a timer are O(1); timers are moved down a
+    level ("cascaded") as the wheel turns, and the timers that have expired
+    are moved to a list sorted by deadline from which they are activated.
+*/
+class Q_CORE_EXPORT QTimerInfoList
 {
-    // state variables used by activateTimers()
-    QTimerInfo *firstTimerInfo;
-
 public:
+    enum {
+        WheelBits = 6,
+        WheelSize = 1 << WheelBits,
+        WheelMask = WheelSize - 1,
+        WheelLevels = 6 // 2^36 ms, well beyond the longest int interval
+    };
+
+    typedef QHash<int, QTimerInfo *>::const_iterator const_iterator;
+
     QTimerInfoList();
 
     QDeadlineTimer currentTime();
 
     QDeadlineTimer nextDeadline() const;
     void timerInsert(QTimerInfo *);
+    void timerRemove(QTimerInfo *);
 
     int timerRemainingTime(int timerId);
 
@@ -99,6 +122,42 @@ public:
     QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
 
     int activateTimers();
+
+    bool isEmpty() const { return timers.isEmpty(); }
+    int size() const { return timers.size(); }
+    int count() const { return timers.size(); }
+
+    // iterates over all registered timers, in no particular order
+    const_iterator begin() const { return timers.constBegin(); }
+    const_iterator end() const { return timers.constEnd(); }
+    const_iterator constBegin() const { return timers.constBegin(); }
+    const_iterator constEnd() const { return timers.constEnd(); }
+
+private:
+    void collectExpiredTimers(QDeadlineTimer currentTime);
+    void collectBucket(int index, qint64 now, QVarLengthArray<QTimerInfo *, 32> &expired);
+    void cascadeBucket(int level, int index);
+    QTimerInfo *firstTimerOfLevel(int level, bool skipActive) const;
+
+    QHash<int, QTimerInfo *> timers;
+
+    QTimerInfo *buckets[WheelLevels * WheelSize];
+    quint64 occupied[WheelLevels];      // non-empty buckets, one bit per bucket
+    qint64 wheelTime;                   // current tick, in milliseconds
+
+    // earliest timer of each level, valid if the level's bit is set
+    mutable QTimerInfo *levelFirst[WheelLevels];
+    mutable uint levelFirstValid;
+
+    // expired timers waiting for activation, sorted by deadline
+    QTimerInfo *expiredHead;
+    QTimerInfo **expiredTail;
+    int expiredCount;
+
+    quint64 insertCounter;
+    int activeTimers;                   // timers currently being delivered
+
+    Q_DISABLE_COPY(QTimerInfoList)
 };
 
 QT_END_NAMESPACE
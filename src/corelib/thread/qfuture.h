@@ -46,6 +46,7 @@
 
 #include <QtCore/qfutureinterface.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qscopedpointer.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -55,6 +56,24 @@ class QFutureWatcher;
 template <>
 class QFutureWatcher<void>;
 
+namespace QtPrivate {
+
+template <typename Function, typename T>
+struct ContinuationResult
+{
+    typedef typename std::decay<decltype(std::declval<Function &>()(std::declval<const T &>()))>::type Type;
+};
+
+template <typename Function>
+struct ContinuationResult<Function, void>
+{
+    typedef typename std::decay<decltype(std::declval<Function &>()())>::type Type;
+};
+
+struct WhenContinuations;
+
+} // namespace QtPrivate
+
 template <typename T>
 class QFuture
 {
@@ -143,6 +162,17 @@ public:
     const_iterator end() const { return const_iterator(this, -1); }
     const_iterator constEnd() const { return const_iterator(this, -1); }
 
+    template <typename Function>
+    QFuture<typename QtPrivate::ContinuationResult<Function, T>::Type> then(Function function);
+    template <typename Function>
+    QFuture<typename QtPrivate::ContinuationResult<Function, T>::Type> then(QThreadPool *pool, Function function);
+    template <typename Function>
+    QFuture<typename QtPrivate::ContinuationResult<Function, T>::Type> then(QObject *context, Function function);
+#ifndef QT_NO_EXCEPTIONS
+    template <typename Function>
+    QFuture<T> onFailed(Function handler);
+#endif
+
 private:
     friend class QFutureWatcher<T>;
 
@@ -220,8 +250,20 @@ public:
     QString progressText() const { return d.progressText(); }
     void waitForFinished() { d.waitForFinished(); }
 
+    template <typename Function>
+    QFuture<typename QtPrivate::ContinuationResult<Function, void>::Type> then(Function function);
+    template <typename Function>
+    QFuture<typename QtPrivate::ContinuationResult<Function, void>::Type> then(QThreadPool *pool, Function function);
+    template <typename Function>
+    QFuture<typename QtPrivate::ContinuationResult<Function, void>::Type> then(QObject *context, Function function);
+#ifndef QT_NO_EXCEPTIONS
+    template <typename Function>
+    QFuture<void> onFailed(Function handler);
+#endif
+
 private:
     friend class QFutureWatcher<void>;
+    friend struct QtPrivate::WhenContinuations;
 
 #ifdef QFUTURE_TEST
 public:
@@ -240,6 +282,414 @@ QFuture<void> qToVoidFuture(const QFuture<T> &future)
     return QFuture<void>(future.d);
 }
 
+namespace QtFuture {
+
+template <typename T>
+struct WhenAnyResult
+{
+    WhenAnyResult() : index(-1) { }
+    WhenAnyResult(int index, const QFuture<T> &future) : index(index), future(future) { }
+
+    int index;
+    QFuture<T> future;
+};
+
+} // namespace QtFuture
+
+namespace QtPrivate {
+
+// Reports the return value of function, called with the given argument if any.
+template <typename R>
+struct ContinuationCall
+{
+    template <typename Function>
+    static void call(QFutureInterface<R> &promise, Function &function)
+    { promise.reportResult(function()); }
+    template <typename Function, typename Arg>
+    static void call(QFutureInterface<R> &promise, Function &function, const Arg &arg)
+    { promise.reportResult(function(arg)); }
+};
+
+template <>
+struct ContinuationCall<void>
+{
+    template <typename Function>
+    static void call(QFutureInterface<void> &, Function &function)
+    { function(); }
+    template <typename Function, typename Arg>
+    static void call(QFutureInterface<void> &, Function &function, const Arg &arg)
+    { function(arg); }
+};
+
+// Calls function with the result of the parent future, if it has one.
+template <typename T>
+struct ContinuationArgument
+{
+    template <typename R, typename Function>
+    static bool call(QFutureInterface<R> &promise, Function &function, QFutureInterface<T> &parent)
+    {
+        if (!parent.isResultReadyAt(0))
+            return false;
+        ContinuationCall<R>::call(promise, function, parent.resultReference(0));
+        return true;
+    }
+    static void forward(QFutureInterface<T> &promise, QFutureInterface<T> &parent)
+    {
+        if (parent.isResultReadyAt(0))
+            promise.reportResult(parent.resultReference(0));
+    }
+};
+
+template <>
+struct ContinuationArgument<void>
+{
+    template <typename R, typename Function>
+    static bool call(QFutureInterface<R> &promise, Function &function, QFutureInterface<void> &)
+    {
+        ContinuationCall<R>::call(promise, function);
+        return true;
+    }
+    static void forward(QFutureInterface<void> &, QFutureInterface<void> &) { }
+};
+
+// A continuation that reports to the future returned by then() or onFailed().
+// If it is deleted before it could complete, that future is canceled.
+template <typename T, typename R>
+class ContinuationBase : public FutureContinuation
+{
+public:
+    ContinuationBase()
+    {
+        m_promise.reportStarted();
+    }
+    ~ContinuationBase()
+    {
+        if (!m_promise.isFinished()) {
+            m_promise.reportCanceled();
+            m_promise.reportFinished();
+        }
+    }
+
+    QFuture<R> future() { return m_promise.future(); }
+
+    void finished(const QFutureInterfaceBase &future, bool deferred) Q_DECL_OVERRIDE
+    {
+        if (deferred) {
+            // keep the result of the parent until the executor calls run()
+            m_parent.reset(new QFutureInterface<T>(future));
+        } else {
+            QFutureInterface<T> parent(future);
+            complete(parent);
+        }
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        complete(*m_parent);
+        m_parent.reset();
+    }
+
+protected:
+    virtual void complete(QFutureInterface<T> &parent) = 0;
+
+    void propagateFailure(QFutureInterface<T> &parent)
+    {
+#ifndef QT_NO_EXCEPTIONS
+        if (parent.exceptionStore().hasException()) {
+            m_promise.reportException(*parent.exceptionStore().exception().exception());
+            return;
+        }
+#endif
+        m_promise.reportCanceled();
+    }
+
+    QFutureInterface<R> m_promise;
+    QScopedPointer<QFutureInterface<T> > m_parent;
+};
+
+template <typename Function, typename T, typename R>
+class ThenContinuation : public ContinuationBase<T, R>
+{
+public:
+    explicit ThenContinuation(Function &&function)
+        : m_function(std::move(function))
+    { }
+
+protected:
+    void complete(QFutureInterface<T> &parent) Q_DECL_OVERRIDE
+    {
+        if (this->m_promise.isCanceled()) {
+            // canceled before the parent finished, don't run
+        } else if (parent.isCanceled()) {
+            this->propagateFailure(parent);
+        } else {
+#ifndef QT_NO_EXCEPTIONS
+            try {
+#endif
+                if (!ContinuationArgument<T>::call(this->m_promise, m_function, parent))
+                    this->m_promise.reportCanceled();
+#ifndef QT_NO_EXCEPTIONS
+            } catch (QException &e) {
+                this->m_promise.reportException(e);
+            } catch (...) {
+                this->m_promise.reportException(QUnhandledException());
+            }
+#endif
+        }
+        this->m_promise.reportFinished();
+    }
+
+private:
+    Function m_function;
+};
+
+#ifndef QT_NO_EXCEPTIONS
+template <typename Function, typename T>
+class FailureContinuation : public ContinuationBase<T, T>
+{
+public:
+    explicit FailureContinuation(Function &&handler)
+        : m_handler(std::move(handler))
+    { }
+
+protected:
+    void complete(QFutureInterface<T> &parent) Q_DECL_OVERRIDE
+    {
+        if (this->m_promise.isCanceled()) {
+            // canceled before the parent finished, don't run
+        } else if (parent.exceptionStore().hasException()) {
+            try {
+                ContinuationCall<T>::call(this->m_promise, m_handler,
+                                          *parent.exceptionStore().exception().exception());
+            } catch (QException &e) {
+                this->m_promise.reportException(e);
+            } catch (...) {
+                this->m_promise.reportException(QUnhandledException());
+            }
+        } else if (parent.isCanceled()) {
+            this->m_promise.reportCanceled();
+        } else {
+            ContinuationArgument<T>::forward(this->m_promise, parent);
+        }
+        this->m_promise.reportFinished();
+    }
+
+private:
+    Function m_handler;
+};
+#endif
+
+template <typename R, typename Continuation>
+QFuture<R> addContinuation(QFutureInterfaceBase &parent, Continuation *continuation,
+                           QThreadPool *pool, QObject *context)
+{
+    // the continuation may run and be deleted right away
+    QFuture<R> future = continuation->future();
+    parent.addContinuation(continuation, pool, context);
+    return future;
+}
+
+// Notifies a whenAll() or whenAny() context that one of its futures has finished.
+// A future that is destroyed without finishing counts as canceled. The context
+// only refers to the futures through these continuations, so a future that is
+// abandoned by everybody else is not kept alive by it.
+template <typename Context>
+class WhenContinuation : public FutureContinuation
+{
+public:
+    WhenContinuation(Context *context, int index)
+        : m_context(context), m_index(index)
+    { }
+    ~WhenContinuation()
+    {
+        if (m_context)
+            m_context->futureFinished(m_index, Context::FutureInterface::canceledResult());
+    }
+
+    void finished(const QFutureInterfaceBase &future, bool) Q_DECL_OVERRIDE
+    {
+        Context *context = m_context;
+        m_context = Q_NULLPTR;
+        context->futureFinished(m_index, typename Context::FutureInterface(future));
+    }
+    void run() Q_DECL_OVERRIDE { }
+
+private:
+    Context *m_context;
+    int m_index;
+};
+
+template <typename T>
+class WhenAllContext
+{
+public:
+    typedef QFutureInterface<T> FutureInterface;
+
+    explicit WhenAllContext(int count)
+        : futures(count), remaining(count)
+    {
+        promise.reportStarted();
+    }
+
+    // each index is written by one thread only, and read after the last one
+    void futureFinished(int index, FutureInterface future)
+    {
+        futures[index] = future.future();
+        if (!remaining.deref()) {
+            promise.reportResult(futures.toList());
+            promise.reportFinished();
+            delete this;
+        }
+    }
+
+    QVector<QFuture<T> > futures;
+    QAtomicInt remaining;
+    QFutureInterface<QList<QFuture<T> > > promise;
+};
+
+template <typename T>
+class WhenAnyContext
+{
+public:
+    typedef QFutureInterface<T> FutureInterface;
+
+    explicit WhenAnyContext(int count)
+        : remaining(count), done(0)
+    {
+        promise.reportStarted();
+    }
+
+    void futureFinished(int index, FutureInterface future)
+    {
+        if (done.testAndSetRelaxed(0, 1)) {
+            promise.reportResult(QtFuture::WhenAnyResult<T>(index, future.future()));
+            promise.reportFinished();
+        }
+        if (!remaining.deref())
+            delete this;
+    }
+
+    QAtomicInt remaining;
+    QAtomicInt done;
+    QFutureInterface<QtFuture::WhenAnyResult<T> > promise;
+};
+
+struct WhenContinuations
+{
+    template <typename Context, typename T>
+    static void add(Context *context, const QList<QFuture<T> > &futures)
+    {
+        for (int i = 0; i < futures.size(); ++i)
+            futures.at(i).d.addContinuation(new WhenContinuation<Context>(context, i));
+    }
+};
+
+} // namespace QtPrivate
+
+template <typename T>
+template <typename Function>
+QFuture<typename QtPrivate::ContinuationResult<Function, T>::Type> QFuture<T>::then(Function function)
+{
+    typedef typename QtPrivate::ContinuationResult<Function, T>::Type R;
+    return QtPrivate::addContinuation<R>(d, new QtPrivate::ThenContinuation<Function, T, R>(std::move(function)),
+                                         Q_NULLPTR, Q_NULLPTR);
+}
+
+template <typename T>
+template <typename Function>
+QFuture<typename QtPrivate::ContinuationResult<Function, T>::Type> QFuture<T>::then(QThreadPool *pool, Function function)
+{
+    typedef typename QtPrivate::ContinuationResult<Function, T>::Type R;
+    return QtPrivate::addContinuation<R>(d, new QtPrivate::ThenContinuation<Function, T, R>(std::move(function)),
+                                         pool, Q_NULLPTR);
+}
+
+template <typename T>
+template <typename Function>
+QFuture<typename QtPrivate::ContinuationResult<Function, T>::Type> QFuture<T>::then(QObject *context, Function function)
+{
+    typedef typename QtPrivate::ContinuationResult<Function, T>::Type R;
+    return QtPrivate::addContinuation<R>(d, new QtPrivate::ThenContinuation<Function, T, R>(std::move(function)),
+                                         Q_NULLPTR, context);
+}
+
+template <typename Function>
+QFuture<typename QtPrivate::ContinuationResult<Function, void>::Type> QFuture<void>::then(Function function)
+{
+    typedef typename QtPrivate::ContinuationResult<Function, void>::Type R;
+    return QtPrivate::addContinuation<R>(d, new QtPrivate::ThenContinuation<Function, void, R>(std::move(function)),
+                                         Q_NULLPTR, Q_NULLPTR);
+}
+
+template <typename Function>
+QFuture<typename QtPrivate::ContinuationResult<Function, void>::Type> QFuture<void>::then(QThreadPool *pool, Function function)
+{
+    typedef typename QtPrivate::ContinuationResult<Function, void>::Type R;
+    return QtPrivate::addContinuation<R>(d, new QtPrivate::ThenContinuation<Function, void, R>(std::move(function)),
+                                         pool, Q_NULLPTR);
+}
+
+template <typename Function>
+QFuture<typename QtPrivate::ContinuationResult<Function, void>::Type> QFuture<void>::then(QObject *context, Function function)
+{
+    typedef typename QtPrivate::ContinuationResult<Function, void>::Type R;
+    return QtPrivate::addContinuation<R>(d, new QtPrivate::ThenContinuation<Function, void, R>(std::move(function)),
+                                         Q_NULLPTR, context);
+}
+
+#ifndef QT_NO_EXCEPTIONS
+template <typename T>
+template <typename Function>
+QFuture<T> QFuture<T>::onFailed(Function handler)
+{
+    return QtPrivate::addContinuation<T>(d, new QtPrivate::FailureContinuation<Function, T>(std::move(handler)),
+                                         Q_NULLPTR, Q_NULLPTR);
+}
+
+template <typename Function>
+QFuture<void> QFuture<void>::onFailed(Function handler)
+{
+    return QtPrivate::addContinuation<void>(d, new QtPrivate::FailureContinuation<Function, void>(std::move(handler)),
+                                            Q_NULLPTR, Q_NULLPTR);
+}
+#endif
+
+namespace QtFuture {
+
+template <typename T>
+QFuture<QList<QFuture<T> > > whenAll(const QList<QFuture<T> > &futures)
+{
+    if (futures.isEmpty()) {
+        QFutureInterface<QList<QFuture<T> > > promise;
+        promise.reportStarted();
+        promise.reportResult(futures);
+        promise.reportFinished();
+        return promise.future();
+    }
+    QtPrivate::WhenAllContext<T> *context = new QtPrivate::WhenAllContext<T>(futures.size());
+    QFuture<QList<QFuture<T> > > future = context->promise.future();
+    QtPrivate::WhenContinuations::add(context, futures);
+    return future;
+}
+
+template <typename T>
+QFuture<WhenAnyResult<T> > whenAny(const QList<QFuture<T> > &futures)
+{
+    if (futures.isEmpty()) {
+        QFutureInterface<WhenAnyResult<T> > promise;
+        promise.reportStarted();
+        promise.reportResult(WhenAnyResult<T>());
+        promise.reportFinished();
+        return promise.future();
+    }
+    QtPrivate::WhenAnyContext<T> *context = new QtPrivate::WhenAnyContext<T>(futures.size());
+    QFuture<WhenAnyResult<T> > future = context->promise.future();
+    QtPrivate::WhenContinuations::add(context, futures);
+    return future;
+}
+
+} // namespace QtFuture
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_QFUTURE
@@ -45,7 +45,10 @@
 #include "qfutureinterface_p.h"
 
 #include <QtCore/qatomic.h>
+#include <QtCore/qmetaobject.h>
 #include <QtCore/qthread.h>
+#include <private/qmetaobject_p.h>
+#include <private/qobject_p.h>
 #include <private/qthreadpool_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -64,6 +67,34 @@ public:
     ~ThreadPoolThreadReleaser()
     { if (m_pool) m_pool->reserveThread(); }
 };
+
+// Runs a continuation from the event loop of its context object's thread.
+// The continuation is deleted with the last reference to the slot object.
+class ContinuationSlotObject : public QtPrivate::QSlotObjectBase
+{
+    QtPrivate::FutureContinuation *continuation;
+
+    static void impl(int which, QSlotObjectBase *this_, QObject *, void **, bool *)
+    {
+        ContinuationSlotObject *self = static_cast<ContinuationSlotObject *>(this_);
+        switch (which) {
+        case Destroy:
+            delete self->continuation;
+            delete self;
+            break;
+        case Call:
+            self->continuation->run();
+            break;
+        case Compare:
+        case NumOperations:
+            break;
+        }
+    }
+public:
+    explicit ContinuationSlotObject(QtPrivate::FutureContinuation *continuation)
+        : QSlotObjectBase(&impl), continuation(continuation)
+    { }
+};
 } // unnamed namespace
 
 
@@ -181,6 +212,40 @@ bool QFutureInterfaceBase::waitForNextResult()
     return d->internal_waitForNextResult();
 }
 
+// Attaches a continuation to this future and takes ownership of it. Once the
+// future has finished, or right away if it already has, the continuation is
+// run by the pool, or in the thread of the context object, or by the thread
+// that finished the future if both are null. The continuation is deleted
+// without having run if the future is destroyed before it finishes, or if the
+// context object is destroyed first.
+void QFutureInterfaceBase::addContinuation(QtPrivate::FutureContinuation *continuation,
+                                           QThreadPool *pool, QObject *context)
+{
+    QFutureInterfaceBasePrivate::Continuation c = { continuation, pool, Q_NULLPTR, Q_NULLPTR };
+    if (context) {
+        // The future may finish in any thread, where the context object could
+        // be destroyed at any time. Connect the destroyed() signal of an
+        // invoker object to the context instead: the connection is dropped
+        // safely with the context, and deleting the invoker queues the call.
+        // Our own reference keeps the continuation alive until then.
+        c.invoker = new QObject;
+        c.slotObject = new ContinuationSlotObject(continuation);
+        c.slotObject->ref();
+        static const int destroyedIndex =
+                QMetaObjectPrivate::signalIndex(QMetaMethod::fromSignal(&QObject::destroyed));
+        QObjectPrivate::connectImpl(c.invoker, destroyedIndex, context, Q_NULLPTR, c.slotObject,
+                                    Qt::QueuedConnection, Q_NULLPTR, &QObject::staticMetaObject);
+    }
+
+    QMutexLocker locker(&d->m_mutex);
+    if (!(d->state & Finished)) {
+        d->continuations.append(c);
+        return;
+    }
+    locker.unlock();
+    QFutureInterfaceBasePrivate::runContinuation(c, *this);
+}
+
 void QFutureInterfaceBase::waitForResume()
 {
     // return early if possible to avoid taking the mutex lock.
@@ -270,6 +335,17 @@ void QFutureInterfaceBase::reportFinished()
         d->state = State((d->state & ~Running) | Finished);
         d->waitCondition.wakeAll();
         d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::Finished));
+
+        if (d->continuations.isEmpty())
+            return;
+        QVector<QFutureInterfaceBasePrivate::Continuation> continuations;
+        continuations.swap(d->continuations);
+        locker.unlock();
+
+        // the continuations may release the last reference to this interface
+        const QFutureInterfaceBase self(*this);
+        for (const QFutureInterfaceBasePrivate::Continuation &continuation : qAsConst(continuations))
+            QFutureInterfaceBasePrivate::runContinuation(continuation, self);
     }
 }
 
@@ -453,6 +529,37 @@ QFutureInterfaceBasePrivate::QFutureInterfaceBasePrivate(QFutureInterfaceBase::S
     progressTime.invalidate();
 }
 
+QFutureInterfaceBasePrivate::~QFutureInterfaceBasePrivate()
+{
+    // never finished: the continuations cancel the futures they report to
+    for (const Continuation &continuation : qAsConst(continuations)) {
+        if (continuation.invoker) {
+            QObject::disconnect(continuation.invoker, Q_NULLPTR, Q_NULLPTR, Q_NULLPTR);
+            delete continuation.invoker;
+            continuation.slotObject->destroyIfLastRef();
+        } else {
+            delete continuation.continuation;
+        }
+    }
+}
+
+void QFutureInterfaceBasePrivate::runContinuation(const Continuation &c,
+                                                  const QFutureInterfaceBase &future)
+{
+    if (c.invoker) {
+        // does nothing but release the continuation if the context is gone
+        c.continuation->finished(future, true);
+        delete c.invoker;
+        c.slotObject->destroyIfLastRef();
+    } else if (c.pool) {
+        c.continuation->finished(future, true);
+        c.pool->start(c.continuation);
+    } else {
+        c.continuation->finished(future, false);
+        delete c.continuation;
+    }
+}
+
 int QFutureInterfaceBasePrivate::internal_resultCount() const
 {
     return m_results.count(); // ### subtract canceled results.
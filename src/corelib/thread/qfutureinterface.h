@@ -52,11 +52,28 @@ QT_BEGIN_NAMESPACE
 
 
 template <typename T> class QFuture;
+class QObject;
 class QThreadPool;
+class QFutureInterfaceBase;
 class QFutureInterfaceBasePrivate;
 class QFutureWatcherBase;
 class QFutureWatcherBasePrivate;
 
+namespace QtPrivate {
+
+// Work attached to a future with QFutureInterfaceBase::addContinuation().
+// finished() is called in the thread that finishes the future. If the
+// continuation was added with an executor (a thread pool or a context
+// object), run() is called afterwards by that executor; otherwise
+// finished() does all the work and run() is never called.
+class FutureContinuation : public QRunnable
+{
+public:
+    virtual void finished(const QFutureInterfaceBase &future, bool deferred) = 0;
+};
+
+} // namespace QtPrivate
+
 class Q_CORE_EXPORT QFutureInterfaceBase
 {
 public:
@@ -118,6 +135,9 @@ public:
     void waitForResult(int resultIndex);
     void waitForResume();
 
+    void addContinuation(QtPrivate::FutureContinuation *continuation,
+                         QThreadPool *pool = Q_NULLPTR, QObject *context = Q_NULLPTR);
+
     QMutex *mutex() const;
     QtPrivate::ExceptionStore &exceptionStore();
     QtPrivate::ResultStoreBase &resultStoreBase();
@@ -156,6 +176,11 @@ public:
     {
         refT();
     }
+    explicit QFutureInterface(const QFutureInterfaceBase &other) // internal
+        : QFutureInterfaceBase(other)
+    {
+        refT();
+    }
     ~QFutureInterface()
     {
         if (!derefT())
@@ -288,6 +313,9 @@ public:
     explicit QFutureInterface<void>(State initialState = NoState)
         : QFutureInterfaceBase(initialState)
     { }
+    explicit QFutureInterface<void>(const QFutureInterfaceBase &other) // internal
+        : QFutureInterfaceBase(other)
+    { }
 
     static QFutureInterface<void> canceledResult()
     { return QFutureInterface(State(Started | Finished | Canceled)); }
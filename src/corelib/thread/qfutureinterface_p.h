@@ -55,6 +55,7 @@
 #include <QtCore/qelapsedtimer.h>
 #include <QtCore/qcoreevent.h>
 #include <QtCore/qlist.h>
+#include <QtCore/qvector.h>
 #include <QtCore/qwaitcondition.h>
 #include <QtCore/qrunnable.h>
 #include <QtCore/qthreadpool.h>
@@ -128,6 +129,7 @@ class QFutureInterfaceBasePrivate
 {
 public:
     QFutureInterfaceBasePrivate(QFutureInterfaceBase::State initialState);
+    ~QFutureInterfaceBasePrivate();
 
     // When the last QFuture<T> reference is removed, we need to make
     // sure that data stored in the ResultStore is cleaned out.
@@ -173,6 +175,16 @@ public:
     QRunnable *runnable;
     QThreadPool *m_pool;
 
+    struct Continuation {
+        QtPrivate::FutureContinuation *continuation;
+        QThreadPool *pool;
+        // set for continuations with a context object: deleting the invoker
+        // queues the slot object to the context, see addContinuation()
+        QObject *invoker;
+        QtPrivate::QSlotObjectBase *slotObject;
+    };
+    QVector<Continuation> continuations;
+
     inline QThreadPool *pool() const
     { return m_pool ? m_pool : QThreadPool::globalInstance(); }
 
@@ -189,8 +201,12 @@ public:
     void disconnectOutputInterface(QFutureCallOutInterface *iface);
 
     void setState(QFutureInterfaceBase::State state);
+
+    static void runContinuation(const Continuation &continuation, const QFutureInterfaceBase &future);
 };
 
+Q_DECLARE_TYPEINFO(QFutureInterfaceBasePrivate::Continuation, Q_MOVABLE_TYPE);
+
 QT_END_NAMESPACE
 
 #endif
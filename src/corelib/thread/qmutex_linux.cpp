@@ -45,21 +45,12 @@
 #include "qatomic.h"
 #include "qmutex_p.h"
 #include "qelapsedtimer.h"
-
-#include <linux/futex.h>
-#include <sys/syscall.h>
-#include <unistd.h>
-#include <errno.h>
-#include <asm/unistd.h>
+#include "qfutex_p.h"
 
 #ifndef QT_ALWAYS_USE_FUTEX
 # error "Qt build is broken: qmutex_linux.cpp is being built but futex support is not wanted"
 #endif
 
-#ifndef FUTEX_PRIVATE_FLAG
-#  define FUTEX_PRIVATE_FLAG    0
-#endif
-
 
 QT_BEGIN_NAMESPACE
 
@@ -114,18 +105,10 @@ static bool futexAvailable()
     return true;
 }
 
-static inline int _q_futex(void *addr, int op, int val, const struct timespec *timeout) Q_DECL_NOTHROW
+static inline int _q_futex(QBasicAtomicPointer<QMutexData> *addr, int op, int val, const struct timespec *timeout) Q_DECL_NOTHROW
 {
-    volatile int *int_addr = reinterpret_cast<volatile int *>(addr);
-#if Q_BYTE_ORDER == Q_BIG_ENDIAN && QT_POINTER_SIZE == 8
-    int_addr++; //We want a pointer to the 32 least significant bit of QMutex::d
-#endif
-    int *addr2 = 0;
-    int val2 = 0;
-
-    // we use __NR_futex because some libcs (like Android's bionic) don't
-    // provide SYS_futex etc.
-    return syscall(__NR_futex, int_addr, op | FUTEX_PRIVATE_FLAG, val, timeout, addr2, val2);
+    // We want a pointer to the 32 least significant bit of QMutex::d
+    return QtLinuxFutex::_q_futex(QtLinuxFutex::addr(addr), op, val, timeout);
 }
 
 static inline QMutexData *dummyFutexValue()
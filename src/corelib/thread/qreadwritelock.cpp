@@ -48,8 +48,15 @@
 #include "qwaitcondition.h"
 #include "qreadwritelock_p.h"
 #include "qelapsedtimer.h"
+#include "qmutex_p.h"
 #include "private/qfreelist_p.h"
 
+#ifdef QT_ALWAYS_USE_FUTEX
+#include "qfutex_p.h"
+#include <limits.h>
+#include <time.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 /*
@@ -62,6 +69,20 @@ QT_BEGIN_NAMESPACE
  *    are waiting, and the lock is not recursive.
  *  - when d_ptr == 0x2: We are locked for write and nobody is waiting. (no contention)
  *  - In any other case, d_ptr points to an actual QReadWriteLockPrivate.
+ *
+ * When futexes are available (QT_ALWAYS_USE_FUTEX), a non-recursive lock never
+ * allocates a QReadWriteLockPrivate. The contended states are encoded in d_ptr as
+ * well, and the threads that have to wait sleep on its 32 least significant bits:
+ *  - d_ptr & 0x1: Locked for read. d_ptr>>15 is the number of reading threads minus 1.
+ *  - d_ptr & 0x2: Locked for write.
+ *  - d_ptr & 0x4: Some threads may be sleeping in FUTEX_WAIT.
+ *  - (d_ptr>>3) & 0xfff: The number of writers waiting for the lock. As long as it is
+ *    not 0, readers do not get the lock, so that writers are not starved.
+ * 0x4 is always set when writers are waiting, so the three least significant bits are
+ * never all 0 unless d_ptr is 0x0. Recursive locks still point to their
+ * QReadWriteLockPrivate, which is at least 8-byte aligned.
+ * Readers sleep with the ReaderBitset and writers with the WriterBitset, so that
+ * unlock() can wake a single writer when there is one, or all readers otherwise.
  */
 
 namespace {
@@ -69,11 +90,174 @@ enum {
     StateMask = 0x3,
     StateLockedForRead = 0x1,
     StateLockedForWrite = 0x2,
+#ifdef QT_ALWAYS_USE_FUTEX
+    StateWaiters = 0x4,
+    FutexStateMask = 0x7,
+    WriterWaitingIncrement = 0x8,
+    WritersWaitingMask = 0x7ff8,
+    ReaderIncrement = 0x8000,
+    ReaderBitset = 0x1,
+    WriterBitset = 0x2,
+#endif
 };
 const auto dummyLockedForRead = reinterpret_cast<QReadWriteLockPrivate *>(quintptr(StateLockedForRead));
 const auto dummyLockedForWrite = reinterpret_cast<QReadWriteLockPrivate *>(quintptr(StateLockedForWrite));
 inline bool isUncontendedLocked(const QReadWriteLockPrivate *d)
 { return quintptr(d) & StateMask; }
+
+#ifdef QT_ALWAYS_USE_FUTEX
+using namespace QtLinuxFutex;
+
+inline bool isFutexState(const QReadWriteLockPrivate *d)
+{ return !d || (quintptr(d) & FutexStateMask); }
+inline QReadWriteLockPrivate *futexState(quintptr state)
+{ return reinterpret_cast<QReadWriteLockPrivate *>(state); }
+
+const timespec *futexDeadline(int timeout, timespec *ts)
+{
+    if (timeout < 0)
+        return nullptr;
+    // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC time
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += timeout / 1000;
+    ts->tv_nsec += (timeout % 1000) * 1000 * 1000;
+    if (ts->tv_nsec >= 1000 * 1000 * 1000) {
+        ++ts->tv_sec;
+        ts->tv_nsec -= 1000 * 1000 * 1000;
+    }
+    return ts;
+}
+
+// returns false if the deadline has expired
+bool futexWait(QAtomicPointer<QReadWriteLockPrivate> &d_ptr, quintptr expected, int bitset,
+               const timespec *deadline)
+{
+    int r = _q_futex(addr(&d_ptr), FUTEX_WAIT_BITSET, int(quint32(expected)), deadline, 0, bitset);
+    return r == 0 || errno != ETIMEDOUT;
+}
+
+// Called after the lock was released by a state that had StateWaiters set.
+// Writers have priority: wake one of them if there are any, otherwise wake everybody.
+void futexWake(QAtomicPointer<QReadWriteLockPrivate> &d_ptr, quintptr state)
+{
+    if (state & WritersWaitingMask)
+        _q_futex(addr(&d_ptr), FUTEX_WAKE_BITSET, 1, 0, 0, WriterBitset);
+    else
+        _q_futex(addr(&d_ptr), FUTEX_WAKE_BITSET, INT_MAX, 0, 0, FUTEX_BITSET_MATCH_ANY);
+}
+
+bool futexLockForRead(QAtomicPointer<QReadWriteLockPrivate> &d_ptr, QReadWriteLockPrivate *d,
+                      int timeout)
+{
+    timespec ts;
+    const timespec *deadline = futexDeadline(timeout, &ts);
+    bool expired = false;
+    while (true) {
+        quintptr state = quintptr(d);
+        if (!(state & (StateLockedForWrite | WritersWaitingMask))) {
+            // unlocked or locked for read, and no writer is waiting: just add ourselves
+            quintptr val = (state & StateLockedForRead) ? state + ReaderIncrement
+                                                        : state | StateLockedForRead;
+            Q_ASSERT_X(val > state && quint32(val) == val, "QReadWriteLock::tryLockForRead()",
+                       "Overflow in lock counter");
+            if (d_ptr.testAndSetAcquire(d, futexState(val), d))
+                return true;
+            continue;
+        }
+
+        if (timeout == 0 || expired)
+            return false;
+
+        if (!(state & StateWaiters)) {
+            state |= StateWaiters;
+            if (!d_ptr.testAndSetRelaxed(d, futexState(state), d))
+                continue;
+        }
+        expired = !futexWait(d_ptr, state, ReaderBitset, deadline);
+        d = d_ptr.load();
+    }
+}
+
+// A waiting writer gives up: it was counted in WritersWaitingMask and may
+// have consumed a wake up meant for somebody else.
+void futexStopWaitingForWrite(QAtomicPointer<QReadWriteLockPrivate> &d_ptr)
+{
+    QReadWriteLockPrivate *d = d_ptr.load();
+    quintptr val;
+    do {
+        quintptr state = quintptr(d);
+        Q_ASSERT((state & WritersWaitingMask) && (state & StateWaiters));
+        val = state - WriterWaitingIncrement;
+        if (!(val & (WritersWaitingMask | StateLockedForWrite))) {
+            // nothing keeps the readers waiting any longer, we wake them below
+            val &= ~quintptr(StateWaiters);
+        }
+    } while (!d_ptr.testAndSetRelaxed(d, futexState(val), d));
+
+    if (!(val & StateWaiters) || !(val & (StateLockedForRead | StateLockedForWrite)))
+        futexWake(d_ptr, val);
+}
+
+bool futexLockForWrite(QAtomicPointer<QReadWriteLockPrivate> &d_ptr, QReadWriteLockPrivate *d,
+                       int timeout)
+{
+    timespec ts;
+    const timespec *deadline = futexDeadline(timeout, &ts);
+    bool waiting = false; // whether we are counted in WritersWaitingMask
+    bool expired = false;
+    while (true) {
+        quintptr state = quintptr(d);
+        if (!(state & (StateLockedForRead | StateLockedForWrite))) {
+            quintptr val = state | StateLockedForWrite;
+            if (waiting)
+                val -= WriterWaitingIncrement;
+            if (d_ptr.testAndSetAcquire(d, futexState(val), d))
+                return true;
+            continue;
+        }
+
+        if (timeout == 0)
+            return false;
+        if (expired) {
+            futexStopWaitingForWrite(d_ptr);
+            return false;
+        }
+
+        quintptr val = state | StateWaiters;
+        if (!waiting) {
+            Q_ASSERT_X((state & WritersWaitingMask) != WritersWaitingMask,
+                       "QReadWriteLock::tryLockForWrite()", "Overflow in waiting writers counter");
+            val += WriterWaitingIncrement;
+        }
+        if (val != state) {
+            if (!d_ptr.testAndSetRelaxed(d, futexState(val), d))
+                continue;
+            waiting = true;
+        }
+        expired = !futexWait(d_ptr, val, WriterBitset, deadline);
+        d = d_ptr.load();
+    }
+}
+
+void futexUnlock(QAtomicPointer<QReadWriteLockPrivate> &d_ptr, QReadWriteLockPrivate *d)
+{
+    quintptr state, val;
+    do {
+        state = quintptr(d);
+        Q_ASSERT_X(state & (StateLockedForRead | StateLockedForWrite), "QReadWriteLock::unlock()",
+                   "Cannot unlock an unlocked lock");
+        if ((state & StateLockedForRead) && state >= ReaderIncrement)
+            val = state - ReaderIncrement; // not the last reader
+        else if (state & WritersWaitingMask)
+            val = state & ~quintptr(StateLockedForRead | StateLockedForWrite);
+        else
+            val = 0;
+    } while (!d_ptr.testAndSetRelease(d, futexState(val), d));
+
+    if ((state & StateWaiters) && !(val & (StateLockedForRead | StateLockedForWrite)))
+        futexWake(d_ptr, val);
+}
+#endif // QT_ALWAYS_USE_FUTEX
 }
 
 /*! \class QReadWriteLock
@@ -144,7 +328,11 @@ inline bool isUncontendedLocked(const QReadWriteLockPrivate *d)
 QReadWriteLock::QReadWriteLock(RecursionMode recursionMode)
     : d_ptr(recursionMode == Recursive ? new QReadWriteLockPrivate(true) : nullptr)
 {
+#ifdef QT_ALWAYS_USE_FUTEX
+    Q_ASSERT_X(!(quintptr(d_ptr.load()) & FutexStateMask), "QReadWriteLock::QReadWriteLock", "bad d_ptr alignment");
+#else
     Q_ASSERT_X(!(quintptr(d_ptr.load()) & StateMask), "QReadWriteLock::QReadWriteLock", "bad d_ptr alignment");
+#endif
 }
 
 /*!
@@ -156,7 +344,11 @@ QReadWriteLock::QReadWriteLock(RecursionMode recursionMode)
 QReadWriteLock::~QReadWriteLock()
 {
     auto d = d_ptr.load();
+#ifdef QT_ALWAYS_USE_FUTEX
+    if (d && isFutexState(d)) {
+#else
     if (isUncontendedLocked(d)) {
+#endif
         qWarning("QReadWriteLock: destroying locked QReadWriteLock");
         return;
     }
@@ -226,6 +418,11 @@ bool QReadWriteLock::tryLockForRead(int timeout)
     if (d_ptr.testAndSetAcquire(nullptr, dummyLockedForRead, d))
         return true;
 
+#ifdef QT_ALWAYS_USE_FUTEX
+    if (isFutexState(d))
+        return futexLockForRead(d_ptr, d, timeout);
+    return d->recursiveLockForRead(timeout);
+#else
     while (true) {
         if (d == 0) {
             if (!d_ptr.testAndSetAcquire(nullptr, dummyLockedForRead, d))
@@ -276,6 +473,7 @@ bool QReadWriteLock::tryLockForRead(int timeout)
         }
         return d->lockForRead(timeout);
     }
+#endif
 }
 
 /*!
@@ -340,6 +538,11 @@ bool QReadWriteLock::tryLockForWrite(int timeout)
     if (d_ptr.testAndSetAcquire(nullptr, dummyLockedForWrite, d))
         return true;
 
+#ifdef QT_ALWAYS_USE_FUTEX
+    if (isFutexState(d))
+        return futexLockForWrite(d_ptr, d, timeout);
+    return d->recursiveLockForWrite(timeout);
+#else
     while (true) {
         if (d == 0) {
             if (!d_ptr.testAndSetAcquire(d, dummyLockedForWrite, d))
@@ -380,6 +583,7 @@ bool QReadWriteLock::tryLockForWrite(int timeout)
         }
         return d->lockForWrite(timeout);
     }
+#endif
 }
 
 /*!
@@ -403,6 +607,13 @@ void QReadWriteLock::unlock()
             return;
         }
 
+#ifdef QT_ALWAYS_USE_FUTEX
+        if (isFutexState(d)) {
+            futexUnlock(d_ptr, d);
+            return;
+        }
+#endif
+
         if ((quintptr(d) & StateMask) == StateLockedForRead) {
             Q_ASSERT(quintptr(d) > (1U<<4)); //otherwise that would be the fast case
             // Just decrease the reader's count.
@@ -453,6 +664,10 @@ QReadWriteLock::StateForWaitCondition QReadWriteLock::stateForWaitCondition() co
 
     if (!d)
         return Unlocked;
+#ifdef QT_ALWAYS_USE_FUTEX
+    if (isFutexState(d))
+        return Unlocked;
+#endif
     if (d->writerCount > 1)
         return RecursivelyLocked;
     else if (d->writerCount == 1)
@@ -82,6 +82,7 @@ QThreadData::~QThreadData()
     thread = 0;
     delete t;
 
+    flushIncomingEvents();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -94,6 +95,44 @@ QThreadData::~QThreadData()
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+/*
+    Moves the events posted without locking postEventList.mutex into the
+    sorted list, in the order they were posted, and accounts for them in
+    the receivers' postedEvents. Events for receivers that
+    have moved to another thread in the meantime are passed on to that
+    thread. Must be called with postEventList.mutex locked.
+*/
+void QThreadData::flushIncomingEvents()
+{
+    QPostEventList::IncomingEvent *ev = postEventList.incoming.fetchAndStoreAcquire(0);
+    if (!ev)
+        return;
+
+    // the incoming events are newest first
+    QPostEventList::IncomingEvent *oldest = 0;
+    while (ev) {
+        QPostEventList::IncomingEvent *next = ev->next;
+        ev->next = oldest;
+        oldest = ev;
+        ev = next;
+    }
+
+    for (ev = oldest; ev; ) {
+        QPostEventList::IncomingEvent *next = ev->next;
+        QThreadData *data = ev->postEvent.receiver->d_func()->threadData;
+        if (data == this) {
+            ++ev->postEvent.receiver->d_func()->postedEvents;
+            postEventList.addEvent(ev->postEvent);
+            delete ev;
+        } else if (data->postEventList.pushIncomingEvent(ev)) {
+            if (QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire())
+                dispatcher->wakeUp();
+        }
+        ev = next;
+    }
+    canWait = false;
+}
+
 void QThreadData::ref()
 {
 #ifndef QT_NO_THREAD
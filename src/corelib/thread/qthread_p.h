@@ -114,10 +114,30 @@ public:
 
     QMutex mutex;
 
+    // events posted without locking the mutex, newest first; whoever locks
+    // the mutex next moves them into the list (QThreadData::flushIncomingEvents())
+    struct IncomingEvent
+    {
+        QPostEvent postEvent;
+        IncomingEvent *next;
+    };
+    QAtomicPointer<IncomingEvent> incoming;
+
     inline QPostEventList()
-        : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
+        : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0), incoming(0)
     { }
 
+    // returns \c true if there were no incoming events before, in which
+    // case the receiving thread needs to be woken up
+    bool pushIncomingEvent(IncomingEvent *ev)
+    {
+        IncomingEvent *head = incoming.loadAcquire();
+        do {
+            ev->next = head;
+        } while (!incoming.testAndSetRelease(head, ev, head));
+        return !head;
+    }
+
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
         if (isEmpty() ||
@@ -251,9 +271,12 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
+        flushIncomingEvents();
         return canWait;
     }
 
+    void flushIncomingEvents();
+
     // This class provides per-thread (by way of being a QThreadData
     // member) storage for qFlagLocation()
     class FlaggedDebugSignatures
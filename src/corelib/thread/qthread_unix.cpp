@@ -54,6 +54,9 @@
 #endif
 
 #include <private/qeventdispatcher_unix_p.h>
+#if QT_CONFIG(epoll)
+#  include <private/qeventdispatcher_epoll_p.h>
+#endif
 
 #include "qthreadstorage.h"
 
@@ -286,15 +289,21 @@ void QThreadPrivate::createEventDispatcher(QThreadData *data)
         data->eventDispatcher.storeRelease(new QEventDispatcherCoreFoundation);
     else
         data->eventDispatcher.storeRelease(new QEventDispatcherUNIX);
-#elif !defined(QT_NO_GLIB)
+#else
+#  if QT_CONFIG(epoll)
+    QEventDispatcherEpoll::TriggerMode mode;
+    if (QEventDispatcherEpoll::isRequested(&mode))
+        data->eventDispatcher.storeRelease(new QEventDispatcherEpoll(mode));
+    else
+#  endif
+#  if !defined(QT_NO_GLIB)
     if (qEnvironmentVariableIsEmpty("QT_NO_GLIB")
         && qEnvironmentVariableIsEmpty("QT_NO_THREADED_GLIB")
         && QEventDispatcherGlib::versionSupported())
         data->eventDispatcher.storeRelease(new QEventDispatcherGlib);
     else
+#  endif
         data->eventDispatcher.storeRelease(new QEventDispatcherUNIX);
-#else
-    data->eventDispatcher.storeRelease(new QEventDispatcherUNIX);
 #endif
 
     data->eventDispatcher.load()->startingUp();
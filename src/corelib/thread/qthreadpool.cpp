@@ -40,6 +40,7 @@
 #include "qthreadpool.h"
 #include "qthreadpool_p.h"
 #include "qelapsedtimer.h"
+#include <private/qtrace_p.h>
 
 #include <algorithm>
 
@@ -62,8 +63,145 @@ public:
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // runnables started from this thread in work-stealing mode; claimed
+    // from the pool on first use and handed back when the thread exits
+    QThreadPoolWorkDeque *localQueue;
 };
 
+#if defined(Q_COMPILER_THREAD_LOCAL)
+static thread_local QThreadPoolThread *currentPoolThread = 0;
+#endif
+
+void QThreadPoolPrivate::refRunnable(QRunnable *runnable)
+{
+    if (runnable->autoDelete())
+        runnable->ref.ref();
+}
+
+// returns \c true if the runnable has to be deleted
+bool QThreadPoolPrivate::derefRunnable(QRunnable *runnable)
+{
+    return runnable->autoDelete() && !runnable->ref.deref();
+}
+
+QThreadPoolInjectionQueue::QThreadPoolInjectionQueue()
+    : enqueuePos(0), dequeuePos(0)
+{
+    for (uint i = 0; i < Capacity; ++i) {
+        cells[i].sequence.store(i);
+        cells[i].runnable.store(0);
+    }
+}
+
+bool QThreadPoolInjectionQueue::enqueue(QRunnable *runnable)
+{
+    Cell *cell;
+    uint pos = enqueuePos.load();
+    for (;;) {
+        cell = &cells[pos & (Capacity - 1)];
+        const int diff = int(cell->sequence.loadAcquire() - pos);
+        if (diff == 0) {
+            if (enqueuePos.testAndSetRelaxed(pos, pos + 1, pos))
+                break;
+        } else if (diff < 0) {
+            return false; // full
+        } else {
+            pos = enqueuePos.load();
+        }
+    }
+    cell->runnable.store(runnable);
+    cell->sequence.storeRelease(pos + 1);
+    return true;
+}
+
+QRunnable *QThreadPoolInjectionQueue::dequeue()
+{
+    Cell *cell;
+    uint pos = dequeuePos.load();
+    for (;;) {
+        cell = &cells[pos & (Capacity - 1)];
+        const int diff = int(cell->sequence.loadAcquire() - (pos + 1));
+        if (diff == 0) {
+            if (dequeuePos.testAndSetRelaxed(pos, pos + 1, pos))
+                break;
+        } else if (diff < 0) {
+            return 0; // empty
+        } else {
+            pos = dequeuePos.load();
+        }
+    }
+    QRunnable *runnable = cell->runnable.load();
+    cell->sequence.storeRelease(pos + Capacity);
+    return runnable;
+}
+
+QThreadPoolWorkDeque::QThreadPoolWorkDeque()
+    : owned(false), ends(0)
+{
+    for (uint i = 0; i < Capacity; ++i)
+        cells[i].store(0);
+}
+
+// called by the owner only; returns \c false if the deque is full
+bool QThreadPoolWorkDeque::push(QRunnable *runnable)
+{
+    const uint current = ends.loadAcquire();
+    if (size(current) >= Capacity)
+        return false;
+    QAtomicPointer<QRunnable> &cell = cells[bottom(current) & (Capacity - 1)];
+    // a consumer that claimed this cell a full turn ago may not have taken
+    // its runnable out yet
+    if (cell.loadAcquire())
+        return false;
+    cell.store(runnable);
+
+    // only the owner moves the bottom, so this can only fail because of a
+    // concurrent steal
+    uint expected = current;
+    while (!ends.testAndSetOrdered(expected, pack(top(expected), bottom(current) + 1), expected))
+        ;
+    return true;
+}
+
+// called by the owner only
+QRunnable *QThreadPoolWorkDeque::pop()
+{
+    uint current = ends.loadAcquire();
+    while (size(current) > 0) {
+        const uint index = bottom(current) - 1;
+        if (ends.testAndSetOrdered(current, pack(top(current), index), current)) {
+            if (QRunnable *runnable = cells[index & (Capacity - 1)].fetchAndStoreOrdered(0))
+                return runnable;
+            current = ends.loadAcquire(); // removed in the meantime
+        }
+    }
+    return 0;
+}
+
+QRunnable *QThreadPoolWorkDeque::steal()
+{
+    uint current = ends.loadAcquire();
+    while (size(current) > 0) {
+        const uint index = top(current);
+        if (ends.testAndSetOrdered(current, pack(index + 1, bottom(current)), current)) {
+            if (QRunnable *runnable = cells[index & (Capacity - 1)].fetchAndStoreOrdered(0))
+                return runnable;
+            current = ends.loadAcquire(); // removed in the meantime
+        }
+    }
+    return 0;
+}
+
+bool QThreadPoolWorkDeque::remove(QRunnable *runnable)
+{
+    for (uint i = 0; i < Capacity; ++i) {
+        if (cells[i].testAndSetOrdered(runnable, 0))
+            return true;
+    }
+    return false;
+}
+
 /*
     QThreadPool private class.
 */
@@ -73,7 +211,7 @@ public:
     \internal
 */
 QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
-    :manager(manager), runnable(0)
+    :manager(manager), runnable(0), localQueue(0)
 { }
 
 /*
@@ -81,6 +219,9 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    currentPoolThread = this;
+#endif
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -96,6 +237,7 @@ void QThreadPoolThread::run()
 #ifndef QT_NO_EXCEPTIONS
                 try {
 #endif
+                    Q_TRACE_SCOPE(lcTraceCoreThreads, "QRunnable::run", 0);
                     r->run();
 #ifndef QT_NO_EXCEPTIONS
                 } catch (...) {
@@ -106,17 +248,23 @@ void QThreadPoolThread::run()
                     throw;
                 }
 #endif
-                locker.relock();
-
-                if (autoDelete && !--r->ref)
+                if (autoDelete && QThreadPoolPrivate::derefRunnable(r))
                     delete r;
+
+                // keep going without the pool lock while there is local
+                // or injected work
+                r = manager->takeTaskUnlocked(this);
+                if (r)
+                    continue;
+
+                locker.relock();
             }
 
             // if too many threads are active, expire this thread
             if (manager->tooManyThreadsActive())
                 break;
 
-            r = !manager->queue.isEmpty() ? manager->queue.takeFirst().first : 0;
+            r = manager->takeTask(this);
         } while (r != 0);
 
         if (manager->isExiting) {
@@ -129,18 +277,34 @@ void QThreadPoolThread::run()
         if (!expired) {
             manager->waitingThreads.enqueue(this);
             registerThreadInactive();
+            manager->updateHints();
+            // a lock-free submitter either sees needsThread set above or
+            // has published its runnable before we check here
+            if (manager->pendingStealableTasks.fetchAndAddOrdered(0) > 0) {
+                manager->waitingThreads.removeOne(this);
+                ++manager->activeThreads;
+                manager->updateHints();
+                continue;
+            }
             // wait for work, exiting after the expiry timeout is reached
             runnableReady.wait(locker.mutex(), manager->expiryTimeout);
             ++manager->activeThreads;
             if (manager->waitingThreads.removeOne(this))
                 expired = true;
+            manager->updateHints();
         }
         if (expired) {
             manager->expiredThreads.enqueue(this);
             registerThreadInactive();
+            manager->updateHints();
             break;
         }
     }
+
+    if (localQueue) {
+        manager->releaseWorkDeque(localQueue);
+        localQueue = 0;
+    }
 }
 
 void QThreadPoolThread::registerThreadInactive()
@@ -158,8 +322,24 @@ QThreadPoolPrivate:: QThreadPoolPrivate()
       expiryTimeout(30000),
       maxThreadCount(qAbs(QThread::idealThreadCount())),
       reservedThreads(0),
-      activeThreads(0)
-{ }
+      activeThreads(0),
+      workStealing(false),
+      pendingStealableTasks(0),
+      needsThread(true),
+      hasUrgentTask(false),
+      overcommitted(false),
+      workDequeCount(0)
+{
+    for (int i = 0; i < MaxWorkDeques; ++i)
+        workDeques[i].store(0);
+}
+
+QThreadPoolPrivate::~QThreadPoolPrivate()
+{
+    const int count = workDequeCount.load();
+    for (int i = 0; i < count; ++i)
+        delete workDeques[i].load();
+}
 
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
 {
@@ -175,7 +355,8 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
 
     if (waitingThreads.count() > 0) {
         // recycle an available thread
-        enqueueTask(task);
+        if (task)
+            enqueueTask(task);
         waitingThreads.takeFirst()->runnableReady.wakeOne();
         return true;
     }
@@ -187,8 +368,8 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
 
         ++activeThreads;
 
-        if (task->autoDelete())
-            ++task->ref;
+        if (task)
+            refRunnable(task);
         thread->runnable = task;
         thread->start();
         return true;
@@ -206,8 +387,7 @@ inline bool operator<(const QPair<QRunnable *, int> &p, int priority)
 
 void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
-    if (runnable->autoDelete())
-        ++runnable->ref;
+    refRunnable(runnable);
 
     // put it on the queue
     QVector<QPair<QRunnable *, int> >::const_iterator begin = queue.constBegin();
@@ -230,6 +410,12 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
     // try to push tasks on the queue to any available threads
     while (!queue.isEmpty() && tryStart(queue.constFirst().first))
         queue.removeFirst();
+
+    // and get threads going for the runnables in the work-stealing queues
+    for (int i = pendingStealableTasks.load(); i > 0 && tryStart(0); --i)
+        ;
+
+    updateHints();
 }
 
 bool QThreadPoolPrivate::tooManyThreadsActive() const
@@ -238,6 +424,160 @@ bool QThreadPoolPrivate::tooManyThreadsActive() const
     return activeThreadCount > maxThreadCount && (activeThreadCount - reservedThreads) > 1;
 }
 
+/*!
+    \internal
+    Must be called with the pool lock held after changing the queue or the
+    thread bookkeeping, so that the lock-free paths see the new state.
+*/
+void QThreadPoolPrivate::updateHints()
+{
+    // nothing reads the hints unless work stealing is, or was, in use
+    if (!workStealing.load() && pendingStealableTasks.load() <= 0)
+        return;
+
+    hasUrgentTask.store(!queue.isEmpty() && queue.constFirst().second > 0);
+    overcommitted.store(tooManyThreadsActive());
+    // ordered, pairs with the ordered increment of pendingStealableTasks in
+    // tryEnqueueStealableTask()
+    needsThread.fetchAndStoreOrdered(allThreads.isEmpty()
+                                     || !waitingThreads.isEmpty()
+                                     || activeThreadCount() < maxThreadCount);
+}
+
+/*!
+    \internal
+    Work-stealing submission path for runnables with the default priority.
+    Runnables started from one of the pool's threads go to that thread's
+    work deque, all others go to the lock-free injection queue. The pool
+    lock is only taken if a thread has to be woken up or started. Returns
+    \c false if the runnable has to go through the regular queue instead.
+*/
+bool QThreadPoolPrivate::tryEnqueueStealableTask(QRunnable *task)
+{
+    refRunnable(task);
+
+    QThreadPoolThread *thread = 0;
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    thread = currentPoolThread;
+#endif
+    if (thread && thread->manager == this && !thread->localQueue) {
+        QMutexLocker locker(&mutex);
+        thread->localQueue = claimWorkDeque();
+    }
+    if (!(thread && thread->localQueue && thread->localQueue->push(task))
+            && !injectionQueue.enqueue(task)) {
+        // full; undo the reference taken above, the caller still owns it
+        if (task->autoDelete())
+            task->ref.deref();
+        return false;
+    }
+
+    pendingStealableTasks.fetchAndAddOrdered(1);
+    if (needsThread.fetchAndAddOrdered(0)) {
+        QMutexLocker locker(&mutex);
+        if (!tryStart(0) && !waitingThreads.isEmpty())
+            waitingThreads.takeFirst()->runnableReady.wakeOne();
+        updateHints();
+    }
+    return true;
+}
+
+/*!
+    \internal
+    Must be called with the pool lock held. Returns an unowned work deque,
+    allocating a new one if needed, or 0 if all of them are in use.
+*/
+QThreadPoolWorkDeque *QThreadPoolPrivate::claimWorkDeque()
+{
+    const int count = workDequeCount.load();
+    for (int i = 0; i < count; ++i) {
+        QThreadPoolWorkDeque *deque = workDeques[i].load();
+        if (!deque->owned) {
+            deque->owned = true;
+            return deque;
+        }
+    }
+    if (count == MaxWorkDeques)
+        return 0;
+
+    QThreadPoolWorkDeque *deque = new QThreadPoolWorkDeque;
+    deque->owned = true;
+    workDeques[count].storeRelease(deque);
+    workDequeCount.storeRelease(count + 1);
+    return deque;
+}
+
+/*!
+    \internal
+    Must be called with the pool lock held. Runnables left in \a deque are
+    still stolen by the other threads.
+*/
+void QThreadPoolPrivate::releaseWorkDeque(QThreadPoolWorkDeque *deque)
+{
+    deque->owned = false;
+}
+
+/*!
+    \internal
+    Takes a runnable from \a thread's own work deque, the injection queue
+    or, failing that, from the top of the other work deques. Does not need
+    the pool lock.
+*/
+QRunnable *QThreadPoolPrivate::takeStealableTask(QThreadPoolThread *thread)
+{
+    if (pendingStealableTasks.load() <= 0)
+        return 0;
+
+    QRunnable *r = thread->localQueue ? thread->localQueue->pop() : 0;
+    if (!r)
+        r = injectionQueue.dequeue();
+    if (!r) {
+        const int count = workDequeCount.loadAcquire();
+        for (int i = 0; i < count && !r; ++i) {
+            QThreadPoolWorkDeque *victim = workDeques[i].loadAcquire();
+            if (victim != thread->localQueue)
+                r = victim->steal();
+        }
+    }
+
+    if (r)
+        pendingStealableTasks.deref();
+    return r;
+}
+
+/*!
+    \internal
+    Called by \a thread without the pool lock after finishing a runnable.
+    Returns 0 if the next runnable has to be looked up with the lock held.
+*/
+QRunnable *QThreadPoolPrivate::takeTaskUnlocked(QThreadPoolThread *thread)
+{
+    // runnables with a priority above the default, and shrinking the pool,
+    // take precedence over the work-stealing queues
+    if (hasUrgentTask.load() || overcommitted.load())
+        return 0;
+    return takeStealableTask(thread);
+}
+
+/*!
+    \internal
+    Called by \a thread with the pool lock held. Runnables in queue with a
+    priority above the default run first, then the work-stealing queues are
+    drained, then the rest of queue.
+*/
+QRunnable *QThreadPoolPrivate::takeTask(QThreadPoolThread *thread)
+{
+    QRunnable *r = 0;
+    if (!queue.isEmpty() && queue.constFirst().second > 0)
+        r = queue.takeFirst().first;
+    if (!r)
+        r = takeStealableTask(thread);
+    if (!r && !queue.isEmpty())
+        r = queue.takeFirst().first;
+    updateHints();
+    return r;
+}
+
 /*!
     \internal
 */
@@ -248,8 +588,8 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     allThreads.insert(thread.data());
     ++activeThreads;
 
-    if (runnable->autoDelete())
-        ++runnable->ref;
+    if (runnable)
+        refRunnable(runnable);
     thread->runnable = runnable;
     thread.take()->start();
 }
@@ -283,23 +623,27 @@ void QThreadPoolPrivate::reset()
     expiredThreads.clear();
 
     isExiting = false;
+    updateHints();
 }
 
 bool QThreadPoolPrivate::waitForDone(int msecs)
 {
     QMutexLocker locker(&mutex);
+    const auto isDone = [this] {
+        return queue.isEmpty() && activeThreads == 0 && pendingStealableTasks.load() <= 0;
+    };
     if (msecs < 0) {
-        while (!(queue.isEmpty() && activeThreads == 0))
+        while (!isDone())
             noActiveThreads.wait(locker.mutex());
     } else {
         QElapsedTimer timer;
         timer.start();
         int t;
-        while (!(queue.isEmpty() && activeThreads == 0) &&
+        while (!isDone() &&
                ((t = msecs - timer.elapsed()) > 0))
             noActiveThreads.wait(locker.mutex(), t);
     }
-    return queue.isEmpty() && activeThreads == 0;
+    return isDone();
 }
 
 void QThreadPoolPrivate::clear()
@@ -308,10 +652,26 @@ void QThreadPoolPrivate::clear()
     for (QVector<QPair<QRunnable *, int> >::const_iterator it = queue.constBegin();
          it != queue.constEnd(); ++it) {
         QRunnable* r = it->first;
-        if (r->autoDelete() && !--r->ref)
+        if (derefRunnable(r))
             delete r;
     }
     queue.clear();
+
+    QList<QRunnable *> stealable;
+    while (QRunnable *r = injectionQueue.dequeue())
+        stealable.append(r);
+    const int dequeCount = workDequeCount.load();
+    for (int i = 0; i < dequeCount; ++i) {
+        while (QRunnable *r = workDeques[i].load()->steal())
+            stealable.append(r);
+    }
+    for (QRunnable *r : qAsConst(stealable)) {
+        pendingStealableTasks.deref();
+        if (derefRunnable(r))
+            delete r;
+    }
+
+    updateHints();
 }
 
 /*!
@@ -331,10 +691,20 @@ bool QThreadPoolPrivate::stealRunnable(QRunnable *runnable)
         while (it != end) {
             if (it->first == runnable) {
                 queue.erase(it);
+                updateHints();
                 return true;
             }
             ++it;
         }
+
+        // runnables in the injection queue cannot be removed
+        const int dequeCount = workDequeCount.load();
+        for (int i = 0; i < dequeCount; ++i) {
+            if (workDeques[i].load()->remove(runnable)) {
+                pendingStealableTasks.deref();
+                return true;
+            }
+        }
     }
 
     return false;
@@ -350,10 +720,12 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
 {
     if (!stealRunnable(runnable))
         return;
-    const bool autoDelete = runnable->autoDelete();
-    bool del = autoDelete && !--runnable->ref;
+    bool del = derefRunnable(runnable);
 
-    runnable->run();
+    {
+        Q_TRACE_SCOPE(lcTraceCoreThreads, "QRunnable::run", 0);
+        runnable->run();
+    }
 
     if (del) {
         delete runnable;
@@ -407,6 +779,10 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
     implementing time-consuming operations that are not visible to the
     QThreadPool.
 
+    By default, all queued runnables wait in a single queue guarded by one
+    lock. On machines with many cores, setWorkStealingEnabled() gives each
+    pool thread a local queue instead; see its documentation for details.
+
     Note that QThreadPool is a low-level class for managing threads, see
     the Qt Concurrent module for higher level alternatives.
 
@@ -458,6 +834,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->workStealing.load() && d->tryEnqueueStealableTask(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
@@ -465,6 +844,7 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         if (!d->waitingThreads.isEmpty())
             d->waitingThreads.takeFirst()->runnableReady.wakeOne();
     }
+    d->updateHints();
 }
 
 /*!
@@ -495,7 +875,9 @@ bool QThreadPool::tryStart(QRunnable *runnable)
     if (d->allThreads.isEmpty() == false && d->activeThreadCount() >= d->maxThreadCount)
         return false;
 
-    return d->tryStart(runnable);
+    const bool started = d->tryStart(runnable);
+    d->updateHints();
+    return started;
 }
 
 /*! \property QThreadPool::expiryTimeout
@@ -589,6 +971,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->updateHints();
 }
 
 /*!
@@ -655,11 +1038,58 @@ void QThreadPool::cancel(QRunnable *runnable)
     Q_D(QThreadPool);
     if (!d->stealRunnable(runnable))
         return;
-    if (runnable->autoDelete() && !--runnable->ref) {
+    if (d->derefRunnable(runnable)) {
         delete runnable;
     }
 }
 
+/*!
+    \since 5.8
+
+    Returns \c true if work stealing is enabled for this thread pool.
+    The default is \c false.
+
+    \sa setWorkStealingEnabled()
+*/
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.load();
+}
+
+/*!
+    \since 5.8
+
+    Enables work stealing if \a enabled is \c true.
+
+    In work-stealing mode, each thread in the pool has a local queue.
+    Runnables that are started with the default priority from one of the
+    pool's threads, such as the sub-tasks of a Qt Concurrent algorithm,
+    are put on that thread's local queue. The thread takes the most
+    recently queued runnable first. Idle threads take the oldest
+    runnables from the other threads' queues. Runnables that are started
+    with the default priority from other threads go to a bounded queue
+    that does not take the pool lock.
+
+    Runnables with a priority above the default still run before anything
+    else, and runnables with a priority below the default run after the
+    local queues are empty. The order between runnables with the default
+    priority is not specified in this mode.
+
+    Work stealing reduces contention on the pool lock when many threads
+    start many small runnables. Only runnables that are started after
+    this call are affected.
+
+    \sa isWorkStealingEnabled(), start()
+*/
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    d->workStealing.store(enabled);
+    d->updateHints();
+}
+
 QT_END_NAMESPACE
 
 #endif
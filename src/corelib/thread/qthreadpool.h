@@ -84,6 +84,9 @@ public:
 
     void clear();
     void cancel(QRunnable *runnable);
+
+    bool isWorkStealingEnabled() const;
+    void setWorkStealingEnabled(bool enabled);
 };
 
 QT_END_NAMESPACE
@@ -52,6 +52,7 @@
 //
 //
 
+#include "QtCore/qatomic.h"
 #include "QtCore/qmutex.h"
 #include "QtCore/qwaitcondition.h"
 #include "QtCore/qset.h"
@@ -62,6 +63,64 @@
 
 QT_BEGIN_NAMESPACE
 
+/*
+    Bounded lock-free multi-producer/multi-consumer FIFO (Dmitry Vyukov's
+    algorithm). In work-stealing mode, runnables started from threads that
+    do not belong to the pool are queued here without taking the pool lock.
+*/
+class QThreadPoolInjectionQueue
+{
+public:
+    enum { Capacity = 1024 };
+
+    QThreadPoolInjectionQueue();
+
+    bool enqueue(QRunnable *runnable);
+    QRunnable *dequeue();
+
+private:
+    struct Cell {
+        QAtomicInteger<uint> sequence;
+        QAtomicPointer<QRunnable> runnable;
+    };
+
+    Cell cells[Capacity];
+    QAtomicInteger<uint> enqueuePos;
+    QAtomicInteger<uint> dequeuePos;
+};
+
+/*
+    Bounded lock-free work-stealing deque. The owning pool thread pushes and
+    pops at the bottom (LIFO), other threads steal from the top (FIFO). Both
+    ends are packed into one word, so every operation is a single
+    compare-and-swap. A consumer claims a cell by moving an end, then takes
+    the runnable out of the cell; remove() can take it out first, in which
+    case the claim yields nothing and the consumer tries again.
+*/
+class QThreadPoolWorkDeque
+{
+public:
+    enum { Capacity = 256 };
+
+    QThreadPoolWorkDeque();
+
+    bool push(QRunnable *runnable);
+    QRunnable *pop();
+    QRunnable *steal();
+    bool remove(QRunnable *runnable);
+
+    bool owned; // guarded by the pool lock
+
+private:
+    static uint top(uint ends) { return ends >> 16; }
+    static uint bottom(uint ends) { return ends & 0xffff; }
+    static uint pack(uint top, uint bottom) { return ((top & 0xffff) << 16) | (bottom & 0xffff); }
+    static int size(uint ends) { return int((bottom(ends) - top(ends)) & 0xffff); }
+
+    QAtomicInteger<uint> ends;
+    QAtomicPointer<QRunnable> cells[Capacity];
+};
+
 class QThreadPoolThread;
 class Q_CORE_EXPORT QThreadPoolPrivate : public QObjectPrivate
 {
@@ -70,6 +129,7 @@ class Q_CORE_EXPORT QThreadPoolPrivate : public QObjectPrivate
 
 public:
     QThreadPoolPrivate();
+    ~QThreadPoolPrivate();
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
@@ -78,6 +138,17 @@ public:
     void tryToStartMoreThreads();
     bool tooManyThreadsActive() const;
 
+    bool tryEnqueueStealableTask(QRunnable *task);
+    QThreadPoolWorkDeque *claimWorkDeque();
+    void releaseWorkDeque(QThreadPoolWorkDeque *deque);
+    QRunnable *takeStealableTask(QThreadPoolThread *thread);
+    QRunnable *takeTaskUnlocked(QThreadPoolThread *thread);
+    QRunnable *takeTask(QThreadPoolThread *thread);
+    void updateHints();
+
+    static void refRunnable(QRunnable *runnable);
+    static bool derefRunnable(QRunnable *runnable);
+
     void startThread(QRunnable *runnable = 0);
     void reset();
     bool waitForDone(int msecs);
@@ -97,6 +168,22 @@ public:
     int maxThreadCount;
     int reservedThreads;
     int activeThreads;
+
+    // work-stealing mode; the atomics below let the submission and worker
+    // fast paths avoid the pool lock, and are refreshed by updateHints()
+    // whenever the locked state changes
+    QAtomicInt workStealing;
+    QAtomicInt pendingStealableTasks; // runnables in the injection queue and the work deques
+    QAtomicInt needsThread;           // a submitter has to wake or start a thread
+    QAtomicInt hasUrgentTask;         // the head of queue has a priority above 0
+    QAtomicInt overcommitted;         // tooManyThreadsActive()
+    QThreadPoolInjectionQueue injectionQueue;
+
+    // the work deques of the pool threads; allocated on first use and only
+    // deleted with the pool, so thieves can scan them without the pool lock
+    enum { MaxWorkDeques = 64 };
+    QAtomicPointer<QThreadPoolWorkDeque> workDeques[MaxWorkDeques];
+    QAtomicInt workDequeCount;
 };
 
 QT_END_NAMESPACE
@@ -54,6 +54,7 @@ win32 {
     darwin {
         SOURCES += thread/qmutex_mac.cpp
     } else: linux {
+        HEADERS += thread/qfutex_p.h
         SOURCES += thread/qmutex_linux.cpp
     } else {
         SOURCES += thread/qmutex_unix.cpp
@@ -4036,7 +4036,13 @@ QByteArray &QByteArray::setNum(double n, char f, int prec)
             break;
     }
 
-    *this = QLocaleData::c()->doubleToString(n, prec, form, -1, flags).toLatin1();
+    char buf[64];
+    const int length = QLocaleData::doubleToCLocaleChars(n, prec, form, flags, buf, int(sizeof buf));
+    resize(length);
+    if (length <= int(sizeof buf))
+        memcpy(data(), buf, length);
+    else
+        QLocaleData::doubleToCLocaleChars(n, prec, form, flags, data(), length);
     return *this;
 }
 
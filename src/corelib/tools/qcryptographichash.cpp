@@ -40,6 +40,8 @@
 
 #include <qcryptographichash.h>
 #include <qiodevice.h>
+#include <qvector.h>
+#include <private/qsimd_p.h>
 
 #include "../../3rdparty/sha1/sha1.cpp"
 
@@ -137,9 +139,10 @@ static SHA3Final * const sha3Final = Final;
 static int SHA224_256AddLength(SHA256Context *context, unsigned int length);
 static int SHA384_512AddLength(SHA512Context *context, unsigned int length);
 
-// Sources from rfc6234, with 4 modifications:
+// Sources from rfc6234, with 5 modifications:
 // sha224-256.c - commented out 'static uint32_t addTemp;' on line 68
 // sha224-256.c - appended 'M' to the SHA224_256AddLength macro on line 70
+// sha224-256.c - appended 'Generic' to SHA224_256ProcessMessageBlock's definition on line 387
 #include "../../3rdparty/rfc6234/sha224-256.c"
 // sha384-512.c - commented out 'static uint64_t addTemp;' on line 302
 // sha384-512.c - appended 'M' to the SHA224_256AddLength macro on line 304
@@ -164,6 +167,489 @@ static inline int SHA384_512AddLength(SHA512Context *context, unsigned int lengt
 
 QT_BEGIN_NAMESPACE
 
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+static const quint32 sha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(SHA)
+// Implementations using the SHA extensions found on recent x86 CPUs. The
+// message schedule is computed four words at a time, in the same registers
+// that feed the round instructions.
+
+QT_FUNCTION_TARGET(SHA)
+static void sha1ProcessChunkShaNi(Sha1State *state, const unsigned char *buffer)
+{
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0001020304050607), Q_INT64_C(0x08090a0b0c0d0e0f));
+    const __m128i abcdSave = _mm_set_epi32(state->h0, state->h1, state->h2, state->h3);
+    const __m128i eSave = _mm_set_epi32(state->h4, 0, 0, 0);
+
+    __m128i msg[4];
+    for (int i = 0; i < 4; ++i) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + 16 * i));
+        msg[i] = _mm_shuffle_epi8(data, byteSwap);
+    }
+
+    __m128i abcd = abcdSave;
+    __m128i previousAbcd = abcdSave;
+    __m128i e = _mm_add_epi32(eSave, msg[0]);
+
+    // Four rounds per step; the round function must be an immediate, hence
+    // one loop per function. The last three lines compute words 4*i+4 to
+    // 4*i+16 of the schedule, one step each.
+#define SHA1_SHANI_STEP(i, function) \
+    do { \
+        if (i > 0) \
+            e = _mm_sha1nexte_epu32(previousAbcd, msg[i & 3]); \
+        previousAbcd = abcd; \
+        abcd = _mm_sha1rnds4_epu32(abcd, e, function); \
+        if (i >= 3 && i <= 18) \
+            msg[(i + 1) & 3] = _mm_sha1msg2_epu32(msg[(i + 1) & 3], msg[i & 3]); \
+        if (i >= 2 && i <= 17) \
+            msg[(i + 2) & 3] = _mm_xor_si128(msg[(i + 2) & 3], msg[i & 3]); \
+        if (i >= 1 && i <= 16) \
+            msg[(i + 3) & 3] = _mm_sha1msg1_epu32(msg[(i + 3) & 3], msg[i & 3]); \
+    } while (0)
+
+    for (int i = 0; i < 5; ++i)
+        SHA1_SHANI_STEP(i, 0);
+    for (int i = 5; i < 10; ++i)
+        SHA1_SHANI_STEP(i, 1);
+    for (int i = 10; i < 15; ++i)
+        SHA1_SHANI_STEP(i, 2);
+    for (int i = 15; i < 20; ++i)
+        SHA1_SHANI_STEP(i, 3);
+#undef SHA1_SHANI_STEP
+
+    e = _mm_sha1nexte_epu32(previousAbcd, eSave);
+    abcd = _mm_add_epi32(abcd, abcdSave);
+
+    state->h0 = _mm_extract_epi32(abcd, 3);
+    state->h1 = _mm_extract_epi32(abcd, 2);
+    state->h2 = _mm_extract_epi32(abcd, 1);
+    state->h3 = _mm_extract_epi32(abcd, 0);
+    state->h4 = _mm_extract_epi32(e, 3);
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+QT_FUNCTION_TARGET(SHA)
+static void sha256ProcessBlockShaNi(quint32 *hash, const unsigned char *block)
+{
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0c0d0e0f08090a0b), Q_INT64_C(0x0405060700010203));
+
+    // the round instructions want the state as ABEF and CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)), 0xb1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash + 4)), 0x1b);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+    const __m128i abefSave = state0;
+    const __m128i cdghSave = state1;
+
+    __m128i msg[4];
+    for (int i = 0; i < 4; ++i) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16 * i));
+        msg[i] = _mm_shuffle_epi8(data, byteSwap);
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        const __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sha256RoundConstants + 4 * i));
+        const __m128i wk = _mm_add_epi32(msg[i & 3], k);
+        state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+        state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0e));
+
+        // finish words 4*i+4 to 4*i+7, then start on 4*i+12 to 4*i+15
+        if (i >= 3 && i <= 14) {
+            const __m128i w7 = _mm_alignr_epi8(msg[i & 3], msg[(i + 3) & 3], 4);
+            const __m128i next = _mm_add_epi32(msg[(i + 1) & 3], w7);
+            msg[(i + 1) & 3] = _mm_sha256msg2_epu32(next, msg[i & 3]);
+        }
+        if (i >= 1 && i <= 12)
+            msg[(i + 3) & 3] = _mm_sha256msg1_epu32(msg[(i + 3) & 3], msg[i & 3]);
+    }
+
+    state0 = _mm_add_epi32(state0, abefSave);
+    state1 = _mm_add_epi32(state1, cdghSave);
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash + 4), state1);
+}
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+#endif // QT_COMPILER_SUPPORTS_HERE(SHA)
+
+static void sha1ProcessChunk(Sha1State *state, const unsigned char *buffer)
+{
+#if QT_COMPILER_SUPPORTS_HERE(SHA)
+    if (qCpuHasFeature(SHA)) {
+        sha1ProcessChunkShaNi(state, buffer);
+        return;
+    }
+#endif
+    sha1ProcessChunkGeneric(state, buffer);
+}
+
+#if !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+// Multi-buffer implementations: each 32-bit or 64-bit element of an AVX2
+// register holds the same word of a different message, so that eight
+// SHA-256 or four Keccak states are advanced with one instruction stream.
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i sha256RotateRight(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void sha256ProcessBlocksAvx2(quint32 (*state)[8], const unsigned char *const *blocks)
+{
+    __m256i w[16];
+    for (int t = 0; t < 16; ++t) {
+        w[t] = _mm256_setr_epi32(qFromBigEndian<quint32>(blocks[0] + 4 * t),
+                                 qFromBigEndian<quint32>(blocks[1] + 4 * t),
+                                 qFromBigEndian<quint32>(blocks[2] + 4 * t),
+                                 qFromBigEndian<quint32>(blocks[3] + 4 * t),
+                                 qFromBigEndian<quint32>(blocks[4] + 4 * t),
+                                 qFromBigEndian<quint32>(blocks[5] + 4 * t),
+                                 qFromBigEndian<quint32>(blocks[6] + 4 * t),
+                                 qFromBigEndian<quint32>(blocks[7] + 4 * t));
+    }
+
+    __m256i h[8];
+    for (int i = 0; i < 8; ++i)
+        h[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[i]));
+    __m256i a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+
+    for (int t = 0; t < 64; ++t) {
+        if (t >= 16) {
+            const __m256i w2 = w[(t - 2) & 15];
+            const __m256i w15 = w[(t - 15) & 15];
+            const __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(sha256RotateRight(w2, 17), sha256RotateRight(w2, 19)),
+                                                    _mm256_srli_epi32(w2, 10));
+            const __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(sha256RotateRight(w15, 7), sha256RotateRight(w15, 18)),
+                                                    _mm256_srli_epi32(w15, 3));
+            w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], sigma0),
+                                         _mm256_add_epi32(w[(t - 7) & 15], sigma1));
+        }
+
+        const __m256i bigSigma1 = _mm256_xor_si256(_mm256_xor_si256(sha256RotateRight(e, 6), sha256RotateRight(e, 11)),
+                                                   sha256RotateRight(e, 25));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(hh, bigSigma1), ch);
+        temp1 = _mm256_add_epi32(temp1, _mm256_add_epi32(w[t & 15], _mm256_set1_epi32(sha256RoundConstants[t])));
+
+        const __m256i bigSigma0 = _mm256_xor_si256(_mm256_xor_si256(sha256RotateRight(a, 2), sha256RotateRight(a, 13)),
+                                                   sha256RotateRight(a, 22));
+        const __m256i maj = _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(a, b), c), _mm256_and_si256(a, b));
+        const __m256i temp2 = _mm256_add_epi32(bigSigma0, maj);
+
+        hh = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, temp1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(temp1, temp2);
+    }
+
+    h[0] = _mm256_add_epi32(h[0], a);
+    h[1] = _mm256_add_epi32(h[1], b);
+    h[2] = _mm256_add_epi32(h[2], c);
+    h[3] = _mm256_add_epi32(h[3], d);
+    h[4] = _mm256_add_epi32(h[4], e);
+    h[5] = _mm256_add_epi32(h[5], f);
+    h[6] = _mm256_add_epi32(h[6], g);
+    h[7] = _mm256_add_epi32(h[7], hh);
+    for (int i = 0; i < 8; ++i)
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[i]), h[i]);
+}
+
+static const quint64 keccakRoundConstants[24] = {
+    Q_UINT64_C(0x0000000000000001), Q_UINT64_C(0x0000000000008082), Q_UINT64_C(0x800000000000808a),
+    Q_UINT64_C(0x8000000080008000), Q_UINT64_C(0x000000000000808b), Q_UINT64_C(0x0000000080000001),
+    Q_UINT64_C(0x8000000080008081), Q_UINT64_C(0x8000000000008009), Q_UINT64_C(0x000000000000008a),
+    Q_UINT64_C(0x0000000000000088), Q_UINT64_C(0x0000000080008009), Q_UINT64_C(0x000000008000000a),
+    Q_UINT64_C(0x000000008000808b), Q_UINT64_C(0x800000000000008b), Q_UINT64_C(0x8000000000008089),
+    Q_UINT64_C(0x8000000000008003), Q_UINT64_C(0x8000000000008002), Q_UINT64_C(0x8000000000000080),
+    Q_UINT64_C(0x000000000000800a), Q_UINT64_C(0x800000008000000a), Q_UINT64_C(0x8000000080008081),
+    Q_UINT64_C(0x8000000000008080), Q_UINT64_C(0x0000000080000001), Q_UINT64_C(0x8000000080008008)
+};
+
+// indexed by x + 5 * y
+static const int keccakRhoOffsets[25] = {
+     0,  1, 62, 28, 27,
+    36, 44,  6, 55, 20,
+     3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8,
+    18,  2, 61, 56, 14
+};
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i keccakRotateLeft(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void keccakAbsorbAvx2(quint64 (*state)[4], const unsigned char *const *blocks, int laneCount)
+{
+    __m256i a[25];
+    for (int i = 0; i < 25; ++i)
+        a[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[i]));
+    for (int i = 0; i < laneCount; ++i) {
+        const __m256i data = _mm256_set_epi64x(qFromLittleEndian<qint64>(blocks[3] + 8 * i),
+                                               qFromLittleEndian<qint64>(blocks[2] + 8 * i),
+                                               qFromLittleEndian<qint64>(blocks[1] + 8 * i),
+                                               qFromLittleEndian<qint64>(blocks[0] + 8 * i));
+        a[i] = _mm256_xor_si256(a[i], data);
+    }
+
+    for (int round = 0; round < 24; ++round) {
+        // theta
+        __m256i c[5];
+        for (int x = 0; x < 5; ++x) {
+            c[x] = _mm256_xor_si256(_mm256_xor_si256(a[x], a[x + 5]),
+                                    _mm256_xor_si256(_mm256_xor_si256(a[x + 10], a[x + 15]), a[x + 20]));
+        }
+        for (int x = 0; x < 5; ++x) {
+            const __m256i d = _mm256_xor_si256(c[(x + 4) % 5], keccakRotateLeft(c[(x + 1) % 5], 1));
+            for (int y = 0; y < 25; y += 5)
+                a[x + y] = _mm256_xor_si256(a[x + y], d);
+        }
+
+        // rho and pi
+        __m256i b[25];
+        for (int x = 0; x < 5; ++x) {
+            for (int y = 0; y < 5; ++y)
+                b[y + 5 * ((2 * x + 3 * y) % 5)] = keccakRotateLeft(a[x + 5 * y], keccakRhoOffsets[x + 5 * y]);
+        }
+
+        // chi
+        for (int y = 0; y < 25; y += 5) {
+            for (int x = 0; x < 5; ++x)
+                a[x + y] = _mm256_xor_si256(b[x + y], _mm256_andnot_si256(b[(x + 1) % 5 + y], b[(x + 2) % 5 + y]));
+        }
+
+        // iota
+        a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x(keccakRoundConstants[round]));
+    }
+
+    for (int i = 0; i < 25; ++i)
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[i]), a[i]);
+}
+
+struct Sha256Lanes
+{
+    enum { Lanes = 8, MaxBlockSize = 64 };
+
+    Sha256Lanes(const quint32 *initialHash, int hashSize)
+        : initialHash(initialHash), hashSize(hashSize), blockSize(MaxBlockSize)
+    {}
+
+    void reset(int lane)
+    {
+        for (int i = 0; i < 8; ++i)
+            state[i][lane] = initialHash[i];
+    }
+
+    void process(const unsigned char *const *blocks)
+    {
+        sha256ProcessBlocksAvx2(state, blocks);
+    }
+
+    QByteArray result(int lane) const
+    {
+        QByteArray hash(hashSize, Qt::Uninitialized);
+        for (int i = 0; i < hashSize / 4; ++i)
+            qToBigEndian(state[i][lane], hash.data() + 4 * i);
+        return hash;
+    }
+
+    int pad(unsigned char *tail, const char *data, int length, qint64 messageSize) const
+    {
+        const int blocks = length + 1 + 8 > blockSize ? 2 : 1;
+        memcpy(tail, data, length);
+        tail[length] = 0x80;
+        memset(tail + length + 1, 0, blocks * blockSize - length - 1 - 8);
+        qToBigEndian(quint64(messageSize) << 3, tail + blocks * blockSize - 8);
+        return blocks;
+    }
+
+    quint32 state[8][Lanes];
+    const quint32 *initialHash;
+    int hashSize;
+    int blockSize;
+};
+
+struct KeccakLanes
+{
+    enum { Lanes = 4, MaxBlockSize = 1152 / 8 };
+
+    KeccakLanes(int hashBits)
+        : hashSize(hashBits / 8), blockSize((1600 - 2 * hashBits) / 8)
+    {}
+
+    void reset(int lane)
+    {
+        for (int i = 0; i < 25; ++i)
+            state[i][lane] = 0;
+    }
+
+    void process(const unsigned char *const *blocks)
+    {
+        keccakAbsorbAvx2(state, blocks, blockSize / 8);
+    }
+
+    QByteArray result(int lane) const
+    {
+        QByteArray hash(hashSize, Qt::Uninitialized);
+        char *out = hash.data();
+        for (int i = 0; i < hashSize; ++i)
+            out[i] = char(state[i / 8][lane] >> (8 * (i % 8)));
+        return hash;
+    }
+
+    int pad(unsigned char *tail, const char *data, int length, qint64) const
+    {
+        memcpy(tail, data, length);
+        memset(tail + length, 0, blockSize - length);
+        tail[length] |= 0x01;
+        tail[blockSize - 1] |= 0x80;
+        return 1;
+    }
+
+    quint64 state[25][Lanes];
+    int hashSize;
+    int blockSize;
+};
+
+/*
+    Feeds the messages in \a data through the lanes of \a engine, refilling a
+    lane with the next message as soon as the previous one has been padded and
+    absorbed. Lanes without a message left process a block of zeroes whose
+    result is never read.
+*/
+template <typename Engine>
+static void hashInLanes(Engine &engine, const QVector<QByteArray> &data, QVector<QByteArray> &result)
+{
+    struct Lane {
+        const char *data;
+        int index;
+        int block;
+        int blocks;
+        int fullBlocks;
+        unsigned char tail[2 * Engine::MaxBlockSize];
+    } lanes[Engine::Lanes];
+    const unsigned char idleBlock[Engine::MaxBlockSize] = {};
+    const int blockSize = engine.blockSize;
+
+    for (Lane &lane : lanes)
+        lane.index = -1;
+    result.resize(data.size());
+
+    int next = 0;
+    for (;;) {
+        const unsigned char *blocks[Engine::Lanes];
+        bool active = false;
+        for (int i = 0; i < Engine::Lanes; ++i) {
+            Lane &lane = lanes[i];
+            if (lane.index >= 0 && lane.block == lane.blocks) {
+                result[lane.index] = engine.result(i);
+                lane.index = -1;
+            }
+            if (lane.index < 0 && next < data.size()) {
+                const QByteArray &message = data.at(next);
+                lane.data = message.constData();
+                lane.index = next++;
+                lane.block = 0;
+                lane.fullBlocks = message.size() / blockSize;
+                lane.blocks = lane.fullBlocks + engine.pad(lane.tail, lane.data + lane.fullBlocks * blockSize,
+                                                           message.size() % blockSize, message.size());
+                engine.reset(i);
+            }
+            if (lane.index < 0) {
+                blocks[i] = idleBlock;
+                continue;
+            }
+
+            active = true;
+            if (lane.block < lane.fullBlocks)
+                blocks[i] = reinterpret_cast<const unsigned char *>(lane.data) + lane.block * blockSize;
+            else
+                blocks[i] = lane.tail + (lane.block - lane.fullBlocks) * blockSize;
+            ++lane.block;
+        }
+        if (!active)
+            break;
+        engine.process(blocks);
+    }
+}
+#endif // !QT_CRYPTOGRAPHICHASH_ONLY_SHA1 && QT_COMPILER_SUPPORTS_HERE(AVX2)
+
+QT_END_NAMESPACE
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+static void SHA224_256ProcessMessageBlock(SHA256Context *context)
+{
+#if QT_COMPILER_SUPPORTS_HERE(SHA)
+    if (qCpuHasFeature(SHA)) {
+        QT_PREPEND_NAMESPACE(sha256ProcessBlockShaNi)(context->Intermediate_Hash, context->Message_Block);
+        context->Message_Block_Index = 0;
+        return;
+    }
+#endif
+    SHA224_256ProcessMessageBlockGeneric(context);
+}
+
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+
+QT_BEGIN_NAMESPACE
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+/*
+    Replaces SHA224Input() and SHA256Input() from rfc6234, which append the
+    message to the block buffer one byte at a time.
+*/
+static int sha224_256Input(SHA256Context *context, const unsigned char *data, uint length)
+{
+    if (!length)
+        return shaSuccess;
+    if (context->Computed)
+        return context->Corrupted = shaStateError;
+    if (context->Corrupted)
+        return context->Corrupted;
+
+    const quint64 oldLength = (quint64(context->Length_High) << 32) | context->Length_Low;
+    const quint64 newLength = oldLength + (quint64(length) << 3);
+    if (newLength < oldLength)
+        return context->Corrupted = shaInputTooLong;
+    context->Length_High = quint32(newLength >> 32);
+    context->Length_Low = quint32(newLength);
+
+    while (length) {
+        const uint chunk = qMin(length, uint(SHA256_Message_Block_Size - context->Message_Block_Index));
+        memcpy(context->Message_Block + context->Message_Block_Index, data, chunk);
+        context->Message_Block_Index += chunk;
+        data += chunk;
+        length -= chunk;
+        if (context->Message_Block_Index == SHA256_Message_Block_Size)
+            SHA224_256ProcessMessageBlock(context);
+    }
+    return shaSuccess;
+}
+#endif
+
 class QCryptographicHashPrivate
 {
 public:
@@ -304,10 +790,10 @@ void QCryptographicHash::addData(const char *data, int length)
         MD5Update(&d->md5Context, (const unsigned char *)data, length);
         break;
     case Sha224:
-        SHA224Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha224_256Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha256:
-        SHA256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha224_256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha384:
         SHA384Input(&d->sha384Context, reinterpret_cast<const unsigned char *>(data), length);
@@ -461,4 +947,53 @@ QByteArray QCryptographicHash::hash(const QByteArray &data, Algorithm method)
     return hash.result();
 }
 
+/*!
+  \since 5.8
+
+  Returns the hashes of each of the byte arrays in \a data using \a method,
+  in the same order.
+
+  The result is the same as calling hash() on each element, but on CPUs that
+  support it the buffers are processed in parallel, several messages per
+  instruction stream. This is most effective when hashing many buffers of
+  similar size.
+*/
+QVector<QByteArray> QCryptographicHash::hashMany(const QVector<QByteArray> &data, Algorithm method)
+{
+    QVector<QByteArray> result;
+#if !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (data.size() > 1 && qCpuHasFeature(AVX2)) {
+        switch (method) {
+        case Sha224:
+        case Sha256: {
+#if QT_COMPILER_SUPPORTS_HERE(SHA)
+            // a single stream using the SHA instructions is faster than eight lanes
+            if (qCpuHasFeature(SHA))
+                break;
+#endif
+            Sha256Lanes engine(method == Sha224 ? SHA224_H0 : SHA256_H0,
+                               method == Sha224 ? SHA224HashSize : SHA256HashSize);
+            hashInLanes(engine, data, result);
+            return result;
+        }
+        case Sha3_224:
+        case Sha3_256:
+        case Sha3_384:
+        case Sha3_512: {
+            KeccakLanes engine(method == Sha3_224 ? 224 : method == Sha3_256 ? 256 : method == Sha3_384 ? 384 : 512);
+            hashInLanes(engine, data, result);
+            return result;
+        }
+        default:
+            break;
+        }
+    }
+#endif
+
+    result.reserve(data.size());
+    for (const QByteArray &message : data)
+        result.append(hash(message, method));
+    return result;
+}
+
 QT_END_NAMESPACE
@@ -43,6 +43,7 @@
 
 #include <QtCore/qbytearray.h>
 #include <QtCore/qobjectdefs.h>
+#include <QtCore/qcontainerfwd.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -85,6 +86,7 @@ public:
     QByteArray result() const;
 
     static QByteArray hash(const QByteArray &data, Algorithm method);
+    static QVector<QByteArray> hashMany(const QVector<QByteArray> &data, Algorithm method);
 private:
     Q_DISABLE_COPY(QCryptographicHash)
     QCryptographicHashPrivate *d;
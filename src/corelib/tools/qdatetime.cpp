@@ -51,6 +51,8 @@
 #endif
 #include "qregexp.h"
 #include "qdebug.h"
+#include "qcache.h"
+#include "qmutex.h"
 #ifndef Q_OS_WIN
 #include <locale.h>
 #endif
@@ -240,6 +242,59 @@ static ParsedRfcDateTime rfcDateImpl(const QString &s)
 
     return result;
 }
+
+#if QT_CONFIG(timezone)
+namespace {
+struct ParsedFormatKey
+{
+    QString format;
+    QVariant::Type type;
+};
+
+inline bool operator==(const ParsedFormatKey &key1, const ParsedFormatKey &key2) Q_DECL_NOTHROW
+{
+    return key1.type == key2.type && key1.format == key2.format;
+}
+
+inline uint qHash(const ParsedFormatKey &key, uint seed = 0) Q_DECL_NOTHROW
+{
+    return qHash(key.format, seed) ^ uint(key.type);
+}
+} // unnamed namespace
+
+typedef QCache<ParsedFormatKey, QDateTimeParser> ParsedFormatCache;
+Q_GLOBAL_STATIC_WITH_ARGS(ParsedFormatCache, globalParsedFormatCache, (32))
+static QBasicMutex globalParsedFormatCacheMutex;
+
+/*
+    Makes \a parser ready to parse strings in \a format. Programs tend to
+    convert many strings in the same few formats, so the sections found in a
+    format are cached and copied into \a parser rather than worked out anew.
+*/
+static bool parseFormatCached(QDateTimeParser *parser, const QString &format)
+{
+    const ParsedFormatKey key = { format, parser->parserType };
+    {
+        QMutexLocker locker(&globalParsedFormatCacheMutex);
+        if (ParsedFormatCache *cache = globalParsedFormatCache()) {
+            if (const QDateTimeParser *cached = cache->object(key)) {
+                const QLocale locale = parser->defaultLocale;
+                *parser = *cached;
+                parser->defaultLocale = locale;
+                return true;
+            }
+        }
+    }
+
+    if (!parser->parseFormat(format))
+        return false;
+
+    QMutexLocker locker(&globalParsedFormatCacheMutex);
+    if (ParsedFormatCache *cache = globalParsedFormatCache())
+        cache->insert(key, new QDateTimeParser(*parser));
+    return true;
+}
+#endif // QT_CONFIG(timezone)
 #endif // QT_NO_DATESTRING
 
 // Return offset in [+-]HH:mm format
@@ -1333,7 +1388,7 @@ QDate QDate::fromString(const QString &string, const QString &format)
     QDate date;
 #if QT_CONFIG(timezone)
     QDateTimeParser dt(QVariant::Date, QDateTimeParser::FromString);
-    if (dt.parseFormat(format))
+    if (parseFormatCached(&dt, format))
         dt.fromString(string, &date, 0);
 #else
     Q_UNUSED(string);
@@ -1938,6 +1993,99 @@ static QTime fromIsoTimeString(const QStringRef &string, Qt::DateFormat format,
     return QTime(hour, minute, second, msec);
 }
 
+// Reads exactly \a count ASCII digits at \a s; returns -1 if there are not that many.
+static inline int readIsoDigits(const QChar *s, int count)
+{
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        const uint digit = uint(s[i].unicode()) - '0';
+        if (digit > 9)
+            return -1;
+        value = value * 10 + int(digit);
+    }
+    return value;
+}
+
+/*
+    Parses the common, fully specified ISO 8601 / RFC 3339 form
+    "yyyy-MM-ddTHH:mm:ss", with an optional fraction of a second and an
+    optional "Z" or "+HH:mm" designator, without allocating. Returns false for
+    any other shape, leaving it to the general code in QDateTime::fromString(),
+    whose result this matches.
+*/
+static bool fromIsoDateTimeFast(const QString &string, QDateTime *result)
+{
+    const QChar *s = string.constData();
+    const int size = string.size();
+    if (size < 19 || s[4] != QLatin1Char('-') || s[7] != QLatin1Char('-')
+            || (s[10] != QLatin1Char('T') && s[10] != QLatin1Char(' '))
+            || s[13] != QLatin1Char(':') || s[16] != QLatin1Char(':'))
+        return false;
+
+    const int year = readIsoDigits(s, 4);
+    const int month = readIsoDigits(s + 5, 2);
+    const int day = readIsoDigits(s + 8, 2);
+    int hour = readIsoDigits(s + 11, 2);
+    const int minute = readIsoDigits(s + 14, 2);
+    const int second = readIsoDigits(s + 17, 2);
+    if (year < 0 || month < 0 || day < 0 || hour < 0 || minute < 0 || second < 0)
+        return false;
+
+    int pos = 19;
+    int msec = 0;
+    if (pos < size && (s[pos] == QLatin1Char('.') || s[pos] == QLatin1Char(','))) {
+        const int fractionBegin = ++pos;
+        while (pos < size && uint(s[pos].unicode()) - '0' <= 9)
+            ++pos;
+        // like fromIsoTimeString(), only the first four digits count
+        const int digits = qMin(pos - fractionBegin, 4);
+        if (digits == 0)
+            return false;
+        const double secondFraction(readIsoDigits(s + fractionBegin, digits)
+                                    / (std::pow(double(10), digits)));
+        msec = qMin(qRound(secondFraction * 1000.0), 999);
+    }
+
+    Qt::TimeSpec spec = Qt::LocalTime;
+    int offset = 0;
+    if (pos < size) {
+        if (s[pos] == QLatin1Char('Z') && pos + 1 == size) {
+            spec = Qt::UTC;
+        } else if (s[pos] == QLatin1Char('+') || s[pos] == QLatin1Char('-')) {
+            for (int i = pos + 1; i < size; ++i) {
+                if (s[i] != QLatin1Char(':') && uint(s[i].unicode()) - '0' > 9)
+                    return false;
+            }
+            bool ok;
+            offset = fromOffsetString(QStringRef(&string, pos, size - pos), &ok);
+            if (!ok) {
+                *result = QDateTime();
+                return true;
+            }
+            spec = Qt::OffsetFromUTC;
+        } else {
+            return false;
+        }
+    }
+
+    QDate date;
+    if (year > 0)
+        date = QDate(year, month, day);
+    if (!date.isValid()) {
+        *result = QDateTime();
+        return true;
+    }
+
+    // ISO 8601 (section 4.2.3) says that 24:00 is equivalent to 00:00 the next day.
+    if (hour == 24 && minute == 0 && second == 0 && msec == 0) {
+        hour = 0;
+        date = date.addDays(1);
+    }
+    const QTime time(hour, minute, second, msec);
+    *result = time.isValid() ? QDateTime(date, time, spec, offset) : QDateTime();
+    return true;
+}
+
 /*!
     \fn QTime QTime::fromString(const QString &string, Qt::DateFormat format)
 
@@ -2038,7 +2186,7 @@ QTime QTime::fromString(const QString &string, const QString &format)
     QTime time;
 #if QT_CONFIG(timezone)
     QDateTimeParser dt(QVariant::Time, QDateTimeParser::FromString);
-    if (dt.parseFormat(format))
+    if (parseFormatCached(&dt, format))
         dt.fromString(string, 0, &time);
 #else
     Q_UNUSED(string);
@@ -4683,6 +4831,10 @@ QDateTime QDateTime::fromString(const QString& string, Qt::DateFormat format)
         if (size < 10)
             return QDateTime();
 
+        QDateTime dateTime;
+        if (fromIsoDateTimeFast(string, &dateTime))
+            return dateTime;
+
         QStringRef isoString(&string);
         Qt::TimeSpec spec = Qt::LocalTime;
 
@@ -4967,7 +5119,7 @@ QDateTime QDateTime::fromString(const QString &string, const QString &format)
     QDate date;
 
     QDateTimeParser dt(QVariant::DateTime, QDateTimeParser::FromString);
-    if (dt.parseFormat(format) && dt.fromString(string, &date, &time))
+    if (parseFormatCached(&dt, format) && dt.fromString(string, &date, &time))
         return QDateTime(date, time);
 #else
     Q_UNUSED(string);
@@ -0,0 +1,872 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define QT_FLATHASH_SSE2
+#  include <emmintrin.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+/*
+    The slots of a QFlatHash are divided into groups of 16. Each slot has
+    a control byte, which is either Empty, Deleted, or holds the lowest 7
+    bits of the hash of the key stored in the slot. A lookup compares the
+    control bytes of a whole group at once and only looks at the keys of
+    the slots whose 7 bits match.
+*/
+struct QFlatHashGroup
+{
+    enum { Width = 16 };
+    enum Control { Empty = 0x80, Deleted = 0xfe };
+
+    // a bit for each slot of the group at ctrl whose control byte is h2
+    static inline uint match(const quint8 *ctrl, quint8 h2) Q_DECL_NOTHROW
+    {
+#ifdef QT_FLATHASH_SSE2
+        const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+        return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(char(h2)))));
+#else
+        uint mask = 0;
+        for (int i = 0; i < Width; ++i)
+            mask |= uint(ctrl[i] == h2) << i;
+        return mask;
+#endif
+    }
+
+    static inline uint matchEmpty(const quint8 *ctrl) Q_DECL_NOTHROW
+    {
+        return match(ctrl, quint8(Empty));
+    }
+
+    // Empty and Deleted are the only control bytes with the high bit set
+    static inline uint matchEmptyOrDeleted(const quint8 *ctrl) Q_DECL_NOTHROW
+    {
+#ifdef QT_FLATHASH_SSE2
+        return uint(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))));
+#else
+        uint mask = 0;
+        for (int i = 0; i < Width; ++i)
+            mask |= uint(ctrl[i] >> 7) << i;
+        return mask;
+#endif
+    }
+
+    static inline bool isFull(quint8 ctrl) Q_DECL_NOTHROW { return ctrl < 0x80; }
+};
+
+} // namespace QtPrivate
+
+template <typename Key, typename T>
+struct QFlatHashNode
+{
+    Key key;
+    T value;
+
+    inline QFlatHashNode(const Key &key0, const T &value0) : key(key0), value(value0) {}
+};
+
+template <typename Key, typename T>
+class QFlatHash
+{
+    typedef QFlatHashNode<Key, T> Node;
+    typedef QtPrivate::QFlatHashGroup Group;
+
+    // the control bytes and then the nodes follow Data in the same block
+    struct Data
+    {
+        QtPrivate::RefCount ref;
+        int size;
+        int growthLeft;
+        uint seed;
+        uint capacity;
+        quint8 *ctrl;
+        Node *nodes;
+    };
+    Data *d;
+
+    enum {
+        MinimumCapacity = int(Group::Width),
+        HeaderSize = (sizeof(Data) + Group::Width - 1) & ~(Group::Width - 1)
+    };
+    static const uint NotFound = ~0u;
+
+public:
+    inline QFlatHash() Q_DECL_NOTHROW : d(Q_NULLPTR) { }
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+        : d(Q_NULLPTR)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key,T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    QFlatHash(const QFlatHash &other) : d(other.d) { if (d) d->ref.ref(); }
+    ~QFlatHash() { if (d && !d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other)
+    {
+        if (d != other.d) {
+            QFlatHash copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+#ifdef Q_COMPILER_RVALUE_REFS
+    QFlatHash(QFlatHash &&other) Q_DECL_NOTHROW : d(other.d) { other.d = Q_NULLPTR; }
+    QFlatHash &operator=(QFlatHash &&other) Q_DECL_NOTHROW
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+#endif
+    void swap(QFlatHash &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const { return d ? d->size : 0; }
+    inline int count() const { return size(); }
+    inline bool isEmpty() const { return size() == 0; }
+
+    inline int capacity() const { return d ? int(d->capacity) : 0; }
+    void reserve(int size);
+    void squeeze();
+
+    inline void detach() { if (d && d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const { return !d || !d->ref.isShared(); }
+    bool isSharedWith(const QFlatHash &other) const { return d == other.d; }
+
+    void clear() { *this = QFlatHash(); }
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const { return findIndex(key) != NotFound; }
+    int count(const Key &key) const { return contains(key) ? 1 : 0; }
+    const Key key(const T &value) const;
+    const Key key(const T &value, const Key &defaultKey) const;
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const { return value(key); }
+
+    QList<Key> keys() const;
+    QList<Key> keys(const T &value) const;
+    QList<T> values() const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        Data *d;
+        uint i;
+
+        inline iterator(Data *data, uint index) : d(data), i(index) { }
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        inline iterator() : d(Q_NULLPTR), i(0) { }
+
+        inline const Key &key() const { return d->nodes[i].key; }
+        inline T &value() const { return d->nodes[i].value; }
+        inline T &operator*() const { return d->nodes[i].value; }
+        inline T *operator->() const { return &d->nodes[i].value; }
+        inline bool operator==(const iterator &o) const { return i == o.i; }
+        inline bool operator!=(const iterator &o) const { return i != o.i; }
+
+        inline iterator &operator++() { i = nextIndex(d, i); return *this; }
+        inline iterator operator++(int) { iterator r = *this; ++*this; return r; }
+        inline iterator &operator--() { i = previousIndex(d, i); return *this; }
+        inline iterator operator--(int) { iterator r = *this; --*this; return r; }
+
+#ifndef QT_STRICT_ITERATORS
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+#endif
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        const Data *d;
+        uint i;
+
+        inline const_iterator(const Data *data, uint index) : d(data), i(index) { }
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() : d(Q_NULLPTR), i(0) { }
+#ifdef QT_STRICT_ITERATORS
+        explicit inline const_iterator(const iterator &o)
+#else
+        inline const_iterator(const iterator &o)
+#endif
+            : d(o.d), i(o.i) { }
+
+        inline const Key &key() const { return d->nodes[i].key; }
+        inline const T &value() const { return d->nodes[i].value; }
+        inline const T &operator*() const { return d->nodes[i].value; }
+        inline const T *operator->() const { return &d->nodes[i].value; }
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+
+        inline const_iterator &operator++() { i = nextIndex(d, i); return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++*this; return r; }
+        inline const_iterator &operator--() { i = previousIndex(d, i); return *this; }
+        inline const_iterator operator--(int) { const_iterator r = *this; --*this; return r; }
+    };
+    friend class const_iterator;
+
+    class key_iterator
+    {
+        const_iterator i;
+
+    public:
+        typedef typename const_iterator::iterator_category iterator_category;
+        typedef typename const_iterator::difference_type difference_type;
+        typedef Key value_type;
+        typedef const Key *pointer;
+        typedef const Key &reference;
+
+        explicit key_iterator(const_iterator o) : i(o) { }
+
+        const Key &operator*() const { return i.key(); }
+        const Key *operator->() const { return &i.key(); }
+        bool operator==(key_iterator o) const { return i == o.i; }
+        bool operator!=(key_iterator o) const { return i != o.i; }
+
+        inline key_iterator &operator++() { ++i; return *this; }
+        inline key_iterator operator++(int) { return key_iterator(i++);}
+        inline key_iterator &operator--() { --i; return *this; }
+        inline key_iterator operator--(int) { return key_iterator(i--); }
+        const_iterator base() const { return i; }
+    };
+
+    // STL style
+    inline iterator begin() { detach(); return iterator(d, firstIndex(d)); }
+    inline const_iterator begin() const { return const_iterator(d, firstIndex(d)); }
+    inline const_iterator cbegin() const { return const_iterator(d, firstIndex(d)); }
+    inline const_iterator constBegin() const { return const_iterator(d, firstIndex(d)); }
+    inline iterator end() { detach(); return iterator(d, endIndex(d)); }
+    inline const_iterator end() const { return const_iterator(d, endIndex(d)); }
+    inline const_iterator cend() const { return const_iterator(d, endIndex(d)); }
+    inline const_iterator constEnd() const { return const_iterator(d, endIndex(d)); }
+    inline key_iterator keyBegin() const { return key_iterator(begin()); }
+    inline key_iterator keyEnd() const { return key_iterator(end()); }
+
+    iterator erase(iterator it) { return erase(const_iterator(it)); }
+    iterator erase(const_iterator it);
+
+    // more Qt
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const;
+    iterator insert(const Key &key, const T &value);
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const { return isEmpty(); }
+
+private:
+    static inline quint64 hashOf(const Key &key, uint seed)
+    {
+        // qHash() of integers and pointers barely mixes the bits, spread
+        // them before splitting the hash into a group and a control byte
+        const quint64 h = quint64(qHash(key, seed)) * Q_UINT64_C(0x9e3779b97f4a7c15);
+        return h ^ (h >> 32);
+    }
+
+    static inline uint firstIndex(const Data *d) { return d ? nextIndex(d, ~0u) : 0; }
+    static inline uint endIndex(const Data *d) { return d ? d->capacity : 0; }
+    static inline uint nextIndex(const Data *d, uint i)
+    {
+        do {
+            ++i;
+        } while (i < d->capacity && !Group::isFull(d->ctrl[i]));
+        return i;
+    }
+    static inline uint previousIndex(const Data *d, uint i)
+    {
+        do {
+            --i;
+        } while (!Group::isFull(d->ctrl[i]));
+        return i;
+    }
+
+    static uint capacityForSize(int size);
+    static Data *allocateData(uint capacity, uint seed);
+    static void freeData(Data *x);
+    static uint findFirstNonFull(const Data *x, quint64 hash);
+
+    uint findIndex(const Key &key) const
+    { return d && d->size ? findIndex(key, hashOf(key, d->seed)) : NotFound; }
+    uint findIndex(const Key &key, quint64 hash) const;
+    uint findOrInsertIndex(const Key &key, quint8 *h2);
+    void insertIndex(uint i, quint8 h2);
+    void eraseIndex(uint i);
+
+    bool isValidIterator(const const_iterator &it) const Q_DECL_NOTHROW
+    { return it.d == d && it.i <= endIndex(d); }
+    void detach_helper();
+    void rehash(uint capacity);
+};
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE uint QFlatHash<Key, T>::capacityForSize(int size)
+{
+    // keep at least one slot in eight empty, lookups stop at empty slots
+    uint capacity = MinimumCapacity;
+    while (uint(size) > capacity - capacity / 8)
+        capacity *= 2;
+    return capacity;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::Data *QFlatHash<Key, T>::allocateData(uint capacity, uint seed)
+{
+    Q_ASSERT(capacity >= uint(MinimumCapacity) && (capacity & (capacity - 1)) == 0);
+    Q_STATIC_ASSERT(Q_ALIGNOF(Node) <= Group::Width);
+    Data *x = static_cast<Data *>(::malloc(HeaderSize + capacity + size_t(capacity) * sizeof(Node)));
+    Q_CHECK_PTR(x);
+    // capacity is a multiple of 16, so the nodes after the control bytes are aligned
+    x->ctrl = reinterpret_cast<quint8 *>(x) + HeaderSize;
+    x->nodes = reinterpret_cast<Node *>(x->ctrl + capacity);
+    ::memset(x->ctrl, Group::Empty, capacity);
+    x->ref.atomic.store(1);
+    x->size = 0;
+    x->growthLeft = int(capacity - capacity / 8);
+    x->seed = seed;
+    x->capacity = capacity;
+    return x;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::freeData(Data *x)
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        for (uint i = 0; i < x->capacity; ++i) {
+            if (Group::isFull(x->ctrl[i]))
+                x->nodes[i].~Node();
+        }
+    }
+    ::free(x);
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE uint QFlatHash<Key, T>::findFirstNonFull(const Data *x, quint64 hash)
+{
+    const uint groupMask = x->capacity / Group::Width - 1;
+    uint group = uint(hash >> 7) & groupMask;
+    for (uint step = 1; ; ++step) {
+        const uint mask = Group::matchEmptyOrDeleted(x->ctrl + group * Group::Width);
+        if (mask)
+            return group * Group::Width + qCountTrailingZeroBits(mask);
+        group = (group + step) & groupMask;
+    }
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE uint QFlatHash<Key, T>::findIndex(const Key &akey, quint64 hash) const
+{
+    const quint8 h2 = quint8(hash & 0x7f);
+    const uint groupMask = d->capacity / Group::Width - 1;
+    uint group = uint(hash >> 7) & groupMask;
+    // triangular probing visits every group once as the group count is a power of two
+    for (uint step = 1; ; ++step) {
+        const quint8 *ctrl = d->ctrl + group * Group::Width;
+        for (uint mask = Group::match(ctrl, h2); mask; mask &= mask - 1) {
+            const uint i = group * Group::Width + qCountTrailingZeroBits(mask);
+            if (d->nodes[i].key == akey)
+                return i;
+        }
+        if (Group::matchEmpty(ctrl))
+            return NotFound;
+        group = (group + step) & groupMask;
+    }
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE uint QFlatHash<Key, T>::findOrInsertIndex(const Key &akey, quint8 *h2)
+{
+    // Returns the index of akey, or of a free slot for it if it isn't
+    // in the hash yet; insertIndex() marks that slot as used.
+    if (d)
+        detach();
+    else
+        d = allocateData(MinimumCapacity, uint(qGlobalQHashSeed()));
+
+    const quint64 hash = hashOf(akey, d->seed);
+    *h2 = quint8(hash & 0x7f);
+    if (d->size) {
+        const uint i = findIndex(akey, hash);
+        if (i != NotFound)
+            return i;
+    }
+
+    uint i = findFirstNonFull(d, hash);
+    if (d->growthLeft == 0 && d->ctrl[i] == quint8(Group::Empty)) {
+        // only grow if the table is mostly full, rather than full of deleted slots
+        rehash(uint(d->size) * 32 <= d->capacity * 25 ? d->capacity : d->capacity * 2);
+        i = findFirstNonFull(d, hash);
+    }
+    return i;
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::insertIndex(uint i, quint8 h2)
+{
+    if (d->ctrl[i] == quint8(Group::Empty))
+        --d->growthLeft;
+    d->ctrl[i] = h2;
+    ++d->size;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::eraseIndex(uint i)
+{
+    d->nodes[i].~Node();
+    --d->size;
+    // No probe sequence runs past a group that has an empty slot, so the
+    // slot can become empty again unless its group is full.
+    const quint8 *group = d->ctrl + (i & ~uint(Group::Width - 1));
+    if (Group::matchEmpty(group)) {
+        d->ctrl[i] = Group::Empty;
+        ++d->growthLeft;
+    } else {
+        d->ctrl[i] = Group::Deleted;
+    }
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    // keep the layout, so that indexes stay valid
+    Data *x = allocateData(d->capacity, d->seed);
+    QT_TRY {
+        for (uint i = 0; i < d->capacity; ++i) {
+            if (Group::isFull(d->ctrl[i])) {
+                new (x->nodes + i) Node(d->nodes[i]);
+                x->ctrl[i] = d->ctrl[i];
+            }
+        }
+    } QT_CATCH(...) {
+        freeData(x);
+        QT_RETHROW;
+    }
+    ::memcpy(x->ctrl, d->ctrl, d->capacity);
+    x->size = d->size;
+    x->growthLeft = d->growthLeft;
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(uint capacity)
+{
+    Q_ASSERT(isDetached());
+    Data *x = allocateData(capacity, d->seed);
+    for (uint i = 0; i < d->capacity; ++i) {
+        if (!Group::isFull(d->ctrl[i]))
+            continue;
+        const quint64 hash = hashOf(d->nodes[i].key, x->seed);
+        const uint j = findFirstNonFull(x, hash);
+        if (QTypeInfo<Key>::isRelocatable && QTypeInfo<T>::isRelocatable) {
+            ::memcpy(static_cast<void *>(x->nodes + j), static_cast<const void *>(d->nodes + i), sizeof(Node));
+        } else {
+#ifdef Q_COMPILER_RVALUE_REFS
+            new (x->nodes + j) Node(std::move(d->nodes[i]));
+#else
+            new (x->nodes + j) Node(d->nodes[i]);
+#endif
+            d->nodes[i].~Node();
+        }
+        x->ctrl[j] = quint8(hash & 0x7f);
+    }
+    x->size = d->size;
+    x->growthLeft -= d->size;
+    ::free(d);
+    d = x;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    const uint capacity = capacityForSize(qMax(asize, size()));
+    if (capacity <= uint(this->capacity()))
+        return;
+    if (!d) {
+        d = allocateData(capacity, uint(qGlobalQHashSeed()));
+        return;
+    }
+    detach();
+    rehash(capacity);
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (!d)
+        return;
+    if (d->size == 0) {
+        clear();
+        return;
+    }
+    const uint capacity = capacityForSize(d->size);
+    if (capacity < d->capacity) {
+        detach();
+        rehash(capacity);
+    }
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey) const
+{
+    const uint i = findIndex(akey);
+    return i == NotFound ? T() : d->nodes[i].value;
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey, const T &adefaultValue) const
+{
+    const uint i = findIndex(akey);
+    return i == NotFound ? adefaultValue : d->nodes[i].value;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue) const
+{
+    return key(avalue, Key());
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue, const Key &defaultValue) const
+{
+    for (const_iterator i = begin(); i != end(); ++i) {
+        if (i.value() == avalue)
+            return i.key();
+    }
+    return defaultValue;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator i = begin(); i != end(); ++i)
+        res.append(i.key());
+    return res;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys(const T &avalue) const
+{
+    QList<Key> res;
+    for (const_iterator i = begin(); i != end(); ++i) {
+        if (i.value() == avalue)
+            res.append(i.key());
+    }
+    return res;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator i = begin(); i != end(); ++i)
+        res.append(i.value());
+    return res;
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &akey)
+{
+    quint8 h2;
+    const uint i = findOrInsertIndex(akey, &h2);
+    if (!Group::isFull(d->ctrl[i])) {
+        new (d->nodes + i) Node(akey, T());
+        insertIndex(i, h2);
+    }
+    return d->nodes[i].value;
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &akey,
+                                                                                  const T &avalue)
+{
+    quint8 h2;
+    const uint i = findOrInsertIndex(akey, &h2);
+    if (!Group::isFull(d->ctrl[i])) {
+        new (d->nodes + i) Node(akey, avalue);
+        insertIndex(i, h2);
+    } else {
+        d->nodes[i].value = avalue;
+    }
+    return iterator(d, i);
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &akey)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return 0;
+    detach();
+    const uint i = findIndex(akey);
+    if (i == NotFound)
+        return 0;
+    eraseIndex(i);
+    return 1;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &akey)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return T();
+    detach();
+    const uint i = findIndex(akey);
+    if (i == NotFound)
+        return T();
+    T t = d->nodes[i].value;
+    eraseIndex(i);
+    return t;
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    Q_ASSERT_X(isValidIterator(it), "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    if (it == const_iterator(end()))
+        return end();
+    // detaching keeps the layout, so the index is still valid
+    detach();
+    eraseIndex(it.i);
+    return iterator(d, nextIndex(d, it.i));
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &akey)
+{
+    detach();
+    const uint i = findIndex(akey);
+    return iterator(d, i == NotFound ? endIndex(d) : i);
+}
+
+template <typename Key, typename T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &akey) const
+{
+    const uint i = findIndex(akey);
+    return const_iterator(d, i == NotFound ? endIndex(d) : i);
+}
+
+template <typename Key, typename T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+
+    for (const_iterator it = begin(); it != end(); ++it) {
+        const const_iterator found = other.constFind(it.key());
+        if (found == other.constEnd() || !(found.value() == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class T>
+class QFlatSet
+{
+    typedef QFlatHash<T, QHashDummyValue> Hash;
+
+public:
+    inline QFlatSet() Q_DECL_NOTHROW {}
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatSet(std::initializer_list<T> list)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<T>::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(*it);
+    }
+#endif
+    // compiler-generated copy/move ctor/assignment operators are fine!
+    // compiler-generated destructor is fine!
+
+    inline void swap(QFlatSet<T> &other) Q_DECL_NOTHROW { q_hash.swap(other.q_hash); }
+
+    inline bool operator==(const QFlatSet<T> &other) const
+        { return q_hash == other.q_hash; }
+    inline bool operator!=(const QFlatSet<T> &other) const
+        { return q_hash != other.q_hash; }
+
+    inline int size() const { return q_hash.size(); }
+
+    inline bool isEmpty() const { return q_hash.isEmpty(); }
+
+    inline int capacity() const { return q_hash.capacity(); }
+    inline void reserve(int size) { q_hash.reserve(size); }
+    inline void squeeze() { q_hash.squeeze(); }
+
+    inline void detach() { q_hash.detach(); }
+    inline bool isDetached() const { return q_hash.isDetached(); }
+
+    inline void clear() { q_hash.clear(); }
+
+    inline bool remove(const T &value) { return q_hash.remove(value) != 0; }
+
+    inline bool contains(const T &value) const { return q_hash.contains(value); }
+
+    class const_iterator
+    {
+        typedef typename Hash::const_iterator HashConstIterator;
+        HashConstIterator i;
+        friend class QFlatSet<T>;
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() {}
+        inline const_iterator(HashConstIterator it) : i(it) {}
+        inline const T &operator*() const { return i.key(); }
+        inline const T *operator->() const { return &i.key(); }
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+        inline const_iterator &operator++() { ++i; return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++i; return r; }
+        inline const_iterator &operator--() { --i; return *this; }
+        inline const_iterator operator--(int) { const_iterator r = *this; --i; return r; }
+    };
+    // the values of a set can't be modified in place
+    typedef const_iterator iterator;
+
+    // STL style
+    inline const_iterator begin() const { return q_hash.begin(); }
+    inline const_iterator cbegin() const { return q_hash.begin(); }
+    inline const_iterator constBegin() const { return q_hash.constBegin(); }
+    inline const_iterator end() const { return q_hash.end(); }
+    inline const_iterator cend() const { return q_hash.end(); }
+    inline const_iterator constEnd() const { return q_hash.constEnd(); }
+
+    const_iterator erase(const_iterator i)
+    { return typename Hash::const_iterator(q_hash.erase(i.i)); }
+
+    // more Qt
+    typedef const_iterator ConstIterator;
+    inline int count() const { return q_hash.count(); }
+    inline const_iterator insert(const T &value)
+        { return static_cast<typename Hash::const_iterator>(q_hash.insert(value, QHashDummyValue())); }
+    const_iterator find(const T &value) const { return q_hash.find(value); }
+    const_iterator constFind(const T &value) const { return find(value); }
+    QList<T> values() const { return q_hash.keys(); }
+    QList<T> toList() const { return q_hash.keys(); }
+
+    // STL compatibility
+    typedef T key_type;
+    typedef T value_type;
+    typedef value_type *pointer;
+    typedef const value_type *const_pointer;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const { return isEmpty(); }
+
+    inline QFlatSet<T> &operator<<(const T &value) { insert(value); return *this; }
+
+private:
+    Hash q_hash;
+};
+
+template <class T>
+inline void swap(QFlatSet<T> &value1, QFlatSet<T> &value2) Q_DECL_NOTHROW
+{ value1.swap(value2); }
+
+template <class Key, class T>
+inline void swap(QFlatHash<Key, T> &value1, QFlatHash<Key, T> &value2) Q_DECL_NOTHROW
+{ value1.swap(value2); }
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
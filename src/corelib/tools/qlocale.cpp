@@ -2743,6 +2743,172 @@ QString QLocalePrivate::dateTimeToString(const QString &format, const QDateTime
     return result;
 }
 
+static int digitBufferSize(double d, int precision, QLocaleData::DoubleForm form)
+{
+    int bufSize = 1;
+    if (precision == QLocale::FloatingPointShortest)
+        bufSize += QLocaleData::DoubleMaxSignificant;
+    else if (form == QLocaleData::DFDecimal) // optimize for numbers between -512k and 512k
+        bufSize += ((d > (1 << 19) || d < -(1 << 19)) ? QLocaleData::DoubleMaxDigitsBeforeDecimal : 6) +
+                precision;
+    else // Add extra digit due to different interpretations of precision. Also, "nan" has to fit.
+        bufSize += qMax(2, precision) + 1;
+    return bufSize;
+}
+
+namespace {
+// Bounded writer for doubleToCLocaleChars(): counts everything, stores what fits.
+struct CLocaleCharSink
+{
+    char *out;
+    int size;
+    int pos;
+
+    void put(char c)
+    {
+        if (pos < size)
+            out[pos] = c;
+        ++pos;
+    }
+    void put(char c, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            put(c);
+    }
+    void put(const char *s, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            put(s[i]);
+    }
+};
+}
+
+/*!
+    \internal
+
+    Formats \a d using the number symbols of the C locale into the Latin-1
+    buffer \a buf of \a bufSize bytes, without allocating. \a precision,
+    \a form and \a flags have the same meaning as for doubleToString(), except
+    that ThousandsGroup and ZeroPadded are not supported.
+
+    Returns the length of the formatted number. If that is larger than
+    \a bufSize, only the first \a bufSize characters have been written and the
+    call must be repeated with a larger buffer. The result is not
+    null-terminated.
+*/
+int QLocaleData::doubleToCLocaleChars(double d, int precision, DoubleForm form,
+                                      unsigned flags, char *out, int outSize)
+{
+    Q_ASSERT(!(flags & (ThousandsGroup | ZeroPadded)));
+
+    if (precision != QLocale::FloatingPointShortest && precision < 0)
+        precision = 6;
+
+    const int bufSize = digitBufferSize(d, precision, form);
+    QVarLengthArray<char> buf(bufSize);
+    bool negative = false;
+    int length;
+    int decpt;
+    doubleToAscii(d, form, precision, buf.data(), bufSize, negative, length, decpt);
+    const char *digits = buf.constData();
+
+    const bool special = qstrncmp(digits, "inf", 3) == 0 || qstrncmp(digits, "nan", 3) == 0;
+    if (!special && isZero(d))
+        negative = false;
+
+    CLocaleCharSink sink = { out, outSize, 0 };
+    if (negative)
+        sink.put('-');
+    else if (flags & AlwaysShowSign)
+        sink.put('+');
+    else if (flags & BlankBeforePositive)
+        sink.put(' ');
+
+    const bool alwaysShowDecpt = flags & Alternate;
+    if (special) {
+        sink.put(digits, length);
+    } else {
+        PrecisionMode mode = PMDecimalDigits;
+        bool exponent = form == DFExponent;
+        if (form == DFSignificantDigits) {
+            mode = (flags & Alternate) ? PMSignificantDigits : PMChopTrailingZeros;
+
+            // Same choice of the shorter representation as in doubleToString()
+            int cutoff = precision < 0 ? 6 : precision;
+            if (precision == QLocale::FloatingPointShortest && decpt > 0) {
+                cutoff = length + 4;
+                if (decpt <= 10)
+                    ++cutoff;
+                else
+                    cutoff += decpt > 100 ? 2 : 1;
+                if (!alwaysShowDecpt && length > decpt)
+                    ++cutoff;
+            }
+            exponent = decpt != length && (decpt <= -4 || decpt > cutoff);
+        }
+
+        if (exponent) {
+            int total = length;
+            if (mode == PMDecimalDigits)
+                total = qMax(total, precision + 1);
+            else if (mode == PMSignificantDigits)
+                total = qMax(total, precision);
+
+            sink.put(digits[0]);
+            if (alwaysShowDecpt || total > 1)
+                sink.put('.');
+            sink.put(digits + 1, length - 1);
+            sink.put('0', total - length);
+
+            int exp = decpt - 1;
+            sink.put('e');
+            sink.put(exp < 0 ? '-' : '+');
+            if (exp < 0)
+                exp = -exp;
+            char expDigits[8];
+            int expLength = 0;
+            do {
+                expDigits[expLength++] = char('0' + exp % 10);
+                exp /= 10;
+            } while (exp);
+            if (flags & ZeroPadExponent && expLength < 2)
+                sink.put('0');
+            while (expLength)
+                sink.put(expDigits[--expLength]);
+        } else {
+            // digits are preceded by "0.000" when decpt < 0 and followed by
+            // zeros up to the decimal point or the requested precision.
+            const int leadingZeros = qMax(0, -decpt);
+            const int point = qMax(0, decpt);
+            int total = qMax(length + leadingZeros, point);
+            if (mode == PMDecimalDigits)
+                total = qMax(total, point + precision);
+            else if (mode == PMSignificantDigits)
+                total = qMax(total, precision);
+
+            if (point == 0)
+                sink.put('0');
+            for (int i = 0; i < total; ++i) {
+                if (i == point)
+                    sink.put('.');
+                const int j = i - leadingZeros;
+                sink.put(j >= 0 && j < length ? digits[j] : '0');
+            }
+            if (point == total && alwaysShowDecpt)
+                sink.put('.');
+        }
+    }
+
+    if (flags & CapitalEorX) {
+        const int written = qMin(sink.pos, outSize);
+        for (int i = 0; i < written; ++i) {
+            if (out[i] >= 'a' && out[i] <= 'z')
+                out[i] -= 'a' - 'A';
+        }
+    }
+    return sink.pos;
+}
+
 QString QLocaleData::doubleToString(double d, int precision, DoubleForm form,
                                     int width, unsigned flags) const
 {
@@ -2759,19 +2925,25 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
     if (width < 0)
         width = 0;
 
+    // The symbols of the C locale need no translation, so the result can be
+    // assembled in a single Latin-1 pass instead of the QString edits below.
+    if (_zero.unicode() == '0' && plus.unicode() == '+' && minus.unicode() == '-'
+            && exponential.unicode() == 'e' && decimal.unicode() == '.'
+            && !(flags & (ThousandsGroup | ZeroPadded))) {
+        char latin1[64];
+        const int length = doubleToCLocaleChars(d, precision, form, flags, latin1, int(sizeof latin1));
+        if (length <= int(sizeof latin1))
+            return QString::fromLatin1(latin1, length);
+        QVarLengthArray<char> longBuf(length);
+        doubleToCLocaleChars(d, precision, form, flags, longBuf.data(), length);
+        return QString::fromLatin1(longBuf.constData(), length);
+    }
+
     bool negative = false;
     QString num_str;
 
     int decpt;
-    int bufSize = 1;
-    if (precision == QLocale::FloatingPointShortest)
-        bufSize += DoubleMaxSignificant;
-    else if (form == DFDecimal) // optimize for numbers between -512k and 512k
-        bufSize += ((d > (1 << 19) || d < -(1 << 19)) ? DoubleMaxDigitsBeforeDecimal : 6) +
-                precision;
-    else // Add extra digit due to different interpretations of precision. Also, "nan" has to fit.
-        bufSize += qMax(2, precision) + 1;
-
+    const int bufSize = digitBufferSize(d, precision, form);
     QVarLengthArray<char> buf(bufSize);
     int length;
 
@@ -3255,11 +3427,63 @@ bool QLocaleData::validateChars(const QString &str, NumberMode numMode, QByteArr
     return true;
 }
 
+/*
+    Shortcut for numberToCLocale() when the locale uses the number symbols of
+    the C locale: input made up only of ASCII digits, signs, a decimal point
+    and exponent characters is copied through unchanged. Everything else
+    (whitespace, group separators, letters, non-ASCII) makes it give up and
+    clear \a result so that the caller can fall back to numberToCLocale().
+*/
+static bool plainNumberToCLocale(const QLocaleData *data, const QChar *str, int len,
+                                 QLocale::NumberOptions number_options,
+                                 QLocaleData::CharBuff *result)
+{
+    if (len <= 0 || (number_options & QLocale::RejectLeadingZeroInExponent)
+            || data->m_zero != '0' || data->m_decimal != '.' || data->m_exponential != 'e'
+            || data->m_plus != '+' || data->m_minus != '-')
+        return false;
+
+    result->resize(len + 1);
+    char *out = result->data();
+    bool seenDecimal = false;
+    for (int i = 0; i < len; ++i) {
+        const ushort c = str[i].unicode();
+        if (uint(c - '0') < 10u) {
+            out[i] = char(c);
+            continue;
+        }
+        switch (c) {
+        case '.':
+            // numberToCLocale() rejects a second decimal point up front
+            if (seenDecimal) {
+                result->clear();
+                return false;
+            }
+            seenDecimal = true;
+            Q_FALLTHROUGH();
+        case '+':
+        case '-':
+        case 'e':
+            out[i] = char(c);
+            break;
+        case 'E':
+            out[i] = 'e';
+            break;
+        default:
+            result->clear();
+            return false;
+        }
+    }
+    out[len] = '\0';
+    return true;
+}
+
 double QLocaleData::stringToDouble(const QChar *begin, int len, bool *ok,
                                    QLocale::NumberOptions number_options) const
 {
     CharBuff buff;
-    if (!numberToCLocale(begin, len, number_options, &buff)) {
+    if (!plainNumberToCLocale(this, begin, len, number_options, &buff)
+            && !numberToCLocale(begin, len, number_options, &buff)) {
         if (ok != 0)
             *ok = false;
         return 0.0;
@@ -3276,7 +3500,8 @@ qlonglong QLocaleData::stringToLongLong(const QChar *begin, int len, int base, b
                                         QLocale::NumberOptions number_options) const
 {
     CharBuff buff;
-    if (!numberToCLocale(begin, len, number_options, &buff)) {
+    if (!plainNumberToCLocale(this, begin, len, number_options, &buff)
+            && !numberToCLocale(begin, len, number_options, &buff)) {
         if (ok != 0)
             *ok = false;
         return 0;
@@ -3289,7 +3514,8 @@ qulonglong QLocaleData::stringToUnsLongLong(const QChar *begin, int len, int bas
                                             QLocale::NumberOptions number_options) const
 {
     CharBuff buff;
-    if (!numberToCLocale(begin, len, number_options, &buff)) {
+    if (!plainNumberToCLocale(this, begin, len, number_options, &buff)
+            && !numberToCLocale(begin, len, number_options, &buff)) {
         if (ok != 0)
             *ok = false;
         return 0;
@@ -228,6 +228,9 @@ public:
                                        int base, int width,
                                        unsigned flags);
 
+    Q_CORE_EXPORT static int doubleToCLocaleChars(double d, int precision, DoubleForm form,
+                                                  unsigned flags, char *buf, int bufSize);
+
     QString doubleToString(double d,
                            int precision = -1,
                            DoubleForm form = DFSignificantDigits,
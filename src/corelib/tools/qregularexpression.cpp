@@ -47,6 +47,7 @@
 #include <QtCore/qhashfunctions.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qvector.h>
+#include <QtCore/qvarlengtharray.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qdebug.h>
 #include <QtCore/qthreadstorage.h>
@@ -639,6 +640,74 @@ QT_BEGIN_NAMESPACE
     \sa QRegularExpression, QRegularExpressionMatch
 */
 
+/*!
+    \class QRegularExpressionMatcher
+    \inmodule QtCore
+    \reentrant
+
+    \brief The QRegularExpressionMatcher class matches a regular expression
+    repeatedly without allocating memory for every match.
+
+    \since 5.8
+
+    \ingroup tools
+
+    Every call to QRegularExpression::match() creates a new
+    QRegularExpressionMatch, which allocates the match results and keeps a
+    reference to the regular expression and the subject string. That is
+    convenient, but it can cost as much as the matching itself when a
+    pattern is matched against a large number of short strings.
+
+    A QRegularExpressionMatcher binds a QRegularExpression to the buffers the
+    matching needs, and reuses them for every call to match(). If the pattern
+    is JIT-compiled, the matcher also owns the JIT stack used for running it,
+    so it doesn't need to look up the thread-local one.
+
+    The results of the last match are available from the matcher itself,
+    through the same functions offered by QRegularExpressionMatch:
+
+    \snippet code/src_corelib_tools_qregularexpression.cpp 31
+
+    A matcher is meant to be used in tight loops by a single thread; it can't
+    be copied. Create one matcher for every thread that needs to match the
+    same regular expression.
+
+    \sa QRegularExpression, QRegularExpressionMatch, QRegularExpressionSet
+*/
+
+/*!
+    \class QRegularExpressionSet
+    \inmodule QtCore
+    \reentrant
+
+    \brief The QRegularExpressionSet class finds out which of a number of
+    regular expressions match a string.
+
+    \since 5.8
+
+    \ingroup tools
+
+    Matching many patterns against the same subject string, for instance to
+    classify lines of a log file, is done with QRegularExpressionSet by
+    adding the patterns once and then calling match() for every subject. It
+    returns the indexes of the patterns that match:
+
+    \snippet code/src_corelib_tools_qregularexpression.cpp 32
+
+    The set scans the subject string only once, checking it for validity and
+    recording the characters it contains. Most patterns contain at least one
+    character that must be present in any string they match; the patterns
+    whose characters are missing from the subject are skipped without running
+    them at all. The remaining patterns are run like a
+    QRegularExpressionMatcher does, sharing a single set of match buffers and
+    JIT stack.
+
+    Like QRegularExpressionMatcher, a set is meant to be used by a single
+    thread, and it can't be copied.
+
+    \sa QRegularExpression, QRegularExpressionMatcher
+*/
+
 
 /*!
     \enum QRegularExpression::PatternOption
@@ -835,6 +904,7 @@ struct QRegularExpressionPrivate : QSharedData
     };
 
     void optimizePattern(OptimizePatternOption option);
+    void optimizeBeforeMatch();
 
     enum CheckSubjectStringOption {
         CheckSubjectString,
@@ -892,8 +962,9 @@ struct QRegularExpressionMatchPrivate : QSharedData
     const QRegularExpression regularExpression;
     const QString subject;
     // the capturedOffsets vector contains pairs of (start, end) positions
-    // for each captured substring
-    QVector<int> capturedOffsets;
+    // for each captured substring; the inline storage avoids a second
+    // allocation for patterns with up to 9 capturing groups
+    QVarLengthArray<int, 30> capturedOffsets;
 
     const int subjectStart;
     const int subjectLength;
@@ -922,6 +993,96 @@ struct QRegularExpressionMatchIteratorPrivate : QSharedData
     const QRegularExpression::MatchOptions matchOptions;
 };
 
+/*
+    The match data and the JIT stack used by QRegularExpressionMatcher and
+    QRegularExpressionSet, which are kept from one match to the next.
+*/
+struct QRegularExpressionMatchBuffers
+{
+    QRegularExpressionMatchBuffers()
+        : jitStack(0)
+    {
+    }
+    ~QRegularExpressionMatchBuffers();
+
+    int exec(QRegularExpressionPrivate *re,
+             const ushort *subject, int length, int offset,
+             QRegularExpression::MatchType matchType,
+             QRegularExpression::MatchOptions matchOptions,
+             bool subjectChecked = false);
+
+    // the ovector used by PCRE: pairs of (start, end) positions for each
+    // captured substring, followed by PCRE's own workspace
+    QVarLengthArray<int, 30> captureOffsets;
+    pcre16_jit_stack *jitStack;
+
+private:
+    Q_DISABLE_COPY(QRegularExpressionMatchBuffers)
+};
+
+struct QRegularExpressionMatcherPrivate
+{
+    QRegularExpressionMatcherPrivate()
+        : subjectStart(0), subjectLength(0), capturedCount(0),
+          hasMatch(false), hasPartialMatch(false), isValid(false)
+    {
+    }
+
+    bool match(const QString &subject, int subjectStart, int subjectLength, int offset,
+               QRegularExpression::MatchType matchType,
+               QRegularExpression::MatchOptions matchOptions);
+
+    QRegularExpression regularExpression;
+    QString subject;
+    int subjectStart;
+    int subjectLength;
+
+    QRegularExpressionMatchBuffers buffers;
+    int capturedCount;
+
+    bool hasMatch;
+    bool hasPartialMatch;
+    bool isValid;
+};
+
+struct QRegularExpressionSetPrivate
+{
+    struct Entry {
+        QRegularExpression regularExpression;
+        // up to two code units one of which has to be in the subject
+        // for the pattern to match, or -1
+        int requiredChars[2];
+        bool caseless;
+    };
+
+    QRegularExpressionSetPrivate()
+        : valid(true)
+    {
+    }
+
+    int add(const QRegularExpression &re);
+    QVector<int> match(const QString &subject, int subjectStart, int subjectLength, int offset,
+                       QRegularExpression::MatchOptions matchOptions);
+
+    void scanSubject(const ushort *subject, int length, bool checkValidity);
+    bool hasSeen(uint c) const
+    {
+        const uint index = c < 0x100 ? c : 0x100 | (c & 0xff);
+        return seenChars[index >> 5] & (1u << (index & 31));
+    }
+    bool canMatch(const Entry &entry) const;
+
+    QVector<Entry> entries;
+    QRegularExpressionMatchBuffers buffers;
+    bool valid;
+
+    // the code units seen in the last subject: the ones above 0xff are
+    // folded on the upper half of the table
+    quint32 seenChars[512 / 32];
+    bool seenNonAscii;
+    bool subjectValid;
+};
+
 /*!
     \internal
 */
@@ -1158,6 +1319,9 @@ void QRegularExpressionPrivate::optimizePattern(OptimizePatternOption option)
 {
     Q_ASSERT(compiledPattern);
 
+    if (studyData.loadAcquire()) // already optimized, no need to lock
+        return;
+
     QMutexLocker lock(&mutex);
 
     if (studyData.load()) // already optimized
@@ -1184,6 +1348,26 @@ void QRegularExpressionPrivate::optimizePattern(OptimizePatternOption option)
     studyData.storeRelease(localStudyData);
 }
 
+/*!
+    \internal
+
+    Optimizes the pattern before performing a match, as requested by the
+    pattern options.
+*/
+void QRegularExpressionPrivate::optimizeBeforeMatch()
+{
+    if (patternOptions & QRegularExpression::DontAutomaticallyOptimizeOption)
+        return;
+
+    const OptimizePatternOption optimizePatternOption =
+            (patternOptions & QRegularExpression::OptimizeOnFirstUsageOption)
+                ? ImmediateOptimizeOption
+                : LazyOptimizeOption;
+
+    // this is mutex protected
+    optimizePattern(optimizePatternOption);
+}
+
 /*!
     \internal
 
@@ -1230,6 +1414,113 @@ static int pcre16SafeExec(const pcre16 *code, const pcre16_extra *extra,
     return result;
 }
 
+#if PCRE_MAJOR > 8 || (PCRE_MAJOR == 8 && PCRE_MINOR >= 32)
+#  define QT_PCRE_HAS_JIT_EXEC
+#endif
+
+#ifdef QT_PCRE_HAS_JIT_EXEC
+/*!
+    \internal
+
+    Returns \c true if the \a length code units at \a s are valid UTF-16,
+    that is, if every surrogate is part of a pair.
+*/
+static bool isValidUtf16(const ushort *s, int length)
+{
+    const ushort * const end = s + length;
+    while (s < end) {
+        const ushort uc = *s++;
+        if (!QChar::isSurrogate(uc))
+            continue;
+        if (!QChar::isHighSurrogate(uc) || s == end || !QChar::isLowSurrogate(*s))
+            return false;
+        ++s;
+    }
+    return true;
+}
+#endif
+
+/*!
+    \internal
+*/
+QRegularExpressionMatchBuffers::~QRegularExpressionMatchBuffers()
+{
+    if (jitStack)
+        pcre16_jit_stack_free(jitStack);
+}
+
+/*!
+    \internal
+
+    Matches the pattern of \a re against the \a length code units at \a
+    subject, starting at \a offset, and stores the captured offsets into
+    captureOffsets. Returns the result of the PCRE matching function.
+
+    If the pattern was JIT-compiled, the JIT code is called directly with the
+    JIT stack of these buffers, which is allocated on first use. \a
+    subjectChecked tells that the subject is already known to be valid UTF-16.
+*/
+int QRegularExpressionMatchBuffers::exec(QRegularExpressionPrivate *re,
+                                         const ushort *subject, int length, int offset,
+                                         QRegularExpression::MatchType matchType,
+                                         QRegularExpression::MatchOptions matchOptions,
+                                         bool subjectChecked)
+{
+    Q_ASSERT(re->compiledPattern);
+    Q_ASSERT(offset >= 0 && offset <= length);
+
+    re->optimizeBeforeMatch();
+    const pcre16_extra * const currentStudyData = re->studyData.loadAcquire();
+
+    int pcreOptions = convertToPcreOptions(matchOptions);
+
+    if (matchType == QRegularExpression::PartialPreferCompleteMatch)
+        pcreOptions |= PCRE_PARTIAL_SOFT;
+    else if (matchType == QRegularExpression::PartialPreferFirstMatch)
+        pcreOptions |= PCRE_PARTIAL_HARD;
+
+    if (subjectChecked || matchOptions & QRegularExpression::DontCheckSubjectStringMatchOption)
+        pcreOptions |= PCRE_NO_UTF16_CHECK;
+
+    // capturingCount doesn't include the implicit "0" capturing group
+    captureOffsets.resize((re->capturingCount + 1) * 3);
+    int * const ovector = captureOffsets.data();
+    const int ovecsize = captureOffsets.size();
+
+#ifdef QT_PCRE_HAS_JIT_EXEC
+    const int jitOptions = PCRE_NO_UTF16_CHECK | PCRE_PARTIAL_SOFT | PCRE_PARTIAL_HARD;
+    if (currentStudyData && (currentStudyData->flags & PCRE_EXTRA_EXECUTABLE_JIT)
+            && !(pcreOptions & ~jitOptions)) {
+        // pcre16_jit_exec doesn't check the subject like pcre16_exec does
+        if (!(pcreOptions & PCRE_NO_UTF16_CHECK)) {
+            if (!isValidUtf16(subject, length))
+                return PCRE_ERROR_BADUTF16;
+            if (offset < length && QChar::isLowSurrogate(subject[offset]))
+                return PCRE_ERROR_BADUTF16_OFFSET;
+        }
+
+        // unlike pcre16_exec, pcre16_jit_exec needs an explicit stack;
+        // this has the same size as the thread-local one used by QRegularExpression
+        if (!jitStack)
+            jitStack = pcre16_jit_stack_alloc(32*1024, 512*1024);
+
+        if (jitStack) {
+            const int result = pcre16_jit_exec(re->compiledPattern, currentStudyData,
+                                               subject, length, offset, pcreOptions,
+                                               ovector, ovecsize, jitStack);
+
+            // the match type requires a JIT mode that wasn't compiled
+            if (result != PCRE_ERROR_JIT_BADOPTION)
+                return result;
+        }
+    }
+#endif
+
+    return pcre16SafeExec(re->compiledPattern, currentStudyData,
+                          subject, length, offset, pcreOptions,
+                          ovector, ovecsize);
+}
+
 /*!
     \internal
 
@@ -1296,15 +1587,7 @@ QRegularExpressionMatchPrivate *QRegularExpressionPrivate::doMatch(const QString
                                                                               matchType, matchOptions,
                                                                               capturingCount + 1);
 
-    if (!(patternOptions & QRegularExpression::DontAutomaticallyOptimizeOption)) {
-        const OptimizePatternOption optimizePatternOption =
-                (patternOptions & QRegularExpression::OptimizeOnFirstUsageOption)
-                    ? ImmediateOptimizeOption
-                    : LazyOptimizeOption;
-
-        // this is mutex protected
-        const_cast<QRegularExpressionPrivate *>(this)->optimizePattern(optimizePatternOption);
-    }
+    const_cast<QRegularExpressionPrivate *>(this)->optimizeBeforeMatch();
 
     // work with a local copy of the study data, as we are running pcre_exec
     // potentially more than once, and we don't want to run call it
@@ -2441,6 +2724,535 @@ QRegularExpression::MatchOptions QRegularExpressionMatchIterator::matchOptions()
     return d->matchOptions;
 }
 
+/*!
+    \internal
+*/
+bool QRegularExpressionMatcherPrivate::match(const QString &subject,
+                                             int subjectStart,
+                                             int subjectLength,
+                                             int offset,
+                                             QRegularExpression::MatchType matchType,
+                                             QRegularExpression::MatchOptions matchOptions)
+{
+    this->subject = subject;
+    this->subjectStart = subjectStart;
+    this->subjectLength = subjectLength;
+    capturedCount = 0;
+    hasMatch = false;
+    hasPartialMatch = false;
+    isValid = false;
+
+    if (offset < 0)
+        offset += subjectLength;
+
+    if (offset < 0 || offset > subjectLength)
+        return false;
+
+    QRegularExpressionPrivate *re = regularExpression.d.data();
+    if (!re->compiledPattern) {
+        qWarning("QRegularExpressionMatcher::match(): called on an invalid QRegularExpression object");
+        return false;
+    }
+
+    if (matchType == QRegularExpression::NoMatch) {
+        isValid = true;
+        return false;
+    }
+
+    const int result = buffers.exec(re, subject.utf16() + subjectStart, subjectLength,
+                                    offset, matchType, matchOptions);
+
+    // result == 0 means not enough space in captureOffsets; should never happen
+    Q_ASSERT(result != 0);
+
+    if (result > 0) {
+        isValid = true;
+        hasMatch = true;
+        capturedCount = result;
+    } else {
+        hasPartialMatch = (result == PCRE_ERROR_PARTIAL);
+        isValid = (result == PCRE_ERROR_NOMATCH || result == PCRE_ERROR_PARTIAL);
+        // a partial match only reports cap(0)
+        if (hasPartialMatch)
+            capturedCount = 1;
+    }
+
+    return hasMatch;
+}
+
+/*!
+    Constructs a matcher without a regular expression; call
+    setRegularExpression() before matching.
+*/
+QRegularExpressionMatcher::QRegularExpressionMatcher()
+    : d(new QRegularExpressionMatcherPrivate)
+{
+}
+
+/*!
+    Constructs a matcher for the regular expression \a re.
+*/
+QRegularExpressionMatcher::QRegularExpressionMatcher(const QRegularExpression &re)
+    : d(new QRegularExpressionMatcherPrivate)
+{
+    setRegularExpression(re);
+}
+
+/*!
+    Destroys the matcher.
+*/
+QRegularExpressionMatcher::~QRegularExpressionMatcher()
+{
+    delete d;
+}
+
+/*!
+    Sets the regular expression to be matched to \a re, and discards the
+    results of the last match.
+
+    \sa regularExpression()
+*/
+void QRegularExpressionMatcher::setRegularExpression(const QRegularExpression &re)
+{
+    d->regularExpression = re;
+    d->regularExpression.d.data()->compilePattern();
+
+    d->subject.clear();
+    d->subjectStart = 0;
+    d->subjectLength = 0;
+    d->capturedCount = 0;
+    d->hasMatch = false;
+    d->hasPartialMatch = false;
+    d->isValid = false;
+}
+
+/*!
+    Returns the regular expression matched by this matcher.
+
+    \sa setRegularExpression()
+*/
+QRegularExpression QRegularExpressionMatcher::regularExpression() const
+{
+    return d->regularExpression;
+}
+
+/*!
+    Attempts to match the regular expression against the given \a subject
+    string, starting at the position \a offset inside the subject, using a
+    match of type \a matchType and honoring the given \a matchOptions.
+
+    Returns \c true if the regular expression matched; the results replace
+    the ones of the previous match.
+
+    \sa QRegularExpression::match(), hasMatch()
+*/
+bool QRegularExpressionMatcher::match(const QString &subject,
+                                      int offset,
+                                      QRegularExpression::MatchType matchType,
+                                      QRegularExpression::MatchOptions matchOptions)
+{
+    return d->match(subject, 0, subject.length(), offset, matchType, matchOptions);
+}
+
+/*!
+    \overload
+
+    Attempts to match the regular expression against the given \a subjectRef
+    string reference, starting at the position \a offset inside the subject,
+    using a match of type \a matchType and honoring the given \a matchOptions.
+    The offsets of the results are relative to \a subjectRef.
+*/
+bool QRegularExpressionMatcher::match(const QStringRef &subjectRef,
+                                      int offset,
+                                      QRegularExpression::MatchType matchType,
+                                      QRegularExpression::MatchOptions matchOptions)
+{
+    const QString subject = subjectRef.string() ? *subjectRef.string() : QString();
+    return d->match(subject, subjectRef.position(), subjectRef.length(), offset, matchType, matchOptions);
+}
+
+/*!
+    Returns \c true if the last match found a full match.
+
+    \sa hasPartialMatch(), QRegularExpressionMatch::hasMatch()
+*/
+bool QRegularExpressionMatcher::hasMatch() const
+{
+    return d->hasMatch;
+}
+
+/*!
+    Returns \c true if the last match found a partial match.
+
+    \sa hasMatch(), QRegularExpressionMatch::hasPartialMatch()
+*/
+bool QRegularExpressionMatcher::hasPartialMatch() const
+{
+    return d->hasPartialMatch;
+}
+
+/*!
+    Returns \c true if the last match was performed on a valid regular
+    expression and a valid subject string.
+
+    \sa QRegularExpressionMatch::isValid()
+*/
+bool QRegularExpressionMatcher::isValid() const
+{
+    return d->isValid;
+}
+
+/*!
+    Returns the index of the last capturing group that captured something in
+    the last match, including the implicit capturing group 0, or -1 if
+    there was no match.
+
+    \sa QRegularExpressionMatch::lastCapturedIndex()
+*/
+int QRegularExpressionMatcher::lastCapturedIndex() const
+{
+    return d->capturedCount - 1;
+}
+
+/*!
+    Returns the substring captured by the \a nth capturing group in the last
+    match. If the \a nth capturing group did not capture a string or doesn't
+    exist, returns a null QString.
+
+    \sa capturedRef(), capturedStart(), capturedLength()
+*/
+QString QRegularExpressionMatcher::captured(int nth) const
+{
+    const int start = capturedStart(nth);
+    if (start == -1)
+        return QString();
+
+    return d->subject.mid(start + d->subjectStart, capturedLength(nth));
+}
+
+/*!
+    Returns a reference to the substring captured by the \a nth capturing
+    group in the last match. If the \a nth capturing group did not capture a
+    string or doesn't exist, returns a null QStringRef.
+
+    The reference is valid until the next call to match().
+
+    \sa captured(), capturedStart(), capturedLength()
+*/
+QStringRef QRegularExpressionMatcher::capturedRef(int nth) const
+{
+    const int start = capturedStart(nth);
+    if (start == -1)
+        return QStringRef();
+
+    return d->subject.midRef(start + d->subjectStart, capturedLength(nth));
+}
+
+/*!
+    Returns the offset inside the subject string of the start of the
+    substring captured by the \a nth capturing group in the last match, or
+    -1 if the group did not capture a string or doesn't exist.
+
+    \sa capturedEnd(), capturedLength()
+*/
+int QRegularExpressionMatcher::capturedStart(int nth) const
+{
+    if (nth < 0 || nth > lastCapturedIndex())
+        return -1;
+
+    return d->buffers.captureOffsets.at(nth * 2);
+}
+
+/*!
+    Returns the length of the substring captured by the \a nth capturing
+    group in the last match, or 0 if the group did not capture a string or
+    doesn't exist.
+
+    \sa capturedStart(), capturedEnd()
+*/
+int QRegularExpressionMatcher::capturedLength(int nth) const
+{
+    // bound checking performed by these two functions
+    return capturedEnd(nth) - capturedStart(nth);
+}
+
+/*!
+    Returns the offset inside the subject string immediately after the end
+    of the substring captured by the \a nth capturing group in the last
+    match, or -1 if the group did not capture a string or doesn't exist.
+
+    \sa capturedStart(), capturedLength()
+*/
+int QRegularExpressionMatcher::capturedEnd(int nth) const
+{
+    if (nth < 0 || nth > lastCapturedIndex())
+        return -1;
+
+    return d->buffers.captureOffsets.at(nth * 2 + 1);
+}
+
+/*!
+    \internal
+*/
+int QRegularExpressionSetPrivate::add(const QRegularExpression &re)
+{
+    Entry entry;
+    entry.regularExpression = re;
+    entry.requiredChars[0] = -1;
+    entry.requiredChars[1] = -1;
+    // inline options can turn on caseless matching for parts of the pattern
+    entry.caseless = (re.patternOptions() & QRegularExpression::CaseInsensitiveOption)
+            || re.pattern().contains(QLatin1String("(?"));
+
+    QRegularExpressionPrivate *priv = entry.regularExpression.d.data();
+    priv->compilePattern();
+
+    if (priv->compiledPattern) {
+        int flags;
+        quint32 c;
+        if (pcre16_fullinfo(priv->compiledPattern, 0, PCRE_INFO_FIRSTCHARACTERFLAGS, &flags) == 0
+                && flags == 1
+                && pcre16_fullinfo(priv->compiledPattern, 0, PCRE_INFO_FIRSTCHARACTER, &c) == 0) {
+            entry.requiredChars[0] = c;
+        }
+        if (pcre16_fullinfo(priv->compiledPattern, 0, PCRE_INFO_REQUIREDCHARFLAGS, &flags) == 0
+                && flags == 1
+                && pcre16_fullinfo(priv->compiledPattern, 0, PCRE_INFO_REQUIREDCHAR, &c) == 0) {
+            entry.requiredChars[1] = c;
+        }
+    } else {
+        valid = false;
+    }
+
+    entries.append(entry);
+    return entries.size() - 1;
+}
+
+/*!
+    \internal
+
+    Records which code units appear in the \a length code units at \a
+    subject, and checks them for being valid UTF-16 if \a checkValidity is
+    true.
+*/
+void QRegularExpressionSetPrivate::scanSubject(const ushort *subject, int length, bool checkValidity)
+{
+    memset(seenChars, 0, sizeof(seenChars));
+    subjectValid = true;
+
+    ushort allBits = 0;
+    const ushort * const end = subject + length;
+    for (const ushort *s = subject; s < end; ++s) {
+        const ushort uc = *s;
+        const uint index = uc < 0x100 ? uc : 0x100 | (uc & 0xff);
+        seenChars[index >> 5] |= 1u << (index & 31);
+        allBits |= uc;
+
+        if (checkValidity && QChar::isSurrogate(uc)) {
+            if (!QChar::isHighSurrogate(uc) || s + 1 == end || !QChar::isLowSurrogate(s[1])) {
+                subjectValid = false;
+                return;
+            }
+            ++s;
+            const uint lowIndex = 0x100 | (*s & 0xff);
+            seenChars[lowIndex >> 5] |= 1u << (lowIndex & 31);
+        }
+    }
+
+    // surrogates are above 0x80 as well, no need to track the low ones
+    seenNonAscii = allBits >= 0x80;
+}
+
+/*!
+    \internal
+
+    Returns \c false if the pattern of \a entry can't match the last scanned
+    subject because it lacks a character any match needs.
+*/
+bool QRegularExpressionSetPrivate::canMatch(const Entry &entry) const
+{
+    for (int i = 0; i < 2; ++i) {
+        const int c = entry.requiredChars[i];
+        if (c < 0 || hasSeen(c))
+            continue;
+
+        // in caseless mode a character can also match characters outside of
+        // Latin-1 (like 'k' and KELVIN SIGN); don't try to be smart about those
+        if (entry.caseless
+                && (seenNonAscii || hasSeen(QChar::toLower(uint(c))) || hasSeen(QChar::toUpper(uint(c))))) {
+            continue;
+        }
+
+        return false;
+    }
+    return true;
+}
+
+/*!
+    \internal
+*/
+QVector<int> QRegularExpressionSetPrivate::match(const QString &subject,
+                                                 int subjectStart,
+                                                 int subjectLength,
+                                                 int offset,
+                                                 QRegularExpression::MatchOptions matchOptions)
+{
+    QVector<int> result;
+
+    if (offset < 0)
+        offset += subjectLength;
+
+    if (offset < 0 || offset > subjectLength || entries.isEmpty())
+        return result;
+
+    const ushort * const subjectUtf16 = subject.utf16() + subjectStart;
+    const bool checkValidity = !(matchOptions & QRegularExpression::DontCheckSubjectStringMatchOption);
+
+    scanSubject(subjectUtf16, subjectLength, checkValidity);
+    if (!subjectValid)
+        return result;
+    if (checkValidity && offset < subjectLength && QChar::isLowSurrogate(subjectUtf16[offset]))
+        return result;
+
+    for (int i = 0; i < entries.size(); ++i) {
+        const Entry &entry = entries.at(i);
+        QRegularExpressionPrivate *re = entry.regularExpression.d.data();
+        if (!re->compiledPattern || !canMatch(entry))
+            continue;
+
+        if (buffers.exec(re, subjectUtf16, subjectLength, offset,
+                         QRegularExpression::NormalMatch, matchOptions, true) > 0) {
+            result.append(i);
+        }
+    }
+
+    return result;
+}
+
+/*!
+    Constructs an empty set.
+*/
+QRegularExpressionSet::QRegularExpressionSet()
+    : d(new QRegularExpressionSetPrivate)
+{
+}
+
+/*!
+    Constructs a set holding a regular expression for each of the given \a
+    patterns, all using the pattern options \a options. The index of each
+    regular expression in the set is the index of its pattern in \a patterns.
+*/
+QRegularExpressionSet::QRegularExpressionSet(const QStringList &patterns,
+                                             QRegularExpression::PatternOptions options)
+    : d(new QRegularExpressionSetPrivate)
+{
+    d->entries.reserve(patterns.size());
+    for (const QString &pattern : patterns)
+        d->add(QRegularExpression(pattern, options));
+}
+
+/*!
+    Destroys the set.
+*/
+QRegularExpressionSet::~QRegularExpressionSet()
+{
+    delete d;
+}
+
+/*!
+    Adds the regular expression \a re to the set, and returns its index.
+
+    An invalid regular expression never matches; it makes isValid() return
+    \c false.
+*/
+int QRegularExpressionSet::add(const QRegularExpression &re)
+{
+    return d->add(re);
+}
+
+/*!
+    Removes all the regular expressions from the set.
+*/
+void QRegularExpressionSet::clear()
+{
+    d->entries.clear();
+    d->valid = true;
+}
+
+/*!
+    Returns the number of regular expressions in the set.
+
+    \sa count(), isEmpty()
+*/
+int QRegularExpressionSet::size() const
+{
+    return d->entries.size();
+}
+
+/*!
+    \fn int QRegularExpressionSet::count() const
+
+    Same as size().
+*/
+
+/*!
+    \fn bool QRegularExpressionSet::isEmpty() const
+
+    Returns \c true if the set holds no regular expressions.
+*/
+
+/*!
+    Returns the regular expression at index \a i in the set.
+
+    \a i must be a valid index in the set (i.e., 0 <= \a i < size()).
+*/
+QRegularExpression QRegularExpressionSet::at(int i) const
+{
+    Q_ASSERT_X(i >= 0 && i < size(), "QRegularExpressionSet::at", "index out of range");
+    return d->entries.at(i).regularExpression;
+}
+
+/*!
+    Returns \c true if all the regular expressions in the set are valid.
+*/
+bool QRegularExpressionSet::isValid() const
+{
+    return d->valid;
+}
+
+/*!
+    Matches all the regular expressions in the set against the given \a
+    subject string, starting at the position \a offset inside the subject
+    and honoring the given \a matchOptions, and returns the indexes of the
+    ones that match, in ascending order.
+
+    If \a subject is not valid UTF-16, no regular expression matches.
+
+    \sa QRegularExpression::match()
+*/
+QVector<int> QRegularExpressionSet::match(const QString &subject,
+                                          int offset,
+                                          QRegularExpression::MatchOptions matchOptions)
+{
+    return d->match(subject, 0, subject.length(), offset, matchOptions);
+}
+
+/*!
+    \overload
+
+    Matches all the regular expressions in the set against the given \a
+    subjectRef string reference, starting at the position \a offset inside
+    the subject and honoring the given \a matchOptions, and returns the
+    indexes of the ones that match.
+*/
+QVector<int> QRegularExpressionSet::match(const QStringRef &subjectRef,
+                                          int offset,
+                                          QRegularExpression::MatchOptions matchOptions)
+{
+    const QString subject = subjectRef.string() ? *subjectRef.string() : QString();
+    return d->match(subject, subjectRef.position(), subjectRef.length(), offset, matchOptions);
+}
+
 #ifndef QT_NO_DATASTREAM
 /*!
     \relates QRegularExpression
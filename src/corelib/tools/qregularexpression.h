@@ -49,12 +49,15 @@
 #include <QtCore/qstringlist.h>
 #include <QtCore/qshareddata.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
 class QRegularExpressionMatch;
 class QRegularExpressionMatchIterator;
 struct QRegularExpressionPrivate;
+struct QRegularExpressionMatcherPrivate;
+struct QRegularExpressionSetPrivate;
 class QRegularExpression;
 
 Q_CORE_EXPORT uint qHash(const QRegularExpression &key, uint seed = 0) Q_DECL_NOTHROW;
@@ -148,6 +151,9 @@ private:
     friend class QRegularExpressionMatch;
     friend struct QRegularExpressionMatchPrivate;
     friend class QRegularExpressionMatchIterator;
+    friend class QRegularExpressionMatcher;
+    friend struct QRegularExpressionMatcherPrivate;
+    friend struct QRegularExpressionSetPrivate;
     friend Q_CORE_EXPORT uint qHash(const QRegularExpression &key, uint seed) Q_DECL_NOTHROW;
 
     QRegularExpression(QRegularExpressionPrivate &dd);
@@ -260,6 +266,76 @@ private:
 
 Q_DECLARE_SHARED(QRegularExpressionMatchIterator)
 
+class Q_CORE_EXPORT QRegularExpressionMatcher
+{
+public:
+    QRegularExpressionMatcher();
+    explicit QRegularExpressionMatcher(const QRegularExpression &re);
+    ~QRegularExpressionMatcher();
+
+    void setRegularExpression(const QRegularExpression &re);
+    QRegularExpression regularExpression() const;
+
+    bool match(const QString &subject,
+               int offset                                    = 0,
+               QRegularExpression::MatchType matchType       = QRegularExpression::NormalMatch,
+               QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption);
+
+    bool match(const QStringRef &subjectRef,
+               int offset                                    = 0,
+               QRegularExpression::MatchType matchType       = QRegularExpression::NormalMatch,
+               QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption);
+
+    bool hasMatch() const;
+    bool hasPartialMatch() const;
+
+    bool isValid() const;
+
+    int lastCapturedIndex() const;
+
+    QString captured(int nth = 0) const;
+    QStringRef capturedRef(int nth = 0) const;
+
+    int capturedStart(int nth = 0) const;
+    int capturedLength(int nth = 0) const;
+    int capturedEnd(int nth = 0) const;
+
+private:
+    Q_DISABLE_COPY(QRegularExpressionMatcher)
+    QRegularExpressionMatcherPrivate *d;
+};
+
+class Q_CORE_EXPORT QRegularExpressionSet
+{
+public:
+    QRegularExpressionSet();
+    explicit QRegularExpressionSet(const QStringList &patterns,
+                                   QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption);
+    ~QRegularExpressionSet();
+
+    int add(const QRegularExpression &re);
+    void clear();
+
+    int size() const;
+    inline int count() const { return size(); }
+    bool isEmpty() const { return size() == 0; }
+    QRegularExpression at(int i) const;
+
+    bool isValid() const;
+
+    QVector<int> match(const QString &subject,
+                       int offset                                    = 0,
+                       QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption);
+
+    QVector<int> match(const QStringRef &subjectRef,
+                       int offset                                    = 0,
+                       QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption);
+
+private:
+    Q_DISABLE_COPY(QRegularExpressionSet)
+    QRegularExpressionSetPrivate *d;
+};
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_REGULAREXPRESSION
@@ -69,6 +69,32 @@ const char *QRingBuffer::readPointerAtPosition(qint64 pos, qint64 &length) const
     return 0;
 }
 
+/*!
+    \internal
+
+    Fills \a data and \a lengths with the addresses and sizes of the
+    contiguous blocks that make up the first \a maxLength bytes of the
+    buffer, at most \a maxCount of them, and returns how many were stored.
+*/
+int QRingBuffer::readPointers(const char **data, qint64 *lengths, int maxCount,
+                              qint64 maxLength) const
+{
+    int count = 0;
+    qint64 pos = head;
+    for (int i = 0; count < maxCount && maxLength > 0 && i < buffers.size(); ++i) {
+        const qint64 blockLength = qMin(qint64(i == tailBuffer ? tail : buffers[i].size()) - pos,
+                                        maxLength);
+        if (blockLength > 0) {
+            data[count] = buffers[i].constData() + pos;
+            lengths[count] = blockLength;
+            maxLength -= blockLength;
+            ++count;
+        }
+        pos = 0;
+    }
+    return count;
+}
+
 void QRingBuffer::free(qint64 bytes)
 {
     Q_ASSERT(bytes <= bufferSize);
@@ -81,7 +107,8 @@ void QRingBuffer::free(qint64 bytes)
             // the basic block size, to avoid repeated allocations
             // between uses of the buffer
             if (bufferSize <= bytes) {
-                if (buffers.constFirst().size() <= basicBlockSize) {
+                if (buffers.constFirst().size() <= basicBlockSize
+                    && buffers.constFirst().isDetached()) {
                     bufferSize = 0;
                     head = tail = 0;
                 } else {
@@ -115,11 +142,14 @@ char *QRingBuffer::reserve(qint64 bytes)
             buffers.first().resize(qMax(basicBlockSize, int(bytes)));
     } else {
         const qint64 newSize = bytes + tail;
-        // if need a new buffer
-        if (basicBlockSize == 0 || (newSize > buffers.constLast().capacity()
-                                    && (tail >= basicBlockSize || newSize >= MaxByteArraySize))) {
+        // if need a new buffer; a block adopted by append(const QByteArray &)
+        // is still shared with the caller and is never written to
+        if (basicBlockSize == 0 || !buffers.constLast().isDetached()
+            || (newSize > buffers.constLast().capacity()
+                && (tail >= basicBlockSize || newSize >= MaxByteArraySize))) {
             // shrink this buffer to its current size
-            buffers.last().resize(tail);
+            if (tail != buffers.constLast().size())
+                buffers.last().resize(tail);
 
             // create a new QByteArray
             buffers.append(QByteArray(qMax(basicBlockSize, int(bytes)), Qt::Uninitialized));
@@ -147,7 +177,7 @@ char *QRingBuffer::reserveFront(qint64 bytes)
     if (bytes <= 0 || bytes >= MaxByteArraySize)
         return 0;
 
-    if (head < bytes || basicBlockSize == 0) {
+    if (head < bytes || basicBlockSize == 0 || !buffers.constFirst().isDetached()) {
         if (head > 0) {
             buffers.first().remove(0, head);
             if (tailBuffer == 0)
@@ -182,7 +212,8 @@ void QRingBuffer::chop(qint64 bytes)
             // the basic block size, to avoid repeated allocations
             // between uses of the buffer
             if (bufferSize <= bytes) {
-                if (buffers.constFirst().size() <= basicBlockSize) {
+                if (buffers.constFirst().size() <= basicBlockSize
+                    && buffers.constFirst().isDetached()) {
                     bufferSize = 0;
                     head = tail = 0;
                 } else {
@@ -342,7 +373,8 @@ void QRingBuffer::append(const QByteArray &qba)
         else
             buffers.last() = qba;
     } else {
-        buffers.last().resize(tail);
+        if (tail != buffers.constLast().size())
+            buffers.last().resize(tail);
         buffers.append(qba);
         ++tailBuffer;
     }
@@ -79,11 +79,17 @@ public:
         return (tailBuffer == 0 ? tail : buffers.first().size()) - head;
     }
 
+    inline int blockCount() const {
+        return bufferSize == 0 ? 0 : buffers.size();
+    }
+
     inline const char *readPointer() const {
         return bufferSize == 0 ? Q_NULLPTR : (buffers.first().constData() + head);
     }
 
     Q_CORE_EXPORT const char *readPointerAtPosition(qint64 pos, qint64 &length) const;
+    Q_CORE_EXPORT int readPointers(const char **data, qint64 *lengths, int maxCount,
+                                   qint64 maxLength) const;
     Q_CORE_EXPORT void free(qint64 bytes);
     Q_CORE_EXPORT char *reserve(qint64 bytes);
     Q_CORE_EXPORT char *reserveFront(qint64 bytes);
@@ -114,7 +120,7 @@ public:
 
     void ungetChar(char c)
     {
-        if (head > 0) {
+        if (head > 0 && buffers.constFirst().isDetached()) {
             --head;
             buffers.first()[head] = c;
             ++bufferSize;
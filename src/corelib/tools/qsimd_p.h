@@ -206,6 +206,15 @@
 #define QT_FUNCTION_TARGET_STRING_SSE4_1    "sse4.1"
 #if defined(__SSE4_1__) || (defined(QT_COMPILER_SUPPORTS_SSE4_1) && defined(QT_COMPILER_SUPPORTS_SIMD_ALWAYS))
 #include <smmintrin.h>
+
+// SHA intrinsics
+#  if defined(QT_COMPILER_SUPPORTS_SSE4_1) && (!defined(Q_CC_MSVC) || Q_CC_MSVC >= 1900)
+#    define QT_COMPILER_SUPPORTS_SHA        1
+#  endif
+#  define QT_FUNCTION_TARGET_STRING_SHA     "sha,sse4.1"
+#  if defined(__SHA__) || (defined(QT_COMPILER_SUPPORTS_SHA) && defined(QT_COMPILER_SUPPORTS_SIMD_ALWAYS))
+#    include <immintrin.h>
+#  endif
 #endif
 
 // SSE4.2 intrinsics
@@ -262,7 +271,6 @@
 #define QT_FUNCTION_TARGET_STRING_BMI           "bmi"
 #define QT_FUNCTION_TARGET_STRING_BMI2          "bmi2"
 #define QT_FUNCTION_TARGET_STRING_RDSEED        "rdseed"
-#define QT_FUNCTION_TARGET_STRING_SHA           "sha"
 
 // other x86 intrinsics
 #if defined(Q_PROCESSOR_X86) && ((defined(Q_CC_GNU) && (Q_CC_GNU >= 404)) \
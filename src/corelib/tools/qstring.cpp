@@ -7035,6 +7035,211 @@ QVector<QStringRef> QStringRef::split(QChar sep, QString::SplitBehavior behavior
     return splitString<QVector<QStringRef> >(*this, &sep, behavior, cs, 1);
 }
 
+/*!
+    \fn QStringTokenizer QString::tokenize(QChar sep, SplitBehavior behavior, Qt::CaseSensitivity cs) const
+    \since 5.8
+
+    Returns a QStringTokenizer that splits the string wherever \a sep
+    occurs. Unlike splitRef(), no container is allocated: the parts are
+    found one at a time while the tokenizer is iterated.
+
+    \a cs specifies whether \a sep should be matched case
+    sensitively or case insensitively.
+
+    If \a behavior is QString::SkipEmptyParts, empty entries are
+    skipped. By default, empty entries are kept.
+
+    \note The references returned by the tokenizer are valid as long as
+    this string is alive and not modified.
+
+    \sa splitRef(), QStringRef::tokenize()
+*/
+
+/*!
+    \fn QStringTokenizer QString::tokenize(const QString &sep, SplitBehavior behavior, Qt::CaseSensitivity cs) const
+    \overload
+    \since 5.8
+*/
+
+/*!
+    \fn QStringTokenizer QString::tokenize(QLatin1String sep, SplitBehavior behavior, Qt::CaseSensitivity cs) const
+    \overload
+    \since 5.8
+*/
+
+/*!
+    \fn QStringTokenizer QStringRef::tokenize(QChar sep, QString::SplitBehavior behavior, Qt::CaseSensitivity cs) const
+    \since 5.8
+
+    Returns a QStringTokenizer that splits the string reference wherever
+    \a sep occurs, without allocating a container for the parts.
+
+    \sa split(), QString::tokenize()
+*/
+
+/*!
+    \fn QStringTokenizer QStringRef::tokenize(const QString &sep, QString::SplitBehavior behavior, Qt::CaseSensitivity cs) const
+    \overload
+    \since 5.8
+*/
+
+/*!
+    \fn QStringTokenizer QStringRef::tokenize(QLatin1String sep, QString::SplitBehavior behavior, Qt::CaseSensitivity cs) const
+    \overload
+    \since 5.8
+*/
+
+/*!
+    \class QStringTokenizer
+    \inmodule QtCore
+    \since 5.8
+    \ingroup tools
+    \ingroup string-processing
+
+    \brief The QStringTokenizer class splits a string lazily into
+    QStringRef parts.
+
+    QStringTokenizer produces the same parts as QStringRef::split(), but
+    does not store them: each part is located when the iterator is
+    advanced. Iterating over a tokenizer therefore does not allocate
+    memory, which makes it suitable for parsing large amounts of text:
+
+    \code
+    int sum = 0;
+    for (const QStringRef &field : line.tokenize(QLatin1Char(',')))
+        sum += field.toInt();
+    \endcode
+
+    The tokenizer only holds a QStringRef to the string being split, so
+    that string must stay alive and unmodified while the tokenizer or the
+    parts it returned are used.
+
+    \sa QString::tokenize(), QStringRef::tokenize(), QString::splitRef()
+*/
+
+/*!
+    \fn QStringTokenizer::QStringTokenizer(const QStringRef &haystack, QChar sep, QString::SplitBehavior behavior, Qt::CaseSensitivity cs)
+
+    Constructs a tokenizer that splits \a haystack wherever \a sep occurs.
+    \a behavior and \a cs have the same meaning as for QStringRef::split().
+*/
+
+/*!
+    \fn QStringTokenizer::QStringTokenizer(const QStringRef &haystack, const QString &sep, QString::SplitBehavior behavior, Qt::CaseSensitivity cs)
+    \overload
+*/
+
+/*!
+    \fn QStringTokenizer::QStringTokenizer(const QStringRef &haystack, QLatin1String sep, QString::SplitBehavior behavior, Qt::CaseSensitivity cs)
+    \overload
+
+    The Latin-1 string referenced by \a sep must outlive the tokenizer.
+*/
+
+/*!
+    \fn QStringTokenizer::const_iterator QStringTokenizer::begin() const
+
+    Returns a forward iterator pointing to the first part.
+*/
+
+/*!
+    \fn QStringTokenizer::const_iterator QStringTokenizer::cbegin() const
+
+    Same as begin().
+*/
+
+/*!
+    \fn QStringTokenizer::const_iterator QStringTokenizer::end() const
+
+    Returns an iterator pointing past the last part.
+*/
+
+/*!
+    \fn QStringTokenizer::const_iterator QStringTokenizer::cend() const
+
+    Same as end().
+*/
+
+/*!
+    \fn QStringRef QStringTokenizer::haystack() const
+
+    Returns the string reference being split.
+*/
+
+/*!
+    Returns all parts in a vector. This is equivalent to calling
+    QStringRef::split() with the same arguments.
+*/
+QVector<QStringRef> QStringTokenizer::toVector() const
+{
+    QVector<QStringRef> result;
+    for (const_iterator it = begin(), e = end(); it != e; ++it)
+        result.append(*it);
+    return result;
+}
+
+/*!
+    \internal
+
+    Returns the position of the first separator at or after \a from,
+    or -1 if there is none.
+*/
+int QStringTokenizer::findSeparator(int from) const
+{
+    const QChar *hay = m_haystack.unicode();
+    const int size = m_haystack.size();
+    switch (m_sepKind) {
+    case Char:
+        return findChar(hay, size, m_sepChar, from, m_cs);
+    case Utf16:
+        return qFindString(hay, size, from, m_sepString.constData(), m_sepSize, m_cs);
+    case Latin1:
+        if (m_sepSize == 1)
+            return findChar(hay, size, QLatin1Char(*m_sepLatin1.latin1()), from, m_cs);
+        return qt_find_latin1_string(hay, size, m_sepLatin1, from, m_cs);
+    }
+    Q_UNREACHABLE();
+    return -1;
+}
+
+/*!
+    \internal
+
+    Moves \a it to the next part, following the same rules as
+    splitString(): an empty separator matches between every character,
+    and the text after the last separator is always a part of its own.
+*/
+void QStringTokenizer::advance(const_iterator *it) const
+{
+    if (it->m_next == const_iterator::Last) {
+        it->m_next = const_iterator::Done;
+        it->m_token = QStringRef();
+        return;
+    }
+    Q_ASSERT(it->m_next >= 0);
+
+    forever {
+        const int start = it->m_next;
+        const int end = findSeparator(it->m_searchFrom);
+        if (end == -1) {
+            if (start != m_haystack.size() || m_behavior == QString::KeepEmptyParts) {
+                it->m_next = const_iterator::Last;
+                it->m_token = m_haystack.mid(start);
+            } else {
+                it->m_next = const_iterator::Done;
+                it->m_token = QStringRef();
+            }
+            return;
+        }
+        it->m_next = end + m_sepSize;
+        it->m_searchFrom = it->m_next + (m_sepSize == 0 ? 1 : 0);
+        if (start != end || m_behavior == QString::KeepEmptyParts) {
+            it->m_token = m_haystack.mid(start, end - start);
+            return;
+        }
+    }
+}
+
 #ifndef QT_NO_REGEXP
 namespace {
 template<class ResultList, typename MidMethod>
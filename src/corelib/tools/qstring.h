@@ -84,6 +84,7 @@ class QStringList;
 class QStringArgBuilder;
 class QTextCodec;
 class QStringRef;
+class QStringTokenizer;
 template <typename T> class QVector;
 
 class QLatin1String
@@ -504,6 +505,12 @@ public:
     QStringList split(const QRegularExpression &sep, SplitBehavior behavior = KeepEmptyParts) const Q_REQUIRED_RESULT;
     QVector<QStringRef> splitRef(const QRegularExpression &sep, SplitBehavior behavior = KeepEmptyParts) const Q_REQUIRED_RESULT;
 #endif
+    inline QStringTokenizer tokenize(QChar sep, SplitBehavior behavior = KeepEmptyParts,
+                                     Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_REQUIRED_RESULT;
+    inline QStringTokenizer tokenize(const QString &sep, SplitBehavior behavior = KeepEmptyParts,
+                                     Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_REQUIRED_RESULT;
+    inline QStringTokenizer tokenize(QLatin1String sep, SplitBehavior behavior = KeepEmptyParts,
+                                     Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_REQUIRED_RESULT;
     enum NormalizationForm {
         NormalizationForm_D,
         NormalizationForm_C,
@@ -1453,6 +1460,12 @@ public:
                       Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_REQUIRED_RESULT;
     QVector<QStringRef> split(QChar sep, QString::SplitBehavior behavior = QString::KeepEmptyParts,
                       Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_REQUIRED_RESULT;
+    inline QStringTokenizer tokenize(QChar sep, QString::SplitBehavior behavior = QString::KeepEmptyParts,
+                                     Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_REQUIRED_RESULT;
+    inline QStringTokenizer tokenize(const QString &sep, QString::SplitBehavior behavior = QString::KeepEmptyParts,
+                                     Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_REQUIRED_RESULT;
+    inline QStringTokenizer tokenize(QLatin1String sep, QString::SplitBehavior behavior = QString::KeepEmptyParts,
+                                     Qt::CaseSensitivity cs = Qt::CaseSensitive) const Q_REQUIRED_RESULT;
 
     QStringRef left(int n) const Q_REQUIRED_RESULT;
     QStringRef right(int n) const Q_REQUIRED_RESULT;
@@ -1589,6 +1602,108 @@ inline QStringRef::QStringRef(const QString *aString, int aPosition, int aSize)
 inline QStringRef::QStringRef(const QString *aString)
     :m_string(aString), m_position(0), m_size(aString?aString->size() : 0){}
 
+class Q_CORE_EXPORT QStringTokenizer
+{
+public:
+    class const_iterator
+    {
+        friend class QStringTokenizer;
+        enum { Last = -1, Done = -2 };
+
+        const QStringTokenizer *m_tokenizer;
+        QStringRef m_token;
+        int m_next;         // where the token after m_token starts, or Last or Done
+        int m_searchFrom;   // where to look for the separator that ends it
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef QStringRef value_type;
+        typedef const QStringRef *pointer;
+        typedef const QStringRef &reference;
+
+        const_iterator() Q_DECL_NOTHROW
+            : m_tokenizer(Q_NULLPTR), m_next(Done), m_searchFrom(0) {}
+
+        const QStringRef &operator*() const Q_DECL_NOTHROW { return m_token; }
+        const QStringRef *operator->() const Q_DECL_NOTHROW { return &m_token; }
+        const_iterator &operator++() { m_tokenizer->advance(this); return *this; }
+        const_iterator operator++(int) { const_iterator it = *this; ++*this; return it; }
+
+        friend bool operator==(const const_iterator &lhs, const const_iterator &rhs) Q_DECL_NOTHROW
+        { return lhs.m_tokenizer == rhs.m_tokenizer && lhs.m_next == rhs.m_next; }
+        friend bool operator!=(const const_iterator &lhs, const const_iterator &rhs) Q_DECL_NOTHROW
+        { return !(lhs == rhs); }
+    };
+    typedef const_iterator iterator;
+    typedef QStringRef value_type;
+
+    QStringTokenizer(const QStringRef &haystack, QChar sep,
+                     QString::SplitBehavior behavior = QString::KeepEmptyParts,
+                     Qt::CaseSensitivity cs = Qt::CaseSensitive) Q_DECL_NOTHROW
+        : m_haystack(haystack), m_sepChar(sep), m_sepSize(1), m_sepKind(Char),
+          m_behavior(behavior), m_cs(cs) {}
+    QStringTokenizer(const QStringRef &haystack, const QString &sep,
+                     QString::SplitBehavior behavior = QString::KeepEmptyParts,
+                     Qt::CaseSensitivity cs = Qt::CaseSensitive) Q_DECL_NOTHROW
+        : m_haystack(haystack), m_sepString(sep), m_sepSize(sep.size()), m_sepKind(Utf16),
+          m_behavior(behavior), m_cs(cs) {}
+    QStringTokenizer(const QStringRef &haystack, QLatin1String sep,
+                     QString::SplitBehavior behavior = QString::KeepEmptyParts,
+                     Qt::CaseSensitivity cs = Qt::CaseSensitive) Q_DECL_NOTHROW
+        : m_haystack(haystack), m_sepLatin1(sep), m_sepSize(sep.size()), m_sepKind(Latin1),
+          m_behavior(behavior), m_cs(cs) {}
+
+    const_iterator begin() const
+    {
+        const_iterator it;
+        it.m_tokenizer = this;
+        it.m_next = 0;
+        advance(&it);
+        return it;
+    }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator end() const Q_DECL_NOTHROW
+    {
+        const_iterator it;
+        it.m_tokenizer = this;
+        return it;
+    }
+    const_iterator cend() const Q_DECL_NOTHROW { return end(); }
+
+    QStringRef haystack() const Q_DECL_NOTHROW { return m_haystack; }
+
+    QVector<QStringRef> toVector() const Q_REQUIRED_RESULT;
+
+private:
+    enum SeparatorKind { Char, Utf16, Latin1 };
+
+    void advance(const_iterator *it) const;
+    int findSeparator(int from) const;
+
+    QStringRef m_haystack;
+    QString m_sepString;
+    QLatin1String m_sepLatin1;
+    QChar m_sepChar;
+    int m_sepSize;
+    SeparatorKind m_sepKind;
+    QString::SplitBehavior m_behavior;
+    Qt::CaseSensitivity m_cs;
+};
+
+inline QStringTokenizer QString::tokenize(QChar sep, SplitBehavior behavior, Qt::CaseSensitivity cs) const
+{ return QStringTokenizer(QStringRef(this), sep, behavior, cs); }
+inline QStringTokenizer QString::tokenize(const QString &sep, SplitBehavior behavior, Qt::CaseSensitivity cs) const
+{ return QStringTokenizer(QStringRef(this), sep, behavior, cs); }
+inline QStringTokenizer QString::tokenize(QLatin1String sep, SplitBehavior behavior, Qt::CaseSensitivity cs) const
+{ return QStringTokenizer(QStringRef(this), sep, behavior, cs); }
+inline QStringTokenizer QStringRef::tokenize(QChar sep, QString::SplitBehavior behavior, Qt::CaseSensitivity cs) const
+{ return QStringTokenizer(*this, sep, behavior, cs); }
+inline QStringTokenizer QStringRef::tokenize(const QString &sep, QString::SplitBehavior behavior, Qt::CaseSensitivity cs) const
+{ return QStringTokenizer(*this, sep, behavior, cs); }
+inline QStringTokenizer QStringRef::tokenize(QLatin1String sep, QString::SplitBehavior behavior, Qt::CaseSensitivity cs) const
+{ return QStringTokenizer(*this, sep, behavior, cs); }
+
 // QStringRef <> QStringRef
 Q_CORE_EXPORT bool operator==(const QStringRef &s1, const QStringRef &s2) Q_DECL_NOTHROW;
 inline bool operator!=(const QStringRef &s1, const QStringRef &s2) Q_DECL_NOTHROW
@@ -333,7 +333,8 @@ public:
 private:
     void init(const QByteArray &ianaId);
 
-    Data dataForTzTransition(QTzTransitionTime tran) const;
+    Data dataForTzTransition(QTzTransitionTime tran, bool withAbbreviation = true) const;
+    Data dataForMSecs(qint64 forMSecsSinceEpoch, bool withAbbreviation) const;
     QVector<QTzTransitionTime> m_tranTimes;
     QVector<QTzTransitionRule> m_tranRules;
     QList<QByteArray> m_abbreviations;
@@ -341,6 +342,9 @@ private:
     mutable QSharedDataPointer<QTimeZonePrivate> m_icu;
 #endif // QT_USE_ICU
     QByteArray m_posixRule;
+    // Transitions following from m_posixRule, worked out once up to m_posixTransitionsEnd
+    QVector<Data> m_posixTransitions;
+    qint64 m_posixTransitionsEnd;
 };
 #endif // Q_OS_UNIX
 
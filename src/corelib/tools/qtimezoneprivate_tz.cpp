@@ -620,7 +620,9 @@ QTzTimeZonePrivate::QTzTimeZonePrivate(const QTzTimeZonePrivate &other)
 #ifdef QT_USE_ICU
                     m_icu(other.m_icu),
 #endif // QT_USE_ICU
-                    m_posixRule(other.m_posixRule)
+                    m_posixRule(other.m_posixRule),
+                    m_posixTransitions(other.m_posixTransitions),
+                    m_posixTransitionsEnd(other.m_posixTransitionsEnd)
 {
 }
 
@@ -635,6 +637,8 @@ QTimeZonePrivate *QTzTimeZonePrivate::clone()
 
 void QTzTimeZonePrivate::init(const QByteArray &ianaId)
 {
+    m_posixTransitionsEnd = 0;
+
     QFile tzif;
     if (ianaId.isEmpty()) {
         // Open system tz
@@ -758,6 +762,21 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
         m_tranTimes.append(tran);
     }
 
+    // Past the last transition in the file the POSIX rule applies. Work out its transitions
+    // up to the end of PosixCacheLastYear once, rather than on every call to data(); the
+    // windows of three years that data() and friends use are all covered by this list.
+    if (!m_posixRule.isEmpty() && !m_tranTimes.isEmpty()) {
+        enum { PosixCacheLastYear = 2099 };
+        const qint64 lastTran = m_tranTimes.last().atMSecsSinceEpoch;
+        const int firstYear = QDateTime::fromMSecsSinceEpoch(qMax(lastTran, qint64(0)), Qt::UTC).date().year();
+        if (firstYear <= PosixCacheLastYear) {
+            m_posixTransitions = calculatePosixTransitions(m_posixRule, firstYear - 1,
+                                                           PosixCacheLastYear + 1, lastTran);
+            m_posixTransitionsEnd = QDateTime(QDate(PosixCacheLastYear + 1, 1, 1), QTime(0, 0),
+                                              Qt::UTC).toMSecsSinceEpoch();
+        }
+    }
+
     if (ianaId.isEmpty())
         m_id = systemTimeZoneId();
     else
@@ -862,18 +881,18 @@ QString QTzTimeZonePrivate::abbreviation(qint64 atMSecsSinceEpoch) const
 
 int QTzTimeZonePrivate::offsetFromUtc(qint64 atMSecsSinceEpoch) const
 {
-    const QTimeZonePrivate::Data tran = data(atMSecsSinceEpoch);
+    const QTimeZonePrivate::Data tran = dataForMSecs(atMSecsSinceEpoch, false);
     return tran.standardTimeOffset + tran.daylightTimeOffset;
 }
 
 int QTzTimeZonePrivate::standardTimeOffset(qint64 atMSecsSinceEpoch) const
 {
-    return data(atMSecsSinceEpoch).standardTimeOffset;
+    return dataForMSecs(atMSecsSinceEpoch, false).standardTimeOffset;
 }
 
 int QTzTimeZonePrivate::daylightTimeOffset(qint64 atMSecsSinceEpoch) const
 {
-    return data(atMSecsSinceEpoch).daylightTimeOffset;
+    return dataForMSecs(atMSecsSinceEpoch, false).daylightTimeOffset;
 }
 
 bool QTzTimeZonePrivate::hasDaylightTime() const
@@ -891,7 +910,8 @@ bool QTzTimeZonePrivate::isDaylightTime(qint64 atMSecsSinceEpoch) const
     return (daylightTimeOffset(atMSecsSinceEpoch) != 0);
 }
 
-QTimeZonePrivate::Data QTzTimeZonePrivate::dataForTzTransition(QTzTransitionTime tran) const
+QTimeZonePrivate::Data QTzTimeZonePrivate::dataForTzTransition(QTzTransitionTime tran,
+                                                                bool withAbbreviation) const
 {
     QTimeZonePrivate::Data data;
     data.atMSecsSinceEpoch = tran.atMSecsSinceEpoch;
@@ -899,40 +919,77 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::dataForTzTransition(QTzTransitionTime
     data.standardTimeOffset = rule.stdOffset;
     data.daylightTimeOffset = rule.dstOffset;
     data.offsetFromUtc = rule.stdOffset + rule.dstOffset;
-    data.abbreviation = QString::fromUtf8(m_abbreviations.at(rule.abbreviationIndex));
+    if (withAbbreviation)
+        data.abbreviation = QString::fromUtf8(m_abbreviations.at(rule.abbreviationIndex));
     return data;
 }
 
+static bool msecsLessThanTransition(qint64 msecs, const QTzTransitionTime &tran)
+{
+    return msecs < tran.atMSecsSinceEpoch;
+}
+
+static bool transitionLessThanMSecs(const QTzTransitionTime &tran, qint64 msecs)
+{
+    return tran.atMSecsSinceEpoch < msecs;
+}
+
+static bool msecsLessThanData(qint64 msecs, const QTimeZonePrivate::Data &data)
+{
+    return msecs < data.atMSecsSinceEpoch;
+}
+
+static bool dataLessThanMSecs(const QTimeZonePrivate::Data &data, qint64 msecs)
+{
+    return data.atMSecsSinceEpoch < msecs;
+}
+
 QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
+{
+    return dataForMSecs(forMSecsSinceEpoch, true);
+}
+
+QTimeZonePrivate::Data QTzTimeZonePrivate::dataForMSecs(qint64 forMSecsSinceEpoch,
+                                                        bool withAbbreviation) const
 {
     // If the required time is after the last transition and we have a POSIX rule then use it
     if (m_tranTimes.size() > 0 && m_tranTimes.last().atMSecsSinceEpoch < forMSecsSinceEpoch
         && !m_posixRule.isEmpty() && forMSecsSinceEpoch >= 0) {
-        const int year = QDateTime::fromMSecsSinceEpoch(forMSecsSinceEpoch, Qt::UTC).date().year();
-        QVector<QTimeZonePrivate::Data> posixTrans =
-            calculatePosixTransitions(m_posixRule, year - 1, year + 1,
-                                      m_tranTimes.last().atMSecsSinceEpoch);
-        for (int i = posixTrans.size() - 1; i >= 0; --i) {
-            if (posixTrans.at(i).atMSecsSinceEpoch <= forMSecsSinceEpoch) {
-                QTimeZonePrivate::Data data = posixTrans.at(i);
+        if (forMSecsSinceEpoch < m_posixTransitionsEnd) {
+            const auto it = std::upper_bound(m_posixTransitions.cbegin(), m_posixTransitions.cend(),
+                                             forMSecsSinceEpoch, msecsLessThanData);
+            if (it != m_posixTransitions.cbegin()) {
+                QTimeZonePrivate::Data data = *(it - 1);
                 data.atMSecsSinceEpoch = forMSecsSinceEpoch;
                 return data;
             }
+        } else {
+            const int year = QDateTime::fromMSecsSinceEpoch(forMSecsSinceEpoch, Qt::UTC).date().year();
+            QVector<QTimeZonePrivate::Data> posixTrans =
+                calculatePosixTransitions(m_posixRule, year - 1, year + 1,
+                                          m_tranTimes.last().atMSecsSinceEpoch);
+            for (int i = posixTrans.size() - 1; i >= 0; --i) {
+                if (posixTrans.at(i).atMSecsSinceEpoch <= forMSecsSinceEpoch) {
+                    QTimeZonePrivate::Data data = posixTrans.at(i);
+                    data.atMSecsSinceEpoch = forMSecsSinceEpoch;
+                    return data;
+                }
+            }
         }
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    for (int i = m_tranTimes.size() - 1; i >= 0; --i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch <= forMSecsSinceEpoch) {
-            Data data = dataForTzTransition(m_tranTimes.at(i));
-            data.atMSecsSinceEpoch = forMSecsSinceEpoch;
-            return data;
-        }
+    const auto it = std::upper_bound(m_tranTimes.cbegin(), m_tranTimes.cend(),
+                                     forMSecsSinceEpoch, msecsLessThanTransition);
+    if (it != m_tranTimes.cbegin()) {
+        Data data = dataForTzTransition(*(it - 1), withAbbreviation);
+        data.atMSecsSinceEpoch = forMSecsSinceEpoch;
+        return data;
     }
 
     // Otherwise use the earliest transition we have
     if (m_tranTimes.size() > 0) {
-        Data data = dataForTzTransition(m_tranTimes.at(0));
+        Data data = dataForTzTransition(m_tranTimes.at(0), withAbbreviation);
         data.atMSecsSinceEpoch = forMSecsSinceEpoch;
         return data;
     }
@@ -951,22 +1008,28 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::nextTransition(qint64 afterMSecsSince
     // If the required time is after the last transition and we have a POSIX rule then use it
     if (m_tranTimes.size() > 0 && m_tranTimes.last().atMSecsSinceEpoch < afterMSecsSinceEpoch
         && !m_posixRule.isEmpty() && afterMSecsSinceEpoch >= 0) {
-        const int year = QDateTime::fromMSecsSinceEpoch(afterMSecsSinceEpoch, Qt::UTC).date().year();
-        QVector<QTimeZonePrivate::Data> posixTrans =
-            calculatePosixTransitions(m_posixRule, year - 1, year + 1,
-                                      m_tranTimes.last().atMSecsSinceEpoch);
-        for (int i = 0; i < posixTrans.size(); ++i) {
-            if (posixTrans.at(i).atMSecsSinceEpoch > afterMSecsSinceEpoch)
-                return posixTrans.at(i);
+        if (afterMSecsSinceEpoch < m_posixTransitionsEnd) {
+            const auto it = std::upper_bound(m_posixTransitions.cbegin(), m_posixTransitions.cend(),
+                                             afterMSecsSinceEpoch, msecsLessThanData);
+            if (it != m_posixTransitions.cend())
+                return *it;
+        } else {
+            const int year = QDateTime::fromMSecsSinceEpoch(afterMSecsSinceEpoch, Qt::UTC).date().year();
+            QVector<QTimeZonePrivate::Data> posixTrans =
+                calculatePosixTransitions(m_posixRule, year - 1, year + 1,
+                                          m_tranTimes.last().atMSecsSinceEpoch);
+            for (int i = 0; i < posixTrans.size(); ++i) {
+                if (posixTrans.at(i).atMSecsSinceEpoch > afterMSecsSinceEpoch)
+                    return posixTrans.at(i);
+            }
         }
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    for (int i = 0; i < m_tranTimes.size(); ++i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch > afterMSecsSinceEpoch) {
-            return dataForTzTransition(m_tranTimes.at(i));
-        }
-    }
+    const auto it = std::upper_bound(m_tranTimes.cbegin(), m_tranTimes.cend(),
+                                     afterMSecsSinceEpoch, msecsLessThanTransition);
+    if (it != m_tranTimes.cend())
+        return dataForTzTransition(*it);
 
     // Otherwise we have no rule, or there is no next transition, so return invalid data
     return invalidData();
@@ -977,22 +1040,28 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::previousTransition(qint64 beforeMSecs
     // If the required time is after the last transition and we have a POSIX rule then use it
     if (m_tranTimes.size() > 0 && m_tranTimes.last().atMSecsSinceEpoch < beforeMSecsSinceEpoch
         && !m_posixRule.isEmpty() && beforeMSecsSinceEpoch > 0) {
-        const int year = QDateTime::fromMSecsSinceEpoch(beforeMSecsSinceEpoch, Qt::UTC).date().year();
-        QVector<QTimeZonePrivate::Data> posixTrans =
-            calculatePosixTransitions(m_posixRule, year - 1, year + 1,
-                                      m_tranTimes.last().atMSecsSinceEpoch);
-        for (int i = posixTrans.size() - 1; i >= 0; --i) {
-            if (posixTrans.at(i).atMSecsSinceEpoch < beforeMSecsSinceEpoch)
-                return posixTrans.at(i);
+        if (beforeMSecsSinceEpoch < m_posixTransitionsEnd) {
+            const auto it = std::lower_bound(m_posixTransitions.cbegin(), m_posixTransitions.cend(),
+                                             beforeMSecsSinceEpoch, dataLessThanMSecs);
+            if (it != m_posixTransitions.cbegin())
+                return *(it - 1);
+        } else {
+            const int year = QDateTime::fromMSecsSinceEpoch(beforeMSecsSinceEpoch, Qt::UTC).date().year();
+            QVector<QTimeZonePrivate::Data> posixTrans =
+                calculatePosixTransitions(m_posixRule, year - 1, year + 1,
+                                          m_tranTimes.last().atMSecsSinceEpoch);
+            for (int i = posixTrans.size() - 1; i >= 0; --i) {
+                if (posixTrans.at(i).atMSecsSinceEpoch < beforeMSecsSinceEpoch)
+                    return posixTrans.at(i);
+            }
         }
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    for (int i = m_tranTimes.size() - 1; i >= 0; --i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch < beforeMSecsSinceEpoch) {
-            return dataForTzTransition(m_tranTimes.at(i));
-        }
-    }
+    const auto it = std::lower_bound(m_tranTimes.cbegin(), m_tranTimes.cend(),
+                                     beforeMSecsSinceEpoch, transitionLessThanMSecs);
+    if (it != m_tranTimes.cbegin())
+        return dataForTzTransition(*(it - 1));
 
     // Otherwise we have no rule, so return invalid data
     return invalidData();
@@ -24,6 +24,7 @@ HEADERS +=  \
         tools/qdatetimeparser_p.h \
         tools/qdoublescanprint_p.h \
         tools/qeasingcurve.h \
+        tools/qflathash.h \
         tools/qfreelist_p.h \
         tools/qgenericarray.h \
         tools/qhash.h \
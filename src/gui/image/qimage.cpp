@@ -65,9 +65,12 @@
 
 #include <private/qimage_p.h>
 #include <private/qfont_p.h>
+#include <private/qtrace_p.h>
 
 QT_BEGIN_NAMESPACE
 
+Q_LOGGING_CATEGORY(lcTraceGuiImage, "qt.trace.gui.image", QtInfoMsg)
+
 static inline bool isLocked(QImageData *data)
 {
     return data != 0 && data->is_locked;
@@ -2017,6 +2020,7 @@ QImage QImage::convertToFormat_helper(Format format, Qt::ImageConversionFlags fl
         image.d->offset = offset();
         copyMetadata(image.d, d);
 
+        Q_TRACE_SCOPE(lcTraceGuiImage, "QImage::convertToFormat", format);
         converter(image.d, d, flags);
         return image;
     }
@@ -2036,7 +2040,10 @@ QImage QImage::convertToFormat_helper(Format format, Qt::ImageConversionFlags fl
 */
 bool QImage::convertToFormat_inplace(Format format, Qt::ImageConversionFlags flags)
 {
-    return d && d->convertInPlace(format, flags);
+    if (!d)
+        return false;
+    Q_TRACE_SCOPE(lcTraceGuiImage, "QImage::convertToFormat_inplace", format);
+    return d->convertInPlace(format, flags);
 }
 
 static inline int pixel_distance(QRgb p1, QRgb p2) {
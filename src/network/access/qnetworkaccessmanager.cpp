@@ -69,8 +69,12 @@
 
 #include "qthread.h"
 
+#include <QtCore/private/qtrace_p.h>
+
 QT_BEGIN_NAMESPACE
 
+Q_LOGGING_CATEGORY(lcTraceNetworkAccess, "qt.trace.network.access", QtInfoMsg)
+
 Q_GLOBAL_STATIC(QNetworkAccessFileBackendFactory, fileBackend)
 #ifndef QT_NO_FTP
 Q_GLOBAL_STATIC(QNetworkAccessFtpBackendFactory, ftpBackend)
@@ -1363,8 +1367,10 @@ void QNetworkAccessManagerPrivate::_q_replyFinished()
     Q_Q(QNetworkAccessManager);
 
     QNetworkReply *reply = qobject_cast<QNetworkReply *>(q->sender());
-    if (reply)
+    if (reply) {
+        Q_TRACE_ASYNC_END(lcTraceNetworkAccess, "QNetworkReply", quintptr(reply));
         emit q->finished(reply);
+    }
 
 #ifndef QT_NO_BEARERMANAGEMENT
     // If there are no active requests, release our reference to the network session.
@@ -1414,6 +1420,7 @@ QNetworkReply *QNetworkAccessManagerPrivate::postProcess(QNetworkReply *reply)
 {
     Q_Q(QNetworkAccessManager);
     QNetworkReplyPrivate::setManager(reply, q);
+    Q_TRACE_ASYNC_BEGIN(lcTraceNetworkAccess, "QNetworkReply", quintptr(reply));
     q->connect(reply, SIGNAL(finished()), SLOT(_q_replyFinished()));
 #ifndef QT_NO_SSL
     /* In case we're compiled without SSL support, we don't have this signal and we need to
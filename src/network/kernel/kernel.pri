@@ -9,6 +9,7 @@ HEADERS += kernel/qtnetworkglobal.h \
 	   kernel/qauthenticator_p.h \
            kernel/qdnslookup.h \
            kernel/qdnslookup_p.h \
+           kernel/qdnsresolver_p.h \
            kernel/qhostaddress.h \
            kernel/qhostaddress_p.h \
            kernel/qhostinfo.h \
@@ -22,6 +23,7 @@ HEADERS += kernel/qtnetworkglobal.h \
 
 SOURCES += kernel/qauthenticator.cpp \
            kernel/qdnslookup.cpp \
+           kernel/qdnsresolver.cpp \
            kernel/qhostaddress.cpp \
            kernel/qhostinfo.cpp \
            kernel/qnetworkdatagram.cpp \
@@ -0,0 +1,779 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qdnsresolver_p.h"
+
+#ifndef QT_NO_UDPSOCKET
+
+#include "qhostinfo_p.h"
+
+#include <qdatetime.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qtcpsocket.h>
+#include <qtimer.h>
+#include <qudpsocket.h>
+#include <qurl.h>
+#include <quuid.h>
+
+QT_BEGIN_NAMESPACE
+
+// time to wait for a reply before asking the next nameserver
+#ifndef QDNSRESOLVER_TIMEOUT
+#define QDNSRESOLVER_TIMEOUT 2000 // msecs
+#endif
+
+// every nameserver is asked this many times before a query fails
+#ifndef QDNSRESOLVER_ATTEMPTS
+#define QDNSRESOLVER_ATTEMPTS 2
+#endif
+
+// upper bound for the time a result is cached, whatever the server says
+#ifndef QDNSRESOLVER_MAX_TTL
+#define QDNSRESOLVER_MAX_TTL 86400 // secs
+#endif
+
+enum {
+    DnsTypeA = 1,
+    DnsTypeSoa = 6,
+    DnsTypeAaaa = 28,
+    DnsClassIn = 1,
+
+    DnsRcodeNoError = 0,
+    DnsRcodeServFail = 2,
+    DnsRcodeNxDomain = 3,
+    DnsRcodeRefused = 5,
+
+    DnsHeaderSize = 12
+};
+
+static inline quint16 readUInt16(const char *p)
+{
+    const uchar *u = reinterpret_cast<const uchar *>(p);
+    return quint16((u[0] << 8) | u[1]);
+}
+
+static inline quint32 readUInt32(const char *p)
+{
+    const uchar *u = reinterpret_cast<const uchar *>(p);
+    return (quint32(u[0]) << 24) | (quint32(u[1]) << 16) | (quint32(u[2]) << 8) | quint32(u[3]);
+}
+
+static inline void appendUInt16(QByteArray *data, quint16 value)
+{
+    data->append(char(value >> 8));
+    data->append(char(value & 0xff));
+}
+
+// Builds a query for a single question with recursion desired. Returns an
+// empty array if \a aceName cannot be encoded.
+static QByteArray buildQuery(quint16 id, const QByteArray &aceName, quint16 type)
+{
+    QByteArray query;
+    query.reserve(DnsHeaderSize + aceName.size() + 6);
+    appendUInt16(&query, id);
+    appendUInt16(&query, 0x0100); // RD
+    appendUInt16(&query, 1); // QDCOUNT
+    appendUInt16(&query, 0); // ANCOUNT
+    appendUInt16(&query, 0); // NSCOUNT
+    appendUInt16(&query, 0); // ARCOUNT
+
+    int labelStart = 0;
+    while (labelStart < aceName.size()) {
+        int labelEnd = aceName.indexOf('.', labelStart);
+        if (labelEnd < 0)
+            labelEnd = aceName.size();
+        const int labelLength = labelEnd - labelStart;
+        if (labelLength < 1 || labelLength > 63)
+            return QByteArray();
+        query.append(char(labelLength));
+        query.append(aceName.constData() + labelStart, labelLength);
+        labelStart = labelEnd + 1;
+    }
+    query.append('\0');
+    if (query.size() - DnsHeaderSize > 255)
+        return QByteArray();
+
+    appendUInt16(&query, type);
+    appendUInt16(&query, DnsClassIn);
+    return query;
+}
+
+// Reads the (possibly compressed) name at \a *offset, advancing \a *offset
+// past it. Returns false if the name runs off the end of the message or
+// contains a compression loop.
+static bool readName(const QByteArray &message, int *offset, QByteArray *name)
+{
+    const char *data = message.constData();
+    const int size = message.size();
+    int pos = *offset;
+    int jumps = 0;
+    bool jumped = false;
+    name->clear();
+
+    forever {
+        if (pos >= size)
+            return false;
+        const uchar length = uchar(data[pos]);
+        if ((length & 0xc0) == 0xc0) {
+            if (pos + 1 >= size || ++jumps > 64)
+                return false;
+            if (!jumped)
+                *offset = pos + 2;
+            jumped = true;
+            pos = ((length & 0x3f) << 8) | uchar(data[pos + 1]);
+            continue;
+        }
+        if (length & 0xc0)
+            return false;
+        ++pos;
+        if (length == 0)
+            break;
+        if (pos + length > size)
+            return false;
+        if (!name->isEmpty())
+            name->append('.');
+        name->append(data + pos, length);
+        pos += length;
+    }
+
+    if (!jumped)
+        *offset = pos;
+    return true;
+}
+
+// Parses a reply to the question (\a aceName, \a type) with ID \a id.
+// Returns false if \a message is not such a reply.
+static bool parseReply(const QByteArray &message, quint16 id, const QByteArray &aceName,
+                       quint16 type, QDnsResolver::Answer *answer)
+{
+    const char *data = message.constData();
+    const int size = message.size();
+    if (size < DnsHeaderSize || readUInt16(data) != id)
+        return false;
+
+    const quint16 flags = readUInt16(data + 2);
+    if (!(flags & 0x8000)) // QR
+        return false;
+    answer->truncated = flags & 0x0200;
+    answer->rcode = flags & 0x000f;
+    if (readUInt16(data + 4) != 1)
+        return false;
+    const int answerCount = readUInt16(data + 6);
+    const int authorityCount = readUInt16(data + 8);
+
+    // the question must be the one we asked
+    int offset = DnsHeaderSize;
+    QByteArray name;
+    if (!readName(message, &offset, &name) || offset + 4 > size)
+        return false;
+    if (name.toLower() != aceName.toLower()
+            || readUInt16(data + offset) != type || readUInt16(data + offset + 2) != DnsClassIn) {
+        return false;
+    }
+    offset += 4;
+
+    // a truncated reply is retried over TCP, don't bother with the rest
+    if (answer->truncated)
+        return true;
+
+    const int expectedLength = type == DnsTypeA ? 4 : 16;
+    for (int i = 0; i < answerCount + authorityCount; ++i) {
+        if (!readName(message, &offset, &name) || offset + 10 > size)
+            return false;
+        const quint16 rrType = readUInt16(data + offset);
+        const quint16 rrClass = readUInt16(data + offset + 2);
+        const qint64 ttl = qint64(readUInt32(data + offset + 4) & 0x7fffffff);
+        const int rdLength = readUInt16(data + offset + 8);
+        offset += 10;
+        if (offset + rdLength > size)
+            return false;
+
+        if (i < answerCount) {
+            // CNAME records count as well: the addresses are only valid
+            // for as long as the alias is
+            if (rrClass == DnsClassIn) {
+                answer->timeToLive = answer->timeToLive < 0 ? ttl : qMin(answer->timeToLive, ttl);
+                if (rrType == type && rdLength == expectedLength) {
+                    QHostAddress address;
+                    if (type == DnsTypeA)
+                        address.setAddress(readUInt32(data + offset));
+                    else
+                        address.setAddress(reinterpret_cast<const quint8 *>(data + offset));
+                    answer->addresses.append(address);
+                }
+            }
+        } else if (rrType == DnsTypeSoa) {
+            // RFC 2308: negative answers are cached for the smaller of the
+            // SOA's own TTL and its MINIMUM field
+            int soaOffset = offset;
+            QByteArray ignored;
+            if (readName(message, &soaOffset, &ignored) && readName(message, &soaOffset, &ignored)
+                    && soaOffset + 20 <= offset + rdLength) {
+                const qint64 minimum = qint64(readUInt32(data + soaOffset + 16) & 0x7fffffff);
+                answer->negativeTimeToLive = qMin(ttl, minimum);
+            }
+        }
+        offset += rdLength;
+    }
+
+    if (answer->addresses.isEmpty())
+        answer->timeToLive = -1;
+    return true;
+}
+
+static QDnsResolver::Nameserver parseNameserver(const QString &entry)
+{
+    QDnsResolver::Nameserver nameserver;
+    nameserver.port = 53;
+
+    QString host = entry.trimmed();
+    if (!nameserver.address.setAddress(host)) {
+        // "addr:port" or "[addr]:port"
+        const int colon = host.lastIndexOf(QLatin1Char(':'));
+        if (colon > 0) {
+            bool ok;
+            const uint port = host.midRef(colon + 1).toUInt(&ok);
+            host.truncate(colon);
+            if (host.startsWith(QLatin1Char('[')) && host.endsWith(QLatin1Char(']')))
+                host = host.mid(1, host.size() - 2);
+            if (ok && port > 0 && port <= 0xffff && nameserver.address.setAddress(host))
+                nameserver.port = quint16(port);
+            else
+                nameserver.address.clear();
+        }
+    }
+    return nameserver;
+}
+
+namespace {
+// The names in /etc/hosts must keep resolving the way the system resolver
+// resolves them, so they are handed to the thread pool instead.
+struct HostsFile
+{
+    bool contains(const QString &name)
+    {
+#ifdef Q_OS_UNIX
+        QMutexLocker locker(&mutex);
+        if (!checked.isValid() || checked.hasExpired(1000)) {
+            checked.start();
+            const QFileInfo info(QStringLiteral("/etc/hosts"));
+            const QDateTime modified = info.lastModified();
+            if (modified != lastModified) {
+                lastModified = modified;
+                reload();
+            }
+        }
+        return names.contains(name.toLower());
+#else
+        Q_UNUSED(name);
+        return false;
+#endif
+    }
+
+private:
+    void reload()
+    {
+        names.clear();
+        QFile file(QStringLiteral("/etc/hosts"));
+        if (!file.open(QIODevice::ReadOnly))
+            return;
+        while (!file.atEnd()) {
+            QByteArray line = file.readLine();
+            const int comment = line.indexOf('#');
+            if (comment >= 0)
+                line.truncate(comment);
+            const QList<QByteArray> fields = line.simplified().split(' ');
+            for (int i = 1; i < fields.size(); ++i) {
+                QByteArray field = fields.at(i).toLower();
+                if (field.endsWith('.'))
+                    field.chop(1);
+                names.insert(QString::fromLatin1(field));
+            }
+        }
+    }
+
+    QMutex mutex;
+    QElapsedTimer checked;
+    QDateTime lastModified;
+    QSet<QString> names;
+};
+}
+
+Q_GLOBAL_STATIC(HostsFile, hostsFile)
+
+QDnsResolver::QDnsResolver(const QVector<Nameserver> &nameservers, QHostInfoCache *cache)
+    : nameservers(nameservers), cache(cache),
+      timeoutTimer(new QTimer(this))
+{
+    timeoutTimer->setInterval(QDNSRESOLVER_TIMEOUT / 4);
+    connect(timeoutTimer, SIGNAL(timeout()), this, SLOT(checkTimeouts()));
+}
+
+QDnsResolver::~QDnsResolver()
+{
+    // the thread has finished, nobody is waiting for these any more
+    for (Lookup *lookup : qAsConst(lookups)) {
+        for (Query &query : lookup->queries) {
+            dropUdpSocket(&query);
+            dropTcpSocket(&query);
+        }
+        qDeleteAll(lookup->requests);
+        delete lookup;
+    }
+    qDeleteAll(incoming);
+}
+
+/*!
+    \internal
+
+    Returns \c true if QHostInfo should send its queries to the DNS servers
+    itself instead of calling the system resolver from a thread pool.
+*/
+bool QDnsResolver::isEnabled()
+{
+    return qgetenv("QT_HOSTINFO_RESOLVER") == "dns";
+}
+
+/*!
+    \internal
+
+    Returns the nameservers listed in QT_HOSTINFO_NAMESERVERS, or else the
+    ones in /etc/resolv.conf.
+*/
+QVector<QDnsResolver::Nameserver> QDnsResolver::configuredNameservers()
+{
+    QVector<Nameserver> result;
+    const QString configured = QString::fromLocal8Bit(qgetenv("QT_HOSTINFO_NAMESERVERS"));
+    if (!configured.isEmpty()) {
+        const QStringList entries = configured.split(QLatin1Char(','), QString::SkipEmptyParts);
+        for (const QString &entry : entries) {
+            const Nameserver nameserver = parseNameserver(entry);
+            if (!nameserver.address.isNull())
+                result.append(nameserver);
+        }
+        return result;
+    }
+
+#ifdef Q_OS_UNIX
+    QFile file(QStringLiteral("/etc/resolv.conf"));
+    if (file.open(QIODevice::ReadOnly)) {
+        while (!file.atEnd()) {
+            const QList<QByteArray> fields = file.readLine().simplified().split(' ');
+            if (fields.size() < 2 || fields.first() != "nameserver")
+                continue;
+            Nameserver nameserver;
+            nameserver.port = 53;
+            if (nameserver.address.setAddress(QString::fromLatin1(fields.at(1))))
+                result.append(nameserver);
+        }
+    }
+#endif
+    return result;
+}
+
+/*!
+    \internal
+
+    Returns \c true if \a name can be resolved by a plain DNS query. IP
+    addresses (reverse lookups), names that are not fully qualified and
+    would need the search list, multicast DNS names and names listed in
+    the hosts file are left to the system resolver.
+*/
+bool QDnsResolver::canResolve(const QString &name)
+{
+    QHostAddress address;
+    if (address.setAddress(name))
+        return false;
+
+    QByteArray aceName = QUrl::toAce(name);
+    if (aceName.endsWith('.'))
+        aceName.chop(1);
+    if (!aceName.contains('.'))
+        return false;
+    aceName = aceName.toLower();
+    if (aceName.endsWith(".localhost") || aceName.endsWith(".local"))
+        return false;
+
+    return !hostsFile()->contains(QString::fromLatin1(aceName));
+}
+
+// called from any thread
+void QDnsResolver::lookup(QHostInfoRunnable *request)
+{
+    QMutexLocker locker(&mutex);
+    activeIds.insert(request->id);
+    incoming.append(request);
+    if (incoming.size() == 1)
+        QMetaObject::invokeMethod(this, "processRequests", Qt::QueuedConnection);
+}
+
+// called from any thread
+bool QDnsResolver::abortLookup(int id)
+{
+    QMutexLocker locker(&mutex);
+    if (!activeIds.contains(id))
+        return false;
+    abortedIds.insert(id);
+    return true;
+}
+
+void QDnsResolver::processRequests()
+{
+    QList<QHostInfoRunnable *> requests;
+    {
+        QMutexLocker locker(&mutex);
+        requests.swap(incoming);
+    }
+
+    for (QHostInfoRunnable *request : qAsConst(requests)) {
+        QByteArray aceName = QUrl::toAce(request->toBeLookedUp);
+        if (aceName.endsWith('.'))
+            aceName.chop(1);
+        aceName = aceName.toLower();
+
+        // only one lookup per name is in progress
+        if (Lookup *lookup = lookups.value(aceName)) {
+            lookup->requests.append(request);
+            continue;
+        }
+
+        if (buildQuery(0, aceName, DnsTypeA).isEmpty()) {
+            QHostInfo info;
+            info.setHostName(request->toBeLookedUp);
+            info.setError(QHostInfo::HostNotFound);
+            info.setErrorString(QHostInfoAgent::tr("Invalid hostname"));
+            deliver(request, info);
+            continue;
+        }
+
+        Lookup *lookup = new Lookup;
+        lookup->name = request->toBeLookedUp;
+        lookup->aceName = aceName;
+        lookup->requests.append(request);
+        lookups.insert(aceName, lookup);
+
+        // ask for both address families at the same time; the lookup may be
+        // finished (and deleted) by the last send() if no server is reachable
+        static const quint16 types[2] = { DnsTypeAaaa, DnsTypeA };
+        for (int i = 0; i < 2; ++i) {
+            Query &query = lookup->queries[i];
+            query.lookup = lookup;
+            query.type = types[i];
+            query.id = 0;
+            query.attempt = 0;
+            query.finished = false;
+            query.failed = false;
+            query.udpSocket = 0;
+            query.tcpSocket = 0;
+        }
+        send(&lookup->queries[0]);
+        send(&lookup->queries[1]);
+    }
+}
+
+const QDnsResolver::Nameserver &QDnsResolver::nameserverFor(const Query *query) const
+{
+    return nameservers.at(query->attempt % nameservers.size());
+}
+
+void QDnsResolver::readDatagrams(Query *query)
+{
+    QUdpSocket *socket = query->udpSocket;
+    while (socket->hasPendingDatagrams()) {
+        QByteArray datagram(qMax<qint64>(socket->pendingDatagramSize(), 0), Qt::Uninitialized);
+        QHostAddress sender;
+        quint16 senderPort;
+        const qint64 size = socket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
+        if (size < DnsHeaderSize)
+            continue;
+        datagram.resize(int(size));
+
+        // ignore anything that does not come from the server we asked
+        if (readUInt16(datagram.constData()) != query->id)
+            continue;
+        const Nameserver &nameserver = nameserverFor(query);
+        if (senderPort != nameserver.port || sender != nameserver.address)
+            continue;
+        // an accepted reply may finish the query, or even delete it with
+        // its lookup; one that doesn't parse is ignored like a stray one
+        if (handleReply(query, datagram))
+            return;
+    }
+}
+
+void QDnsResolver::send(Query *query)
+{
+    // pick an unpredictable ID that is not in use
+    do {
+        const QByteArray random = QUuid::createUuid().toRfc4122();
+        query->id = readUInt16(random.constData());
+    } while (inFlight.contains(query->id));
+    inFlight.insert(query->id, query);
+    query->sent.start();
+    if (!timeoutTimer->isActive())
+        timeoutTimer->start();
+
+    const Nameserver &nameserver = nameserverFor(query);
+    const QByteArray packet = buildQuery(query->id, query->lookup->aceName, query->type);
+#if defined(QDNSRESOLVER_DEBUG)
+    qDebug("QDnsResolver: query %d for %s (type %d) to %s:%d", query->id,
+           query->lookup->aceName.constData(), query->type,
+           qPrintable(nameserver.address.toString()), nameserver.port);
+#endif
+
+    // every attempt goes out from its own ephemeral port, which makes forged
+    // replies harder to get accepted and releases the port once it is done
+    dropUdpSocket(query);
+    QUdpSocket *socket = new QUdpSocket(this);
+    const bool ipv4 = nameserver.address.protocol() == QAbstractSocket::IPv4Protocol;
+    if (!socket->bind(QHostAddress(ipv4 ? QHostAddress::AnyIPv4 : QHostAddress::AnyIPv6))) {
+#if defined(QDNSRESOLVER_DEBUG)
+        qDebug("QDnsResolver: cannot bind: %s", qPrintable(socket->errorString()));
+#endif
+        delete socket;
+        retry(query, tr("Cannot send a query to the DNS server"));
+        return;
+    }
+    query->udpSocket = socket;
+    connect(socket, &QIODevice::readyRead, this, [this, query]() { readDatagrams(query); });
+    if (socket->writeDatagram(packet, nameserver.address, nameserver.port) != packet.size())
+        retry(query, tr("Cannot send a query to the DNS server"));
+}
+
+void QDnsResolver::dropUdpSocket(Query *query)
+{
+    if (!query->udpSocket)
+        return;
+    query->udpSocket->disconnect(this);
+    query->udpSocket->close();
+    query->udpSocket->deleteLater();
+    query->udpSocket = 0;
+}
+
+void QDnsResolver::dropTcpSocket(Query *query)
+{
+    if (!query->tcpSocket)
+        return;
+    query->tcpSocket->disconnect(this);
+    query->tcpSocket->abort();
+    query->tcpSocket->deleteLater();
+    query->tcpSocket = 0;
+    query->tcpBuffer.clear();
+}
+
+void QDnsResolver::sendOverTcp(Query *query)
+{
+    const Nameserver &nameserver = nameserverFor(query);
+    QByteArray packet = buildQuery(query->id, query->lookup->aceName, query->type);
+    const quint16 length = quint16(packet.size());
+    packet.prepend(char(length & 0xff));
+    packet.prepend(char(length >> 8));
+
+    dropUdpSocket(query);
+    QTcpSocket *socket = new QTcpSocket(this);
+    query->tcpSocket = socket;
+    query->sent.start();
+    connect(socket, &QIODevice::readyRead, this, [this, query]() { readTcpReply(query); });
+    connect(socket, static_cast<void (QAbstractSocket::*)(QAbstractSocket::SocketError)>(&QAbstractSocket::error),
+            this, [this, query]() { retry(query, tr("Connection to the DNS server failed")); });
+    socket->connectToHost(nameserver.address, nameserver.port);
+    // buffered until the connection is established
+    socket->write(packet);
+}
+
+void QDnsResolver::readTcpReply(Query *query)
+{
+    query->tcpBuffer += query->tcpSocket->readAll();
+    if (query->tcpBuffer.size() < 2)
+        return;
+    const int length = readUInt16(query->tcpBuffer.constData());
+    if (query->tcpBuffer.size() < 2 + length)
+        return;
+    if (!handleReply(query, query->tcpBuffer.mid(2, length)))
+        retry(query, tr("Invalid reply received"));
+}
+
+bool QDnsResolver::handleReply(Query *query, const QByteArray &reply)
+{
+    Answer answer;
+    if (!parseReply(reply, query->id, query->lookup->aceName, query->type, &answer))
+        return false;
+
+    if (answer.truncated && !query->tcpSocket) {
+        sendOverTcp(query);
+        return true;
+    }
+
+    switch (answer.rcode) {
+    case DnsRcodeNoError:
+    case DnsRcodeNxDomain:
+        query->answer = answer;
+        finishQuery(query);
+        break;
+    case DnsRcodeServFail:
+        retry(query, tr("Server failure"));
+        break;
+    case DnsRcodeRefused:
+        retry(query, tr("Server refused to answer"));
+        break;
+    default:
+        retry(query, tr("Invalid reply received"));
+        break;
+    }
+    return true;
+}
+
+void QDnsResolver::retry(Query *query, const QString &errorString)
+{
+    inFlight.remove(query->id);
+    dropUdpSocket(query);
+    dropTcpSocket(query);
+    if (++query->attempt >= nameservers.size() * QDNSRESOLVER_ATTEMPTS) {
+        query->failed = true;
+        query->errorString = errorString;
+        finishQuery(query);
+        return;
+    }
+    send(query);
+}
+
+void QDnsResolver::finishQuery(Query *query)
+{
+    query->finished = true;
+    inFlight.remove(query->id);
+    dropUdpSocket(query);
+    dropTcpSocket(query);
+    if (inFlight.isEmpty())
+        timeoutTimer->stop();
+
+    Lookup *lookup = query->lookup;
+    if (lookup->queries[0].finished && lookup->queries[1].finished)
+        finishLookup(lookup);
+}
+
+void QDnsResolver::checkTimeouts()
+{
+    QVector<QPair<quint16, Query *> > expired;
+    for (auto it = inFlight.cbegin(), end = inFlight.cend(); it != end; ++it) {
+        if (it.value()->sent.hasExpired(QDNSRESOLVER_TIMEOUT))
+            expired.append(qMakePair(it.key(), it.value()));
+    }
+
+    // a retry can finish a lookup, and with it the other query of the pair
+    for (const auto &entry : qAsConst(expired)) {
+        if (inFlight.value(entry.first) == entry.second)
+            retry(entry.second, tr("DNS server timed out"));
+    }
+}
+
+void QDnsResolver::finishLookup(Lookup *lookup)
+{
+    const Query &ipv6 = lookup->queries[0];
+    const Query &ipv4 = lookup->queries[1];
+
+    QHostInfo info;
+    info.setHostName(lookup->name);
+    QHostInfoPrivate *d = QHostInfoPrivate::get(info);
+
+    // alternate between the families, IPv6 first, so that connecting to the
+    // addresses in order tries both early on
+    QList<QHostAddress> addresses;
+    const QList<QHostAddress> &addresses6 = ipv6.answer.addresses;
+    const QList<QHostAddress> &addresses4 = ipv4.answer.addresses;
+    for (int i = 0; i < qMax(addresses6.size(), addresses4.size()); ++i) {
+        if (i < addresses6.size())
+            addresses.append(addresses6.at(i));
+        if (i < addresses4.size())
+            addresses.append(addresses4.at(i));
+    }
+
+    if (!addresses.isEmpty()) {
+        info.setAddresses(addresses);
+        qint64 ttl = QDNSRESOLVER_MAX_TTL;
+        for (const Query &query : lookup->queries) {
+            if (!query.answer.addresses.isEmpty())
+                ttl = qMin(ttl, query.answer.timeToLive);
+        }
+        d->timeToLive = ttl;
+    } else if (!ipv6.failed && !ipv4.failed) {
+        // the name does not exist, or it has no addresses
+        info.setError(QHostInfo::HostNotFound);
+        info.setErrorString(QHostInfoAgent::tr("Host not found"));
+        if (ipv6.answer.negativeTimeToLive >= 0 && ipv4.answer.negativeTimeToLive >= 0) {
+            d->timeToLive = qMin<qint64>(QDNSRESOLVER_MAX_TTL,
+                                         qMin(ipv6.answer.negativeTimeToLive,
+                                              ipv4.answer.negativeTimeToLive));
+        }
+    } else {
+        info.setError(QHostInfo::UnknownError);
+        info.setErrorString(ipv6.failed ? ipv6.errorString : ipv4.errorString);
+    }
+
+#if defined(QDNSRESOLVER_DEBUG)
+    qDebug("QDnsResolver: %s finished with %d addresses, error %d, ttl %lld",
+           lookup->aceName.constData(), addresses.size(), info.error(), d->timeToLive);
+#endif
+
+    lookups.remove(lookup->aceName);
+    for (QHostInfoRunnable *request : qAsConst(lookup->requests)) {
+        if (cache->isEnabled())
+            cache->put(request->toBeLookedUp, info);
+        deliver(request, info);
+    }
+    delete lookup;
+}
+
+void QDnsResolver::deliver(QHostInfoRunnable *request, const QHostInfo &info)
+{
+    // emitting only posts an event, so it is done under the lock to make
+    // abortLookup() reliable
+    QMutexLocker locker(&mutex);
+    activeIds.remove(request->id);
+    if (!abortedIds.remove(request->id)) {
+        QHostInfo result(info);
+        result.setLookupId(request->id);
+        request->resultEmitter.emitResultsReady(result);
+    }
+    delete request;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_UDPSOCKET
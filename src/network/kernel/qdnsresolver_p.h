@@ -0,0 +1,167 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QDNSRESOLVER_P_H
+#define QDNSRESOLVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QHostInfo class.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include "QtCore/qbytearray.h"
+#include "QtCore/qelapsedtimer.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qlist.h"
+#include "QtCore/qmutex.h"
+#include "QtCore/qobject.h"
+#include "QtCore/qset.h"
+#include "QtCore/qvector.h"
+#include "QtNetwork/qhostaddress.h"
+
+#ifndef QT_NO_UDPSOCKET
+
+QT_BEGIN_NAMESPACE
+
+//#define QDNSRESOLVER_DEBUG
+
+class QHostInfo;
+class QHostInfoCache;
+class QHostInfoRunnable;
+class QTcpSocket;
+class QTimer;
+class QUdpSocket;
+
+class QDnsResolver : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Nameserver {
+        QHostAddress address;
+        quint16 port;
+    };
+
+    QDnsResolver(const QVector<Nameserver> &nameservers, QHostInfoCache *cache);
+    ~QDnsResolver();
+
+    static bool isEnabled();
+    static QVector<Nameserver> configuredNameservers();
+    static bool canResolve(const QString &name);
+
+    // called from any thread
+    void lookup(QHostInfoRunnable *request);
+    bool abortLookup(int id);
+
+    struct Answer {
+        Answer() : rcode(0), truncated(false), timeToLive(-1), negativeTimeToLive(-1) { }
+
+        int rcode;
+        bool truncated;
+        QList<QHostAddress> addresses;
+        qint64 timeToLive; // -1 if there were no records
+        qint64 negativeTimeToLive; // -1 if there was no SOA record
+    };
+
+private Q_SLOTS:
+    void processRequests();
+    void checkTimeouts();
+
+private:
+    struct Lookup;
+    struct Query {
+        Lookup *lookup;
+        quint16 type;
+        quint16 id;
+        int attempt;
+        bool finished;
+        bool failed;
+        QElapsedTimer sent;
+        QUdpSocket *udpSocket;
+        QTcpSocket *tcpSocket;
+        QByteArray tcpBuffer;
+        Answer answer;
+        QString errorString;
+    };
+    struct Lookup {
+        QString name;
+        QByteArray aceName;
+        QList<QHostInfoRunnable *> requests;
+        Query queries[2];
+    };
+
+    const Nameserver &nameserverFor(const Query *query) const;
+    void readDatagrams(Query *query);
+    void send(Query *query);
+    void dropUdpSocket(Query *query);
+    void dropTcpSocket(Query *query);
+    void sendOverTcp(Query *query);
+    void readTcpReply(Query *query);
+    bool handleReply(Query *query, const QByteArray &reply);
+    void retry(Query *query, const QString &errorString);
+    void finishQuery(Query *query);
+    void finishLookup(Lookup *lookup);
+    void deliver(QHostInfoRunnable *request, const QHostInfo &info);
+
+    QVector<Nameserver> nameservers;
+    QHostInfoCache *cache;
+    QHash<QByteArray, Lookup *> lookups;
+    QHash<quint16, Query *> inFlight;
+    QTimer *timeoutTimer;
+
+    // guards the members below, which are also used from the threads that
+    // start and abort lookups
+    QMutex mutex;
+    QList<QHostInfoRunnable *> incoming;
+    QSet<int> activeIds;
+    QSet<int> abortedIds;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_UDPSOCKET
+
+#endif // QDNSRESOLVER_P_H
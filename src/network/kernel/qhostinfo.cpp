@@ -39,6 +39,7 @@
 
 #include "qhostinfo.h"
 #include "qhostinfo_p.h"
+#include "qdnsresolver_p.h"
 
 #include "QtCore/qscopedpointer.h"
 #include <qabstracteventdispatcher.h>
@@ -146,7 +147,18 @@ std::pair<OutputIt1, OutputIt2> separate_if(InputIt first, InputIt last, OutputI
     but also changes the order of signal emissions when using lookupHost()
     compared to previous versions of Qt.
     \note Since Qt 4.6.3 QHostInfo is using a small internal 60 second DNS cache
-    for performance improvements.
+    for performance improvements. Since Qt 5.8 the number of cached names can
+    be set with the \c QT_HOSTINFO_CACHE_SIZE environment variable (128 by
+    default).
+    \note Since Qt 5.8, if the \c QT_HOSTINFO_RESOLVER environment variable is
+    set to \c dns, lookupHost() sends the queries for fully qualified names
+    directly to the DNS servers listed in \c /etc/resolv.conf, or to the
+    comma-separated \e{address}[:\e{port}] list in \c QT_HOSTINFO_NAMESERVERS.
+    The IPv4 and IPv6 addresses are then queried in parallel from a single
+    thread, and results are cached for as long as the server allows,
+    including negative answers. Names listed in the hosts file, names that
+    need the search list, and names ending in \c .local are still resolved by
+    the operating system.
 
     \sa QAbstractSocket, {http://www.rfc-editor.org/rfc/rfc3492.txt}{RFC 3492}
 */
@@ -237,7 +249,10 @@ int QHostInfo::lookupHost(const QString &name, QObject *receiver,
         QHostInfoRunnable* runnable = new QHostInfoRunnable(name, id);
         if (receiver)
             QObject::connect(&runnable->resultEmitter, SIGNAL(resultsReady(QHostInfo)), receiver, member, Qt::QueuedConnection);
-        manager->scheduleLookup(runnable);
+#ifndef QT_NO_UDPSOCKET
+        if (!manager->lookupWithDnsResolver(runnable))
+#endif
+            manager->scheduleLookup(runnable);
     }
     return id;
 }
@@ -552,7 +567,11 @@ void QHostInfoRunnable::run()
     // thread goes back to QThreadPool
 }
 
-QHostInfoLookupManager::QHostInfoLookupManager() : mutex(QMutex::Recursive), wasDeleted(false)
+QHostInfoLookupManager::QHostInfoLookupManager()
+    : mutex(QMutex::Recursive), wasDeleted(false)
+#ifndef QT_NO_UDPSOCKET
+    , resolver(0), resolverChecked(false)
+#endif
 {
     moveToThread(QCoreApplicationPrivate::mainThread());
     connect(QCoreApplication::instance(), SIGNAL(destroyed()), SLOT(waitForThreadPoolDone()), Qt::DirectConnection);
@@ -580,9 +599,69 @@ void QHostInfoLookupManager::clear()
     }
 
     threadPool.waitForDone();
+#ifndef QT_NO_UDPSOCKET
+    // the environment is read again for the next lookup
+    stopDnsResolver();
+#endif
     cache.clear();
 }
 
+void QHostInfoLookupManager::waitForThreadPoolDone()
+{
+    threadPool.waitForDone();
+#ifndef QT_NO_UDPSOCKET
+    stopDnsResolver();
+#endif
+}
+
+#ifndef QT_NO_UDPSOCKET
+// Hands \a runnable to the built-in resolver. Returns false if the thread
+// pool should look it up instead.
+bool QHostInfoLookupManager::lookupWithDnsResolver(QHostInfoRunnable *runnable)
+{
+    if (wasDeleted)
+        return false;
+
+    // stopDnsResolver() takes the resolver away with the mutex locked, so
+    // it stays alive while the lookup is passed on
+    QMutexLocker locker(&this->mutex);
+    if (!resolverChecked) {
+        resolverChecked = true;
+        if (QDnsResolver::isEnabled()) {
+            const QVector<QDnsResolver::Nameserver> nameservers = QDnsResolver::configuredNameservers();
+            if (!nameservers.isEmpty()) {
+                resolver = new QDnsResolver(nameservers, &cache);
+                resolver->moveToThread(&resolverThread);
+                resolverThread.start();
+            }
+        }
+    }
+
+    if (!resolver || !QDnsResolver::canResolve(runnable->toBeLookedUp))
+        return false;
+    resolver->lookup(runnable);
+    return true;
+}
+
+void QHostInfoLookupManager::stopDnsResolver()
+{
+    QDnsResolver *dns;
+    {
+        QMutexLocker locker(&this->mutex);
+        dns = resolver;
+        resolver = 0;
+        resolverChecked = false;
+    }
+    if (!dns)
+        return;
+
+    // the resolver's sockets must be destroyed in its own thread
+    connect(&resolverThread, SIGNAL(finished()), dns, SLOT(deleteLater()));
+    resolverThread.quit();
+    resolverThread.wait();
+}
+#endif
+
 void QHostInfoLookupManager::work()
 {
     if (wasDeleted)
@@ -656,6 +735,11 @@ void QHostInfoLookupManager::abortLookup(int id)
 
     QMutexLocker locker(&this->mutex);
 
+#ifndef QT_NO_UDPSOCKET
+    if (resolver && resolver->abortLookup(id))
+        return;
+#endif
+
     // is postponed? delete and return
     for (int i = 0; i < postponedLookups.length(); i++) {
         if (postponedLookups.at(i)->id == id) {
@@ -747,13 +831,17 @@ void qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolut
 }
 #endif
 
-// cache for 60 seconds
-// cache 128 items
+// cache for 60 seconds, unless the result carries its own time to live
+// cache 128 items, unless QT_HOSTINFO_CACHE_SIZE says otherwise
 QHostInfoCache::QHostInfoCache() : max_age(60), enabled(true), cache(128)
 {
 #ifdef QT_QHOSTINFO_CACHE_DISABLED_BY_DEFAULT
     enabled = false;
 #endif
+    bool ok;
+    const int size = qEnvironmentVariableIntValue("QT_HOSTINFO_CACHE_SIZE", &ok);
+    if (ok && size > 0)
+        cache.setMaxCost(size);
 }
 
 bool QHostInfoCache::isEnabled()
@@ -775,7 +863,7 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
 
     *valid = false;
     if (QHostInfoCacheElement *element = cache.object(name)) {
-        if (element->age.elapsed() < max_age*1000)
+        if (element->age.elapsed() < element->lifetime)
             *valid = true;
         return element->info;
 
@@ -789,12 +877,17 @@ QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
 
 void QHostInfoCache::put(const QString &name, const QHostInfo &info)
 {
-    // if the lookup failed, don't cache
-    if (info.error() != QHostInfo::NoError)
+    // if the lookup failed, only cache it when the DNS server told us for how
+    // long the name is known not to exist
+    const qint64 timeToLive = QHostInfoPrivate::get(info)->timeToLive;
+    if (info.error() != QHostInfo::NoError && timeToLive < 0)
+        return;
+    if (timeToLive == 0)
         return;
 
     QHostInfoCacheElement* element = new QHostInfoCacheElement();
     element->info = info;
+    element->lifetime = (timeToLive < 0 ? max_age : timeToLive) * 1000;
     element->age = QElapsedTimer();
     element->age.start();
 
@@ -88,6 +88,7 @@ public:
     static QString localDomainName();
 
 private:
+    friend class QHostInfoPrivate;
     QScopedPointer<QHostInfoPrivate> d;
 };
 
@@ -104,9 +104,13 @@ public:
     inline QHostInfoPrivate()
         : err(QHostInfo::NoError),
           errorStr(QLatin1String(QT_TRANSLATE_NOOP("QHostInfo", "Unknown error"))),
-          lookupId(0)
+          lookupId(0),
+          timeToLive(-1)
     {
     }
+
+    static inline QHostInfoPrivate *get(QHostInfo &info) { return info.d.data(); }
+    static inline const QHostInfoPrivate *get(const QHostInfo &info) { return info.d.data(); }
 #ifndef QT_NO_BEARERMANAGEMENT
     //not a public API yet
     static QHostInfo fromName(const QString &hostName, QSharedPointer<QNetworkSession> networkSession);
@@ -117,6 +121,7 @@ public:
     QList<QHostAddress> addrs;
     QString hostName;
     int lookupId;
+    qint64 timeToLive; // seconds the result may be cached for, -1 if unknown
 };
 
 // These functions are outside of the QHostInfo class and strictly internal.
@@ -130,7 +135,7 @@ class QHostInfoCache
 {
 public:
     QHostInfoCache();
-    const int max_age; // seconds
+    const int max_age; // seconds, for results that carry no time to live
 
     QHostInfo get(const QString &name, bool *valid);
     void put(const QString &name, const QHostInfo &info);
@@ -143,6 +148,7 @@ private:
     struct QHostInfoCacheElement {
         QHostInfo info;
         QElapsedTimer age;
+        qint64 lifetime; // msecs
     };
     QCache<QString,QHostInfoCacheElement> cache;
     QMutex mutex;
@@ -178,6 +184,8 @@ protected:
 
 };
 
+class QDnsResolver;
+
 class QHostInfoLookupManager : public QAbstractHostInfoLookupManager
 {
     Q_OBJECT
@@ -191,6 +199,9 @@ public:
     // called from QHostInfo
     void scheduleLookup(QHostInfoRunnable *r);
     void abortLookup(int id);
+#ifndef QT_NO_UDPSOCKET
+    bool lookupWithDnsResolver(QHostInfoRunnable *runnable);
+#endif
 
     // called from QHostInfoRunnable
     void lookupFinished(QHostInfoRunnable *r);
@@ -210,8 +221,17 @@ protected:
 
     bool wasDeleted;
 
+#ifndef QT_NO_UDPSOCKET
+    // the built-in DNS resolver, used instead of the thread pool if enabled
+    void stopDnsResolver();
+
+    QThread resolverThread;
+    QDnsResolver *resolver;
+    bool resolverChecked;
+#endif
+
 private slots:
-    void waitForThreadPoolDone() { threadPool.waitForDone(); }
+    void waitForThreadPoolDone();
 };
 
 QT_END_NAMESPACE
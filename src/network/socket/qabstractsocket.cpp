@@ -462,6 +462,7 @@
 #include "private/qnetworksession_p.h"
 
 #include <qabstracteventdispatcher.h>
+#include <qfiledevice.h>
 #include <qhostaddress.h>
 #include <qhostinfo.h>
 #include <qmetaobject.h>
@@ -491,11 +492,64 @@
 #ifndef QABSTRACTSOCKET_BUFFERSIZE
 #define QABSTRACTSOCKET_BUFFERSIZE 32768
 #endif
+#ifndef QABSTRACTSOCKET_MAXWRITEBLOCKS
+#define QABSTRACTSOCKET_MAXWRITEBLOCKS 1024
+#endif
 #define QT_CONNECT_TIMEOUT 30000
+// RFC 8305 recommends 250 msecs between connection attempts
+#ifndef QABSTRACTSOCKET_CONNECTION_ATTEMPT_DELAY
+#define QABSTRACTSOCKET_CONNECTION_ATTEMPT_DELAY 250
+#endif
 #define QT_TRANSFER_TIMEOUT 120000
 
 QT_BEGIN_NAMESPACE
 
+/*! \internal
+
+    Receives the notifications of a socket engine whose connection attempt
+    races the socket's current one.
+*/
+class QAbstractSocketConnectionAttempt : public QAbstractSocketEngineReceiver
+{
+public:
+    QAbstractSocketConnectionAttempt(QAbstractSocketPrivate *d, QAbstractSocketEngine *engine,
+                                     const QHostAddress &address, const QElapsedTimer &started)
+        : d(d), engine(engine), address(address), started(started)
+    {
+        engine->setReceiver(this);
+    }
+    ~QAbstractSocketConnectionAttempt()
+    {
+        if (engine) {
+            engine->close();
+            engine->disconnect();
+            delete engine;
+        }
+    }
+
+    QAbstractSocketEngine *takeEngine()
+    {
+        QAbstractSocketEngine *taken = engine;
+        engine = 0;
+        return taken;
+    }
+
+    // from QAbstractSocketEngineReceiver
+    void readNotification() Q_DECL_OVERRIDE {}
+    void writeNotification() Q_DECL_OVERRIDE { d->connectionAttemptFinished(this); }
+    void closeNotification() Q_DECL_OVERRIDE {}
+    void exceptionNotification() Q_DECL_OVERRIDE {}
+    void connectionNotification() Q_DECL_OVERRIDE { d->connectionAttemptFinished(this); }
+#ifndef QT_NO_NETWORKPROXY
+    void proxyAuthenticationRequired(const QNetworkProxy &, QAuthenticator *) Q_DECL_OVERRIDE {}
+#endif
+
+    QAbstractSocketPrivate *d;
+    QAbstractSocketEngine *engine;
+    QHostAddress address;
+    QElapsedTimer started;
+};
+
 #if defined QABSTRACTSOCKET_DEBUG
 QT_BEGIN_INCLUDE_NAMESPACE
 #include <qstring.h>
@@ -567,6 +621,8 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       hasPendingData(false),
       connectTimer(0),
       disconnectTimer(0),
+      connectionAttemptDelayTimer(0),
+      connectionAttemptDelay(-1),
       hostLookupId(-1),
       socketType(QAbstractSocket::UnknownSocketType),
       state(QAbstractSocket::UnconnectedState),
@@ -587,7 +643,8 @@ QAbstractSocketPrivate::~QAbstractSocketPrivate()
 
 /*! \internal
 
-    Resets the socket layer and deletes any socket notifiers.
+    Resets the socket layer and deletes any socket notifiers. Connection
+    attempts racing the current one are aborted as well.
 */
 void QAbstractSocketPrivate::resetSocketLayer()
 {
@@ -595,6 +652,17 @@ void QAbstractSocketPrivate::resetSocketLayer()
     qDebug("QAbstractSocketPrivate::resetSocketLayer()");
 #endif
 
+    abortRacingAttempts();
+    resetSocketEngine();
+}
+
+/*! \internal
+
+    Deletes the current socket engine and stops its timers, leaving any
+    racing connection attempts alone.
+*/
+void QAbstractSocketPrivate::resetSocketEngine()
+{
     hasPendingData = false;
     if (socketEngine) {
         socketEngine->close();
@@ -607,6 +675,8 @@ void QAbstractSocketPrivate::resetSocketLayer()
         connectTimer->stop();
     if (disconnectTimer)
         disconnectTimer->stop();
+    if (connectionAttemptDelayTimer)
+        connectionAttemptDelayTimer->stop();
 }
 
 /*! \internal
@@ -635,7 +705,7 @@ bool QAbstractSocketPrivate::initSocketLayer(QAbstractSocket::NetworkLayerProtoc
     else protocolStr = QLatin1String("UnknownNetworkLayerProtocol");
 #endif
 
-    resetSocketLayer();
+    resetSocketEngine();
     socketEngine = QAbstractSocketEngine::createSocketEngine(q->socketType(), proxyInUse, q);
     if (!socketEngine) {
         setError(QAbstractSocket::UnsupportedSocketOperationError,
@@ -828,7 +898,7 @@ void QAbstractSocketPrivate::connectionNotification()
 bool QAbstractSocketPrivate::writeToSocket()
 {
     Q_Q(QAbstractSocket);
-    if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
+    if (!socketEngine || !socketEngine->isValid() || (!hasPendingWrites()
         && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::writeToSocket() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
@@ -846,11 +916,27 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
-    qint64 nextSize = writeBuffer.nextDataBlockSize();
-    const char *ptr = writeBuffer.readPointer();
+    // a file queued by sendFile() goes out once the data written before it did
+    if (!pendingFiles.isEmpty() && pendingFiles.constFirst().bufferedBefore == 0)
+        return writeFileToSocket();
+
+    qint64 nextSize = writeBuffer.size();
+    if (!pendingFiles.isEmpty())
+        nextSize = qMin(nextSize, pendingFiles.constFirst().bufferedBefore);
 
-    // Attempt to write it all in one chunk.
-    qint64 written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+    // Attempt to write it all at once, gathering the buffer's blocks into
+    // a single call when there are several of them.
+    qint64 written = 0;
+    if (nextSize) {
+        const int maxBlocks = qMin(writeBuffer.blockCount(), QABSTRACTSOCKET_MAXWRITEBLOCKS);
+        QVarLengthArray<const char *, 16> blocks(maxBlocks);
+        QVarLengthArray<qint64, 16> blockSizes(maxBlocks);
+        const int blockCount = writeBuffer.readPointers(blocks.data(), blockSizes.data(),
+                                                        maxBlocks, nextSize);
+        written = blockCount == 1 ? socketEngine->write(blocks[0], blockSizes[0])
+                                  : socketEngine->writeMultiple(blocks.constData(),
+                                                                blockSizes.constData(), blockCount);
+    }
     if (written < 0) {
 #if defined (QABSTRACTSOCKET_DEBUG)
         qDebug() << "QAbstractSocketPrivate::writeToSocket() write error, aborting."
@@ -870,12 +956,14 @@ bool QAbstractSocketPrivate::writeToSocket()
     if (written > 0) {
         // Remove what we wrote so far.
         writeBuffer.free(written);
+        for (PendingFile &pending : pendingFiles)
+            pending.bufferedBefore -= written;
 
         // Emit notifications.
         emitBytesWritten(written);
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
+    if (!hasPendingWrites() && socketEngine && !socketEngine->bytesToWrite())
         socketEngine->setWriteNotificationEnabled(false);
     if (state == QAbstractSocket::ClosingState)
         q->disconnectFromHost();
@@ -883,6 +971,88 @@ bool QAbstractSocketPrivate::writeToSocket()
     return written > 0;
 }
 
+/*! \internal
+
+    Writes the next part of the file at the head of the sendFile() queue to
+    the socket, using QAbstractSocketEngine::sendFile() if possible. If the
+    socket engine cannot send the file directly, the file is read into the
+    front of the write buffer one chunk at a time and sent from there.
+
+    Emits bytesWritten().
+*/
+bool QAbstractSocketPrivate::writeFileToSocket()
+{
+    Q_Q(QAbstractSocket);
+    PendingFile &pending = pendingFiles.first();
+    QFileDevice *file = pending.file.data();
+    if (!file || !file->isOpen()) {
+        setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                        QAbstractSocket::tr("File was closed before it could be sent"));
+        q->abort();
+        return false;
+    }
+
+    if (pending.zeroCopy) {
+        qint64 written = socketEngine->sendFile(file->handle(), pending.offset, pending.remaining);
+        if (written < 0 && socketEngine->error() != QAbstractSocket::UnsupportedSocketOperationError) {
+            setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
+            q->abort();
+            return false;
+        }
+
+        // sendfile() also sends nothing at the end of the file; don't wait
+        // for a write notification that would only repeat that
+        if (written == 0 && file->size() < pending.offset + pending.remaining) {
+            setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                            QAbstractSocket::tr("File was truncated before it could be sent"));
+            q->abort();
+            return false;
+        }
+
+        if (written >= 0) {
+#if defined (QABSTRACTSOCKET_DEBUG)
+            qDebug("QAbstractSocketPrivate::writeFileToSocket() %lld bytes sent from file", written);
+#endif
+            pending.offset += written;
+            pending.remaining -= written;
+            if (pending.remaining == 0)
+                pendingFiles.removeFirst();
+            if (written > 0)
+                emitBytesWritten(written);
+
+            if (!hasPendingWrites() && !socketEngine->bytesToWrite())
+                socketEngine->setWriteNotificationEnabled(false);
+            if (state == QAbstractSocket::ClosingState)
+                q->disconnectFromHost();
+            return written > 0;
+        }
+
+        // not supported for this socket or this file, read it instead
+        pending.zeroCopy = false;
+    }
+
+    const qint64 chunkSize = qMin(pending.remaining, qint64(QABSTRACTSOCKET_BUFFERSIZE));
+    QByteArray chunk;
+    if (file->seek(pending.offset))
+        chunk = file->read(chunkSize);
+    if (chunk.isEmpty()) {
+        setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                        QAbstractSocket::tr("Unable to read the file to send: %1").arg(file->errorString()));
+        q->abort();
+        return false;
+    }
+
+    memcpy(writeBuffer.reserveFront(chunk.size()), chunk.constData(), chunk.size());
+    pending.offset += chunk.size();
+    pending.remaining -= chunk.size();
+    for (PendingFile &other : pendingFiles)
+        other.bufferedBefore += chunk.size();
+    if (pending.remaining == 0)
+        pendingFiles.removeFirst();
+
+    return writeToSocket();
+}
+
 /*! \internal
 
     Writes pending data in the write buffers to the socket. The function
@@ -893,7 +1063,7 @@ bool QAbstractSocketPrivate::flush()
 {
     bool dataWasWritten = false;
 
-    while (!allWriteBuffersEmpty() && writeToSocket())
+    while (hasPendingWrites() && writeToSocket())
         dataWasWritten = true;
 
     return dataWasWritten;
@@ -1025,6 +1195,36 @@ void QAbstractSocketPrivate::_q_startConnecting(const QHostInfo &hostInfo)
     qDebug("QAbstractSocketPrivate::_q_startConnecting(hostInfo == %s)", s.toLatin1().constData());
 #endif
 
+    // Race the connection attempts, unless a proxy does the connecting
+    // or there is no event loop to start the later attempts from.
+    bool ok;
+    connectionAttemptDelay = qEnvironmentVariableIntValue("QT_CONNECTION_ATTEMPT_DELAY", &ok);
+    if (!ok)
+        connectionAttemptDelay = QABSTRACTSOCKET_CONNECTION_ATTEMPT_DELAY;
+#ifndef QT_NO_NETWORKPROXY
+    if (proxyInUse.type() != QNetworkProxy::NoProxy)
+        connectionAttemptDelay = -1;
+#endif
+    if (cachedSocketDescriptor != -1 || !threadData->hasEventDispatcher())
+        connectionAttemptDelay = -1;
+
+    // Alternate between the address families, keeping the family of the
+    // first address first, so that a broken family only delays the first
+    // attempt of the other one (RFC 8305 section 4).
+    if (connectionAttemptDelay >= 0 && addresses.count() > 2) {
+        const QAbstractSocket::NetworkLayerProtocol firstFamily = addresses.first().protocol();
+        QList<QHostAddress> first, second;
+        for (const QHostAddress &address : qAsConst(addresses))
+            (address.protocol() == firstFamily ? first : second).append(address);
+        addresses.clear();
+        for (int i = 0; i < qMax(first.count(), second.count()); ++i) {
+            if (i < first.count())
+                addresses += first.at(i);
+            if (i < second.count())
+                addresses += second.at(i);
+        }
+    }
+
     // Try all addresses twice.
     addresses += addresses;
 
@@ -1069,6 +1269,12 @@ void QAbstractSocketPrivate::_q_connectToNextAddress()
     do {
         // Check for more pending addresses
         if (addresses.isEmpty()) {
+            // Attempts started earlier may still connect; continue with
+            // the oldest one.
+            if (!racingAttempts.isEmpty()) {
+                adoptConnectionAttempt(racingAttempts.takeFirst());
+                return;
+            }
 #if defined(QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocketPrivate::_q_connectToNextAddress(), all addresses failed.");
 #endif
@@ -1095,6 +1301,17 @@ void QAbstractSocketPrivate::_q_connectToNextAddress()
             return;
         }
 
+        // If the next address is still being tried by a racing attempt,
+        // wait for that attempt; the address stays pending for its second
+        // try, which is only made once the attempt has failed.
+        for (QAbstractSocketConnectionAttempt *attempt : qAsConst(racingAttempts)) {
+            if (attempt->address == addresses.first()) {
+                racingAttempts.removeOne(attempt);
+                adoptConnectionAttempt(attempt);
+                return;
+            }
+        }
+
         // Pick the first host address candidate
         host = addresses.takeFirst();
 #if defined(QABSTRACTSOCKET_DEBUG)
@@ -1120,6 +1337,7 @@ void QAbstractSocketPrivate::_q_connectToNextAddress()
 #endif
             socketEngine->connectToHost(host, port)) {
                 //_q_testConnection();
+                abortRacingAttempts();
                 fetchConnectionParameters();
                 return;
         }
@@ -1143,6 +1361,19 @@ void QAbstractSocketPrivate::_q_connectToNextAddress()
                                  Qt::DirectConnection);
             }
             connectTimer->start(QT_CONNECT_TIMEOUT);
+            connectAttemptTimer.start();
+
+            // Start the next attempt if this one takes too long.
+            if (connectionAttemptDelay >= 0 && !addresses.isEmpty()) {
+                if (!connectionAttemptDelayTimer) {
+                    connectionAttemptDelayTimer = new QTimer(q);
+                    connectionAttemptDelayTimer->setSingleShot(true);
+                    QObject::connect(connectionAttemptDelayTimer, SIGNAL(timeout()),
+                                     q, SLOT(_q_startNextConnectionAttempt()),
+                                     Qt::DirectConnection);
+                }
+                connectionAttemptDelayTimer->start(connectionAttemptDelay);
+            }
         }
 
         // Wait for a write notification that will eventually call
@@ -1166,6 +1397,7 @@ void QAbstractSocketPrivate::_q_testConnection()
         if (socketEngine->state() == QAbstractSocket::ConnectedState) {
             // Fetch the parameters if our connection is completed;
             // otherwise, fall out and try the next address.
+            abortRacingAttempts();
             fetchConnectionParameters();
             if (pendingClose) {
                 q_func()->disconnectFromHost();
@@ -1205,6 +1437,8 @@ void QAbstractSocketPrivate::_q_abortConnectionAttempt()
     connectTimer->stop();
 
     if (addresses.isEmpty()) {
+        // the racing attempts started before this one
+        abortRacingAttempts();
         state = QAbstractSocket::UnconnectedState;
         setError(QAbstractSocket::SocketTimeoutError,
                  QAbstractSocket::tr("Connection timed out"));
@@ -1215,6 +1449,115 @@ void QAbstractSocketPrivate::_q_abortConnectionAttempt()
     }
 }
 
+/*! \internal
+
+    Called when the current connection attempt has not finished within
+    the connection attempt delay. The attempt keeps running in the
+    background, and the next address is tried next to it.
+*/
+void QAbstractSocketPrivate::_q_startNextConnectionAttempt()
+{
+    if (state != QAbstractSocket::ConnectingState || addresses.isEmpty() || !socketEngine
+        || socketEngine->state() != QAbstractSocket::ConnectingState) {
+        return;
+    }
+
+    // Don't race an address against itself, the second try of each
+    // address is only made once the first one has failed.
+    const QHostAddress &next = addresses.first();
+    if (next == host)
+        return;
+    for (const QAbstractSocketConnectionAttempt *attempt : qAsConst(racingAttempts)) {
+        if (attempt->address == next)
+            return;
+    }
+
+#if defined(QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::_q_startNextConnectionAttempt(), %s is slow, trying %s as well",
+           host.toString().toLatin1().constData(), next.toString().toLatin1().constData());
+#endif
+    racingAttempts.append(new QAbstractSocketConnectionAttempt(this, socketEngine, host,
+                                                               connectAttemptTimer));
+    socketEngine = 0;
+    cachedSocketDescriptor = -1;
+    if (connectTimer)
+        connectTimer->stop();
+    _q_connectToNextAddress();
+}
+
+/*! \internal
+
+    Called when the racing connection attempt \a attempt has connected or
+    failed. The first attempt to connect becomes the socket's connection.
+*/
+void QAbstractSocketPrivate::connectionAttemptFinished(QAbstractSocketConnectionAttempt *attempt)
+{
+    const QAbstractSocket::SocketState attemptState = attempt->engine->state();
+    if (attemptState == QAbstractSocket::ConnectingState)
+        return;
+    racingAttempts.removeOne(attempt);
+
+    if (attemptState == QAbstractSocket::ConnectedState) {
+#if defined(QABSTRACTSOCKET_DEBUG)
+        qDebug("QAbstractSocketPrivate::connectionAttemptFinished(), %s won",
+               attempt->address.toString().toLatin1().constData());
+#endif
+        abortRacingAttempts();
+        adoptConnectionAttempt(attempt);
+        return;
+    }
+
+#if defined(QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::connectionAttemptFinished(), %s failed (%s)",
+           attempt->address.toString().toLatin1().constData(),
+           attempt->engine->errorString().toLatin1().constData());
+#endif
+    delete attempt;
+
+    // A failed attempt doesn't need to be waited for (RFC 8305 section 5).
+    if (connectionAttemptDelayTimer && connectionAttemptDelayTimer->isActive()) {
+        connectionAttemptDelayTimer->stop();
+        _q_startNextConnectionAttempt();
+    }
+}
+
+/*! \internal
+
+    Makes the engine of \a attempt the socket's engine again, and deletes
+    \a attempt.
+*/
+void QAbstractSocketPrivate::adoptConnectionAttempt(QAbstractSocketConnectionAttempt *attempt)
+{
+    resetSocketEngine();
+    socketEngine = attempt->takeEngine();
+    socketEngine->setReceiver(this);
+    host = attempt->address;
+    const qint64 elapsed = attempt->started.elapsed();
+    delete attempt;
+
+    if (socketEngine->state() != QAbstractSocket::ConnectingState) {
+        _q_testConnection();
+        return;
+    }
+
+    // keep waiting, for the rest of the time this attempt was given
+    if (connectTimer) {
+        connectTimer->start(int(qMax<qint64>(0, QT_CONNECT_TIMEOUT - elapsed)));
+        connectAttemptTimer.start();
+    }
+    socketEngine->setWriteNotificationEnabled(true);
+}
+
+/*! \internal
+
+    Aborts all connection attempts racing the current one.
+*/
+void QAbstractSocketPrivate::abortRacingAttempts()
+{
+    qDeleteAll(racingAttempts);
+    racingAttempts.clear();
+}
+
 void QAbstractSocketPrivate::_q_forceDisconnect()
 {
     Q_Q(QAbstractSocket);
@@ -1641,6 +1984,14 @@ bool QAbstractSocket::isValid() const
     established, QAbstractSocket enters ConnectedState and
     emits connected().
 
+    Since Qt 5.8, if the lookup returns several addresses, the next one is
+    tried when the previous attempt has not succeeded after 250
+    milliseconds, without aborting it, and addresses of the two IP
+    families are tried alternately (RFC 8305, "Happy Eyeballs"). The
+    first attempt to succeed is used. The delay can be changed with the
+    \c QT_CONNECTION_ATTEMPT_DELAY environment variable; a negative value
+    tries the addresses one at a time.
+
     At any point, the socket can emit error() to signal that an error
     occurred.
 
@@ -1673,6 +2024,7 @@ void QAbstractSocket::connectToHost(const QString &hostName, quint16 port,
     d->port = port;
     d->setReadChannelCount(0);
     d->setWriteChannelCount(0);
+    d->pendingFiles.clear();
     d->abortCalled = false;
     d->pendingClose = false;
     if (d->state != BoundState) {
@@ -1769,7 +2121,10 @@ void QAbstractSocket::connectToHost(const QHostAddress &address, quint16 port,
 */
 qint64 QAbstractSocket::bytesToWrite() const
 {
-    const qint64 pendingBytes = QIODevice::bytesToWrite();
+    Q_D(const QAbstractSocket);
+    qint64 pendingBytes = QIODevice::bytesToWrite();
+    for (const QAbstractSocketPrivate::PendingFile &pending : d->pendingFiles)
+        pendingBytes += pending.remaining;
 #if defined(QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocket::bytesToWrite() == %lld", pendingBytes);
 #endif
@@ -1914,6 +2269,7 @@ bool QAbstractSocket::setSocketDescriptor(qintptr socketDescriptor, SocketState
     d->resetSocketLayer();
     d->setReadChannelCount(0);
     d->setWriteChannelCount(0);
+    d->pendingFiles.clear();
     d->socketEngine = QAbstractSocketEngine::createSocketEngine(socketDescriptor, this);
     if (!d->socketEngine) {
         d->setError(UnsupportedSocketOperationError, tr("Operation on socket is not supported"));
@@ -2237,7 +2593,7 @@ bool QAbstractSocketPrivate::waitForReadyRead(QDeadlineTimer deadline)
 
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !writeBuffer.isEmpty(),
+        if (!socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, hasPendingWrites(),
                                                  deadline)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2301,7 +2657,7 @@ bool QAbstractSocketPrivate::waitForBytesWritten(QDeadlineTimer deadline)
         return false;
     }
 
-    if (writeBuffer.isEmpty())
+    if (!hasPendingWrites())
         return false;
 
     // handle a socket in connecting state
@@ -2315,7 +2671,7 @@ bool QAbstractSocketPrivate::waitForBytesWritten(QDeadlineTimer deadline)
         bool readyToWrite = false;
         if (!socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite,
                                   !readBufferMaxSize || buffer.size() < readBufferMaxSize,
-                                  !writeBuffer.isEmpty(),
+                                  hasPendingWrites(),
                                   deadline)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForBytesWritten(%i) failed (%i, %s)",
@@ -2405,7 +2761,7 @@ bool QAbstractSocketPrivate::waitForClosed(QDeadlineTimer deadline)
         bool readyToRead = false;
         bool readyToWrite = false;
         if (!socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, state == QAbstractSocket::ConnectedState,
-                                              !writeBuffer.isEmpty(),
+                                              hasPendingWrites(),
                                                  deadline)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2442,6 +2798,7 @@ void QAbstractSocket::abort()
     qDebug("QAbstractSocket::abort()");
 #endif
     d->setWriteChannelCount(0);
+    d->pendingFiles.clear();
     if (d->state == UnconnectedState)
         return;
 #ifndef QT_NO_SSL
@@ -2499,6 +2856,85 @@ bool QAbstractSocket::flush()
     return d_func()->flush();
 }
 
+/*!
+    \since 5.8
+
+    Queues \a length bytes of \a file, starting at \a offset, to be sent
+    over the socket after any data that has already been written. If \a
+    length is -1, everything from \a offset to the end of the file is sent.
+    Returns the number of bytes queued, or -1 if an error occurred.
+
+    The data is not read into the write buffer up front. Where the platform
+    supports it (such as \c sendfile() on Linux), it is copied from the file
+    to the socket by the kernel; otherwise it is read in chunks as the
+    socket becomes ready for writing. In both cases bytesWritten() is
+    emitted as the data goes out, and bytesToWrite() includes the part of
+    the file that has not been sent yet.
+
+    The socket must be a connected TCP socket, and \a file must stay open and
+    unchanged until the data has been sent. Data written to the socket after
+    this call is sent after the file.
+
+    \sa write(), bytesToWrite(), bytesWritten()
+*/
+qint64 QAbstractSocket::sendFile(QFileDevice *file, qint64 offset, qint64 length)
+{
+    Q_D(QAbstractSocket);
+    if (d->state != ConnectedState || !isWritable()) {
+        d->setError(OperationError, tr("Socket is not connected"));
+        return -1;
+    }
+    if (d->socketType != TcpSocket) {
+        d->setError(UnsupportedSocketOperationError, tr("Operation on socket is not supported"));
+        return -1;
+    }
+    if (!file || !file->isReadable()) {
+        qWarning("QAbstractSocket::sendFile: file is not open for reading");
+        return -1;
+    }
+
+    const qint64 fileSize = file->size();
+    if (length == -1)
+        length = fileSize - offset;
+    if (offset < 0 || length < 0 || offset > fileSize || length > fileSize - offset) {
+        qWarning("QAbstractSocket::sendFile: offset and length out of range");
+        return -1;
+    }
+    if (length == 0)
+        return 0;
+
+    // make sure buffered writes to the file are visible through its handle
+    file->flush();
+
+#ifndef QT_NO_SSL
+    if (qobject_cast<QSslSocket *>(this)) {
+        // the data has to pass through the encryption layer
+        if (!file->seek(offset))
+            return -1;
+        qint64 queued = 0;
+        while (queued < length) {
+            const QByteArray chunk = file->read(qMin(length - queued, qint64(QABSTRACTSOCKET_BUFFERSIZE)));
+            if (chunk.isEmpty() || write(chunk) != chunk.size())
+                return -1;
+            queued += chunk.size();
+        }
+        return queued;
+    }
+#endif
+
+    QAbstractSocketPrivate::PendingFile pending;
+    pending.file = file;
+    pending.offset = offset;
+    pending.remaining = length;
+    pending.bufferedBefore = d->writeBuffer.size();
+    pending.zeroCopy = file->handle() != -1;
+    d->pendingFiles.append(pending);
+
+    if (d->socketEngine)
+        d->socketEngine->setWriteNotificationEnabled(true);
+    return length;
+}
+
 /*! \reimp
 */
 qint64 QAbstractSocket::readData(char *data, qint64 maxSize)
@@ -2552,7 +2988,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     }
 
     if (!d->isBuffered && d->socketType == TcpSocket
-        && d->socketEngine && d->writeBuffer.isEmpty()) {
+        && d->socketEngine && !d->hasPendingWrites()) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = size ? d->socketEngine->write(data, size) : Q_INT64_C(0);
         if (written < 0) {
@@ -2592,7 +3028,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     // We just write to our write buffer and enable the write notifier
     // The write notifier then flush()es the buffer.
 
-    d->writeBuffer.append(data, size);
+    d->write(data, size);
     qint64 written = size;
 
     if (d->socketEngine && !d->writeBuffer.isEmpty())
@@ -2782,14 +3218,14 @@ void QAbstractSocket::disconnectFromHost()
         }
 
         // Wait for pending data to be written.
-        if (d->socketEngine && d->socketEngine->isValid() && (!d->allWriteBuffersEmpty()
+        if (d->socketEngine && d->socketEngine->isValid() && (d->hasPendingWrites()
             || d->socketEngine->bytesToWrite() > 0)) {
             // hack: when we are waiting for the socket engine to write bytes (only
             // possible when using Socks5 or HTTP socket engine), then close
             // anyway after 2 seconds. This is to prevent a timeout on Mac, where we
             // sometimes just did not get the write notifier from the underlying
             // CFSocket and no progress was made.
-            if (d->allWriteBuffersEmpty() && d->socketEngine->bytesToWrite() > 0) {
+            if (!d->hasPendingWrites() && d->socketEngine->bytesToWrite() > 0) {
                 if (!d->disconnectTimer) {
                     d->disconnectTimer = new QTimer(this);
                     connect(d->disconnectTimer, SIGNAL(timeout()), this,
@@ -2827,6 +3263,7 @@ void QAbstractSocket::disconnectFromHost()
     d->peerAddress.clear();
     d->peerName.clear();
     d->setWriteChannelCount(0);
+    d->pendingFiles.clear();
 
 #if defined(QABSTRACTSOCKET_DEBUG)
         qDebug("QAbstractSocket::disconnectFromHost() disconnected!");
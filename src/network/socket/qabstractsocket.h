@@ -50,6 +50,7 @@
 QT_BEGIN_NAMESPACE
 
 
+class QFileDevice;
 class QHostAddress;
 #ifndef QT_NO_NETWORKPROXY
 class QNetworkProxy;
@@ -187,6 +188,8 @@ public:
     bool atEnd() const Q_DECL_OVERRIDE; // ### Qt6: remove me
     bool flush();
 
+    qint64 sendFile(QFileDevice *file, qint64 offset = 0, qint64 length = -1);
+
     // for synchronous access
     virtual bool waitForConnected(int msecs = 30000);
     bool waitForConnected(QDeadlineTimer deadline);
@@ -234,6 +237,7 @@ private:
     Q_PRIVATE_SLOT(d_func(), void _q_connectToNextAddress())
     Q_PRIVATE_SLOT(d_func(), void _q_startConnecting(const QHostInfo &))
     Q_PRIVATE_SLOT(d_func(), void _q_abortConnectionAttempt())
+    Q_PRIVATE_SLOT(d_func(), void _q_startNextConnectionAttempt())
     Q_PRIVATE_SLOT(d_func(), void _q_testConnection())
     Q_PRIVATE_SLOT(d_func(), void _q_forceDisconnect())
 };
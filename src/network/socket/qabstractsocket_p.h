@@ -54,14 +54,19 @@
 #include <QtNetwork/private/qtnetworkglobal_p.h>
 #include "QtNetwork/qabstractsocket.h"
 #include "QtCore/qbytearray.h"
+#include "QtCore/qelapsedtimer.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qpointer.h"
 #include "QtCore/qtimer.h"
+#include "QtCore/qvector.h"
 #include "private/qiodevice_p.h"
 #include "private/qabstractsocketengine_p.h"
 #include "qnetworkproxy.h"
 
 QT_BEGIN_NAMESPACE
 
+class QAbstractSocketConnectionAttempt;
+class QFileDevice;
 class QHostInfo;
 
 class QAbstractSocketPrivate : public QIODevicePrivate, public QAbstractSocketEngineReceiver, public QIODeviceExtraFunctions
@@ -101,6 +106,7 @@ public:
     void _q_startConnecting(const QHostInfo &hostInfo);
     void _q_testConnection();
     void _q_abortConnectionAttempt();
+    void _q_startNextConnectionAttempt();
     void _q_forceDisconnect();
 
     bool emittedReadyRead;
@@ -135,6 +141,7 @@ public:
     inline void resolveProxy(quint16 port) { resolveProxy(QString(), port); }
 
     void resetSocketLayer();
+    void resetSocketEngine();
     virtual bool flush();
 
     bool initSocketLayer(QAbstractSocket::NetworkLayerProtocol protocol);
@@ -143,6 +150,7 @@ public:
     void fetchConnectionParameters();
     bool readFromSocket();
     virtual bool writeToSocket();
+    bool writeFileToSocket();
     void emitReadyRead(int channel = 0);
     void emitBytesWritten(qint64 bytes, int channel = 0);
 
@@ -153,8 +161,30 @@ public:
     bool isBuffered;
     bool hasPendingData;
 
+    // file ranges queued by sendFile(), interleaved with the write buffer
+    struct PendingFile {
+        QPointer<QFileDevice> file;
+        qint64 offset;
+        qint64 remaining;
+        qint64 bufferedBefore;  // bytes of writeBuffer to be sent ahead of this file
+        bool zeroCopy;
+    };
+    QVector<PendingFile> pendingFiles;
+    inline bool hasPendingWrites() const
+    { return !allWriteBuffersEmpty() || !pendingFiles.isEmpty(); }
+
     QTimer *connectTimer;
     QTimer *disconnectTimer;
+    QElapsedTimer connectAttemptTimer;
+
+    // Happy Eyeballs (RFC 8305): earlier connection attempts keep running
+    // while the next address is tried, the first one to connect wins
+    QList<QAbstractSocketConnectionAttempt *> racingAttempts;
+    QTimer *connectionAttemptDelayTimer;
+    int connectionAttemptDelay; // msecs, negative to try one address at a time
+    void connectionAttemptFinished(QAbstractSocketConnectionAttempt *attempt);
+    void adoptConnectionAttempt(QAbstractSocketConnectionAttempt *attempt);
+    void abortRacingAttempts();
 
     int hostLookupId;
 
@@ -273,4 +273,107 @@ int QAbstractSocketEngine::outboundStreamCount() const
     return d_func()->outboundStreamCount;
 }
 
+/*!
+    \internal
+
+    Writes \a len bytes starting at \a offset of the file open as
+    \a fileDescriptor directly to the socket, without copying them through
+    user space. Returns the number of bytes written, which may be less than
+    \a len or 0 if the socket cannot accept more data right now, or -1 if an
+    error occurred.
+
+    The default implementation fails with
+    QAbstractSocket::UnsupportedSocketOperationError, which tells the caller
+    to send the file contents through the regular write() path instead.
+*/
+qint64 QAbstractSocketEngine::sendFile(int fileDescriptor, qint64 offset, qint64 len)
+{
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(len);
+    setError(QAbstractSocket::UnsupportedSocketOperationError, tr("Unsupported socket operation"));
+    return -1;
+}
+
+/*!
+    \internal
+
+    Writes the \a count blocks of \a len bytes in \a data to the socket, in
+    order. Returns the total number of bytes written, or -1 if an error
+    occurred before anything could be written.
+
+    The default implementation calls write() once per block and stops at the
+    first short write; engines that can gather several blocks into one system
+    call reimplement it.
+*/
+qint64 QAbstractSocketEngine::writeMultiple(const char *const *data, const qint64 *len, int count)
+{
+    qint64 total = 0;
+    for (int i = 0; i < count; ++i) {
+        const qint64 written = write(data[i], len[i]);
+        if (written < 0)
+            return total ? total : qint64(-1);
+        total += written;
+        if (written < len[i])
+            break;
+    }
+    return total;
+}
+
+#ifndef QT_NO_UDPSOCKET
+/*!
+    \internal
+
+    Reads up to \a count pending datagrams of at most \a maxlen bytes each
+    into \a datagrams, reusing their existing payload buffers. Returns the
+    number of datagrams read, -2 if none was pending or -1 if an error
+    occurred before the first one could be read.
+
+    The default implementation calls readDatagram() once per datagram; engines
+    that can receive several datagrams with one system call reimplement it.
+*/
+int QAbstractSocketEngine::readDatagrams(QNetworkDatagramPrivate *const *datagrams, int count,
+                                         qint64 maxlen, PacketHeaderOptions options)
+{
+    int i = 0;
+    for ( ; i < count; ++i) {
+        if (i && !hasPendingDatagrams())
+            break;
+
+        QNetworkDatagramPrivate *datagram = datagrams[i];
+        datagram->data.reserve(int(maxlen));
+        datagram->data.resize(int(maxlen));
+        datagram->header.clear();
+        qint64 readBytes = readDatagram(datagram->data.data(), maxlen, &datagram->header, options);
+        if (readBytes < 0) {
+            datagram->data.resize(0);
+            return i ? i : int(readBytes);
+        }
+        datagram->data.resize(int(readBytes));
+    }
+    return i;
+}
+
+/*!
+    \internal
+
+    Writes the \a count datagrams in \a datagrams, stopping at the first one
+    that cannot be sent. Returns the number of datagrams written, -2 if the
+    first one would have blocked or -1 if it failed.
+
+    The default implementation calls writeDatagram() once per datagram.
+*/
+int QAbstractSocketEngine::writeDatagrams(const QNetworkDatagramPrivate *const *datagrams, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const QNetworkDatagramPrivate *datagram = datagrams[i];
+        qint64 sent = writeDatagram(datagram->data.constData(), datagram->data.size(),
+                                    datagram->header);
+        if (sent < 0)
+            return i ? i : int(sent);
+    }
+    return count;
+}
+#endif // QT_NO_UDPSOCKET
+
 QT_END_NAMESPACE
@@ -140,6 +140,8 @@ public:
 
     virtual qint64 read(char *data, qint64 maxlen) = 0;
     virtual qint64 write(const char *data, qint64 len) = 0;
+    virtual qint64 sendFile(int fileDescriptor, qint64 offset, qint64 len);
+    virtual qint64 writeMultiple(const char *const *data, const qint64 *len, int count);
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -153,6 +155,10 @@ public:
 
     virtual bool hasPendingDatagrams() const = 0;
     virtual qint64 pendingDatagramSize() const = 0;
+
+    virtual int readDatagrams(QNetworkDatagramPrivate *const *datagrams, int count, qint64 maxlen,
+                              PacketHeaderOptions options = WantNone);
+    virtual int writeDatagrams(const QNetworkDatagramPrivate *const *datagrams, int count);
 #endif // QT_NO_UDPSOCKET
 
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = 0,
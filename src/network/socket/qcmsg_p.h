@@ -156,8 +156,10 @@ private:
     // Note: never use the actual TypedPayload member in the union below.
     // The order from the kernel may not match the order of the template
     // parameters we used.
+    // cmsghdr may end in a flexible array member (glibc), which can't be
+    // followed by another member, so only reserve its storage here.
     struct TypedPayload {
-        cmsghdr hdr;
+        alignas(cmsghdr) uchar hdr[sizeof(cmsghdr)];
         First data;
     };
 
@@ -226,10 +228,7 @@ private:
     decltype(msghdr::msg_controllen) &controlLength() { return msg_controllen; }
 #endif
 
-    union {
-        SocketMessageBuffer<Types...> buffer;
-        cmsghdr _for_alignment;
-    };
+    alignas(cmsghdr) SocketMessageBuffer<Types...> buffer;
 
     void commonInit(const char *data, qint64 len) Q_DECL_NOEXCEPT
     {
@@ -258,9 +257,18 @@ private:
 public:
     qt_sockaddr address;
 
+    // for arrays of messages (recvmmsg/sendmmsg); call one of the
+    // initForXxx() functions before use
+    SocketMessage() Q_DECL_NOTHROW {}
+
     // sending API
 
     SocketMessage(const char *data, qint64 len)
+    {
+        initForSending(data, len);
+    }
+
+    void initForSending(const char *data, qint64 len) Q_DECL_NOTHROW
     {
         commonInit(data, len);
     }
@@ -291,6 +299,11 @@ public:
     // receiving API
 
     SocketMessage(char *data, qint64 maxLen)
+    {
+        initForReceiving(data, maxLen);
+    }
+
+    void initForReceiving(char *data, qint64 maxLen) Q_DECL_NOTHROW
     {
         commonInit(data, maxLen);
         controlLength() = sizeof(buffer);
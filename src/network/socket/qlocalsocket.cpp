@@ -204,6 +204,21 @@ bool QLocalSocket::waitForBytesWritten(QDeadlineTimer deadline)
     \sa write(), waitForBytesWritten()
 */
 
+/*!
+    \fn qint64 QLocalSocket::sendFile(QFileDevice *file, qint64 offset, qint64 length)
+    \since 5.8
+
+    Queues \a length bytes of \a file, starting at \a offset, to be sent
+    over the socket after any data that has already been written. If \a
+    length is -1, everything from \a offset to the end of the file is sent.
+    Returns the number of bytes queued, or -1 if an error occurred.
+
+    On platforms that support it the data is copied from the file to the
+    socket by the kernel, without being read into the write buffer.
+
+    \sa QAbstractSocket::sendFile(), write()
+*/
+
 /*!
     \fn void QLocalSocket::disconnectFromServer()
 
@@ -100,6 +100,7 @@ public:
     virtual void close() Q_DECL_OVERRIDE;
     LocalSocketError error() const;
     bool flush();
+    qint64 sendFile(QFileDevice *file, qint64 offset = 0, qint64 length = -1);
     bool isValid() const;
     qint64 readBufferSize() const;
     void setReadBufferSize(qint64 size);
@@ -452,6 +452,12 @@ bool QLocalSocket::flush()
     return d->unixSocket.flush();
 }
 
+qint64 QLocalSocket::sendFile(QFileDevice *file, qint64 offset, qint64 length)
+{
+    Q_D(QLocalSocket);
+    return d->unixSocket.sendFile(file, offset, length);
+}
+
 void QLocalSocket::disconnectFromServer()
 {
     Q_D(QLocalSocket);
@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qlocalsocket_p.h"
+#include <qfiledevice.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -316,6 +317,29 @@ bool QLocalSocket::flush()
     return written;
 }
 
+qint64 QLocalSocket::sendFile(QFileDevice *file, qint64 offset, qint64 length)
+{
+    // named pipes have no zero-copy path; queue the file contents as ordinary writes
+    if (!isValid() || !file || !file->isReadable())
+        return -1;
+    const qint64 fileSize = file->size();
+    if (length == -1)
+        length = fileSize - offset;
+    if (offset < 0 || length < 0 || offset > fileSize || length > fileSize - offset)
+        return -1;
+    if (!file->seek(offset))
+        return -1;
+
+    qint64 queued = 0;
+    while (queued < length) {
+        const QByteArray chunk = file->read(qMin(length - queued, qint64(32768)));
+        if (chunk.isEmpty() || write(chunk) != chunk.size())
+            return -1;
+        queued += chunk.size();
+    }
+    return queued;
+}
+
 void QLocalSocket::disconnectFromServer()
 {
     Q_D(QLocalSocket);
@@ -831,6 +831,62 @@ qint64 QNativeSocketEngine::pendingDatagramSize() const
 
     return d->nativePendingDatagramSize();
 }
+
+/*!
+    Reads up to \a count datagrams of at most \a maxSize bytes each into
+    \a datagrams, reusing the payload buffers already allocated in them. The
+    IP header fields are stored according to the request in \a options.
+
+    On Linux, all pending datagrams are received with a single recvmmsg()
+    call per batch; elsewhere, this function reads them one by one.
+
+    Returns the number of datagrams read, -2 if there was none pending or -1
+    if an error occurred before the first datagram could be read.
+
+    \sa readDatagram(), writeDatagrams()
+*/
+int QNativeSocketEngine::readDatagrams(QNetworkDatagramPrivate *const *datagrams, int count,
+                                       qint64 maxSize, PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#ifdef Q_OS_UNIX
+    return d->nativeReceiveDatagrams(datagrams, count, maxSize, options);
+#else
+    Q_UNUSED(d);
+    return QAbstractSocketEngine::readDatagrams(datagrams, count, maxSize, options);
+#endif
+}
+
+/*!
+    Writes the \a count datagrams in \a datagrams to the socket, each to the
+    destination contained in its header. On Linux, they are passed to the
+    operating system with a single sendmmsg() call per batch.
+
+    Returns the number of datagrams written, which is less than \a count if
+    the socket's send buffer filled up or an error occurred part way. Returns
+    -2 if not even the first datagram could be sent without blocking, or -1
+    if sending it failed.
+
+    \sa writeDatagram(), readDatagrams()
+*/
+int QNativeSocketEngine::writeDatagrams(const QNetworkDatagramPrivate *const *datagrams, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#ifdef Q_OS_UNIX
+    return d->nativeSendDatagrams(datagrams, count);
+#else
+    Q_UNUSED(d);
+    return QAbstractSocketEngine::writeDatagrams(datagrams, count);
+#endif
+}
 #endif // QT_NO_UDPSOCKET
 
 /*!
@@ -954,6 +1010,51 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
 }
 
 
+/*!
+    Writes \a size bytes starting at \a offset of the file open as
+    \a fileDescriptor to the socket, letting the kernel copy the data
+    directly from the page cache. Returns the number of bytes written, 0 if
+    the socket's send buffer is full, or -1 if an error occurred.
+
+    If the operating system cannot send from this kind of file, the function
+    fails with QAbstractSocket::UnsupportedSocketOperationError and the caller
+    should fall back to write().
+*/
+qint64 QNativeSocketEngine::sendFile(int fileDescriptor, qint64 offset, qint64 size)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::sendFile(), QAbstractSocket::TcpSocket, -1);
+
+#ifdef Q_OS_UNIX
+    return d->nativeSendFile(fileDescriptor, offset, size);
+#else
+    Q_UNUSED(d);
+    return QAbstractSocketEngine::sendFile(fileDescriptor, offset, size);
+#endif
+}
+
+/*!
+    Writes the \a count blocks of \a len bytes in \a data to the socket, in
+    order, with as few system calls as possible. Returns the total number of
+    bytes written, or -1 if an error occurred.
+*/
+qint64 QNativeSocketEngine::writeMultiple(const char *const *data, const qint64 *len, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeMultiple(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::writeMultiple(), QAbstractSocket::ConnectedState, -1);
+
+#ifdef Q_OS_UNIX
+    if (d->socketType == QAbstractSocket::TcpSocket)
+        return d->nativeWriteMultiple(data, len, count);
+#else
+    Q_UNUSED(d);
+#endif
+    return QAbstractSocketEngine::writeMultiple(data, len, count);
+}
+
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
     return 0;
@@ -168,6 +168,8 @@ public:
 
     qint64 read(char *data, qint64 maxlen) Q_DECL_OVERRIDE;
     qint64 write(const char *data, qint64 len) Q_DECL_OVERRIDE;
+    qint64 sendFile(int fileDescriptor, qint64 offset, qint64 len) Q_DECL_OVERRIDE;
+    qint64 writeMultiple(const char *const *data, const qint64 *len, int count) Q_DECL_OVERRIDE;
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -181,6 +183,10 @@ public:
 
     bool hasPendingDatagrams() const Q_DECL_OVERRIDE;
     qint64 pendingDatagramSize() const Q_DECL_OVERRIDE;
+
+    int readDatagrams(QNetworkDatagramPrivate *const *datagrams, int count, qint64 maxlen,
+                      PacketHeaderOptions options = WantNone) Q_DECL_OVERRIDE;
+    int writeDatagrams(const QNetworkDatagramPrivate *const *datagrams, int count) Q_DECL_OVERRIDE;
 #endif // QT_NO_UDPSOCKET
 
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = 0,
@@ -302,8 +308,15 @@ public:
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
     qint64 nativeSendDatagram(const char *data, qint64 length,
                               const QNativeSocketEngine::FileDescriptorBundle &fileDescriptors);
+#ifndef QT_NO_UDPSOCKET
+    int nativeReceiveDatagrams(QNetworkDatagramPrivate *const *datagrams, int count, qint64 maxLength,
+                               QAbstractSocketEngine::PacketHeaderOptions options); // only on Unix
+    int nativeSendDatagrams(const QNetworkDatagramPrivate *const *datagrams, int count); // only on Unix
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+    qint64 nativeSendFile(int fileDescriptor, qint64 offset, qint64 length); // only on Unix
+    qint64 nativeWriteMultiple(const char *const *data, const qint64 *len, int count); // only on Unix
     int nativeSelect(QDeadlineTimer deadline, bool selectForRead) const;
     int nativeSelect(QDeadlineTimer deadline, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
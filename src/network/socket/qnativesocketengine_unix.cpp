@@ -56,9 +56,8 @@
 #ifdef QT_LINUXBASE
 #include <arpa/inet.h>
 #endif
-#ifdef Q_OS_INTEGRITY
+#include <limits.h>
 #include <sys/uio.h>
-#endif
 
 #if defined QNATIVESOCKETENGINE_DEBUG
 #include <qstring.h>
@@ -889,27 +888,30 @@ qint64 QNativeSocketEnginePrivate::nativePendingDatagramSize() const
     return qint64(recvResult);
 }
 
-qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
-                                                         QAbstractSocketEngine::PacketHeaderOptions options)
-{
 #if defined(IP_PKTINFO) || defined(IP_RECVDSTADDR)
-    Q_STATIC_ASSERT(sizeof(in6_pktinfo) >= sizeof(in_pktinfo));
+Q_STATIC_ASSERT(sizeof(in6_pktinfo) >= sizeof(in_pktinfo));
 #endif
-    Q_STATIC_ASSERT(sizeof(in6_hoplimit) >= sizeof(in_ttl));
+Q_STATIC_ASSERT(sizeof(in6_hoplimit) >= sizeof(in_ttl));
 
-    // we need to receive at least one byte, even if our user isn't interested in it
-    char c;
-    if (maxSize == 0)
-        data = &c;
-
-    SocketMessage<
+typedef SocketMessage<
 #if defined(IP_RECVIF) && !defined(IP_PKTINFO)
-            sockaddr_dl,
+        sockaddr_dl,
 #endif
 #ifndef QT_NO_SCTP
-            sctp_sndrcvinfo,
+        sctp_sndrcvinfo,
 #endif
-            in6_pktinfo, in6_hoplimit> msg(data, qMax<qint64>(maxSize, 1));
+        in6_pktinfo, in6_hoplimit> ReceiveDatagramMessage;
+
+typedef SocketMessage<
+#ifndef QT_NO_SCTP
+        sctp_sndrcvinfo,
+#endif
+        in6_pktinfo, in6_hoplimit> SendDatagramMessage;
+
+static void qt_initReceiveDatagramMessage(ReceiveDatagramMessage &msg, char *data, qint64 maxSize,
+                                          QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    msg.initForReceiving(data, maxSize);
 
     // turn off what we're not interested in
     if (!options.testFlag(QAbstractSocketEngine::WantDatagramSender)) {
@@ -921,6 +923,58 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
         msg.msg_control = nullptr;
         msg.msg_controllen = 0;
     }
+}
+
+static void qt_parseReceivedDatagramHeader(ReceiveDatagramMessage &msg, QIpPacketHeader *header,
+                                           quint16 localPort)
+{
+    qt_socket_getPortAndAddress(&msg.address, &header->senderPort, &header->senderAddress);
+    header->destinationPort = localPort;
+    header->endOfRecord = (msg.msg_flags & MSG_EOR) != 0;
+
+    // parse the ancillary data
+    for (AncillaryData *adata = msg.firstAncillaryPayload(); adata; adata = msg.next(adata)) {
+        if (in6_pktinfo *info = adata->payload<in6_pktinfo>()) {
+            header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
+            header->ifindex = info->ipi6_ifindex;
+            if (header->ifindex)
+                header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
+        }
+#if defined(IP_PKTINFO) || defined(IP_RECVDSTADDR)
+        if (in_pktinfo *info = adata->payload<in_pktinfo>()) {
+            header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
+#  ifdef IP_PKTINFO
+            header->ifindex = info->ipi_ifindex;
+#  endif
+        }
+#endif
+#if !defined(IP_PKTINFO) && defined(IP_RECVIF) // BSDs, QNX
+        if (sockaddr_dl *sdl = adata->payload<sockaddr_dl>()) {
+            header->ifindex = sdl->sdl_index;
+        }
+#endif
+        if (in_ttl *ptr = adata->payload<in_ttl>())
+            header->hopLimit = ptr->value;
+        if (in6_hoplimit *ptr = adata->payload<in6_hoplimit>())
+            header->hopLimit = ptr->value;
+
+#ifndef QT_NO_SCTP
+        if (sctp_sndrcvinfo *rcvInfo = adata->payload<sctp_sndrcvinfo>())
+            header->streamNumber = int(rcvInfo->sinfo_stream);
+#endif
+    }
+}
+
+qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
+                                                         QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    // we need to receive at least one byte, even if our user isn't interested in it
+    char c;
+    if (maxSize == 0)
+        data = &c;
+
+    ReceiveDatagramMessage msg;
+    qt_initReceiveDatagramMessage(msg, data, qMax<qint64>(maxSize, 1), options);
 
     ssize_t recvResult = 0;
     do {
@@ -946,41 +1000,7 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
             header->clear();
     } else if (options != QAbstractSocketEngine::WantNone) {
         Q_ASSERT(header);
-        qt_socket_getPortAndAddress(&msg.address, &header->senderPort, &header->senderAddress);
-        header->destinationPort = localPort;
-        header->endOfRecord = (msg.msg_flags & MSG_EOR) != 0;
-
-        // parse the ancillary data
-        for (AncillaryData *adata = msg.firstAncillaryPayload(); adata; adata = msg.next(adata)) {
-            if (in6_pktinfo *info = adata->payload<in6_pktinfo>()) {
-                header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
-                header->ifindex = info->ipi6_ifindex;
-                if (header->ifindex)
-                    header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
-            }
-#if defined(IP_PKTINFO) || defined(IP_RECVDSTADDR)
-            if (in_pktinfo *info = adata->payload<in_pktinfo>()) {
-                header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
-#  ifdef IP_PKTINFO
-                header->ifindex = info->ipi_ifindex;
-#  endif
-            }
-#endif
-#if !defined(IP_PKTINFO) && defined(IP_RECVIF) // BSDs, QNX
-            if (sockaddr_dl *sdl = adata->payload<sockaddr_dl>()) {
-                header->ifindex = sdl->sdl_index;
-            }
-#endif
-            if (in_ttl *ptr = adata->payload<in_ttl>())
-                header->hopLimit = ptr->value;
-            if (in6_hoplimit *ptr = adata->payload<in6_hoplimit>())
-                header->hopLimit = ptr->value;
-
-#ifndef QT_NO_SCTP
-            if (sctp_sndrcvinfo *rcvInfo = adata->payload<sctp_sndrcvinfo>())
-                header->streamNumber = int(rcvInfo->sinfo_stream);
-#endif
-        }
+        qt_parseReceivedDatagramHeader(msg, header, localPort);
     }
 
 #if defined (QNATIVESOCKETENGINE_DEBUG)
@@ -995,25 +1015,17 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
     return qint64((maxSize || recvResult < 0) ? recvResult : Q_INT64_C(0));
 }
 
-qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+static void qt_initSendDatagramMessage(QNativeSocketEnginePrivate *d, SendDatagramMessage &msg,
+                                       const char *data, qint64 len, const QIpPacketHeader &header)
 {
-#if defined(IP_PKTINFO) || defined(IP_SENDSRCADDR)
-    Q_STATIC_ASSERT(sizeof(in6_pktinfo) >= sizeof(in_pktinfo));
-#endif
-    Q_STATIC_ASSERT(sizeof(in6_hoplimit) >= sizeof(in_ttl));
-
-    SocketMessage<
-#ifndef QT_NO_SCTP
-                  sctp_sndrcvinfo,
-#endif
-                  in6_pktinfo, in6_hoplimit> msg(data, len);
+    msg.initForSending(data, len);
 
     if (header.destinationPort == 0 || header.destinationAddress.isNull()) {
         msg.msg_name = nullptr;
         msg.msg_namelen = 0;
     } else {
-        setPortAndAddress(header.destinationPort, header.destinationAddress,
-                          &msg.address, &msg.msg_namelen);
+        d->setPortAndAddress(header.destinationPort, header.destinationAddress,
+                             &msg.address, &msg.msg_namelen);
     }
 
     if (msg.msg_namelen == sizeof(msg.address.a6)) {
@@ -1051,6 +1063,12 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         data->sinfo_stream = uint16_t(header.streamNumber);
     }
 #endif
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+{
+    SendDatagramMessage msg;
+    qt_initSendDatagramMessage(this, msg, data, len, header);
 
     ssize_t sentBytes = qt_safe_sendmsg(socketDescriptor, msg.forSending(), 0);
 
@@ -1083,6 +1101,155 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return qint64(sentBytes);
 }
 
+#ifndef QT_NO_UDPSOCKET
+int QNativeSocketEnginePrivate::nativeReceiveDatagrams(QNetworkDatagramPrivate *const *datagrams, int count,
+                                                       qint64 maxSize,
+                                                       QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    Q_Q(QNativeSocketEngine);
+#ifdef QT_HAVE_MMSG
+    // receive in batches, so the message headers can live on the stack
+    enum { BatchSize = 32 };
+    ReceiveDatagramMessage messages[BatchSize];
+    struct mmsghdr headers[BatchSize];
+
+    // like nativeReceiveDatagram(), always receive at least one byte
+    const int bufferSize = int(qMax<qint64>(maxSize, 1));
+
+    int received = 0;
+    while (received < count) {
+        const int batchCount = qMin(count - received, int(BatchSize));
+        for (int i = 0; i < batchCount; ++i) {
+            // reserving keeps the buffer allocated when it's shrunk to the
+            // received size, so it can be reused by the next call
+            QByteArray &data = datagrams[received + i]->data;
+            data.reserve(bufferSize);
+            data.resize(bufferSize);
+            qt_initReceiveDatagramMessage(messages[i], data.data(), bufferSize, options);
+            headers[i].msg_hdr = *messages[i].forReceiving();
+            headers[i].msg_len = 0;
+        }
+
+        int result = qt_safe_recvmmsg(socketDescriptor, headers, batchCount, MSG_WAITFORONE);
+        if (result == -1) {
+            for (int i = 0; i < batchCount; ++i)
+                datagrams[received + i]->data.resize(0);
+            if (received)
+                break;
+
+            switch (errno) {
+            case ENOSYS:
+                // kernel older than 2.6.33
+                return q->QAbstractSocketEngine::readDatagrams(datagrams, count, maxSize, options);
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+            case EAGAIN:
+                // No datagram was available for reading
+                return -2;
+            case ECONNREFUSED:
+                setError(QAbstractSocket::ConnectionRefusedError, ConnectionRefusedErrorString);
+                break;
+            default:
+                setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+            }
+            return -1;
+        }
+
+        for (int i = 0; i < batchCount; ++i) {
+            QNetworkDatagramPrivate *datagram = datagrams[received + i];
+            if (i >= result) {
+                datagram->data.resize(0);
+                continue;
+            }
+
+            datagram->data.resize(maxSize ? int(headers[i].msg_len) : 0);
+            if (options != QAbstractSocketEngine::WantNone) {
+                // the kernel updated the lengths and flags in our copy of the header
+                *messages[i].forReceiving() = headers[i].msg_hdr;
+                datagram->header.clear();
+                qt_parseReceivedDatagramHeader(messages[i], &datagram->header, localPort);
+            }
+        }
+
+        received += result;
+        if (result < batchCount)
+            break;      // drained the socket
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagrams(%p, %d, %lli) == %d",
+           datagrams, count, maxSize, received);
+#endif
+
+    return received;
+#else
+    return q->QAbstractSocketEngine::readDatagrams(datagrams, count, maxSize, options);
+#endif // QT_HAVE_MMSG
+}
+
+int QNativeSocketEnginePrivate::nativeSendDatagrams(const QNetworkDatagramPrivate *const *datagrams, int count)
+{
+    Q_Q(QNativeSocketEngine);
+#ifdef QT_HAVE_MMSG
+    enum { BatchSize = 32 };
+    SendDatagramMessage messages[BatchSize];
+    struct mmsghdr headers[BatchSize];
+
+    int sent = 0;
+    while (sent < count) {
+        const int batchCount = qMin(count - sent, int(BatchSize));
+        for (int i = 0; i < batchCount; ++i) {
+            const QNetworkDatagramPrivate *datagram = datagrams[sent + i];
+            qt_initSendDatagramMessage(this, messages[i], datagram->data.constData(),
+                                       datagram->data.size(), datagram->header);
+            headers[i].msg_hdr = *messages[i].forSending();
+            headers[i].msg_len = 0;
+        }
+
+        int result = qt_safe_sendmmsg(socketDescriptor, headers, batchCount, 0);
+        if (result == -1) {
+            // the error will be reported again by the next call
+            if (sent)
+                break;
+
+            switch (errno) {
+            case ENOSYS:
+                // kernel older than 3.0
+                return q->QAbstractSocketEngine::writeDatagrams(datagrams, count);
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+            case EAGAIN:
+                return -2;
+            case EMSGSIZE:
+                setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+                break;
+            case ECONNRESET:
+                setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+                break;
+            default:
+                setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
+            }
+            return -1;
+        }
+
+        sent += result;
+        if (result < batchCount)
+            break;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendDatagrams(%p, %d) == %d", datagrams, count, sent);
+#endif
+
+    return sent;
+#else
+    return q->QAbstractSocketEngine::writeDatagrams(datagrams, count);
+#endif // QT_HAVE_MMSG
+}
+#endif // QT_NO_UDPSOCKET
+
 qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxLength,
                                                          QNativeSocketEngine::FileDescriptorBundle &fileDescriptors)
 {
@@ -1371,6 +1538,100 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+qint64 QNativeSocketEnginePrivate::nativeWriteMultiple(const char *const *data, const qint64 *len, int count)
+{
+    Q_Q(QNativeSocketEngine);
+
+#if defined(IOV_MAX)
+    count = qMin(count, int(IOV_MAX));
+#elif defined(UIO_MAXIOV)
+    count = qMin(count, int(UIO_MAXIOV));
+#else
+    count = qMin(count, 16); // the minimum POSIX guarantees
+#endif
+
+    QVarLengthArray<iovec, 64> vec(count);
+    for (int i = 0; i < count; ++i) {
+        vec[i].iov_base = const_cast<char *>(data[i]);
+        vec[i].iov_len = size_t(len[i]);
+    }
+
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = vec.data();
+    msg.msg_iovlen = count;
+
+    // sendmsg() rather than writev() so that MSG_NOSIGNAL can be used
+    ssize_t writtenBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, WriteErrorString);
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWriteMultiple(%d blocks) == %i", count, (int) writtenBytes);
+#endif
+
+    return qint64(writtenBytes);
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendFile(int fileDescriptor, qint64 offset, qint64 length)
+{
+#ifdef QT_HAVE_SENDFILE
+    Q_Q(QNativeSocketEngine);
+
+    qint64 sentBytes = qt_safe_sendfile(socketDescriptor, fileDescriptor, offset, length);
+    if (sentBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            sentBytes = 0;
+            break;
+        case EINVAL:
+        case ENOSYS:
+            // the file cannot be mmap()ed, like a pipe or a file in /proc
+            setError(QAbstractSocket::UnsupportedSocketOperationError, OperationUnsupportedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, WriteErrorString);
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendFile(%d, %lld, %lld) == %lld",
+           fileDescriptor, offset, length, sentBytes);
+#endif
+
+    return sentBytes;
+#else
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(length);
+    setError(QAbstractSocket::UnsupportedSocketOperationError, OperationUnsupportedErrorString);
+    return -1;
+#endif
+}
+
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
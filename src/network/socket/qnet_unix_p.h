@@ -61,6 +61,9 @@
 #if defined(Q_OS_VXWORKS)
 #  include <sockLib.h>
 #endif
+#if defined(Q_OS_LINUX)
+#  include <sys/sendfile.h>
+#endif
 
 // for inet_addr
 #include <netdb.h>
@@ -251,6 +254,54 @@ static inline int qt_safe_recvmsg(int sockfd, struct msghdr *msg, int flags)
     return ret;
 }
 
+#if defined(Q_OS_LINUX)
+// Linux 2.6.33 and later accept any kind of socket as the destination
+#  define QT_HAVE_SENDFILE
+static inline qint64 qt_safe_sendfile(int sockfd, int fd, qint64 offset, qint64 count)
+{
+    // sendfile() has no flag to suppress SIGPIPE
+    qt_ignore_sigpipe();
+
+    // and it transfers at most 0x7ffff000 bytes per call anyway
+    const size_t len = size_t(qMin(count, qint64(0x7ffff000)));
+    QT_OFF_T off = offset;
+    ssize_t ret;
+#if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+    EINTR_LOOP(ret, ::sendfile64(sockfd, fd, &off, len));
+#else
+    EINTR_LOOP(ret, ::sendfile(sockfd, fd, &off, len));
+#endif
+    return ret;
+}
+#endif
+
+// recvmmsg() appeared in Linux 2.6.33 and glibc 2.12, sendmmsg() in Linux 3.0
+// and glibc 2.14; MSG_WAITFORONE was added together with recvmmsg()
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && defined(MSG_WAITFORONE) \
+    && (!defined(__GLIBC__) || __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14))
+#  define QT_HAVE_MMSG
+static inline int qt_safe_sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#else
+    qt_ignore_sigpipe();
+#endif
+
+    int ret;
+    EINTR_LOOP(ret, ::sendmmsg(sockfd, msgvec, vlen, flags));
+    return ret;
+}
+
+static inline int qt_safe_recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    int ret;
+
+    EINTR_LOOP(ret, ::recvmmsg(sockfd, msgvec, vlen, flags, nullptr));
+    return ret;
+}
+#endif
+
 QT_END_NAMESPACE
 
 #endif // QNET_UNIX_P_H
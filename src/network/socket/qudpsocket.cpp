@@ -83,6 +83,12 @@
     options. Use setMulticastInterface() to control the outgoing interface for
     multicast datagrams, and multicastInterface() to query it.
 
+    Applications that exchange many datagrams at high rates can use
+    receiveDatagrams() and writeDatagrams() to transfer a whole batch of
+    QNetworkDatagram objects at once. On Linux, each batch needs only one
+    system call, and the payload buffers of the received datagrams are reused
+    from one call to the next.
+
     With QUdpSocket, you can also establish a virtual connection to a
     UDP server using connectToHost() and then use read() and write()
     to exchange datagrams without specifying the receiver for each
@@ -102,6 +108,8 @@
 #include "qnetworkdatagram.h"
 #include "qnetworkinterface.h"
 #include "qabstractsocket_p.h"
+#include "qvarlengtharray.h"
+#include "qvector.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -461,6 +469,120 @@ QNetworkDatagram QUdpSocket::receiveDatagram(qint64 maxSize)
     return result;
 }
 
+/*!
+    \since 5.8
+
+    Receives up to \l{QVector::size()}{datagrams.size()} pending datagrams
+    no larger than \a maxSize bytes each, storing them in the existing
+    elements of \a datagrams along with their sender's host address and port,
+    their destination, and their hop count at reception time. Returns the
+    number of datagrams received, which is 0 if none were pending, or -1 if an
+    error occurred. Elements past the returned count are left empty.
+
+    The payload buffers of the elements are reused: once a buffer has been
+    grown by a call to this function, later calls receive into the same
+    memory, provided the application did not keep a copy of the element's
+    data(). Keeping \a datagrams around between calls therefore avoids
+    allocating memory for every datagram. On Linux, all datagrams in the
+    batch are fetched from the operating system with a single system call.
+
+    If \a maxSize is too small, the rest of the datagram will be lost. If \a
+    maxSize is -1 (the default) or larger than the maximum size of a UDP
+    datagram, the buffers are sized to hold any UDP datagram.
+
+    \sa receiveDatagram(), writeDatagrams(), hasPendingDatagrams()
+*/
+int QUdpSocket::receiveDatagrams(QVector<QNetworkDatagram> &datagrams, qint64 maxSize)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::receiveDatagrams(%d, %lld)", datagrams.size(), maxSize);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::receiveDatagrams()", -1);
+
+    // the largest possible payload of a UDP datagram is a little less than 64k
+    const qint64 MaxDatagramSize = 65536;
+    if (maxSize < 0 || maxSize > MaxDatagramSize)
+        maxSize = MaxDatagramSize;
+    if (datagrams.isEmpty())
+        return 0;
+
+    QVarLengthArray<QNetworkDatagramPrivate *, 64> privates(datagrams.size());
+    QNetworkDatagram *datagram = datagrams.data();
+    for (int i = 0; i < privates.size(); ++i) {
+        if (!datagram[i].d)     // moved-from
+            datagram[i].d = new QNetworkDatagramPrivate;
+        privates[i] = datagram[i].d;
+    }
+
+    int received = d->socketEngine->readDatagrams(privates.constData(), privates.size(), maxSize,
+                                                  QAbstractSocketEngine::WantAll);
+    d->hasPendingData = false;
+    d->socketEngine->setReadNotificationEnabled(true);
+    if (received == -2) {
+        received = 0;
+    } else if (received < 0) {
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+        return -1;
+    }
+    for (int i = received; i < privates.size(); ++i) {
+        privates[i]->data.resize(0);
+        privates[i]->header.clear();
+    }
+    return received;
+}
+
+/*!
+    \since 5.8
+
+    Sends all datagrams in \a datagrams, each to the host address and port
+    numbers contained in it, as writeDatagram(const QNetworkDatagram &) does.
+    On Linux, the whole batch is passed to the operating system with a single
+    system call.
+
+    Returns the number of datagrams sent, which may be less than the size of
+    \a datagrams, or even 0, if the socket's send buffer filled up. Returns -1
+    if an error occurred before the first datagram was sent. The
+    bytesWritten() signal is emitted once, with the total payload size of the
+    datagrams sent.
+
+    \sa writeDatagram(), receiveDatagrams()
+*/
+int QUdpSocket::writeDatagrams(const QVector<QNetworkDatagram> &datagrams)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%d)", datagrams.size());
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, datagrams.constFirst().destinationAddress()))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    QVarLengthArray<const QNetworkDatagramPrivate *, 64> privates(datagrams.size());
+    for (int i = 0; i < privates.size(); ++i)
+        privates[i] = datagrams.at(i).d;
+
+    int sent = d->socketEngine->writeDatagrams(privates.constData(), privates.size());
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (sent == -2) {
+        // the send buffer is full, try again later
+        sent = 0;
+    } else if (sent > 0) {
+        qint64 written = 0;
+        for (int i = 0; i < sent; ++i)
+            written += privates.at(i)->data.size();
+        emit bytesWritten(written);
+    } else if (sent < 0) {
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+    }
+    return sent;
+}
+
 /*!
     Receives a datagram no larger than \a maxSize bytes and stores
     it in \a data. The sender's host address and port is stored in
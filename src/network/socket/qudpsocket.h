@@ -43,6 +43,7 @@
 #include <QtNetwork/qtnetworkglobal.h>
 #include <QtNetwork/qabstractsocket.h>
 #include <QtNetwork/qhostaddress.h>
+#include <QtCore/qcontainerfwd.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -75,9 +76,11 @@ public:
     bool hasPendingDatagrams() const;
     qint64 pendingDatagramSize() const;
     QNetworkDatagram receiveDatagram(qint64 maxSize = -1);
+    int receiveDatagrams(QVector<QNetworkDatagram> &datagrams, qint64 maxSize = -1);
     qint64 readDatagram(char *data, qint64 maxlen, QHostAddress *host = Q_NULLPTR, quint16 *port = Q_NULLPTR);
 
     qint64 writeDatagram(const QNetworkDatagram &datagram);
+    int writeDatagrams(const QVector<QNetworkDatagram> &datagrams);
     qint64 writeDatagram(const char *data, qint64 len, const QHostAddress &host, quint16 port);
     inline qint64 writeDatagram(const QByteArray &datagram, const QHostAddress &host, quint16 port)
         { return writeDatagram(datagram.constData(), datagram.size(), host, port); }
@@ -2000,10 +2000,13 @@ qint64 QSslSocket::writeData(const char *data, qint64 len)
 #ifdef QSSLSOCKET_DEBUG
     qCDebug(lcSsl) << "QSslSocket::writeData(" << (void *)data << ',' << len << ')';
 #endif
-    if (d->mode == UnencryptedMode && !d->autoStartHandshake)
+    if (d->mode == UnencryptedMode && !d->autoStartHandshake) {
+        if (d->isWriteChunkCached(data, len))
+            return d->plainSocket->write(*d->currentWriteChunk);
         return d->plainSocket->write(data, len);
+    }
 
-    d->writeBuffer.append(data, len);
+    d->write(data, len);
 
     // make sure we flush to the plain socket's buffer
     QMetaObject::invokeMethod(this, "_q_flushWriteBuffer", Qt::QueuedConnection);
@@ -82,6 +82,9 @@ private slots:
     void noIterations();
     void throttling();
     void blockSize();
+    void iterationHints_data();
+    void iterationHints();
+    void orderedIterations();
     void multipleResults();
 };
 
@@ -284,6 +287,92 @@ void tst_QtConcurrentIterateKernel::blockSize()
     QVERIFY2(recorder.peakBlockSize >= expectedMinimumBlockSize, msgBlockSize(recorder, expectedMinimumBlockSize));
 }
 
+class CoverageRecorder : public IterateKernel<TestIterator, void>
+{
+public:
+    CoverageRecorder(TestIterator begin, TestIterator end)
+        : IterateKernel<TestIterator, void>(begin, end)
+        , visits(end.i - begin.i)
+    {}
+
+    inline bool runIterations(TestIterator, int begin, int end, void *)
+    {
+        // the first items are much more expensive than the others, so the
+        // threads done with theirs have to take over
+        if (begin < 10)
+            QTest::qSleep(10);
+        for (int i = begin; i < end; ++i)
+            visits[i].ref();
+        return false;
+    }
+
+    QVector<QAtomicInt> visits;
+};
+
+void tst_QtConcurrentIterateKernel::iterationHints_data()
+{
+    QTest::addColumn<int>("grainSize");
+    QTest::addColumn<int>("cost");
+
+    QTest::newRow("default") << 0 << int(IterationHints::UnknownCost);
+    QTest::newRow("uniform") << 0 << int(IterationHints::UniformCost);
+    QTest::newRow("varying") << 0 << int(IterationHints::VaryingCost);
+    QTest::newRow("grain size") << 64 << int(IterationHints::UnknownCost);
+}
+
+void tst_QtConcurrentIterateKernel::iterationHints()
+{
+    QFETCH(int, grainSize);
+    QFETCH(int, cost);
+
+    const int iterationCount = 10000;
+    for (int i = 0; i < 20; ++i) {
+        CoverageRecorder recorder(0, iterationCount);
+        recorder.setIterationHints(IterationHints(grainSize, IterationHints::Cost(cost)));
+        recorder.startBlocking();
+
+        for (int j = 0; j < iterationCount; ++j)
+            QCOMPARE(recorder.visits.at(j).load(), 1);
+    }
+}
+
+class OrderRecorder : public IterateKernel<TestIterator, void>
+{
+public:
+    OrderRecorder(TestIterator begin, TestIterator end)
+        : IterateKernel<TestIterator, void>(begin, end), started(0), peakLead(0)
+    {}
+
+    inline bool runIterations(TestIterator, int begin, int end, void *)
+    {
+        // how far ahead of the items started so far this block is
+        QMutexLocker locker(&mutex);
+        peakLead = qMax(peakLead, begin - started);
+        started += end - begin;
+        return false;
+    }
+
+    int maximumBlockSize() const Q_DECL_OVERRIDE { return 10; }
+    bool orderedIterations() const Q_DECL_OVERRIDE { return true; }
+
+    QMutex mutex;
+    int started;
+    int peakLead;
+};
+
+void tst_QtConcurrentIterateKernel::orderedIterations()
+{
+    // the blocks are handed out in input order, so none of them is further
+    // ahead than the blocks the other threads have reserved
+    const int threadCount = QThreadPool::globalInstance()->maxThreadCount() + 1;
+    for (int i = 0; i < 20; ++i) {
+        OrderRecorder recorder(0, 10000);
+        recorder.startBlocking();
+        QCOMPARE(recorder.started, 10000);
+        QVERIFY(recorder.peakLead <= threadCount * recorder.maximumBlockSize());
+    }
+}
+
 class MultipleResultsFor : public IterateKernel<TestIterator, int>
 {
 public:
@@ -57,6 +57,7 @@ private slots:
     void qFutureAssignmentLeak();
     void stressTest();
     void persistentResultTest();
+    void parallelReduce();
 public slots:
     void throttling();
 };
@@ -2377,6 +2378,36 @@ void tst_QtConcurrentMap::stressTest()
     }
 }
 
+void tst_QtConcurrentMap::parallelReduce()
+{
+    const int listSize = 1000;
+    const int sum = (listSize - 1) * (listSize / 2);
+    QList<int> list;
+    for (int i = 0; i < listSize; ++i)
+        list.append(i);
+
+    for (int i = 0; i < 100; ++i) {
+        int result = QtConcurrent::blockingMappedReduced(list, echo, add, ParallelReduce);
+        QCOMPARE(result, sum);
+    }
+
+    {
+        QFuture<int> future = QtConcurrent::mappedReduced(list.constBegin(), list.constEnd(),
+                                                          echo, add, ParallelReduce);
+        QCOMPARE(future.result(), sum);
+    }
+
+    {
+        // the result type differs from the intermediate type, this falls
+        // back to an unordered reduction
+        QList<int> result = QtConcurrent::blockingMappedReduced(list, echo, &QList<int>::push_back,
+                                                               ParallelReduce);
+        QCOMPARE(result.count(), listSize);
+        std::sort(result.begin(), result.end());
+        QCOMPARE(result, list);
+    }
+}
+
 struct LockedCounter
 {
     LockedCounter(QMutex *mutex, QAtomicInt *ai)
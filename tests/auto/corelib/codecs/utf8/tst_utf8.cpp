@@ -61,6 +61,9 @@ private slots:
 
     void nonCharacters_data();
     void nonCharacters();
+
+    void invalidInLongText_data();
+    void invalidInLongText();
 };
 
 void tst_Utf8::initTestCase()
@@ -297,5 +300,61 @@ void tst_Utf8::nonCharacters()
         qWarning("System codec reports failure when it shouldn't. Should report bug upstream.");
 }
 
+void tst_Utf8::invalidInLongText_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QByteArray>("invalid");
+    QTest::addColumn<int>("replacements");
+
+    // long enough to be decoded in blocks, with the error at every position
+    const QString texts[] = {
+        QStringLiteral("Voix ambigu\u00eb d'un c\u0153ur qui au z\u00e9phyr pr\u00e9f\u00e8re les jattes"),
+        QStringLiteral("\u0421\u044a\u0435\u0448\u044c \u0436\u0435 \u0435\u0449\u0451 \u044d\u0442\u0438\u0445 "
+                       "\u043c\u044f\u0433\u043a\u0438\u0445 \u0444\u0440\u0430\u043d\u0446\u0443\u0437\u0441\u043a\u0438\u0445"),
+        QStringLiteral("\u6211\u80fd\u541e\u4e0b\u73bb\u7483\u800c\u4e0d\u4f24\u8eab\u4f53\u3002"
+                       "\u8272\u306f\u5302\u3078\u3069\u6563\u308a\u306c\u308b\u3092\u3002"),
+        QStringLiteral("Hello, \u043c\u0438\u0440! \u4f60\u597d\uff0c\u4e16\u754c! \u0393\u03b5\u03b9\u03ac \u03c3\u03bf\u03c5!")
+    };
+    const char *const names[] = { "latin", "cyrillic", "cjk", "mixed" };
+
+    for (int i = 0; i < 4; ++i) {
+        const QString text = texts[i];
+        QByteArray name = names[i];
+        QTest::newRow(name + "-valid") << text << QByteArray() << 0;
+        QTest::newRow(name + "-ff") << text << QByteArray("\xff") << 1;
+        QTest::newRow(name + "-continuation") << text << QByteArray("\x80") << 1;
+        QTest::newRow(name + "-overlong2") << text << QByteArray("\xc0\xaf") << 2;
+        QTest::newRow(name + "-overlong3") << text << QByteArray("\xe0\x9f\xbf") << 3;
+        QTest::newRow(name + "-surrogate") << text << QByteArray("\xed\xa0\x80") << 3;
+        QTest::newRow(name + "-truncated") << text << QByteArray("\xe4\xbd") << 2;
+        QTest::newRow(name + "-4byte") << text << QByteArray("\xf0\x9f\x98\x80") << -1;
+    }
+}
+
+void tst_Utf8::invalidInLongText()
+{
+    QFETCH(QString, text);
+    QFETCH(QByteArray, invalid);
+    QFETCH(int, replacements);
+
+    for (int i = 0; i < text.size(); ++i) {
+        const QString prefix = text.left(i);
+        const QString suffix = text.mid(i);
+        QString expected = prefix;
+        if (replacements < 0)
+            expected += QString::fromUtf8(invalid);     // a valid four-byte sequence
+        else
+            expected += QString(replacements, QChar::ReplacementCharacter);
+        expected += suffix;
+
+        const QByteArray utf8 = to8Bit(prefix) + invalid + to8Bit(suffix);
+        QCOMPARE(from8Bit(utf8), expected);
+
+        const QScopedPointer<QTextDecoder> decoder(codec->makeDecoder());
+        QCOMPARE(decoder->toUnicode(utf8), expected);
+        QCOMPARE(decoder->hasFailure(), replacements > 0);
+    }
+}
+
 QTEST_MAIN(tst_Utf8)
 #include "tst_utf8.moc"
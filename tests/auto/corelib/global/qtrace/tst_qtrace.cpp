@@ -0,0 +1,244 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/private/qtrace_p.h>
+
+#include <functional>
+
+Q_LOGGING_CATEGORY(lcTraceTest, "qt.trace.test", QtInfoMsg)
+
+class tst_QTrace: public QObject
+{
+    Q_OBJECT
+
+signals:
+    void traced();
+
+private slots:
+    void cleanup();
+    void inactive();
+    void scopes();
+    void categoryRules();
+    void asyncOperations();
+    void threads();
+    void ringBuffer();
+    void reusedBuffers();
+};
+
+class FunctionThread : public QThread
+{
+public:
+    explicit FunctionThread(std::function<void()> function) : function(function) { }
+protected:
+    void run() Q_DECL_OVERRIDE { function(); }
+private:
+    std::function<void()> function;
+};
+
+static QJsonArray traceEvents(const QString &name)
+{
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(QTraceRecorder::chromeTrace(), &error);
+    if (error.error != QJsonParseError::NoError)
+        qWarning() << "invalid trace:" << error.errorString();
+
+    QJsonArray events;
+    const QJsonArray all = document.object().value(QLatin1String("traceEvents")).toArray();
+    for (const QJsonValue &event : all) {
+        if (event.toObject().value(QLatin1String("name")).toString() == name)
+            events.append(event);
+    }
+    return events;
+}
+
+void tst_QTrace::cleanup()
+{
+    QTraceRecorder::stop();
+    QLoggingCategory::setFilterRules(QString());
+}
+
+void tst_QTrace::inactive()
+{
+    QVERIFY(!QTraceRecorder::isActive());
+    Q_TRACE_INSTANT(lcTraceTest, "inactive", 0);
+    {
+        Q_TRACE_SCOPE(lcTraceTest, "inactive", 0);
+    }
+    QVERIFY(traceEvents(QStringLiteral("inactive")).isEmpty());
+}
+
+void tst_QTrace::scopes()
+{
+    QObject receiver;
+    connect(this, &tst_QTrace::traced, &receiver, [] { });
+
+    QTraceRecorder::start();
+    QVERIFY(QTraceRecorder::isActive());
+    {
+        Q_TRACE_SCOPE(lcTraceTest, "scope", 42);
+        QEvent event(QEvent::User);
+        QCoreApplication::sendEvent(&receiver, &event);
+        emit traced();
+    }
+    QTraceRecorder::stop();
+
+    const QJsonArray scope = traceEvents(QStringLiteral("scope"));
+    QCOMPARE(scope.size(), 2);
+    const QJsonObject begin = scope.at(0).toObject();
+    const QJsonObject end = scope.at(1).toObject();
+    QCOMPARE(begin.value(QLatin1String("ph")).toString(), QStringLiteral("B"));
+    QCOMPARE(begin.value(QLatin1String("cat")).toString(), QStringLiteral("qt.trace.test"));
+    QCOMPARE(begin.value(QLatin1String("args")).toObject().value(QLatin1String("value")).toInt(), 42);
+    QCOMPARE(end.value(QLatin1String("ph")).toString(), QStringLiteral("E"));
+    QCOMPARE(end.value(QLatin1String("tid")).toInt(), begin.value(QLatin1String("tid")).toInt());
+    QVERIFY(end.value(QLatin1String("ts")).toDouble() >= begin.value(QLatin1String("ts")).toDouble());
+
+    bool userEvent = false;
+    const QJsonArray notify = traceEvents(QStringLiteral("QCoreApplication::notify"));
+    for (const QJsonValue &event : notify) {
+        const QJsonObject object = event.toObject();
+        if (object.value(QLatin1String("ph")).toString() == QLatin1String("B")
+                && object.value(QLatin1String("args")).toObject().value(QLatin1String("value")).toInt() == QEvent::User)
+            userEvent = true;
+    }
+    QVERIFY(userEvent);
+    QVERIFY(!traceEvents(QStringLiteral("QMetaObject::activate")).isEmpty());
+}
+
+void tst_QTrace::categoryRules()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("qt.trace.test.info=false"));
+    QTraceRecorder::start();
+    Q_TRACE_INSTANT(lcTraceTest, "filtered", 0);
+    QLoggingCategory::setFilterRules(QString());
+    Q_TRACE_INSTANT(lcTraceTest, "unfiltered", 0);
+    QTraceRecorder::stop();
+
+    QVERIFY(traceEvents(QStringLiteral("filtered")).isEmpty());
+    const QJsonArray unfiltered = traceEvents(QStringLiteral("unfiltered"));
+    QCOMPARE(unfiltered.size(), 1);
+    QCOMPARE(unfiltered.at(0).toObject().value(QLatin1String("ph")).toString(), QStringLiteral("i"));
+}
+
+void tst_QTrace::asyncOperations()
+{
+    QTraceRecorder::start();
+    Q_TRACE_ASYNC_BEGIN(lcTraceTest, "operation", 0xbeef);
+    FunctionThread thread([] {
+        Q_TRACE_ASYNC_END(lcTraceTest, "operation", 0xbeef);
+    });
+    thread.start();
+    QVERIFY(thread.wait());
+    QTraceRecorder::stop();
+
+    const QJsonArray operation = traceEvents(QStringLiteral("operation"));
+    QCOMPARE(operation.size(), 2);
+    QCOMPARE(operation.at(0).toObject().value(QLatin1String("id")).toString(), QStringLiteral("0xbeef"));
+    QCOMPARE(operation.at(1).toObject().value(QLatin1String("id")).toString(), QStringLiteral("0xbeef"));
+}
+
+void tst_QTrace::threads()
+{
+    class Runnable : public QRunnable
+    {
+    public:
+        void run() Q_DECL_OVERRIDE
+        {
+            Q_TRACE_INSTANT(lcTraceTest, "runnable", 0);
+        }
+    };
+
+    QThreadPool pool;
+    QTraceRecorder::start();
+    Q_TRACE_INSTANT(lcTraceTest, "main", 0);
+    pool.start(new Runnable);
+    QVERIFY(pool.waitForDone());
+    QTraceRecorder::stop();
+
+    const QJsonArray main = traceEvents(QStringLiteral("main"));
+    const QJsonArray runnable = traceEvents(QStringLiteral("runnable"));
+    QCOMPARE(main.size(), 1);
+    QCOMPARE(runnable.size(), 1);
+    QVERIFY(main.at(0).toObject().value(QLatin1String("tid")).toInt()
+            != runnable.at(0).toObject().value(QLatin1String("tid")).toInt());
+    QVERIFY(!traceEvents(QStringLiteral("QRunnable::run")).isEmpty());
+}
+
+void tst_QTrace::ringBuffer()
+{
+    // the buffer size only applies to threads that haven't recorded anything yet
+    QTraceRecorder::start(4);
+    FunctionThread thread([] {
+        for (int i = 0; i < 10; ++i)
+            Q_TRACE_INSTANT(lcTraceTest, "wrapped", i);
+    });
+    thread.start();
+    QVERIFY(thread.wait());
+    QTraceRecorder::stop();
+
+    const QJsonArray wrapped = traceEvents(QStringLiteral("wrapped"));
+    QCOMPARE(wrapped.size(), 4);
+    for (int i = 0; i < 4; ++i)
+        QCOMPARE(wrapped.at(i).toObject().value(QLatin1String("args")).toObject().value(QLatin1String("value")).toInt(), 6 + i);
+}
+
+void tst_QTrace::reusedBuffers()
+{
+    // threads that run one after the other share a buffer
+    QTraceRecorder::start();
+    for (int i = 0; i < 10; ++i) {
+        FunctionThread thread([i] { Q_TRACE_INSTANT(lcTraceTest, "sequential", i); });
+        thread.start();
+        QVERIFY(thread.wait());
+    }
+    QTraceRecorder::stop();
+
+    // the records of the threads that have exited are kept, each thread
+    // with a number and a name of its own
+    const QJsonArray sequential = traceEvents(QStringLiteral("sequential"));
+    QCOMPARE(sequential.size(), 10);
+    QSet<int> values;
+    QSet<int> threads;
+    for (const QJsonValue &event : sequential) {
+        values.insert(event.toObject().value(QLatin1String("args")).toObject().value(QLatin1String("value")).toInt());
+        threads.insert(event.toObject().value(QLatin1String("tid")).toInt());
+    }
+    QCOMPARE(values.size(), 10);
+    QCOMPARE(threads.size(), 10);
+
+    QSet<int> named;
+    const QJsonArray names = traceEvents(QStringLiteral("thread_name"));
+    for (const QJsonValue &name : names)
+        named.insert(name.toObject().value(QLatin1String("tid")).toInt());
+    QVERIFY(named.contains(threads));
+}
+
+QTEST_MAIN(tst_QTrace)
+#include "tst_qtrace.moc"
@@ -32,6 +32,7 @@
 #include "qjsonobject.h"
 #include "qjsonvalue.h"
 #include "qjsondocument.h"
+#include "qjsonstream.h"
 #include <limits>
 
 #define INVALID_UNICODE "\xCE\xBA\xE1"
@@ -94,8 +95,11 @@ private Q_SLOTS:
     void toAndFromBinary_data();
     void toAndFromBinary();
     void invalidBinaryData();
+    void fromMappedFile();
+    void modifyRawData();
     void parseNumbers();
     void parseStrings();
+    void parseLongStrings();
     void parseDuplicateKeys();
     void testParser();
 
@@ -143,6 +147,20 @@ private Q_SLOTS:
     void parseErrorOffset_data();
     void parseErrorOffset();
 
+    void streamReaderTokens();
+    void streamReaderMatchesParser_data();
+    void streamReaderMatchesParser();
+    void streamReaderErrors_data();
+    void streamReaderErrors();
+    void streamReaderMultipleDocuments();
+    void streamReaderEndOfInput();
+    void streamReaderResumeValue();
+    void streamReaderSkipValue();
+    void streamWriter();
+    void streamWriterMatchesToJson_data();
+    void streamWriterMatchesToJson();
+    void streamRoundTripLarge();
+
 private:
     QString testDataDir;
 };
@@ -1786,6 +1804,71 @@ void tst_QtJson::invalidBinaryData()
     }
 }
 
+void tst_QtJson::fromMappedFile()
+{
+    QFile bfile(testDataDir + "/test.bjson");
+    QVERIFY(bfile.open(QFile::ReadOnly));
+    const QByteArray binary = bfile.readAll();
+
+    QJsonDocument mapped = QJsonDocument::fromMappedFile(testDataDir + "/test.bjson");
+    QVERIFY(!mapped.isNull());
+    QCOMPARE(mapped, QJsonDocument::fromBinaryData(binary));
+    QCOMPARE(QJsonDocument::fromMappedFile(testDataDir + "/test.bjson", QJsonDocument::BypassValidation), mapped);
+    QVERIFY(QJsonDocument::fromMappedFile(testDataDir + "/doesnotexist.bjson").isNull());
+    QVERIFY(QJsonDocument::fromMappedFile(testDataDir + "/test.json").isNull());
+
+    QDir dir(testDataDir + "/invalidBinaryData");
+    QFileInfoList files = dir.entryInfoList();
+    for (int i = 0; i < files.size(); ++i) {
+        if (files.at(i).isFile())
+            QVERIFY(QJsonDocument::fromMappedFile(files.at(i).filePath()).isNull());
+    }
+
+    // the data outlives the document it was mapped for
+    QJsonDocument doc = QJsonDocument::fromJson("{ \"a\": { \"b\": [ 1, 2 ], \"c\": \"text\" }, \"d\": [ { \"e\": true } ] }");
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(doc.toBinaryData());
+    file.close();
+    QJsonObject object = QJsonDocument::fromMappedFile(file.fileName()).object();
+    QCOMPARE(object, doc.object());
+
+    // modifications are copied and never reach the file
+    QJsonObject a = object.value(QLatin1String("a")).toObject();
+    a.insert(QLatin1String("c"), QLatin1String("changed"));
+    a.remove(QLatin1String("b"));
+    QJsonArray d = object.value(QLatin1String("d")).toArray();
+    d.append(3);
+    QCOMPARE(a.value(QLatin1String("c")).toString(), QLatin1String("changed"));
+    QCOMPARE(d.size(), 2);
+    QCOMPARE(object, doc.object());
+
+    object.insert(QLatin1String("a"), a);
+    object.remove(QLatin1String("d"));
+    QCOMPARE(object.value(QLatin1String("a")).toObject(), a);
+    QVERIFY(!object.contains(QLatin1String("d")));
+
+    QVERIFY(file.open());
+    QCOMPARE(file.readAll(), doc.toBinaryData());
+    QCOMPARE(QJsonDocument::fromMappedFile(file.fileName()), doc);
+}
+
+void tst_QtJson::modifyRawData()
+{
+    const QByteArray binary = QJsonDocument::fromJson("{ \"a\": [ 1, 2 ], \"b\": { \"c\": 3 } }").toBinaryData();
+    QByteArray data = binary;
+    data.detach();
+
+    QJsonDocument doc = QJsonDocument::fromRawData(data.constData(), data.size());
+    QVERIFY(!doc.isNull());
+    QJsonObject object = doc.object();
+    doc = QJsonDocument();
+    object.remove(QLatin1String("a"));
+    object.insert(QLatin1String("b"), 4);
+    QCOMPARE(object.value(QLatin1String("b")).toInt(), 4);
+    QCOMPARE(data, binary);
+}
+
 void tst_QtJson::parseNumbers()
 {
     {
@@ -1800,7 +1883,15 @@ void tst_QtJson::parseNumbers()
             { "10", 10 },
             { "-1", -1 },
             { "100000", 100000 },
-            { "-999", -999 }
+            { "-999", -999 },
+            { "33554431", 33554431 },
+            { "33554432", 33554432 },
+            { "-33554431", -33554431 },
+            { "-33554432", -33554432 },
+            { "999999999", 999999999 },
+            { "-999999999", -999999999 },
+            { "1000000000", 1000000000 },
+            { "2147483647", 2147483647 }
         };
         int size = sizeof(numbers)/sizeof(Numbers);
         for (int i = 0; i < size; ++i) {
@@ -1935,6 +2026,57 @@ void tst_QtJson::parseStrings()
 
 }
 
+void tst_QtJson::parseLongStrings()
+{
+    // put a character that needs special handling at every position of strings
+    // long enough to be scanned in blocks
+    const QString specials[] = {
+        QStringLiteral("\""), QStringLiteral("\\"), QStringLiteral("\n"),
+        QString(QChar(0xe9)), QString(QChar(0x402)), QString(QChar(0xffff))
+    };
+    const char *escaped[] = { "\\\"", "\\\\", "\\n", "\xc3\xa9", UNICODE_DJE, UNICODE_NON_CHARACTER };
+
+    for (int s = 0; s < int(sizeof(escaped)/sizeof(const char *)); ++s) {
+        for (int length = 1; length < 70; ++length) {
+            for (int at = 0; at < length; ++at) {
+                QString expected(length - 1, QLatin1Char('a'));
+                expected.insert(at, specials[s]);
+                QByteArray json = "[\"";
+                json += QByteArray(at, 'a');
+                json += escaped[s];
+                json += QByteArray(length - 1 - at, 'a');
+                json += "\"]";
+
+                QJsonParseError error;
+                QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+                QCOMPARE(error.error, QJsonParseError::NoError);
+                QCOMPARE(doc.array().at(0).toString(), expected);
+            }
+        }
+    }
+
+    // strings at the limit of what can be stored as Latin-1
+    for (int length = 0x7fe0; length < 0x8020; ++length) {
+        QByteArray json = "[\"" + QByteArray(length, 'b') + "\", \"" + QByteArray(length, 'c') + "\xc3\xa9\"]";
+        QJsonParseError error;
+        QJsonArray array = QJsonDocument::fromJson(json, &error).array();
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QCOMPARE(array.at(0).toString(), QString(length, QLatin1Char('b')));
+        QCOMPARE(array.at(1).toString(), QString(length, QLatin1Char('c')) + QChar(0xe9));
+    }
+
+    // long runs of whitespace and unterminated strings
+    QByteArray json = "{" + QByteArray(40, ' ') + "\"key\":\n" + QByteArray(33, '\t') + "\"" + QByteArray(40, 'd') + "\"\r\n}";
+    QJsonDocument doc = QJsonDocument::fromJson(json);
+    QCOMPARE(doc.object().value(QLatin1String("key")).toString(), QString(40, QLatin1Char('d')));
+
+    QJsonParseError error;
+    QJsonDocument::fromJson("[\"" + QByteArray(40, 'e'), &error);
+    QCOMPARE(error.error, QJsonParseError::UnterminatedString);
+    QJsonDocument::fromJson("[\"" + QByteArray(40, 'e') + UNICODE_DJE + QByteArray(40, 'e'), &error);
+    QCOMPARE(error.error, QJsonParseError::UnterminatedString);
+}
+
 void tst_QtJson::parseDuplicateKeys()
 {
     const char *json = "{ \"B\": true, \"A\": null, \"B\": false }";
@@ -2879,5 +3021,407 @@ void tst_QtJson::parseErrorOffset()
     QCOMPARE(error.offset, errorOffset);
 }
 
+void tst_QtJson::streamReaderTokens()
+{
+    QJsonStreamReader reader(QByteArray("{ \"a\": [1, -2.5e1, \"x\\ty\", true, false, null], \"b\\u00e9\": {} }"));
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), QString("a"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.depth(), 2);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toDouble(), 1.);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toDouble(), -25.);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), QString("x\ty"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Bool);
+    QCOMPARE(reader.toBool(), true);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Bool);
+    QCOMPARE(reader.toBool(), false);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Null);
+    QCOMPARE(reader.value(), QJsonValue(QJsonValue::Null));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), QString::fromUtf8("b\xc3\xa9"));
+    QCOMPARE(reader.offset(), qint64(47));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 0);
+    QVERIFY(!reader.atEnd());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QtJson::streamReaderMatchesParser_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<int>("chunkSize");
+
+    const char *files[] = { "test.json", "test2.json", "test3.json", "bom.json" };
+    for (const char *name : files) {
+        QFile file(testDataDir + QLatin1Char('/') + QLatin1String(name));
+        QVERIFY(file.open(QFile::ReadOnly));
+        const QByteArray json = file.readAll();
+        const int chunkSizes[] = { 1, 7, 100, 0 };
+        for (int chunkSize : chunkSizes)
+            QTest::newRow(QByteArray(name) + " chunk " + QByteArray::number(chunkSize)) << json << chunkSize;
+    }
+    QTest::newRow("unicode") << QByteArray("[\"" UNICODE_DJE "\", \"\\ud834\\udd1e\", \"\xf0\x9d\x84\x9e\"]") << 1;
+}
+
+void tst_QtJson::streamReaderMatchesParser()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(int, chunkSize);
+
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    QVERIFY(!doc.isNull());
+    const QJsonValue expected = doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object());
+
+    // from a device
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader deviceReader(&buffer);
+    deviceReader.readNext();
+    QCOMPARE(deviceReader.readValue(), expected);
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::EndDocument);
+
+    if (!chunkSize)
+        return;
+
+    // fed in chunks, resuming after each premature end
+    QJsonStreamReader reader;
+    QJsonArray values;
+    QVector<QJsonValue> stack;
+    QStringList names;
+    int fed = 0;
+    forever {
+        const QJsonStreamReader::TokenType type = reader.readNext();
+        if (type == QJsonStreamReader::Invalid || type == QJsonStreamReader::EndDocument) {
+            if (type == QJsonStreamReader::Invalid)
+                QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+            if (fed >= json.size())
+                break;
+            reader.addData(json.mid(fed, chunkSize));
+            fed += chunkSize;
+            continue;
+        }
+        QVERIFY(type != QJsonStreamReader::NoToken);
+        if (type == QJsonStreamReader::Name) {
+            names.append(reader.text());
+            continue;
+        }
+        QJsonValue v;
+        if (type == QJsonStreamReader::StartArray) {
+            stack.append(QJsonArray());
+            continue;
+        } else if (type == QJsonStreamReader::StartObject) {
+            stack.append(QJsonObject());
+            continue;
+        } else if (type == QJsonStreamReader::EndArray || type == QJsonStreamReader::EndObject) {
+            v = stack.takeLast();
+        } else {
+            v = reader.value();
+        }
+        if (stack.isEmpty()) {
+            values.append(v);
+        } else if (stack.last().isArray()) {
+            QJsonArray a = stack.last().toArray();
+            a.append(v);
+            stack.last() = a;
+        } else {
+            QJsonObject o = stack.last().toObject();
+            o.insert(names.takeLast(), v);
+            stack.last() = o;
+        }
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(values.size(), 1);
+    QCOMPARE(values.at(0), expected);
+}
+
+void tst_QtJson::streamReaderErrors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<int>("error");
+
+    QTest::newRow("unterminated object") << QByteArray("{ \"a\": 1 ]") << int(QJsonParseError::UnterminatedObject);
+    QTest::newRow("missing name separator") << QByteArray("{ \"a\" 1 }") << int(QJsonParseError::MissingNameSeparator);
+    QTest::newRow("missing value separator") << QByteArray("[ 1 2 ]") << int(QJsonParseError::MissingValueSeparator);
+    QTest::newRow("illegal value") << QByteArray("[ nul ]") << int(QJsonParseError::IllegalValue);
+    QTest::newRow("leading comma") << QByteArray("[ , false]") << int(QJsonParseError::IllegalValue);
+    QTest::newRow("illegal number") << QByteArray("[ -x ]") << int(QJsonParseError::IllegalNumber);
+    QTest::newRow("illegal escape") << QByteArray("[ \"\\u12x4\" ]") << int(QJsonParseError::IllegalEscapeSequence);
+    QTest::newRow("illegal utf8") << QByteArray("[ \"" INVALID_UNICODE "\" ]") << int(QJsonParseError::IllegalUTF8String);
+    QTest::newRow("trailing comma in array") << QByteArray("[ 1, ]") << int(QJsonParseError::MissingObject);
+    QTest::newRow("trailing comma in object") << QByteArray("{ \"a\": 1, }") << int(QJsonParseError::MissingObject);
+    QTest::newRow("stray }") << QByteArray("  }  ") << int(QJsonParseError::MissingObject);
+    QTest::newRow("deep nesting") << QByteArray(2048, '[') << int(QJsonParseError::DeepNesting);
+    QTest::newRow("unterminated array") << QByteArray("[ 1, 2") << int(QJsonParseError::PrematureEndOfDocument);
+    QTest::newRow("unterminated string") << QByteArray("[ \"abc") << int(QJsonParseError::PrematureEndOfDocument);
+}
+
+void tst_QtJson::streamReaderErrors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(int, error);
+
+    QJsonStreamReader reader(json);
+    while (!reader.atEnd())
+        reader.readNext();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QCOMPARE(int(reader.error()), error);
+    QVERIFY(!reader.errorString().isEmpty());
+
+    if (error != QJsonParseError::PrematureEndOfDocument) {
+        // not recoverable
+        QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+        QCOMPARE(int(reader.error()), error);
+    }
+}
+
+void tst_QtJson::streamReaderMultipleDocuments()
+{
+    QJsonStreamReader reader;
+    reader.addData("{\"id\":1}\n[2]\n\"three\" 4");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonObject{{"id", 1}}));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray{2}));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.readValue(), QJsonValue("three"));
+
+    // the number might continue
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    QVERIFY(reader.atEnd());
+    reader.addData("2\n{\"id\"");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toDouble(), 42.);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    reader.addData(": 5}\n");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toDouble(), 5.);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.offset(), qint64(34));
+}
+
+// a sequential device that is fed from the test
+class SequentialDevice : public QIODevice
+{
+public:
+    SequentialDevice() { open(ReadOnly); }
+    bool isSequential() const Q_DECL_OVERRIDE { return true; }
+    qint64 bytesAvailable() const Q_DECL_OVERRIDE { return pending.size() + QIODevice::bytesAvailable(); }
+    void append(const QByteArray &data) { pending += data; }
+    void finishReading() { emit readChannelFinished(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) Q_DECL_OVERRIDE
+    {
+        const int size = int(qMin(maxSize, qint64(pending.size())));
+        memcpy(data, pending.constData(), size);
+        pending.remove(0, size);
+        return size;
+    }
+    qint64 writeData(const char *, qint64) Q_DECL_OVERRIDE { return -1; }
+
+private:
+    QByteArray pending;
+};
+
+void tst_QtJson::streamReaderEndOfInput()
+{
+    // a number at the end of added data is complete after endData()
+    QJsonStreamReader reader;
+    reader.addData("[1] 2");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    reader.skipCurrentValue();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    reader.addData("3");
+    reader.endData();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toDouble(), 23.);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(!reader.hasError());
+
+    // and at the end of a sequential device once its read channel is closed
+    SequentialDevice device;
+    QJsonStreamReader deviceReader(&device);
+    device.append("\"a\\");
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(deviceReader.error(), QJsonParseError::PrematureEndOfDocument);
+    device.append("\"b\" 42");
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(deviceReader.text(), QString("a\"b"));
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(deviceReader.error(), QJsonParseError::PrematureEndOfDocument);
+    device.finishReading();
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(deviceReader.toDouble(), 42.);
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QtJson::streamReaderResumeValue()
+{
+    // a container split across chunks is read again from its start
+    QJsonStreamReader reader;
+    reader.addData("{\"a\": [1, 2");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonValue::Undefined));
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    reader.addData(", 3], \"b\": \"x");
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonValue::Undefined));
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    reader.addData("y\"} ");
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonObject{{"a", QJsonArray{1, 2, 3}}, {"b", "xy"}}));
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+
+    // the value of a member, read from a sequential device
+    SequentialDevice device;
+    QJsonStreamReader deviceReader(&device);
+    device.append("{\"n\": {\"m\": [tr");
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(deviceReader.readValue(), QJsonValue(QJsonValue::Undefined));
+    QCOMPARE(deviceReader.error(), QJsonParseError::PrematureEndOfDocument);
+    device.append("ue]}");
+    QCOMPARE(deviceReader.readValue(), QJsonValue(QJsonObject{{"m", QJsonArray{true}}}));
+    QCOMPARE(deviceReader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(deviceReader.depth(), 1);
+
+    // reading token by token continues after the start of the value
+    device.append(", \"o\": [null");
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(deviceReader.readValue(), QJsonValue(QJsonValue::Undefined));
+    device.append("]}");
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::Null);
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(deviceReader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QtJson::streamReaderSkipValue()
+{
+    QJsonStreamReader reader(QByteArray("{\"skip\": {\"a\": [1, {\"b\": []}]}, \"keep\": [true], \"last\": 1}"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    reader.skipCurrentValue();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), QString("keep"));
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray{true}));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    reader.skipCurrentValue();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Number);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QtJson::streamWriter()
+{
+    QByteArray json;
+    {
+        QJsonStreamWriter writer(&json);
+        QCOMPARE(writer.format(), QJsonDocument::Compact);
+        writer.writeStartObject();
+        writer.writeMember("name", QString("a\"b\n"));
+        writer.writeName("list");
+        writer.writeStartArray();
+        writer.writeValue(1);
+        writer.writeValue(2.5);
+        writer.writeValue(qInf());
+        writer.writeValue(QJsonValue());
+        writer.writeValue(QJsonObject{{"x", false}});
+        writer.writeEndArray();
+        QCOMPARE(writer.depth(), 1);
+        writer.writeEndObject();
+        QCOMPARE(writer.depth(), 0);
+        writer.writeValue(QString("next"));
+        QVERIFY(!writer.hasError());
+    }
+    QCOMPARE(json, QByteArray("{\"name\":\"a\\\"b\\n\",\"list\":[1,2.5,null,null,{\"x\":false}]}\n\"next\"\n"));
+}
+
+void tst_QtJson::streamWriterMatchesToJson_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("test.json") << (testDataDir + "/test.json");
+    QTest::newRow("test2.json") << (testDataDir + "/test2.json");
+    QTest::newRow("test3.json") << (testDataDir + "/test3.json");
+}
+
+void tst_QtJson::streamWriterMatchesToJson()
+{
+    QFETCH(QString, fileName);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(!doc.isNull());
+
+    QByteArray indented;
+    QJsonStreamWriter indentedWriter(&indented);
+    indentedWriter.setFormat(QJsonDocument::Indented);
+    indentedWriter.writeDocument(doc);
+    QCOMPARE(indented, doc.toJson(QJsonDocument::Indented));
+
+    QByteArray compact;
+    QJsonStreamWriter compactWriter(&compact);
+    compactWriter.writeDocument(doc);
+    QCOMPARE(compact, doc.toJson(QJsonDocument::Compact) + '\n');
+}
+
+void tst_QtJson::streamRoundTripLarge()
+{
+    // enough output to go through the writer's and the reader's buffers several times
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    {
+        QJsonStreamWriter writer(&buffer);
+        for (int i = 0; i < 20000; ++i) {
+            writer.writeStartObject();
+            writer.writeMember("id", i);
+            writer.writeMember("text", QString::fromUtf8("line " UNICODE_DJE " ") + QString::number(i));
+            writer.writeEndObject();
+        }
+        QVERIFY(writer.flush());
+    }
+    buffer.close();
+    QVERIFY(data.size() > 256 * 1024);
+
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    int count = 0;
+    while (reader.readNext() == QJsonStreamReader::StartObject) {
+        const QJsonObject o = reader.readValue().toObject();
+        QCOMPARE(o.value("id").toInt(), count);
+        QCOMPARE(o.value("text").toString(), QString::fromUtf8("line " UNICODE_DJE " ") + QString::number(count));
+        ++count;
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndDocument);
+    QCOMPARE(count, 20000);
+}
+
 QTEST_MAIN(tst_QtJson)
 #include "tst_qtjson.moc"
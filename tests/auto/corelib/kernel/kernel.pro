@@ -1,9 +1,11 @@
 TEMPLATE=subdirs
+QT_FOR_CONFIG += core-private
 SUBDIRS=\
     qcoreapplication \
     qdeadlinetimer \
     qelapsedtimer \
     qeventdispatcher \
+    qeventdispatcher_epoll \
     qeventloop \
     qmath \
     qmetaobject \
@@ -19,6 +21,8 @@ SUBDIRS=\
     qsignalblocker \
     qsignalmapper \
     qsocketnotifier \
+    qsocketnotifier_epoll \
+    qsocketnotifier_epoll_et \
     qsystemsemaphore \
     qtimer \
     qtranslator \
@@ -31,12 +35,22 @@ SUBDIRS=\
 !qtHaveModule(network): SUBDIRS -= \
     qeventloop \
     qobject \
-    qsocketnotifier
+    qsocketnotifier \
+    qsocketnotifier_epoll \
+    qsocketnotifier_epoll_et
 
 !qtConfig(private_tests): SUBDIRS -= \
     qsocketnotifier \
+    qsocketnotifier_epoll \
+    qsocketnotifier_epoll_et \
     qsharedmemory
 
+# These tests run the dispatcher tests on top of the Linux epoll dispatcher
+!qtConfig(epoll): SUBDIRS -= \
+    qeventdispatcher_epoll \
+    qsocketnotifier_epoll \
+    qsocketnotifier_epoll_et
+
 # This test is only applicable on Windows
 !win32*|winrt: SUBDIRS -= qwineventnotifier
 
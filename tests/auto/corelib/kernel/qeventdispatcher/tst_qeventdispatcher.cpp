@@ -33,6 +33,15 @@
 #endif
 #include <QtTest/QtTest>
 
+#ifdef TEST_EVENT_DISPATCHER
+// select the dispatcher under test before QTEST_MAIN creates the application
+static void selectEventDispatcher()
+{
+    qputenv("QT_EVENT_DISPATCHER", TEST_EVENT_DISPATCHER);
+}
+Q_CONSTRUCTOR_FUNCTION(selectEventDispatcher)
+#endif
+
 enum {
     PreciseTimerInterval    =   10,
     CoarseTimerInterval     =  200,
@@ -85,6 +94,9 @@ bool tst_QEventDispatcher::event(QEvent *e)
 // drain the system event queue after the test starts to avoid destabilizing the test functions
 void tst_QEventDispatcher::initTestCase()
 {
+#ifdef TEST_EVENT_DISPATCHER_CLASS
+    QCOMPARE(eventDispatcher->metaObject()->className(), TEST_EVENT_DISPATCHER_CLASS);
+#endif
     QElapsedTimer elapsedTimer;
     elapsedTimer.start();
     while (!elapsedTimer.hasExpired(CoarseTimerInterval) && eventDispatcher->processEvents(QEventLoop::AllEvents)) {
@@ -112,6 +112,7 @@ private slots:
     void disconnectByMetaMethod();
     void disconnectNotSignalMetaMethod();
     void autoConnectionBehavior();
+    void disconnectDuringOverlappingEmissions();
     void baseDestroyed();
     void pointerConnect();
     void pointerDisconnect();
@@ -4357,6 +4358,46 @@ void tst_QObject::autoConnectionBehavior()
     delete receiver;
 }
 
+void tst_QObject::disconnectDuringOverlappingEmissions()
+{
+    class EmitThread : public QThread
+    {
+    public:
+        SenderObject *sender;
+        QAtomicInt *stop;
+        EmitThread(SenderObject *sender, QAtomicInt *stop) : sender(sender), stop(stop) {}
+        void run() Q_DECL_OVERRIDE
+        {
+            while (!stop->load())
+                sender->emitSignal1();
+        }
+    };
+
+    SenderObject sender;
+    QAtomicInt stop;
+    EmitThread thread1(&sender, &stop);
+    EmitThread thread2(&sender, &stop);
+    thread1.start();
+    thread2.start();
+
+    // the emissions of the two threads overlap all the time, a disconnected
+    // functor must still be released while they go on
+    for (int i = 0; i < 100; ++i) {
+        QSharedPointer<int> guard(new int(i));
+        QWeakPointer<int> weak = guard;
+        QMetaObject::Connection connection =
+                connect(&sender, &SenderObject::signal1, &sender, [guard] {}, Qt::DirectConnection);
+        guard.reset();
+        sender.emitSignal1();
+        QVERIFY(QObject::disconnect(connection));
+        QTRY_VERIFY(weak.isNull());
+    }
+
+    stop.store(1);
+    QVERIFY(thread1.wait(30000));
+    QVERIFY(thread2.wait(30000));
+}
+
 class BaseDestroyed : public QObject
 { Q_OBJECT
     QList<QString> fooList;
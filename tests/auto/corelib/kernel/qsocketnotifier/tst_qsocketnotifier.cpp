@@ -30,6 +30,7 @@
 #include <QtTest/QSignalSpy>
 #include <QtTest/QTestEventLoop>
 
+#include <QtCore/QAbstractEventDispatcher>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTimer>
 #include <QtCore/QSocketNotifier>
@@ -48,6 +49,15 @@
 #endif
 #include <limits>
 
+#ifdef TEST_EVENT_DISPATCHER
+// select the dispatcher under test before QTEST_MAIN creates the application
+static void selectEventDispatcher()
+{
+    qputenv("QT_EVENT_DISPATCHER", TEST_EVENT_DISPATCHER);
+}
+Q_CONSTRUCTOR_FUNCTION(selectEventDispatcher)
+#endif
+
 #if defined (Q_CC_MSVC) && defined(max)
 #  undef max
 #  undef min
@@ -57,6 +67,9 @@ class tst_QSocketNotifier : public QObject
 {
     Q_OBJECT
 private slots:
+#ifdef TEST_EVENT_DISPATCHER_CLASS
+    void initTestCase();
+#endif
     void unexpectedDisconnection();
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
@@ -73,6 +86,14 @@ private:
     QUdpSocket *m_asyncReceiver;
 };
 
+#ifdef TEST_EVENT_DISPATCHER_CLASS
+void tst_QSocketNotifier::initTestCase()
+{
+    QCOMPARE(QAbstractEventDispatcher::instance()->metaObject()->className(),
+             TEST_EVENT_DISPATCHER_CLASS);
+}
+#endif
+
 static QHostAddress makeNonAny(const QHostAddress &address,
                                QHostAddress::SpecialAddress preferForAny = QHostAddress::LocalHost)
 {
@@ -0,0 +1,9 @@
+CONFIG += testcase
+TARGET = tst_qsocketnotifier_epoll_et
+QT = core-private network-private testlib
+SOURCES = ../qsocketnotifier/tst_qsocketnotifier.cpp
+DEFINES += TEST_EVENT_DISPATCHER=\\\"epoll-et\\\" TEST_EVENT_DISPATCHER_CLASS=\\\"QEventDispatcherEpoll\\\"
+
+requires(qtConfig(private_tests))
+
+include(../../../network/socket/platformsocketengine/platformsocketengine.pri)
@@ -69,6 +69,16 @@ private slots:
     void nestedExceptions();
 #endif
     void nonGlobalThreadPool();
+    void then();
+    void thenOnThreadPool();
+    void thenOnContext();
+    void thenAbandoned();
+#ifndef QT_NO_EXCEPTIONS
+    void thenExceptions();
+    void onFailed();
+#endif
+    void whenAll();
+    void whenAny();
 };
 
 void tst_QFuture::resultStore()
@@ -1482,5 +1492,361 @@ void tst_QFuture::nonGlobalThreadPool()
     }
 }
 
+static QFuture<void> createFinishedFuture()
+{
+    QFutureInterface<void> i;
+    i.reportStarted();
+    i.reportFinished();
+    return i.future();
+}
+
+void tst_QFuture::then()
+{
+    // attached before the future finishes
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        bool called = false;
+        QFuture<QString> f = i.future()
+                .then([&](int value) { called = true; return value * 2; })
+                .then([](int value) { return QString::number(value); });
+        QVERIFY(f.isRunning());
+        QVERIFY(!called);
+
+        i.reportResult(21);
+        i.reportFinished();
+        QVERIFY(called);
+        QVERIFY(f.isFinished());
+        QCOMPARE(f.result(), QString("42"));
+    }
+
+    // attached after the future finished
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        i.reportResult(1);
+        i.reportFinished();
+        QFuture<int> f = i.future().then([](int value) { return value + 1; });
+        QVERIFY(f.isFinished());
+        QCOMPARE(f.result(), 2);
+    }
+
+    // void futures and continuations
+    {
+        QFutureInterface<void> i;
+        i.reportStarted();
+        int calls = 0;
+        QFuture<void> f = i.future()
+                .then([&]() { ++calls; })
+                .then([&]() { ++calls; });
+        i.reportFinished();
+        QVERIFY(f.isFinished());
+        QVERIFY(!f.isCanceled());
+        QCOMPARE(calls, 2);
+    }
+
+    // several continuations on the same future
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        QFuture<int> f1 = i.future().then([](int value) { return value + 1; });
+        QFuture<int> f2 = i.future().then([](int value) { return value + 2; });
+        i.reportResult(0);
+        i.reportFinished();
+        QCOMPARE(f1.result(), 1);
+        QCOMPARE(f2.result(), 2);
+    }
+
+    // cancellation is propagated and the continuation doesn't run
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        bool called = false;
+        QFuture<int> f = i.future().then([&](int value) { called = true; return value; });
+        i.future().cancel();
+        i.reportFinished();
+        QVERIFY(!called);
+        QVERIFY(f.isFinished());
+        QVERIFY(f.isCanceled());
+    }
+
+    // canceling the continuation's future keeps it from running
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        bool called = false;
+        QFuture<int> f = i.future().then([&](int value) { called = true; return value; });
+        f.cancel();
+        i.reportResult(0);
+        i.reportFinished();
+        QVERIFY(!called);
+        QVERIFY(f.isFinished());
+    }
+}
+
+void tst_QFuture::thenOnThreadPool()
+{
+    QThreadPool pool;
+    QFutureInterface<int> i;
+    i.reportStarted();
+    QThread *thread = Q_NULLPTR;
+    QFuture<int> f = i.future().then(&pool, [&](int value) {
+        thread = QThread::currentThread();
+        return value + 1;
+    });
+    i.reportResult(1);
+    i.reportFinished();
+
+    QCOMPARE(f.result(), 2);
+    QVERIFY(thread);
+    QVERIFY(thread != QThread::currentThread());
+    QVERIFY(pool.waitForDone(10000));
+}
+
+void tst_QFuture::thenOnContext()
+{
+    QObject context;
+    QThreadPool pool;
+    QThread *thread = Q_NULLPTR;
+    QFutureInterface<int> i;
+    i.reportStarted();
+    QFuture<void> f = i.future()
+        .then(&pool, [](int value) { return value * 2; })
+        .then(&context, [&](int value) {
+            thread = QThread::currentThread();
+            QCOMPARE(value, 42);
+        });
+    i.reportResult(21);
+    i.reportFinished();
+
+    QTRY_VERIFY(f.isFinished());
+    QVERIFY(!f.isCanceled());
+    QCOMPARE(thread, QThread::currentThread());
+
+    // the continuation is canceled when the context is destroyed first
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        bool called = false;
+        QFuture<void> f;
+        {
+            QObject context;
+            f = i.future().then(&context, [&](int) { called = true; });
+        }
+        i.reportResult(0);
+        i.reportFinished();
+        QVERIFY(f.isFinished());
+        QVERIFY(f.isCanceled());
+        QCoreApplication::processEvents();
+        QVERIFY(!called);
+    }
+    QVERIFY(pool.waitForDone(10000));
+}
+
+void tst_QFuture::thenAbandoned()
+{
+    QFuture<int> f;
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        f = i.future().then([](int value) { return value; });
+    }
+    QVERIFY(f.isFinished());
+    QVERIFY(f.isCanceled());
+}
+
+#ifndef QT_NO_EXCEPTIONS
+void tst_QFuture::thenExceptions()
+{
+    // an exception thrown by the parent skips the continuation
+    {
+        bool called = false;
+        QFuture<void> f = createDerivedExceptionFuture().then([&]() { called = true; });
+        QVERIFY(!called);
+        bool caught = false;
+        try {
+            f.waitForFinished();
+        } catch (DerivedException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+
+    // an exception thrown by the continuation
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        QFuture<int> f = i.future()
+                .then([](int) -> int { throw DerivedException(); })
+                .then([](int value) { return value; });
+        i.reportResult(0);
+        i.reportFinished();
+        bool caught = false;
+        try {
+            f.waitForFinished();
+        } catch (DerivedException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+
+    // a non-QException is reported as QUnhandledException
+    {
+        QFutureInterface<int> i;
+        i.reportStarted();
+        QFuture<void> f = i.future().then([](int) { throw 1; });
+        i.reportResult(0);
+        i.reportFinished();
+        bool caught = false;
+        try {
+            f.waitForFinished();
+        } catch (QUnhandledException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+}
+
+void tst_QFuture::onFailed()
+{
+    // the handler replaces the result of a failed future
+    {
+        bool derived = false;
+        QFuture<int> f = createExceptionResultFuture()
+                .then([](int value) { return value + 1; })
+                .onFailed([&](const QException &e) {
+                    derived = dynamic_cast<const DerivedException *>(&e);
+                    return -1;
+                });
+        QVERIFY(f.isFinished());
+        QVERIFY(!f.isCanceled());
+        QCOMPARE(f.result(), -1);
+        QVERIFY(!derived);
+    }
+    {
+        bool derived = false;
+        QFuture<void> f = createDerivedExceptionFuture().onFailed([&](const QException &e) {
+            derived = dynamic_cast<const DerivedException *>(&e);
+        });
+        f.waitForFinished();
+        QVERIFY(derived);
+    }
+
+    // the result goes through when there is no failure
+    {
+        bool called = false;
+        QFutureInterface<int> i;
+        i.reportStarted();
+        QFuture<int> f = i.future().onFailed([&](const QException &) { called = true; return -1; });
+        i.reportResult(7);
+        i.reportFinished();
+        QCOMPARE(f.result(), 7);
+        QVERIFY(!called);
+    }
+
+    // cancellation is not a failure
+    {
+        bool called = false;
+        QFutureInterface<int> i;
+        i.reportStarted();
+        QFuture<int> f = i.future().onFailed([&](const QException &) { called = true; return -1; });
+        i.reportCanceled();
+        i.reportFinished();
+        QVERIFY(f.isCanceled());
+        QVERIFY(!called);
+    }
+}
+#endif // QT_NO_EXCEPTIONS
+
+void tst_QFuture::whenAll()
+{
+    QFutureInterface<int> i1, i2;
+    i1.reportStarted();
+    i2.reportStarted();
+    QList<QFuture<int> > futures;
+    futures << i1.future() << i2.future();
+
+    QFuture<QList<QFuture<int> > > all = QtFuture::whenAll(futures);
+    QVERIFY(!all.isFinished());
+    i2.reportResult(2);
+    i2.reportFinished();
+    QVERIFY(!all.isFinished());
+    i1.reportCanceled();
+    i1.reportFinished();
+    QVERIFY(all.isFinished());
+
+    const QList<QFuture<int> > results = all.result();
+    QCOMPARE(results.size(), 2);
+    QVERIFY(results.at(0).isCanceled());
+    QCOMPARE(results.at(1).result(), 2);
+
+    QFuture<QList<QFuture<int> > > none = QtFuture::whenAll(QList<QFuture<int> >());
+    QVERIFY(none.isFinished());
+    QVERIFY(none.result().isEmpty());
+
+    // whenAll() does not keep its futures alive, an abandoned one counts as canceled
+    {
+        QFuture<QList<QFuture<int> > > all;
+        {
+            QFutureInterface<int> i;
+            i.reportStarted();
+            all = QtFuture::whenAll(QList<QFuture<int> >() << i.future());
+        }
+        QVERIFY(all.isFinished());
+        QVERIFY(all.result().at(0).isCanceled());
+    }
+
+    // from several threads
+    QThreadPool pool;
+    QList<QFuture<int> > tasks;
+    for (int i = 0; i < 10; ++i)
+        tasks << createFinishedFuture().then(&pool, [i]() { QThread::msleep(10); return i; });
+    QFuture<int> sum = QtFuture::whenAll(tasks).then([](const QList<QFuture<int> > &tasks) {
+        int sum = 0;
+        for (const QFuture<int> &task : tasks)
+            sum += task.result();
+        return sum;
+    });
+    QCOMPARE(sum.result(), 45);
+    QVERIFY(pool.waitForDone(10000));
+}
+
+void tst_QFuture::whenAny()
+{
+    QFutureInterface<int> i1, i2;
+    i1.reportStarted();
+    i2.reportStarted();
+    QList<QFuture<int> > futures;
+    futures << i1.future() << i2.future();
+
+    QFuture<QtFuture::WhenAnyResult<int> > any = QtFuture::whenAny(futures);
+    QVERIFY(!any.isFinished());
+    i2.reportResult(2);
+    i2.reportFinished();
+    QVERIFY(any.isFinished());
+    QCOMPARE(any.result().index, 1);
+    QCOMPARE(any.result().future.result(), 2);
+
+    i1.reportResult(1);
+    i1.reportFinished();
+    QCOMPARE(any.result().index, 1);
+
+    QFuture<QtFuture::WhenAnyResult<int> > none = QtFuture::whenAny(QList<QFuture<int> >());
+    QVERIFY(none.isFinished());
+    QCOMPARE(none.result().index, -1);
+
+    {
+        QFuture<QtFuture::WhenAnyResult<int> > any;
+        {
+            QFutureInterface<int> i;
+            i.reportStarted();
+            any = QtFuture::whenAny(QList<QFuture<int> >() << i.future());
+        }
+        QVERIFY(any.isFinished());
+        QCOMPARE(any.result().index, 0);
+        QVERIFY(any.result().future.isCanceled());
+    }
+}
+
 QTEST_MAIN(tst_QFuture)
 #include "tst_qfuture.moc"
@@ -91,6 +91,9 @@ private slots:
     void cancel();
     void waitForDoneTimeout();
     void destroyingWaitsForTasksToFinish();
+    void workStealing();
+    void workStealingClear();
+    void workStealingCancel();
     void stressTest();
 
 private:
@@ -824,9 +827,13 @@ void tst_QThreadPool::tryStartCount()
 void tst_QThreadPool::priorityStart_data()
 {
     QTest::addColumn<int>("otherCount");
-    QTest::newRow("0") << 0;
-    QTest::newRow("1") << 1;
-    QTest::newRow("2") << 2;
+    QTest::addColumn<bool>("workStealing");
+    QTest::newRow("0") << 0 << false;
+    QTest::newRow("1") << 1 << false;
+    QTest::newRow("2") << 2 << false;
+    QTest::newRow("0-workstealing") << 0 << true;
+    QTest::newRow("1-workstealing") << 1 << true;
+    QTest::newRow("2-workstealing") << 2 << true;
 }
 
 void tst_QThreadPool::priorityStart()
@@ -853,11 +860,13 @@ void tst_QThreadPool::priorityStart()
     };
 
     QFETCH(int, otherCount);
+    QFETCH(bool, workStealing);
     QSemaphore sem;
     QAtomicPointer<QRunnable> firstStarted;
     QRunnable *expected;
     QThreadPool threadPool;
     threadPool.setMaxThreadCount(1); // start only one thread at a time
+    threadPool.setWorkStealingEnabled(workStealing);
 
     // queue the holder first
     // We need to be sure that all threads are active when we
@@ -1037,6 +1046,110 @@ void tst_QThreadPool::destroyingWaitsForTasksToFinish()
     }
 }
 
+void tst_QThreadPool::workStealing()
+{
+    class SpawningRunnable : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        int children;
+        SpawningRunnable(QThreadPool *pool, int children) : pool(pool), children(children) {}
+        void run()
+        {
+            count.ref();
+            // started from a pool thread, so these go to its local queue
+            for (int i = 0; i < children; ++i)
+                pool->start(new SpawningRunnable(pool, 0));
+        }
+    };
+
+    QThreadPool threadPool;
+    QVERIFY(!threadPool.isWorkStealingEnabled());
+    threadPool.setWorkStealingEnabled(true);
+    QVERIFY(threadPool.isWorkStealingEnabled());
+
+    for (int pass = 0; pass < 10; ++pass) {
+        count.store(0);
+        // more than fit into the injection queue at once
+        const int parents = 5000;
+        const int children = 10;
+        for (int i = 0; i < parents; ++i)
+            threadPool.start(new SpawningRunnable(&threadPool, children));
+        QVERIFY(threadPool.waitForDone());
+        QCOMPARE(count.load(), parents * (children + 1));
+    }
+}
+
+void tst_QThreadPool::workStealingClear()
+{
+    QSemaphore sem(0);
+    class BlockingRunnable : public QRunnable
+    {
+        public:
+            QSemaphore & sem;
+            BlockingRunnable(QSemaphore & sem) : sem(sem){}
+            void run()
+            {
+                sem.acquire();
+                count.ref();
+            }
+    };
+
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(true);
+    threadPool.setMaxThreadCount(4);
+    count.store(0);
+    // block all threads, then queue more than they can take
+    for (int i = 0; i < threadPool.maxThreadCount(); ++i)
+        threadPool.start(new BlockingRunnable(sem), 1);
+    for (int i = 0; i < 100; ++i)
+        threadPool.start(new BlockingRunnable(sem));
+    threadPool.clear();
+    sem.release(threadPool.maxThreadCount());
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(count.load(), threadPool.maxThreadCount());
+}
+
+void tst_QThreadPool::workStealingCancel()
+{
+    class ChildRunnable : public QRunnable
+    {
+    public:
+        void run() { count.ref(); }
+    };
+    class ParentRunnable : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        bool cancelled;
+        ParentRunnable(QThreadPool *pool) : pool(pool), cancelled(false) { setAutoDelete(false); }
+        void run()
+        {
+            // the only pool thread is busy running this, so the children
+            // stay in its work deque until it returns
+            QRunnable *children[3];
+            for (QRunnable *&child : children) {
+                child = new ChildRunnable;
+                pool->start(child);
+            }
+            // deleting the cancelled child must not leave a dangling
+            // pointer in the deque
+            pool->cancel(children[1]);
+            cancelled = true;
+        }
+    };
+
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(true);
+    threadPool.setMaxThreadCount(1);
+    count.store(0);
+    ParentRunnable parent(&threadPool);
+    threadPool.start(&parent);
+    QVERIFY(threadPool.waitForDone());
+    QVERIFY(parent.cancelled);
+    QCOMPARE(count.load(), 2);
+}
+
 void tst_QThreadPool::stressTest()
 {
     class Task : public QRunnable
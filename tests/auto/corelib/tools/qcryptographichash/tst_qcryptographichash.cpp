@@ -39,9 +39,12 @@ private slots:
     void intermediary_result_data();
     void intermediary_result();
     void sha1();
+    void sha256();
     void sha3();
     void files_data();
     void files();
+    void hashMany_data();
+    void hashMany();
 };
 
 void tst_QCryptographicHash::repeated_result_data()
@@ -172,6 +175,33 @@ void tst_QCryptographicHash::sha1()
              QByteArray("34AA973CD4C4DAA4F61EEB2BDBAD27316534016F"));
 }
 
+void tst_QCryptographicHash::sha256()
+{
+//  SHA256("abc") =
+//      BA7816BF 8F01CFEA 414140DE 5DAE2223 B00361A3 96177A9C B410FF61 F20015AD
+    QCOMPARE(QCryptographicHash::hash("abc", QCryptographicHash::Sha256).toHex().toUpper(),
+             QByteArray("BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD"));
+
+//  SHA256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") =
+//      248D6A61 D20638B8 E5C02693 0C3E6039 A33CE459 64FF2167 F6ECEDD4 19DB06C1
+    QCOMPARE(QCryptographicHash::hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+                                      QCryptographicHash::Sha256).toHex().toUpper(),
+             QByteArray("248D6A61D20638B8E5C026930C3E6039A33CE45964FF2167F6ECEDD419DB06C1"));
+
+//  SHA256(A million repetitions of "a") =
+//      CDC76E5C 9914FB92 81A1C7E2 84D73E67 F1809A48 A497200E 046D39CC C7112CD0
+    QByteArray as(1000000, 'a');
+    QCOMPARE(QCryptographicHash::hash(as, QCryptographicHash::Sha256).toHex().toUpper(),
+             QByteArray("CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0"));
+
+    // same, fed in pieces that straddle the block boundaries
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    for (int i = 0, step = 1; i < as.size(); i += step, step = step % 97 + 1)
+        hash.addData(as.constData() + i, qMin(step, as.size() - i));
+    QCOMPARE(hash.result().toHex().toUpper(),
+             QByteArray("CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0"));
+}
+
 void tst_QCryptographicHash::sha3()
 {
     // SHA3-224("The quick brown fox jumps over the lazy dog")
@@ -253,6 +283,41 @@ void tst_QCryptographicHash::files()
     }
 }
 
+void tst_QCryptographicHash::hashMany_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+
+    const QMetaEnum algorithms = QMetaEnum::fromType<QCryptographicHash::Algorithm>();
+    for (int i = 0; i < algorithms.keyCount(); ++i)
+        QTest::newRow(algorithms.key(i)) << QCryptographicHash::Algorithm(algorithms.value(i));
+}
+
+void tst_QCryptographicHash::hashMany()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+
+    QCOMPARE(QCryptographicHash::hashMany(QVector<QByteArray>(), algorithm), QVector<QByteArray>());
+
+    // lengths around the block sizes of all algorithms, in an order that
+    // keeps the lanes of a parallel implementation out of step
+    QVector<QByteArray> data;
+    for (int i = 0; i < 80; ++i) {
+        const int length = (i * 37) % 300;
+        QByteArray message(length, Qt::Uninitialized);
+        for (int j = 0; j < length; ++j)
+            message[j] = char(i * 7 + j * 13);
+        data.append(message);
+    }
+    data.append(QByteArray(5000, 'x'));
+
+    const QVector<QByteArray> hashes = QCryptographicHash::hashMany(data, algorithm);
+    QCOMPARE(hashes.size(), data.size());
+    for (int i = 0; i < data.size(); ++i)
+        QCOMPARE(hashes.at(i), QCryptographicHash::hash(data.at(i), algorithm));
+
+    const QVector<QByteArray> single = QCryptographicHash::hashMany(QVector<QByteArray>() << data.last(), algorithm);
+    QCOMPARE(single, QVector<QByteArray>() << hashes.last());
+}
 
 QTEST_MAIN(tst_QCryptographicHash)
 #include "tst_qcryptographichash.moc"
@@ -2166,6 +2166,23 @@ void tst_QDateTime::fromStringDateFormat_data()
     QTest::newRow("ISO .99999 of a minute (comma)") << QString::fromLatin1("2012-01-01T08:00,99999")
         << Qt::ISODate << QDateTime(QDate(2012, 1, 1), QTime(8, 0, 59, 999), Qt::LocalTime);
     QTest::newRow("ISO empty") << QString::fromLatin1("") << Qt::ISODate << invalidDateTime();
+    // Test the fully specified forms common in logs and RFC 3339.
+    QTest::newRow("ISO space separator") << QString::fromLatin1("2012-01-01 08:00:00")
+        << Qt::ISODate << QDateTime(QDate(2012, 1, 1), QTime(8, 0, 0, 0), Qt::LocalTime);
+    QTest::newRow("ISO long fraction Z") << QString::fromLatin1("2012-01-01T08:00:00.1234567Z")
+        << Qt::ISODate << QDateTime(QDate(2012, 1, 1), QTime(8, 0, 0, 123), Qt::UTC);
+    QTest::newRow("ISO fraction +02:00") << QString::fromLatin1("2012-01-01T08:00:00.5+02:00")
+        << Qt::ISODate << QDateTime(QDate(2012, 1, 1), QTime(6, 0, 0, 500), Qt::UTC);
+    QTest::newRow("ISO -05:30") << QString::fromLatin1("2012-01-01T08:00:00-05:30")
+        << Qt::ISODate << QDateTime(QDate(2012, 1, 1), QTime(13, 30, 0, 0), Qt::UTC);
+    QTest::newRow("ISO 24:00 Z") << QString::fromLatin1("2012-12-31T24:00:00Z")
+        << Qt::ISODate << QDateTime(QDate(2013, 1, 1), QTime(0, 0, 0, 0), Qt::UTC);
+    QTest::newRow("ISO 24:00:01 Z") << QString::fromLatin1("2012-12-31T24:00:01Z")
+        << Qt::ISODate << invalidDateTime();
+    QTest::newRow("ISO bad month Z") << QString::fromLatin1("2012-13-01T08:00:00Z")
+        << Qt::ISODate << invalidDateTime();
+    QTest::newRow("ISO bad offset minutes") << QString::fromLatin1("2012-01-01T08:00:00+02:60")
+        << Qt::ISODate << invalidDateTime();
 
     // Test Qt::RFC2822Date format (RFC 2822).
     QTest::newRow("RFC 2822 +0100") << QString::fromLatin1("13 Feb 1987 13:24:51 +0100")
@@ -0,0 +1,392 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qflathash.h>
+
+#include <unordered_map>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertAndLookup();
+    void operatorBracket();
+    void remove();
+    void take();
+    void eraseWhileIterating();
+    void implicitSharing();
+    void reserveAndSqueeze();
+    void iterators();
+    void equality();
+    void keysAndValues();
+    void complexType();
+    void randomOperations();
+    void flatSet();
+};
+
+void tst_QFlatHash::insertAndLookup()
+{
+    QFlatHash<int, QString> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.value(1), QString());
+    QCOMPARE(hash.value(1, QStringLiteral("default")), QStringLiteral("default"));
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, QString::number(i));
+    QCOMPARE(hash.size(), 1000);
+    QVERIFY(hash.capacity() >= 1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.count(i), 1);
+        QCOMPARE(hash.value(i), QString::number(i));
+    }
+    QVERIFY(!hash.contains(1000));
+    QVERIFY(!hash.contains(-1));
+
+    // inserting an existing key replaces its value
+    QFlatHash<int, QString>::iterator it = hash.insert(500, QStringLiteral("five hundred"));
+    QCOMPARE(it.key(), 500);
+    QCOMPARE(it.value(), QStringLiteral("five hundred"));
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.value(500), QStringLiteral("five hundred"));
+
+    QCOMPARE(hash.find(42).value(), QStringLiteral("42"));
+    QVERIFY(hash.find(4242) == hash.end());
+    QVERIFY(hash.constFind(4242) == hash.constEnd());
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QFlatHash<int, QString> list{{1, QStringLiteral("one")}, {2, QStringLiteral("two")}};
+    QCOMPARE(list.size(), 2);
+    QCOMPARE(list.value(2), QStringLiteral("two"));
+#endif
+}
+
+void tst_QFlatHash::operatorBracket()
+{
+    QFlatHash<QString, int> hash;
+    hash[QStringLiteral("a")] = 1;
+    ++hash[QStringLiteral("a")];
+    ++hash[QStringLiteral("b")];
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(QStringLiteral("a")), 2);
+    QCOMPARE(hash.value(QStringLiteral("b")), 1);
+
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash[QStringLiteral("c")], 0);
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    QCOMPARE(hash.remove(1), 0);
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+
+    for (int i = 0; i < 100; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.remove(0), 0);
+    QCOMPARE(hash.size(), 50);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), i % 2 == 1);
+
+    // slots freed by remove() are reused without growing
+    const int capacity = hash.capacity();
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 100; i += 2)
+            hash.insert(1000 * round + i, i);
+        for (int i = 0; i < 100; i += 2)
+            hash.remove(1000 * round + i);
+    }
+    QCOMPARE(hash.size(), 50);
+    QCOMPARE(hash.capacity(), capacity);
+}
+
+void tst_QFlatHash::take()
+{
+    QFlatHash<int, QString> hash;
+    QCOMPARE(hash.take(1), QString());
+    hash.insert(1, QStringLiteral("one"));
+    hash.insert(2, QStringLiteral("two"));
+    QCOMPARE(hash.take(1), QStringLiteral("one"));
+    QCOMPARE(hash.take(1), QString());
+    QCOMPARE(hash.size(), 1);
+}
+
+void tst_QFlatHash::eraseWhileIterating()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+
+    QFlatHash<int, int>::iterator it = hash.begin();
+    int visited = 0;
+    while (it != hash.end()) {
+        ++visited;
+        if (it.key() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(visited, 1000);
+    QCOMPARE(hash.size(), 666);
+    for (QFlatHash<int, int>::const_iterator cit = hash.constBegin(); cit != hash.constEnd(); ++cit)
+        QVERIFY(cit.key() % 3 != 0);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QStringLiteral("one"));
+
+    QFlatHash<int, QString> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(!hash.isDetached());
+
+    copy.insert(2, QStringLiteral("two"));
+    QVERIFY(!copy.isSharedWith(hash));
+    QVERIFY(hash.isDetached());
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(copy.size(), 2);
+
+    // erasing through an iterator of a shared hash detaches first
+    QFlatHash<int, QString> other = copy;
+    QFlatHash<int, QString>::const_iterator it = other.constFind(2);
+    other.erase(it);
+    QCOMPARE(other.size(), 1);
+    QCOMPARE(copy.size(), 2);
+
+    QFlatHash<int, QString> moved = std::move(copy);
+    QCOMPARE(moved.size(), 2);
+    QVERIFY(copy.isEmpty());
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity >= 1000);
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QCOMPARE(hash.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+
+    hash.clear();
+    hash.squeeze();
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.begin() == hash.end());
+    QVERIFY(hash.constBegin() == hash.constEnd());
+
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i * 2);
+
+    int sum = 0;
+    for (int value : qAsConst(hash))
+        sum += value;
+    QCOMPARE(sum, 99 * 100);
+
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        *it += 1;
+    QCOMPARE(hash.value(10), 21);
+
+    // backwards from the end visits the same entries
+    int count = 0;
+    QFlatHash<int, int>::const_iterator it = hash.constEnd();
+    while (it != hash.constBegin()) {
+        --it;
+        QCOMPARE(it.value(), it.key() * 2 + 1);
+        ++count;
+    }
+    QCOMPARE(count, 100);
+
+    QSet<int> keys;
+    for (QFlatHash<int, int>::key_iterator kit = hash.keyBegin(); kit != hash.keyEnd(); ++kit)
+        keys.insert(*kit);
+    QCOMPARE(keys.size(), 100);
+}
+
+void tst_QFlatHash::equality()
+{
+    QFlatHash<int, int> a;
+    QFlatHash<int, int> b;
+    QVERIFY(a == b);
+
+    // different insertion orders and capacities
+    for (int i = 0; i < 100; ++i)
+        a.insert(i, i);
+    b.reserve(1000);
+    for (int i = 99; i >= 0; --i)
+        b.insert(i, i);
+    QVERIFY(a == b);
+
+    b.insert(50, 0);
+    QVERIFY(a != b);
+    b.insert(50, 50);
+    b.insert(100, 100);
+    QVERIFY(a != b);
+}
+
+void tst_QFlatHash::keysAndValues()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QStringLiteral("odd"));
+    hash.insert(2, QStringLiteral("even"));
+    hash.insert(3, QStringLiteral("odd"));
+
+    QList<int> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys, QList<int>() << 1 << 2 << 3);
+
+    keys = hash.keys(QStringLiteral("odd"));
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys, QList<int>() << 1 << 3);
+
+    QCOMPARE(hash.values().count(QStringLiteral("odd")), 2);
+    QCOMPARE(hash.key(QStringLiteral("even")), 2);
+    QCOMPARE(hash.key(QStringLiteral("none"), -1), -1);
+}
+
+class Counted
+{
+public:
+    Counted(int value = 0) : value(value) { ++count; }
+    Counted(const Counted &other) : value(other.value) { ++count; }
+    ~Counted() { --count; }
+    Counted &operator=(const Counted &other) { value = other.value; return *this; }
+    bool operator==(const Counted &other) const { return value == other.value; }
+
+    int value;
+    static int count;
+};
+int Counted::count = 0;
+
+void tst_QFlatHash::complexType()
+{
+    {
+        QFlatHash<int, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(i, Counted(i));
+        QCOMPARE(Counted::count, 1000);
+
+        QFlatHash<int, Counted> copy = hash;
+        copy.insert(1000, Counted(1000));
+        QCOMPARE(Counted::count, 2001);
+
+        for (int i = 0; i < 500; ++i)
+            hash.remove(i);
+        QCOMPARE(Counted::count, 1501);
+        hash.squeeze();
+        QCOMPARE(Counted::count, 1501);
+        QCOMPARE(hash.value(700).value, 700);
+    }
+    QCOMPARE(Counted::count, 0);
+}
+
+void tst_QFlatHash::randomOperations()
+{
+    QFlatHash<int, int> hash;
+    std::unordered_map<int, int> reference;
+    uint seed = 1;
+    for (int i = 0; i < 100000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const int key = int((seed >> 8) % 2000);
+        switch ((seed >> 4) % 4) {
+        case 0:
+        case 1:
+            hash.insert(key, i);
+            reference[key] = i;
+            break;
+        case 2:
+            QCOMPARE(hash.remove(key), int(reference.erase(key)));
+            break;
+        case 3:
+            QCOMPARE(hash.contains(key), reference.count(key) != 0);
+            break;
+        }
+        QCOMPARE(hash.size(), int(reference.size()));
+    }
+
+    int count = 0;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it, ++count)
+        QCOMPARE(it.value(), reference[it.key()]);
+    QCOMPARE(count, hash.size());
+}
+
+void tst_QFlatHash::flatSet()
+{
+    QFlatSet<QString> set;
+    QVERIFY(set.isEmpty());
+    set << QStringLiteral("a") << QStringLiteral("b") << QStringLiteral("a");
+    set.insert(QStringLiteral("c"));
+    QCOMPARE(set.size(), 3);
+    QVERIFY(set.contains(QStringLiteral("b")));
+    QVERIFY(set.remove(QStringLiteral("b")));
+    QVERIFY(!set.remove(QStringLiteral("b")));
+    QVERIFY(!set.contains(QStringLiteral("b")));
+
+    QStringList values = set.values();
+    values.sort();
+    QCOMPARE(values, QStringList() << QStringLiteral("a") << QStringLiteral("c"));
+
+    QFlatSet<QString> copy = set;
+    QVERIFY(copy == set);
+    copy.erase(copy.constFind(QStringLiteral("a")));
+    QVERIFY(copy != set);
+    QCOMPARE(*copy.constBegin(), QStringLiteral("c"));
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QFlatSet<int> list{1, 2, 3, 2};
+    QCOMPARE(list.size(), 3);
+#endif
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
@@ -92,6 +92,7 @@ private slots:
     void testInfAndNan();
     void fpExceptions();
     void negativeZero();
+    void cLocaleFastPath();
     void dayOfWeek();
     void dayOfWeek_data();
     void formatDate();
@@ -1091,6 +1092,79 @@ void tst_QLocale::negativeZero()
     QCOMPARE(s, QString("0"));
 }
 
+void tst_QLocale::cLocaleFastPath()
+{
+    // Locales with the number symbols of C take a shortcut when formatting
+    // and parsing; German goes through the generic code and must agree.
+    QLocale c = QLocale::c();
+    c.setNumberOptions(QLocale::OmitGroupSeparator);
+    QLocale german(QLocale::German, QLocale::Germany);
+    german.setNumberOptions(QLocale::OmitGroupSeparator);
+
+    const double values[] = {
+        0.0, -0.0, 1.0, -1.5, 0.1, 0.5, 9.5, 99.95, 1e-5, 0.000123, -123456.789, 100.0,
+        1e15, 1e21, 1e22, 12345678901234567.0, 1.7976931348623157e308, 4.9e-324,
+        qInf(), -qInf(), qQNaN()
+    };
+    const char formats[] = { 'e', 'E', 'f', 'g', 'G' };
+    const int precisions[] = { QLocale::FloatingPointShortest, 0, 1, 3, 6, 17, 30 };
+
+    for (double value : values) {
+        for (char format : formats) {
+            for (int precision : precisions) {
+                const QString actual = c.toString(value, format, precision);
+                QString expected = german.toString(value, format, precision);
+                expected.replace(QLatin1Char(','), QLatin1Char('.'));
+                QVERIFY2(actual.compare(expected, Qt::CaseInsensitive) == 0,
+                         qPrintable(actual + QLatin1String(" != ") + expected));
+                QCOMPARE(QByteArray::number(value, format, precision), actual.toLatin1());
+
+                if (qIsFinite(value)) {
+                    bool ok = false;
+                    bool germanOk = false;
+                    const double parsed = c.toDouble(actual, &ok);
+                    const double germanParsed =
+                            german.toDouble(german.toString(value, format, precision), &germanOk);
+                    QCOMPARE(ok, germanOk);
+                    if (ok)
+                        QCOMPARE(parsed, germanParsed);
+                }
+            }
+        }
+
+        if (qIsFinite(value)) {
+            bool ok = false;
+            const QString shortest = QString::number(value, 'g', QLocale::FloatingPointShortest);
+            QCOMPARE(shortest.toDouble(&ok), value);
+            QVERIFY(ok);
+            QCOMPARE(QStringRef(&shortest).toDouble(&ok), value);
+            QVERIFY(ok);
+        }
+    }
+
+    // printf-style flags
+    QCOMPARE(QString::asprintf("%#.3g", 1.0), QString("1.00"));
+    QCOMPARE(QString::asprintf("%#.0f", 1.0), QString("1."));
+    QCOMPARE(QString::asprintf("%#.0e", 2.0), QString("2.e+00"));
+    QCOMPARE(QString::asprintf("%+.2e", 12.5), QString("+1.25e+01"));
+    QCOMPARE(QString::asprintf("% g", 1.0), QString(" 1"));
+    QCOMPARE(QString::asprintf("%G", 1e-10), QString("1E-10"));
+    QCOMPARE(QString::asprintf("%08.2f", -1.5), QString("-0001.50"));
+
+    // parsing falls back to the generic code for anything but plain ASCII numbers
+    bool ok = false;
+    QCOMPARE(c.toDouble(QString(" 1.5 "), &ok), 1.5);
+    QVERIFY(ok);
+    QCOMPARE(c.toDouble(QString("1.5.1"), &ok), 0.0);
+    QVERIFY(!ok);
+    QCOMPARE(c.toDouble(QString("1E3"), &ok), 1000.0);
+    QVERIFY(ok);
+    QCOMPARE(QLocale(QLocale::English).toDouble(QString("1,234.5"), &ok), 1234.5);
+    QVERIFY(ok);
+    QCOMPARE(c.toLongLong(QString("-42"), &ok), Q_INT64_C(-42));
+    QVERIFY(ok);
+}
+
 void tst_QLocale::dayOfWeek_data()
 {
     QTest::addColumn<QDate>("date");
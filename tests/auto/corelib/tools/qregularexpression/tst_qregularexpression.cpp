@@ -1112,6 +1112,172 @@ void tst_QRegularExpression::partialMatch()
                                        match);
 }
 
+static void testMatcher(const QRegularExpression &regexp,
+                        const QString &subject,
+                        int offset,
+                        QRegularExpression::MatchType matchType,
+                        QRegularExpression::MatchOptions matchOptions,
+                        const Match &result)
+{
+    if (forceOptimize)
+        regexp.optimize();
+
+    QRegularExpressionMatcher matcher(regexp);
+    QCOMPARE(matcher.regularExpression(), regexp);
+
+    // a QString subject, matched twice to check the buffers get reused
+    // properly, and the same subject in the middle of a larger string
+    const QString padded = QLatin1String("xyz") + subject + QLatin1String("zyx");
+    for (int i = 0; i < 3; ++i) {
+        bool matched;
+        if (i < 2)
+            matched = matcher.match(subject, offset, matchType, matchOptions);
+        else
+            matched = matcher.match(padded.midRef(3, subject.length()), offset, matchType, matchOptions);
+
+        const QRegularExpressionMatch expected = regexp.match(subject, offset, matchType, matchOptions);
+        QVERIFY(expected == result);
+        QCOMPARE(matched, expected.hasMatch());
+        QCOMPARE(matcher.isValid(), expected.isValid());
+        QCOMPARE(matcher.hasMatch(), expected.hasMatch());
+        QCOMPARE(matcher.hasPartialMatch(), expected.hasPartialMatch());
+        QCOMPARE(matcher.lastCapturedIndex(), expected.lastCapturedIndex());
+        for (int nth = -1; nth <= expected.lastCapturedIndex() + 1; ++nth) {
+            QCOMPARE(matcher.captured(nth), expected.captured(nth));
+            QCOMPARE(matcher.captured(nth).isNull(), expected.captured(nth).isNull());
+            QCOMPARE(matcher.capturedRef(nth), expected.capturedRef(nth));
+            QCOMPARE(matcher.capturedStart(nth), expected.capturedStart(nth));
+            QCOMPARE(matcher.capturedLength(nth), expected.capturedLength(nth));
+            QCOMPARE(matcher.capturedEnd(nth), expected.capturedEnd(nth));
+        }
+
+        // the other match types have been done by now
+        if (matcher.match(subject, offset, QRegularExpression::NoMatch, matchOptions))
+            QFAIL("NoMatch matched");
+        QCOMPARE(matcher.isValid(), expected.isValid());
+        QVERIFY(!matcher.hasPartialMatch());
+        QCOMPARE(matcher.lastCapturedIndex(), -1);
+    }
+}
+
+void tst_QRegularExpression::matcher_data()
+{
+    normalMatch_data();
+}
+
+void tst_QRegularExpression::matcher()
+{
+    QFETCH(QRegularExpression, regexp);
+    QFETCH(QString, subject);
+    QFETCH(int, offset);
+    QFETCH(QRegularExpression::MatchOptions, matchOptions);
+    QFETCH(Match, match);
+
+    testMatcher(regexp, subject, offset, QRegularExpression::NormalMatch, matchOptions, match);
+}
+
+void tst_QRegularExpression::matcherPartial_data()
+{
+    partialMatch_data();
+}
+
+void tst_QRegularExpression::matcherPartial()
+{
+    QFETCH(QRegularExpression, regexp);
+    QFETCH(QString, subject);
+    QFETCH(int, offset);
+    QFETCH(QRegularExpression::MatchType, matchType);
+    QFETCH(QRegularExpression::MatchOptions, matchOptions);
+    QFETCH(Match, match);
+
+    testMatcher(regexp, subject, offset, matchType, matchOptions, match);
+}
+
+void tst_QRegularExpression::regularExpressionSet_data()
+{
+    QTest::addColumn<QString>("subject");
+    QTest::addColumn<int>("offset");
+
+    QTest::newRow("empty") << QString() << 0;
+    QTest::newRow("plain") << QStringLiteral("the quick brown fox") << 0;
+    QTest::newRow("offset") << QStringLiteral("the quick brown fox") << 4;
+    QTest::newRow("negative-offset") << QStringLiteral("the quick brown fox") << -3;
+    QTest::newRow("out-of-range") << QStringLiteral("the quick brown fox") << 50;
+    QTest::newRow("error") << QStringLiteral("2016-10-17 ERROR timeout after 250ms user=jordan") << 0;
+    QTest::newRow("caseless") << QStringLiteral("Error: THE QUICK BROWN FOX") << 0;
+    QTest::newRow("kelvin") << (QStringLiteral("quic") + QChar(0x212a)) << 0;
+    QTest::newRow("latin1") << QStringLiteral("caf\u00e9 CAF\u00c9") << 0;
+    QTest::newRow("surrogates") << (QStringLiteral("fox ") + QChar(0xd83d) + QChar(0xde00)) << 0;
+    QTest::newRow("folded") << (QStringLiteral("fo") + QChar(0x178)) << 0;
+    QTest::newRow("invalid-utf16") << (QStringLiteral("quick fox ") + QChar(0xde00)) << 0;
+}
+
+void tst_QRegularExpression::regularExpressionSet()
+{
+    QFETCH(QString, subject);
+    QFETCH(int, offset);
+
+    const QList<QRegularExpression> regexps = QList<QRegularExpression>()
+            << QRegularExpression("quick")
+            << QRegularExpression("QUICK", QRegularExpression::CaseInsensitiveOption)
+            << QRegularExpression("(?i)error")
+            << QRegularExpression("ERROR")
+            << QRegularExpression("timeout after (\\d+)ms")
+            << QRegularExpression("user=(\\w+)$")
+            << QRegularExpression("^the")
+            << QRegularExpression("fox$")
+            << QRegularExpression("x|y")
+            << QRegularExpression("caf\u00e9")
+            << QRegularExpression("CAF\u00e9", QRegularExpression::CaseInsensitiveOption)
+            << QRegularExpression("fo\u00ff", QRegularExpression::CaseInsensitiveOption | QRegularExpression::UseUnicodePropertiesOption)
+            << QRegularExpression(QStringLiteral("\\x{1f600}"))
+            << QRegularExpression("(a)\\1?z*")
+            << QRegularExpression("");
+
+    QRegularExpressionSet set;
+    QVERIFY(set.isEmpty());
+    QVERIFY(set.isValid());
+    for (int i = 0; i < regexps.size(); ++i) {
+        QCOMPARE(set.add(regexps.at(i)), i);
+        QCOMPARE(set.at(i), regexps.at(i));
+    }
+    QCOMPARE(set.size(), regexps.size());
+    QVERIFY(set.isValid());
+
+    QVector<int> expected;
+    for (int i = 0; i < regexps.size(); ++i) {
+        if (regexps.at(i).match(subject, offset).hasMatch())
+            expected << i;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        QCOMPARE(set.match(subject, offset), expected);
+        const QString padded = QLatin1String("QUICK") + subject + QLatin1String("ERROR");
+        QCOMPARE(set.match(padded.midRef(5, subject.length()), offset), expected);
+    }
+
+    QStringList patterns;
+    for (const QRegularExpression &re : regexps)
+        patterns << re.pattern();
+    QRegularExpressionSet caseless(patterns, QRegularExpression::CaseInsensitiveOption);
+    expected.clear();
+    for (int i = 0; i < patterns.size(); ++i) {
+        if (QRegularExpression(patterns.at(i), QRegularExpression::CaseInsensitiveOption).match(subject, offset).hasMatch())
+            expected << i;
+    }
+    QCOMPARE(caseless.match(subject, offset), expected);
+
+    // an invalid pattern never matches
+    QCOMPARE(set.add(QRegularExpression("(")), regexps.size());
+    QVERIFY(!set.isValid());
+    QVERIFY(!set.match(subject, offset).contains(regexps.size()));
+
+    set.clear();
+    QVERIFY(set.isEmpty());
+    QVERIFY(set.isValid());
+    QVERIFY(set.match(subject, offset).isEmpty());
+}
+
 void tst_QRegularExpression::globalMatch_data()
 {
     QTest::addColumn<QRegularExpression>("regexp");
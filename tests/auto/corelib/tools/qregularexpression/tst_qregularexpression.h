@@ -68,6 +68,12 @@ private slots:
     void JOptionUsage_data();
     void JOptionUsage();
     void QStringAndQStringRefEquivalence();
+    void matcher_data();
+    void matcher();
+    void matcherPartial_data();
+    void matcherPartial();
+    void regularExpressionSet_data();
+    void regularExpressionSet();
 
 private:
     void provideRegularExpressions();
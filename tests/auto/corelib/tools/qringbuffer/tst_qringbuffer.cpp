@@ -51,6 +51,8 @@ private slots:
     void ungetChar();
     void indexOf();
     void appendAndRead();
+    void appendSharedAndWrite();
+    void readPointers();
     void peek();
     void readLine();
 };
@@ -348,6 +350,59 @@ void tst_QRingBuffer::appendAndRead()
     QCOMPARE(ringBuffer.read(), ba3);
 }
 
+void tst_QRingBuffer::appendSharedAndWrite()
+{
+    QRingBuffer ringBuffer;
+    QByteArray shared("Hello world!");
+    shared.reserve(100);
+    const QByteArray copy = shared;
+    ringBuffer.append(shared);
+    QVERIFY(ringBuffer.readPointer() == shared.constData());
+
+    // writing around an adopted block must leave the caller's array alone
+    ringBuffer.putChar('!');
+    ringBuffer.ungetChar('>');
+    ringBuffer.append("tail", 4);
+    QCOMPARE(shared, copy);
+    QVERIFY(shared.isSharedWith(copy));
+
+    QCOMPARE(ringBuffer.size(), qint64(1 + copy.size() + 1 + 4));
+    char buf[64];
+    QCOMPARE(ringBuffer.read(buf, sizeof(buf)), qint64(1 + copy.size() + 1 + 4));
+    QCOMPARE(QByteArray(buf, 1 + copy.size() + 1 + 4), ">" + copy + "!tail");
+    QCOMPARE(shared, copy);
+}
+
+void tst_QRingBuffer::readPointers()
+{
+    QRingBuffer ringBuffer;
+    const char *data[4];
+    qint64 lengths[4];
+    QCOMPARE(ringBuffer.blockCount(), 0);
+    QCOMPARE(ringBuffer.readPointers(data, lengths, 4, 100), 0);
+
+    const QByteArray ba1(5000, 'a');
+    const QByteArray ba2(6000, 'b');
+    ringBuffer.append(ba1);
+    ringBuffer.append(ba2);
+    memset(ringBuffer.reserve(10), 'c', 10);
+    ringBuffer.free(1000);
+    QCOMPARE(ringBuffer.blockCount(), 3);
+
+    QCOMPARE(ringBuffer.readPointers(data, lengths, 4, ringBuffer.size()), 3);
+    QVERIFY(data[0] == ba1.constData() + 1000);
+    QCOMPARE(lengths[0], qint64(4000));
+    QVERIFY(data[1] == ba2.constData());
+    QCOMPARE(lengths[1], qint64(6000));
+    QCOMPARE(QByteArray(data[2], lengths[2]), QByteArray(10, 'c'));
+
+    // limited by count and by length
+    QCOMPARE(ringBuffer.readPointers(data, lengths, 1, ringBuffer.size()), 1);
+    QCOMPARE(lengths[0], qint64(4000));
+    QCOMPARE(ringBuffer.readPointers(data, lengths, 4, 5000), 2);
+    QCOMPARE(lengths[1], qint64(1000));
+}
+
 void tst_QRingBuffer::peek()
 {
     QRingBuffer ringBuffer;
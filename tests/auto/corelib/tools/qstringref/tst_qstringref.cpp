@@ -87,6 +87,8 @@ private slots:
     void mid();
     void split_data();
     void split();
+    void tokenize_data();
+    void tokenize();
 };
 
 static QStringRef emptyRef()
@@ -2159,6 +2161,54 @@ void tst_QStringRef::split()
     }
 }
 
+void tst_QStringRef::tokenize_data()
+{
+    split_data();
+    QTest::newRow("multi-char") << "a::b::::c::" << "::" << (QStringList() << "a" << "b" << "" << "c" << "");
+    QTest::newRow("case") << "aXbxcXX" << "x" << (QStringList() << "aXb" << "cXX");
+    QTest::newRow("no-match") << "abc" << "xyz" << (QStringList() << "abc");
+}
+
+static QVector<QStringRef> iterate(const QStringTokenizer &tokenizer)
+{
+    QVector<QStringRef> result;
+    for (QStringTokenizer::const_iterator it = tokenizer.begin(); it != tokenizer.end(); it++)
+        result.append(*it);
+    return result;
+}
+
+void tst_QStringRef::tokenize()
+{
+    QFETCH(QString, str);
+    QFETCH(QString, sep);
+
+    QString source = str + str + str;
+    QStringRef ref = source.midRef(str.size(), str.size());
+    const QByteArray latin1 = sep.toLatin1();
+    const QLatin1String latin1Sep(latin1.constData(), latin1.size());
+
+    const QString::SplitBehavior behaviors[] = { QString::KeepEmptyParts, QString::SkipEmptyParts };
+    const Qt::CaseSensitivity sensitivities[] = { Qt::CaseSensitive, Qt::CaseInsensitive };
+    for (QString::SplitBehavior behavior : behaviors) {
+        for (Qt::CaseSensitivity cs : sensitivities) {
+            const QVector<QStringRef> expected = ref.split(sep, behavior, cs);
+
+            QCOMPARE(iterate(ref.tokenize(sep, behavior, cs)), expected);
+            QCOMPARE(iterate(ref.tokenize(latin1Sep, behavior, cs)), expected);
+            QCOMPARE(ref.tokenize(sep, behavior, cs).toVector(), expected);
+            if (sep.size() == 1)
+                QCOMPARE(iterate(ref.tokenize(sep.at(0), behavior, cs)), expected);
+
+            QCOMPARE(iterate(str.tokenize(sep, behavior, cs)), str.splitRef(sep, behavior, cs));
+
+            // the parts reference the original string, not a copy
+            const QStringTokenizer tokenizer = ref.tokenize(sep, behavior, cs);
+            for (const QStringRef &part : tokenizer)
+                QCOMPARE(part.string(), &source);
+        }
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_QStringRef)
 
 #include "tst_qstringref.moc"
@@ -46,6 +46,7 @@ private slots:
     void isTimeZoneIdAvailable();
     void availableTimeZoneIds();
     void stressTest();
+    void posixRuleTransitions();
     void windowsId();
     void isValidId_data();
     void isValidId();
@@ -388,6 +389,33 @@ void tst_QTimeZone::availableTimeZoneIds()
     }
 }
 
+void tst_QTimeZone::posixRuleTransitions()
+{
+    // Zone files only list transitions up to some year, the POSIX rule at
+    // their end covers later ones; check that offsets and transitions agree
+    // with each other both where the rule's transitions are precomputed and
+    // beyond.
+    const QTimeZone berlin("Europe/Berlin");
+    if (!berlin.isValid() || !berlin.hasTransitions())
+        QSKIP("Europe/Berlin with transitions is not available");
+
+    for (int year = 2000; year <= 2060; ++year) {
+        QCOMPARE(berlin.offsetFromUtc(QDateTime(QDate(year, 1, 15), QTime(12, 0), Qt::UTC)), 3600);
+        QCOMPARE(berlin.offsetFromUtc(QDateTime(QDate(year, 7, 15), QTime(12, 0), Qt::UTC)), 7200);
+
+        for (int month : {1, 7}) {
+            const QTimeZone::OffsetData tran =
+                    berlin.nextTransition(QDateTime(QDate(year, month, 1), QTime(0, 0), Qt::UTC));
+            if (!tran.atUtc.isValid())
+                continue;
+            QCOMPARE(tran.atUtc.date().year(), year);
+            QCOMPARE(berlin.offsetFromUtc(tran.atUtc), tran.offsetFromUtc);
+            QVERIFY(berlin.offsetFromUtc(tran.atUtc.addSecs(-1)) != tran.offsetFromUtc);
+            QCOMPARE(berlin.nextTransition(tran.atUtc.addSecs(-1)).atUtc, tran.atUtc);
+        }
+    }
+}
+
 void tst_QTimeZone::stressTest()
 {
     QList<QByteArray> idList = QTimeZone::availableTimeZoneIds();
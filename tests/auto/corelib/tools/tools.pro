@@ -19,6 +19,7 @@ SUBDIRS=\
     qdatetime \
     qeasingcurve \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
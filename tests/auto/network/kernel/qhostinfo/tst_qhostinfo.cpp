@@ -46,6 +46,7 @@
 #include <QTcpSocket>
 #include <private/qthread_p.h>
 #include <QTcpServer>
+#include <QUdpSocket>
 
 #ifndef QT_NO_BEARERMANAGEMENT
 #include <QtNetwork/qnetworkconfigmanager.h>
@@ -79,6 +80,206 @@
 
 #define TEST_DOMAIN ".test.macieira.org"
 
+// Answers A and AAAA queries for the names in \c records, over UDP and TCP
+class DnsStubServer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Record {
+        Record() : ttl(300), negativeTtl(-1), rcode(0), truncateOverUdp(false),
+            waitForBothFamilies(false), silent(false), garbageFirst(false) {}
+        QList<QHostAddress> addresses;
+        quint32 ttl;
+        int negativeTtl; // SOA minimum sent with negative answers, -1 for no SOA
+        int rcode;
+        bool truncateOverUdp;
+        bool waitForBothFamilies; // only reply once A and AAAA were both asked for
+        bool silent;
+        bool garbageFirst; // send a reply that doesn't parse right before the real one
+    };
+
+    DnsStubServer() : serverFailure(false), tcpQueries(0)
+    {
+        connect(&udp, SIGNAL(readyRead()), SLOT(readDatagrams()));
+        connect(&tcp, SIGNAL(newConnection()), SLOT(acceptConnection()));
+        if (udp.bind(QHostAddress(QHostAddress::LocalHost)))
+            tcp.listen(QHostAddress::LocalHost, udp.localPort());
+    }
+
+    bool isValid() const { return tcp.isListening(); }
+    QByteArray address() const { return "127.0.0.1:" + QByteArray::number(udp.localPort()); }
+
+    QHash<QByteArray, Record> records;
+    bool serverFailure;
+    QHash<QByteArray, int> queries; // per name
+    QSet<quint16> senderPorts; // of the UDP queries
+    int tcpQueries;
+
+private slots:
+    void readDatagrams()
+    {
+        while (udp.hasPendingDatagrams()) {
+            QByteArray datagram(int(udp.pendingDatagramSize()), Qt::Uninitialized);
+            QHostAddress sender;
+            quint16 port;
+            udp.readDatagram(datagram.data(), datagram.size(), &sender, &port);
+            senderPorts.insert(port);
+            QByteArray name;
+            quint16 type;
+            if (!parseQuery(datagram, &name, &type))
+                continue;
+            const Record record = records.value(name);
+            if (record.silent)
+                continue;
+            const QByteArray reply = buildReply(datagram, name, type, record.truncateOverUdp);
+            if (record.waitForBothFamilies) {
+                pending[name].append(qMakePair(reply, qMakePair(sender, port)));
+                if (pending.value(name).size() < 2)
+                    continue;
+                const auto replies = pending.take(name);
+                for (const auto &r : replies)
+                    udp.writeDatagram(r.first, r.second.first, r.second.second);
+            } else {
+                if (record.garbageFirst)
+                    udp.writeDatagram(reply.left(14), sender, port);
+                udp.writeDatagram(reply, sender, port);
+            }
+        }
+    }
+
+    void acceptConnection()
+    {
+        while (QTcpSocket *socket = tcp.nextPendingConnection()) {
+            connect(socket, &QIODevice::readyRead, this, [this, socket]() {
+                if (socket->bytesAvailable() < 2)
+                    return;
+                QByteArray length = socket->peek(2);
+                const int size = (uchar(length.at(0)) << 8) | uchar(length.at(1));
+                if (socket->bytesAvailable() < 2 + size)
+                    return;
+                socket->read(2);
+                const QByteArray query = socket->read(size);
+                QByteArray name;
+                quint16 type;
+                if (!parseQuery(query, &name, &type))
+                    return;
+                ++tcpQueries;
+                const QByteArray reply = buildReply(query, name, type, false);
+                length[0] = char(reply.size() >> 8);
+                length[1] = char(reply.size() & 0xff);
+                socket->write(length + reply);
+            });
+        }
+    }
+
+private:
+    bool parseQuery(const QByteArray &query, QByteArray *name, quint16 *type)
+    {
+        int pos = 12;
+        name->clear();
+        while (pos < query.size() && query.at(pos)) {
+            const int length = uchar(query.at(pos));
+            if (!name->isEmpty())
+                name->append('.');
+            name->append(query.mid(pos + 1, length));
+            pos += length + 1;
+        }
+        if (pos + 5 > query.size())
+            return false;
+        *type = (uchar(query.at(pos + 1)) << 8) | uchar(query.at(pos + 2));
+        ++queries[*name];
+        return true;
+    }
+
+    static void append16(QByteArray *data, quint16 value)
+    {
+        data->append(char(value >> 8));
+        data->append(char(value & 0xff));
+    }
+
+    static void append32(QByteArray *data, quint32 value)
+    {
+        append16(data, quint16(value >> 16));
+        append16(data, quint16(value & 0xffff));
+    }
+
+    QByteArray buildReply(const QByteArray &query, const QByteArray &name, quint16 type, bool truncate)
+    {
+        const bool known = records.contains(name);
+        const Record record = records.value(name);
+        int rcode = serverFailure ? 2 : known ? record.rcode : 3;
+
+        QList<QHostAddress> answers;
+        if (!truncate && rcode == 0) {
+            for (const QHostAddress &address : record.addresses) {
+                if ((address.protocol() == QAbstractSocket::IPv4Protocol) == (type == 1))
+                    answers.append(address);
+            }
+        }
+        const bool soa = !truncate && answers.isEmpty() && !serverFailure && record.negativeTtl >= 0;
+
+        QByteArray reply = query.left(2);
+        append16(&reply, 0x8180 | (truncate ? 0x0200 : 0) | rcode);
+        append16(&reply, 1);
+        append16(&reply, answers.size());
+        append16(&reply, soa ? 1 : 0);
+        append16(&reply, 0);
+        reply += query.mid(12, name.size() + 6);
+
+        for (const QHostAddress &address : qAsConst(answers)) {
+            append16(&reply, 0xc00c);
+            append16(&reply, type);
+            append16(&reply, 1);
+            append32(&reply, record.ttl);
+            if (type == 1) {
+                append16(&reply, 4);
+                append32(&reply, address.toIPv4Address());
+            } else {
+                append16(&reply, 16);
+                const Q_IPV6ADDR ipv6 = address.toIPv6Address();
+                reply.append(reinterpret_cast<const char *>(ipv6.c), 16);
+            }
+        }
+        if (soa) {
+            append16(&reply, 0xc00c);
+            append16(&reply, 6);
+            append16(&reply, 1);
+            append32(&reply, 3600);
+            append16(&reply, 22);
+            reply.append('\0'); // MNAME
+            reply.append('\0'); // RNAME
+            append32(&reply, 1); // SERIAL
+            append32(&reply, 3600); // REFRESH
+            append32(&reply, 600); // RETRY
+            append32(&reply, 86400); // EXPIRE
+            append32(&reply, record.negativeTtl); // MINIMUM
+        }
+        return reply;
+    }
+
+    QUdpSocket udp;
+    QTcpServer tcp;
+    QHash<QByteArray, QList<QPair<QByteArray, QPair<QHostAddress, quint16> > > > pending;
+};
+
+// Makes QHostInfo use the built-in resolver with the given nameservers
+class DnsStubResolverScope
+{
+public:
+    explicit DnsStubResolverScope(const QByteArray &nameservers)
+    {
+        qputenv("QT_HOSTINFO_RESOLVER", "dns");
+        qputenv("QT_HOSTINFO_NAMESERVERS", nameservers);
+        qt_qhostinfo_clear_cache();
+    }
+    ~DnsStubResolverScope()
+    {
+        qunsetenv("QT_HOSTINFO_RESOLVER");
+        qunsetenv("QT_HOSTINFO_NAMESERVERS");
+        qt_qhostinfo_clear_cache();
+    }
+};
+
 
 class tst_QHostInfo : public QObject
 {
@@ -110,6 +311,14 @@ private slots:
     void cache();
 
     void abortHostLookup();
+
+    void dnsResolverLookup();
+    void dnsResolverTimeToLive();
+    void dnsResolverNegativeCache();
+    void dnsResolverTcpFallback();
+    void dnsResolverInvalidReply();
+    void dnsResolverServerFailure();
+    void dnsResolverAbort();
 protected slots:
     void resultsReady(const QHostInfo &);
 
@@ -575,6 +784,228 @@ void tst_QHostInfo::abortHostLookup()
     QCOMPARE(lookupsDoneCounter, 0);
 }
 
+static QString sortedAddresses(const QHostInfo &info)
+{
+    QStringList tmp;
+    for (int i = 0; i < info.addresses().count(); ++i)
+        tmp.append(info.addresses().at(i).toString());
+    tmp.sort();
+    return tmp.join(' ');
+}
+
+void tst_QHostInfo::dnsResolverLookup()
+{
+    DnsStubServer server;
+    QVERIFY(server.isValid());
+    DnsStubServer::Record record;
+    record.addresses << QHostAddress("192.0.2.1") << QHostAddress("192.0.2.2")
+                     << QHostAddress("2001:db8::1");
+    // a lookup that sends the two queries one after the other times out
+    record.waitForBothFamilies = true;
+    server.records.insert("host.stub.test", record);
+    DnsStubResolverScope scope(server.address());
+
+    // the same name is only asked for once
+    lookupsDoneCounter = 0;
+    for (int i = 0; i < 3; ++i)
+        QHostInfo::lookupHost("host.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 3);
+    QCOMPARE(server.queries.value("host.stub.test"), 2);
+    // every query is sent from a port of its own
+    QCOMPARE(server.senderPorts.size(), 2);
+
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(lookupResults.hostName(), QString("host.stub.test"));
+    // IPv6 first, then alternating between the families
+    QCOMPARE(lookupResults.addresses().size(), 3);
+    QCOMPARE(lookupResults.addresses().at(0), QHostAddress("2001:db8::1"));
+    QCOMPARE(lookupResults.addresses().at(1), QHostAddress("192.0.2.1"));
+    QCOMPARE(lookupResults.addresses().at(2), QHostAddress("192.0.2.2"));
+
+    QFETCH_GLOBAL(bool, cache);
+    bool valid = false;
+    int id = -1;
+    QHostInfo result = qt_qhostinfo_lookup("host.stub.test", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QCOMPARE(valid, cache);
+    if (valid)
+        QCOMPARE(sortedAddresses(result), QString("192.0.2.1 192.0.2.2 2001:db8::1"));
+    else
+        QTRY_COMPARE(lookupsDoneCounter, 4);
+}
+
+void tst_QHostInfo::dnsResolverTimeToLive()
+{
+    QFETCH_GLOBAL(bool, cache);
+    if (!cache)
+        return; // test makes only sense when cache enabled
+
+    DnsStubServer server;
+    QVERIFY(server.isValid());
+    DnsStubServer::Record record;
+    record.addresses << QHostAddress("192.0.2.1");
+    record.ttl = 1;
+    server.records.insert("short.stub.test", record);
+    record.ttl = 0;
+    server.records.insert("uncached.stub.test", record);
+    DnsStubResolverScope scope(server.address());
+
+    lookupsDoneCounter = 0;
+    QHostInfo::lookupHost("short.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QHostInfo::lookupHost("uncached.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 2);
+
+    bool valid = false;
+    int id = -1;
+    QHostInfo result = qt_qhostinfo_lookup("short.stub.test", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(valid);
+    QCOMPARE(sortedAddresses(result), QString("192.0.2.1"));
+
+    result = qt_qhostinfo_lookup("uncached.stub.test", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(!valid);
+    QTRY_COMPARE(lookupsDoneCounter, 3);
+    QCOMPARE(server.queries.value("uncached.stub.test"), 4);
+
+    // the record expires after a second, not after the default 60
+    QTest::qWait(1100);
+    result = qt_qhostinfo_lookup("short.stub.test", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(!valid);
+    QTRY_COMPARE(lookupsDoneCounter, 4);
+    QCOMPARE(server.queries.value("short.stub.test"), 4);
+}
+
+void tst_QHostInfo::dnsResolverNegativeCache()
+{
+    DnsStubServer server;
+    QVERIFY(server.isValid());
+    DnsStubServer::Record record;
+    record.rcode = 3; // NXDOMAIN
+    record.negativeTtl = 60;
+    server.records.insert("missing.stub.test", record);
+    record.negativeTtl = -1;
+    server.records.insert("gone.stub.test", record);
+    record.rcode = 0;
+    record.negativeTtl = 60;
+    record.addresses << QHostAddress("192.0.2.1");
+    server.records.insert("ipv4only.stub.test", record);
+    DnsStubResolverScope scope(server.address());
+
+    lookupsDoneCounter = 0;
+    QHostInfo::lookupHost("missing.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 1);
+    QCOMPARE(lookupResults.error(), QHostInfo::HostNotFound);
+    QVERIFY(lookupResults.addresses().isEmpty());
+    QHostInfo::lookupHost("gone.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 2);
+    QCOMPARE(lookupResults.error(), QHostInfo::HostNotFound);
+
+    // a name without AAAA records is not an error
+    QHostInfo::lookupHost("ipv4only.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 3);
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(sortedAddresses(lookupResults), QString("192.0.2.1"));
+
+    QFETCH_GLOBAL(bool, cache);
+    if (!cache)
+        return;
+
+    // only the answer with an SOA record says for how long it may be cached
+    bool valid = false;
+    int id = -1;
+    QHostInfo result = qt_qhostinfo_lookup("missing.stub.test", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(valid);
+    QCOMPARE(result.error(), QHostInfo::HostNotFound);
+    result = qt_qhostinfo_lookup("gone.stub.test", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(!valid);
+    QTRY_COMPARE(lookupsDoneCounter, 4);
+    QCOMPARE(server.queries.value("missing.stub.test"), 2);
+    QCOMPARE(server.queries.value("gone.stub.test"), 4);
+}
+
+void tst_QHostInfo::dnsResolverTcpFallback()
+{
+    DnsStubServer server;
+    QVERIFY(server.isValid());
+    DnsStubServer::Record record;
+    record.addresses << QHostAddress("192.0.2.1") << QHostAddress("2001:db8::1");
+    record.truncateOverUdp = true;
+    server.records.insert("large.stub.test", record);
+    DnsStubResolverScope scope(server.address());
+
+    lookupsDoneCounter = 0;
+    QHostInfo::lookupHost("large.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 1);
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(sortedAddresses(lookupResults), QString("192.0.2.1 2001:db8::1"));
+    QCOMPARE(server.tcpQueries, 2);
+}
+
+void tst_QHostInfo::dnsResolverInvalidReply()
+{
+    DnsStubServer server;
+    QVERIFY(server.isValid());
+    DnsStubServer::Record record;
+    record.addresses << QHostAddress("192.0.2.1");
+    record.garbageFirst = true;
+    server.records.insert("host.stub.test", record);
+    DnsStubResolverScope scope(server.address());
+
+    // the reply right behind the broken one is read without a retransmission
+    lookupsDoneCounter = 0;
+    QHostInfo::lookupHost("host.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 1);
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(sortedAddresses(lookupResults), QString("192.0.2.1"));
+    QCOMPARE(server.queries.value("host.stub.test"), 2);
+}
+
+void tst_QHostInfo::dnsResolverServerFailure()
+{
+    DnsStubServer failing;
+    QVERIFY(failing.isValid());
+    failing.serverFailure = true;
+    DnsStubServer server;
+    QVERIFY(server.isValid());
+    DnsStubServer::Record record;
+    record.addresses << QHostAddress("192.0.2.1");
+    server.records.insert("host.stub.test", record);
+    DnsStubResolverScope scope(failing.address() + ',' + server.address());
+
+    lookupsDoneCounter = 0;
+    QHostInfo::lookupHost("host.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 1);
+    QCOMPARE(lookupResults.error(), QHostInfo::NoError);
+    QCOMPARE(sortedAddresses(lookupResults), QString("192.0.2.1"));
+    QCOMPARE(failing.queries.value("host.stub.test"), 2);
+
+    // all servers failing is not the same as the name not existing
+    server.serverFailure = true;
+    QHostInfo::lookupHost("other.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QTRY_COMPARE(lookupsDoneCounter, 2);
+    QCOMPARE(lookupResults.error(), QHostInfo::UnknownError);
+}
+
+void tst_QHostInfo::dnsResolverAbort()
+{
+    DnsStubServer server;
+    QVERIFY(server.isValid());
+    DnsStubServer::Record record;
+    record.silent = true;
+    server.records.insert("slow.stub.test", record);
+    record.silent = false;
+    record.addresses << QHostAddress("192.0.2.1");
+    server.records.insert("host.stub.test", record);
+    DnsStubResolverScope scope(server.address());
+
+    lookupsDoneCounter = 0;
+    int id = QHostInfo::lookupHost("slow.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QHostInfo::abortHostLookup(id);
+    id = QHostInfo::lookupHost("host.stub.test", this, SLOT(resultsReady(QHostInfo)));
+    QHostInfo::abortHostLookup(id);
+    QTRY_COMPARE(server.queries.value("host.stub.test"), 2);
+    QTest::qWait(200);
+    QCOMPARE(lookupsDoneCounter, 0);
+}
+
 class LookupAborter : public QObject
 {
     Q_OBJECT
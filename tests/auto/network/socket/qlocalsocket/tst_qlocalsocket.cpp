@@ -104,6 +104,7 @@ private slots:
 
     void writeToClientAndDisconnect_data();
     void writeToClientAndDisconnect();
+    void sendFile();
 
     void debug();
     void bytesWrittenSignal();
@@ -1174,6 +1175,37 @@ void tst_QLocalSocket::writeToClientAndDisconnect()
     QCOMPARE(client.state(), QLocalSocket::UnconnectedState);
 }
 
+void tst_QLocalSocket::sendFile()
+{
+    QByteArray contents(256 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < contents.size(); ++i)
+        contents[i] = char(i % 253);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+
+    QLocalServer server;
+    QLocalSocket client;
+    QVERIFY(server.listen("sendFileServer"));
+    client.connectToServer("sendFileServer");
+    QVERIFY(client.waitForConnected(200));
+    QVERIFY(server.waitForNewConnection(200));
+    QLocalSocket* clientSocket = server.nextPendingConnection();
+    QVERIFY(clientSocket);
+
+    QCOMPARE(clientSocket->write("head"), qint64(4));
+    QCOMPARE(clientSocket->sendFile(&file, 10), qint64(contents.size() - 10));
+    QCOMPARE(clientSocket->write("tail"), qint64(4));
+    const QByteArray expected = "head" + contents.mid(10) + "tail";
+    QCOMPARE(clientSocket->bytesToWrite(), qint64(expected.size()));
+
+    QByteArray received;
+    connect(&client, &QIODevice::readyRead, [&]() { received += client.readAll(); });
+    QTRY_COMPARE(received.size(), expected.size());
+    QVERIFY(received == expected);
+    QCOMPARE(clientSocket->bytesToWrite(), qint64(0));
+}
+
 void tst_QLocalSocket::debug()
 {
     // Make sure this compiles
@@ -58,6 +58,7 @@
 #include <QStringList>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTemporaryFile>
 #ifndef QT_NO_SSL
 #include <QSslSocket>
 #endif
@@ -75,6 +76,7 @@
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <netinet/in.h>
 #endif
 
 #include "private/qhostinfo_p.h"
@@ -199,6 +201,12 @@ private slots:
     void socketDiscardDataInWriteMode();
     void writeOnReadBufferOverflow();
     void readNotificationsAfterBind();
+    void sendFile();
+    void sendTruncatedFile();
+    void writeSharedByteArrays();
+    void connectionRacing();
+    void connectionRacingWinner_data();
+    void connectionRacingWinner();
 
 protected slots:
     void nonBlockingIMAP_hostFound();
@@ -3136,5 +3144,296 @@ void tst_QTcpSocket::readNotificationsAfterBind()
     QCOMPARE(spyReadyRead.count(), 0);
 }
 
+void tst_QTcpSocket::sendFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QByteArray contents(1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < contents.size(); ++i)
+        contents[i] = char(i % 251);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+
+    QTcpServer tcpServer;
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(tcpServer.waitForNewConnection(5000));
+    QTcpSocket *peer = tcpServer.nextPendingConnection();
+    QVERIFY(peer);
+
+    QByteArray received;
+    connect(peer, &QIODevice::readyRead, [&]() { received += peer->readAll(); });
+    qint64 written = 0;
+    connect(socket, &QIODevice::bytesWritten, [&](qint64 bytes) { written += bytes; });
+
+    // data written before and after a file must keep its place around it
+    QCOMPARE(socket->write("head"), qint64(4));
+    QCOMPARE(socket->sendFile(&file, 100, 500000), qint64(500000));
+    QCOMPARE(socket->write("middle"), qint64(6));
+    QCOMPARE(socket->sendFile(&file), qint64(contents.size()));
+    QCOMPARE(socket->write("tail"), qint64(4));
+    const QByteArray expected = "head" + contents.mid(100, 500000) + "middle" + contents + "tail";
+    QCOMPARE(socket->bytesToWrite(), qint64(expected.size()));
+
+    // out of range requests are rejected without queueing anything
+    QTest::ignoreMessage(QtWarningMsg, "QAbstractSocket::sendFile: offset and length out of range");
+    QCOMPARE(socket->sendFile(&file, contents.size() - 10, 20), qint64(-1));
+    QCOMPARE(socket->bytesToWrite(), qint64(expected.size()));
+
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), expected.size(), 10000);
+    QVERIFY(received == expected);
+    QCOMPARE(written, qint64(expected.size()));
+    QCOMPARE(socket->bytesToWrite(), qint64(0));
+
+    delete peer;
+    delete socket;
+}
+
+void tst_QTcpSocket::sendTruncatedFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(QByteArray(100000, 'x')), qint64(100000));
+
+    QTcpServer tcpServer;
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(tcpServer.waitForNewConnection(5000));
+    QTcpSocket *peer = tcpServer.nextPendingConnection();
+    QVERIFY(peer);
+
+    // the end of the file is reached before all of it has been sent
+    QCOMPARE(socket->sendFile(&file), qint64(100000));
+    QVERIFY(file.resize(1000));
+    QTRY_COMPARE_WITH_TIMEOUT(socket->state(), QAbstractSocket::UnconnectedState, 10000);
+    QCOMPARE(socket->error(), QAbstractSocket::UnknownSocketError);
+
+    delete peer;
+    delete socket;
+}
+
+void tst_QTcpSocket::writeSharedByteArrays()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTcpServer tcpServer;
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(tcpServer.waitForNewConnection(5000));
+    QTcpSocket *peer = tcpServer.nextPendingConnection();
+    QVERIFY(peer);
+
+    QByteArray received;
+    connect(peer, &QIODevice::readyRead, [&]() { received += peer->readAll(); });
+
+    // many small headers and large bodies, so that several buffer blocks
+    // are sent together and large bodies are queued without being copied
+    QByteArray expected;
+    QVector<QByteArray> bodies;
+    for (int i = 0; i < 50; ++i) {
+        const QByteArray header = "header " + QByteArray::number(i) + "\r\n";
+        QByteArray body(8192 + i, char('a' + i % 26));
+        QCOMPARE(socket->write(header), qint64(header.size()));
+        QCOMPARE(socket->write(body), qint64(body.size()));
+        expected += header + body;
+        bodies.append(body);
+        // changing the caller's copy must not change what is sent
+        body.fill('x');
+    }
+
+    // the data of a raw array belongs to the caller, it is copied
+    QByteArray raw(8192, 'r');
+    QCOMPARE(socket->write(QByteArray::fromRawData(raw.constData(), raw.size())), qint64(raw.size()));
+    expected += raw;
+    raw.fill('x');
+    QCOMPARE(socket->bytesToWrite(), qint64(expected.size()));
+
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), expected.size(), 10000);
+    QVERIFY(received == expected);
+    QCOMPARE(socket->bytesToWrite(), qint64(0));
+
+    delete peer;
+    delete socket;
+}
+
+#ifdef Q_OS_LINUX
+// A listening socket that never accepts, with a full accept queue: Linux
+// drops the SYNs of further connection attempts, which stay pending.
+class Blackhole
+{
+public:
+    Blackhole(const QHostAddress &address, quint16 port)
+        : fd(::socket(AF_INET, SOCK_STREAM, 0)), blocking(false)
+    {
+        sockaddr_in sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(port);
+        sa.sin_addr.s_addr = htonl(address.toIPv4Address());
+        socklen_t len = sizeof(sa);
+        if (fd == -1 || ::bind(fd, reinterpret_cast<sockaddr *>(&sa), len) != 0
+            || ::listen(fd, 0) != 0 || ::getsockname(fd, reinterpret_cast<sockaddr *>(&sa), &len) != 0) {
+            return;
+        }
+        localPort = ntohs(sa.sin_port);
+        for (int i = 0; i < 4 && !blocking; ++i) {
+            QTcpSocket *filler = new QTcpSocket;
+            fillers.append(filler);
+            filler->connectToHost(address, localPort);
+            blocking = !filler->waitForConnected(200);
+        }
+    }
+    ~Blackhole()
+    {
+        qDeleteAll(fillers);
+        if (fd != -1)
+            ::close(fd);
+    }
+
+    bool isValid() const { return blocking; }
+    quint16 port() const { return localPort; }
+
+    // makes room in the accept queue, so that pending attempts get through
+    void open()
+    {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        int accepted;
+        while ((accepted = ::accept(fd, 0, 0)) != -1)
+            ::close(accepted);
+    }
+
+private:
+    int fd;
+    quint16 localPort;
+    bool blocking;
+    QList<QTcpSocket *> fillers;
+};
+#endif
+
+void tst_QTcpSocket::connectionRacing()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+#ifndef Q_OS_LINUX
+    QSKIP("The blackhole listener relies on Linux dropping SYNs on a full accept queue");
+#else
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    Blackhole blackhole(QHostAddress("127.0.0.2"), server.serverPort());
+    if (!blackhole.isValid())
+        QSKIP("Could not set up a blackhole listener");
+
+    // the unreachable address comes first; without racing, the socket would
+    // wait for the full connect timeout before trying the next one
+    QHostInfo info;
+    info.setAddresses(QList<QHostAddress>() << QHostAddress("127.0.0.2")
+                                            << QHostAddress(QHostAddress::LocalHost));
+    qt_qhostinfo_cache_inject("racing.qt-test", info);
+
+    qputenv("QT_CONNECTION_ATTEMPT_DELAY", "100");
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost("racing.qt-test", server.serverPort());
+    QTRY_COMPARE(socket->state(), QAbstractSocket::ConnectedState);
+    QCOMPARE(socket->peerAddress(), QHostAddress(QHostAddress::LocalHost));
+    QTRY_VERIFY(server.hasPendingConnections());
+    QTcpSocket *peer = server.nextPendingConnection();
+    QVERIFY(peer);
+
+    // the adopted engine is fully functional
+    QCOMPARE(socket->write("racing"), qint64(6));
+    QTRY_COMPARE(peer->bytesAvailable(), qint64(6));
+    QCOMPARE(peer->readAll(), QByteArray("racing"));
+    delete peer;
+    delete socket;
+
+    // the second address refuses the connection, and the next one, the
+    // first address again, is still being tried: the socket waits for it
+    Blackhole slow(QHostAddress("127.0.0.3"), 0);
+    QVERIFY(slow.isValid());
+    info.setAddresses(QList<QHostAddress>() << QHostAddress("127.0.0.3")
+                                            << QHostAddress("127.0.0.4"));
+    qt_qhostinfo_cache_inject("refused.qt-test", info);
+    socket = newSocket();
+    socket->connectToHost("refused.qt-test", slow.port());
+    QTest::qWait(300);
+    QCOMPARE(socket->state(), QAbstractSocket::ConnectingState);
+    slow.open();
+    QTRY_COMPARE_WITH_TIMEOUT(socket->state(), QAbstractSocket::ConnectedState, 10000);
+    QCOMPARE(socket->peerAddress(), QHostAddress("127.0.0.3"));
+    delete socket;
+
+    // one address at a time
+    qputenv("QT_CONNECTION_ATTEMPT_DELAY", "-1");
+    socket = newSocket();
+    socket->connectToHost("racing.qt-test", server.serverPort());
+    QTest::qWait(500);
+    QCOMPARE(socket->state(), QAbstractSocket::ConnectingState);
+    QVERIFY(!server.hasPendingConnections());
+    delete socket;
+    qunsetenv("QT_CONNECTION_ATTEMPT_DELAY");
+#endif
+}
+
+void tst_QTcpSocket::connectionRacingWinner_data()
+{
+    QTest::addColumn<int>("winner");
+    // the first attempt is still running next to the second one, and wins
+    // when its SYN is retransmitted
+    QTest::newRow("earlier") << 0;
+    QTest::newRow("later") << 1;
+}
+
+void tst_QTcpSocket::connectionRacingWinner()
+{
+    QFETCH(int, winner);
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+#ifndef Q_OS_LINUX
+    QSKIP("The blackhole listener relies on Linux dropping SYNs on a full accept queue");
+#else
+    Blackhole first(QHostAddress("127.0.0.2"), 0);
+    if (!first.isValid())
+        QSKIP("Could not set up a blackhole listener");
+    Blackhole second(QHostAddress("127.0.0.3"), first.port());
+    if (!second.isValid())
+        QSKIP("Could not set up a blackhole listener");
+
+    QHostInfo info;
+    info.setAddresses(QList<QHostAddress>() << QHostAddress("127.0.0.2") << QHostAddress("127.0.0.3"));
+    qt_qhostinfo_cache_inject("racing.qt-test", info);
+
+    qputenv("QT_CONNECTION_ATTEMPT_DELAY", "100");
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost("racing.qt-test", first.port());
+    QTest::qWait(300);
+    QCOMPARE(socket->state(), QAbstractSocket::ConnectingState);
+
+    (winner == 0 ? first : second).open();
+    QTRY_COMPARE_WITH_TIMEOUT(socket->state(), QAbstractSocket::ConnectedState, 10000);
+    QCOMPARE(socket->peerAddress(), QHostAddress(winner == 0 ? "127.0.0.2" : "127.0.0.3"));
+    QCOMPARE(socket->peerPort(), first.port());
+    QVERIFY(socket->isValid());
+    delete socket;
+    qunsetenv("QT_CONNECTION_ATTEMPT_DELAY");
+#endif
+}
+
 QTEST_MAIN(tst_QTcpSocket)
 #include "tst_qtcpsocket.moc"
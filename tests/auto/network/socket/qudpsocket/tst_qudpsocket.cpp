@@ -108,6 +108,7 @@ private slots:
     void readyReadForEmptyDatagram();
     void asyncReadDatagram();
     void writeInHostLookupState();
+    void batchedDatagrams();
 
 protected slots:
     void empty_readyReadSlot();
@@ -1748,5 +1749,85 @@ void tst_QUdpSocket::writeInHostLookupState()
     QVERIFY(!socket.putChar('0'));
 }
 
+void tst_QUdpSocket::batchedDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket sender, receiver;
+#ifdef FORCE_SESSION
+    sender.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+    receiver.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    QVERIFY(sender.bind(QHostAddress(QHostAddress::LocalHost), 0));
+
+    // more than one batch of the native engine, including an empty datagram
+    const int count = 70;
+    QVector<QNetworkDatagram> outgoing;
+    for (int i = 0; i < count; ++i) {
+        QNetworkDatagram datagram(QByteArray(i * 7, char('a' + i % 26)),
+                                  receiver.localAddress(), receiver.localPort());
+        datagram.setHopLimit(1 + i % 10);
+        outgoing << datagram;
+    }
+
+    QSignalSpy bytesWrittenSpy(&sender, SIGNAL(bytesWritten(qint64)));
+    QCOMPARE(sender.writeDatagrams(outgoing), count);
+    QCOMPARE(bytesWrittenSpy.count(), 1);
+    QCOMPARE(bytesWrittenSpy.at(0).at(0).toLongLong(), qint64(7 * count * (count - 1) / 2));
+
+    QVERIFY2(receiver.waitForReadyRead(5000), QtNetworkSettings::msgSocketError(receiver).constData());
+
+    // receive in uneven chunks, reusing the same vector
+    QVector<QNetworkDatagram> incoming(25);
+    int received = 0;
+    while (received < count) {
+        int n = receiver.receiveDatagrams(incoming);
+        QVERIFY2(n >= 0, qPrintable(receiver.errorString()));
+        if (n == 0) {
+            QVERIFY(receiver.waitForReadyRead(5000));
+            continue;
+        }
+        for (int i = 0; i < n; ++i) {
+            const QNetworkDatagram &datagram = incoming.at(i);
+            const QNetworkDatagram &expected = outgoing.at(received + i);
+            QCOMPARE(datagram.data(), expected.data());
+            QCOMPARE(datagram.senderAddress(), sender.localAddress());
+            QCOMPARE(datagram.senderPort(), int(sender.localPort()));
+            QCOMPARE(datagram.destinationPort(), int(receiver.localPort()));
+            if (datagram.hopLimit() != -1)
+                QCOMPARE(datagram.hopLimit(), expected.hopLimit());
+        }
+        for (int i = n; i < incoming.size(); ++i)
+            QVERIFY(incoming.at(i).data().isEmpty());
+        received += n;
+    }
+    QCOMPARE(received, count);
+    QVERIFY(!receiver.hasPendingDatagrams());
+    QCOMPARE(receiver.receiveDatagrams(incoming), 0);
+
+    // a too small maximum size truncates each datagram
+    QCOMPARE(sender.writeDatagrams(outgoing.mid(10, 3)), 3);
+    QVERIFY(receiver.waitForReadyRead(5000));
+    received = 0;
+    while (received < 3) {
+        int n = receiver.receiveDatagrams(incoming, 8);
+        QVERIFY(n >= 0);
+        for (int i = 0; i < n; ++i)
+            QCOMPARE(incoming.at(i).data(), outgoing.at(10 + received + i).data().left(8));
+        received += n;
+        if (received < 3 && n == 0)
+            QVERIFY(receiver.waitForReadyRead(5000));
+    }
+
+    // an empty batch is a no-op
+    QCOMPARE(sender.writeDatagrams(QVector<QNetworkDatagram>()), 0);
+    QVector<QNetworkDatagram> none;
+    QCOMPARE(receiver.receiveDatagrams(none), 0);
+}
+
 QTEST_MAIN(tst_QUdpSocket)
 #include "tst_qudpsocket.moc"
@@ -4,6 +4,7 @@ SUBDIRS = \
         sql \
 
 # removed-by-refactor qtHaveModule(opengl): SUBDIRS += opengl
+qtHaveModule(concurrent): SUBDIRS += concurrent
 qtHaveModule(dbus): SUBDIRS += dbus
 qtHaveModule(network): SUBDIRS += network
 qtHaveModule(gui): SUBDIRS += gui
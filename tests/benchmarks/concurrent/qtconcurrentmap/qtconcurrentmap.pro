@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qtconcurrentmap
+
+SOURCES += tst_qtconcurrentmap.cpp
+QT = core testlib concurrent
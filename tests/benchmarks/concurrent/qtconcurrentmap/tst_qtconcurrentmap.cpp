@@ -0,0 +1,206 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <qtest.h>
+#include <QtCore>
+#include <QtConcurrent>
+
+class tst_QtConcurrentMap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mappedReducedMemory_data();
+    void mappedReducedMemory();
+    void blockingMap_data();
+    void blockingMap();
+};
+
+// An intermediate result that keeps track of the number of its instances
+// alive at the same time.
+class Record
+{
+public:
+    Record() : value(0) { construct(); }
+    explicit Record(int v) : value(v) { construct(); }
+    Record(const Record &other) : value(other.value) { construct(); }
+    ~Record() { live.fetchAndAddRelaxed(-1); }
+    Record &operator=(const Record &other) { value = other.value; return *this; }
+
+    static void resetPeak() { peak.store(live.load()); }
+    static int peakCount() { return peak.load(); }
+
+    int value;
+    char payload[1024];
+
+private:
+    void construct()
+    {
+        const int current = live.fetchAndAddRelaxed(1) + 1;
+        int localPeak = peak.load();
+        while (current > localPeak && !peak.testAndSetRelaxed(localPeak, current, localPeak))
+            ;
+    }
+
+    static QAtomicInt live;
+    static QAtomicInt peak;
+};
+
+QAtomicInt Record::live;
+QAtomicInt Record::peak;
+
+static Record map(const int &value)
+{
+    return Record(value);
+}
+
+static volatile int sink;
+
+// Much slower than map(), so that intermediate results pile up.
+static void reduce(Record &result, const Record &record)
+{
+    int value = record.value;
+    for (int i = 0; i < 2000; ++i)
+        value = (value * 1103515245 + 12345) & 0x7fffffff;
+    sink = value;
+    result.value += record.value;
+}
+
+enum {
+    ItemCount = 20000,
+    CheapItemCount = 100000000,
+    SkewedItemCount = 100000
+};
+
+
+void tst_QtConcurrentMap::mappedReducedMemory_data()
+{
+    QTest::addColumn<bool>("forwardIterators");
+    QTest::addColumn<int>("options");
+
+    QTest::newRow("random access, ordered") << false << int(QtConcurrent::OrderedReduce);
+    QTest::newRow("random access, unordered") << false << int(QtConcurrent::UnorderedReduce);
+    QTest::newRow("random access, parallel") << false << int(QtConcurrent::ParallelReduce);
+    QTest::newRow("forward, ordered") << true << int(QtConcurrent::OrderedReduce);
+    QTest::newRow("forward, unordered") << true << int(QtConcurrent::UnorderedReduce);
+    QTest::newRow("forward, parallel") << true << int(QtConcurrent::ParallelReduce);
+}
+
+// Measures the high-water mark of the memory used by intermediate results
+// that wait for a slow reduce function.
+void tst_QtConcurrentMap::mappedReducedMemory()
+{
+    QFETCH(bool, forwardIterators);
+    QFETCH(int, options);
+
+    QVector<int> vector;
+    QLinkedList<int> linkedList;
+    for (int i = 0; i < ItemCount; ++i) {
+        vector.append(i);
+        linkedList.append(i);
+    }
+
+    // the amount of intermediate results depends on the number of
+    // threads, use the same number everywhere
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(8);
+
+    Record::resetPeak();
+    Record result;
+    if (forwardIterators) {
+        result = QtConcurrent::blockingMappedReduced<Record>(linkedList.constBegin(), linkedList.constEnd(),
+                                                             map, reduce,
+                                                             QtConcurrent::ReduceOptions(options));
+    } else {
+        result = QtConcurrent::blockingMappedReduced<Record>(vector.constBegin(), vector.constEnd(),
+                                                             map, reduce,
+                                                             QtConcurrent::ReduceOptions(options));
+    }
+    pool->setMaxThreadCount(maxThreadCount);
+    QCOMPARE(result.value, (ItemCount - 1) * (ItemCount / 2));
+
+    QTest::setBenchmarkResult(qreal(Record::peakCount()) * sizeof(Record), QTest::BytesAllocated);
+}
+
+static void increment(int &value)
+{
+    ++value;
+}
+
+// The first percent of the items is a thousand times as expensive as the rest.
+static void skewed(int &value)
+{
+    const int rounds = value < SkewedItemCount / 100 ? 20000 : 20;
+    for (int i = 0; i < rounds; ++i)
+        value = (value * 1103515245 + 12345) & 0x7fffffff;
+    sink = value;
+}
+
+enum Workload {
+    Cheap,
+    Skewed
+};
+Q_DECLARE_METATYPE(Workload)
+
+void tst_QtConcurrentMap::blockingMap_data()
+{
+    QTest::addColumn<Workload>("workload");
+    QTest::addColumn<int>("grainSize");
+    QTest::addColumn<int>("cost");
+
+    QTest::newRow("10^8 cheap items") << Cheap << 0 << int(QtConcurrent::IterationHints::UnknownCost);
+    QTest::newRow("10^8 cheap items, uniform, grain 4096") << Cheap << 4096 << int(QtConcurrent::IterationHints::UniformCost);
+    QTest::newRow("skewed") << Skewed << 0 << int(QtConcurrent::IterationHints::UnknownCost);
+    QTest::newRow("skewed, varying") << Skewed << 0 << int(QtConcurrent::IterationHints::VaryingCost);
+}
+
+void tst_QtConcurrentMap::blockingMap()
+{
+    QFETCH(Workload, workload);
+    QFETCH(int, grainSize);
+    QFETCH(int, cost);
+
+    const QtConcurrent::IterationHints hints(grainSize, QtConcurrent::IterationHints::Cost(cost));
+    if (workload == Cheap) {
+        QVector<int> vector(CheapItemCount);
+        QBENCHMARK {
+            QtConcurrent::blockingMap(vector, increment, hints);
+        }
+    } else {
+        QVector<int> vector(SkewedItemCount);
+        QBENCHMARK {
+            for (int i = 0; i < vector.size(); ++i)
+                vector[i] = i;
+            QtConcurrent::blockingMap(vector, skewed, hints);
+        }
+    }
+}
+
+QTEST_MAIN(tst_QtConcurrentMap)
+
+#include "tst_qtconcurrentmap.moc"
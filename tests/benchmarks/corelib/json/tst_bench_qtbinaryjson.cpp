@@ -29,6 +29,8 @@
 #include <QtTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonarray.h>
+#include <qjsonstream.h>
 
 class BenchmarkQtBinaryJson: public QObject
 {
@@ -45,6 +47,13 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseNumbersStream();
+    void parseJsonStream();
+
+    void parseLargeArray();
+    void parseLargeArrayStream();
+    void writeLargeArray();
+    void writeLargeArrayStream();
 
     void toByteArray();
     void fromByteArray();
@@ -120,6 +129,125 @@ void BenchmarkQtBinaryJson::parseJsonToVariant()
     }
 }
 
+static void readAllTokens(QJsonStreamReader &reader)
+{
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QJsonStreamReader::Name:
+        case QJsonStreamReader::String:
+            reader.text();
+            break;
+        case QJsonStreamReader::Number:
+            reader.toDouble();
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void BenchmarkQtBinaryJson::parseNumbersStream()
+{
+    QString testFile = QFINDTESTDATA("numbers.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file numbers.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    QBENCHMARK {
+        QJsonStreamReader reader(testJson);
+        readAllTokens(reader);
+    }
+}
+
+void BenchmarkQtBinaryJson::parseJsonStream()
+{
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    QBENCHMARK {
+        QJsonStreamReader reader(testJson);
+        readAllTokens(reader);
+    }
+}
+
+// an array of about 8 MB of small records, as in a large data feed
+static QByteArray largeArray()
+{
+    QByteArray json = "[\n";
+    for (int i = 0; i < 100000; ++i) {
+        if (i)
+            json += ",\n";
+        json += "{\"id\":" + QByteArray::number(i)
+                + ",\"name\":\"record " + QByteArray::number(i)
+                + "\",\"value\":" + QByteArray::number(i * 0.25)
+                + ",\"tags\":[\"a\",\"b\\u00e9\"],\"ok\":true}";
+    }
+    json += "\n]\n";
+    return json;
+}
+
+void BenchmarkQtBinaryJson::parseLargeArray()
+{
+    const QByteArray json = largeArray();
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        QJsonArray array = doc.array();
+        for (const QJsonValue &v : array)
+            v.toObject().value(QLatin1String("id"));
+    }
+}
+
+void BenchmarkQtBinaryJson::parseLargeArrayStream()
+{
+    QByteArray json = largeArray();
+
+    QBENCHMARK {
+        QBuffer buffer(&json);
+        buffer.open(QIODevice::ReadOnly);
+        QJsonStreamReader reader(&buffer);
+        while (!reader.atEnd()) {
+            if (reader.readNext() == QJsonStreamReader::Name && reader.text() == QLatin1String("id")) {
+                reader.readNext();
+                reader.toDouble();
+            }
+        }
+        QVERIFY(!reader.hasError());
+    }
+}
+
+void BenchmarkQtBinaryJson::writeLargeArray()
+{
+    const QJsonArray array = QJsonDocument::fromJson(largeArray()).array();
+
+    QBENCHMARK {
+        QByteArray out;
+        QBuffer buffer(&out);
+        buffer.open(QIODevice::WriteOnly);
+        buffer.write(QJsonDocument(array).toJson(QJsonDocument::Compact));
+    }
+}
+
+void BenchmarkQtBinaryJson::writeLargeArrayStream()
+{
+    const QJsonArray array = QJsonDocument::fromJson(largeArray()).array();
+
+    QBENCHMARK {
+        QByteArray out;
+        QBuffer buffer(&out);
+        buffer.open(QIODevice::WriteOnly);
+        QJsonStreamWriter writer(&buffer);
+        writer.writeStartArray();
+        for (const QJsonValue &v : array)
+            writer.writeValue(v);
+        writer.writeEndArray();
+    }
+}
+
 void BenchmarkQtBinaryJson::toByteArray()
 {
     // Example: send information over a datastream to another process
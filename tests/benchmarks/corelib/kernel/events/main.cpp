@@ -83,6 +83,43 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+class Producer : public QThread
+{
+    Q_OBJECT
+public:
+    explicit Producer(int count) : m_count(count) {}
+
+signals:
+    void produced();
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < m_count; ++i)
+            emit produced();
+    }
+
+private:
+    int m_count;
+};
+
+class Consumer : public QObject
+{
+    Q_OBJECT
+public:
+    void expect(int count) { m_remaining = count; }
+
+public slots:
+    void consume()
+    {
+        if (--m_remaining == 0)
+            QTestEventLoop::instance().exitLoop();
+    }
+
+private:
+    int m_remaining;
+};
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -96,6 +133,8 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void crossThreadSignals_data();
+    void crossThreadSignals();
 };
 
 void EventsBench::initTestCase()
@@ -169,6 +208,40 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::crossThreadSignals_data()
+{
+    QTest::addColumn<int>("producerCount");
+    QTest::newRow("1 producer") << 1;
+    QTest::newRow("2 producers") << 2;
+    QTest::newRow("4 producers") << 4;
+}
+
+void EventsBench::crossThreadSignals()
+{
+    QFETCH(int, producerCount);
+    const int signalsPerProducer = 10000;
+
+    Consumer consumer;
+    QVector<Producer *> producers;
+    for (int i = 0; i < producerCount; ++i) {
+        Producer *producer = new Producer(signalsPerProducer);
+        connect(producer, &Producer::produced, &consumer, &Consumer::consume, Qt::QueuedConnection);
+        producers.append(producer);
+    }
+
+    QBENCHMARK {
+        consumer.expect(producerCount * signalsPerProducer);
+        for (Producer *producer : qAsConst(producers))
+            producer->start();
+        QTestEventLoop::instance().enterLoop(60);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        for (Producer *producer : qAsConst(producers))
+            producer->wait();
+    }
+
+    qDeleteAll(producers);
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
@@ -5,8 +5,13 @@ SUBDIRS = \
         qmetatype \
         qobject \
         qvariant \
-        qcoreapplication
+        qcoreapplication \
+        qsocketnotifier \
+        qtimer
 
 !qtHaveModule(widgets): SUBDIRS -= \
     qmetaobject \
     qobject
+
+!unix: SUBDIRS -= \
+    qsocketnotifier
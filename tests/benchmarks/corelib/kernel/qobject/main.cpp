@@ -43,6 +43,8 @@ Q_OBJECT
 private slots:
     void signal_slot_benchmark();
     void signal_slot_benchmark_data();
+    void signal_emission_benchmark_data();
+    void signal_emission_benchmark();
     void qproperty_benchmark_data();
     void qproperty_benchmark();
     void dynamic_property_benchmark();
@@ -127,6 +129,47 @@ void QObjectBenchmark::signal_slot_benchmark()
     }
 }
 
+void QObjectBenchmark::signal_emission_benchmark_data()
+{
+    QTest::addColumn<int>("receiverCount");
+    QTest::addColumn<bool>("receiversInOtherThread");
+    for (int receiverCount : {1, 10, 100}) {
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 receivers, same thread").arg(receiverCount)))
+                << receiverCount << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1 receivers, other thread").arg(receiverCount)))
+                << receiverCount << true;
+    }
+}
+
+void QObjectBenchmark::signal_emission_benchmark()
+{
+    QFETCH(int, receiverCount);
+    QFETCH(bool, receiversInOtherThread);
+
+    QThread thread;
+    if (receiversInOtherThread)
+        thread.start();
+
+    Object sender;
+    QVector<Object *> receivers;
+    for (int i = 0; i < receiverCount; ++i) {
+        Object *receiver = new Object;
+        if (receiversInOtherThread)
+            receiver->moveToThread(&thread);
+        // the slot does nothing, so calling it from this thread is safe
+        QObject::connect(&sender, &Object::signal0, receiver, &Object::slot0, Qt::DirectConnection);
+        receivers.append(receiver);
+    }
+
+    QBENCHMARK {
+        sender.emitSignal0();
+    }
+
+    thread.quit();
+    thread.wait();
+    qDeleteAll(receivers);
+}
+
 void QObjectBenchmark::qproperty_benchmark_data()
 {
     QTest::addColumn<QByteArray>("name");
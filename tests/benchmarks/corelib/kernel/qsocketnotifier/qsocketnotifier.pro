@@ -0,0 +1,6 @@
+QT = core testlib
+
+TEMPLATE = app
+TARGET = tst_bench_qsocketnotifier
+
+SOURCES += tst_qsocketnotifier.cpp
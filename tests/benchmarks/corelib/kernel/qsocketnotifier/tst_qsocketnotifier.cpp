@@ -0,0 +1,181 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtCore/qabstracteventdispatcher.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qvector.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Run with QT_EVENT_DISPATCHER=epoll or QT_EVENT_DISPATCHER=epoll-et to
+// benchmark the epoll dispatcher instead of the default one.
+class tst_QSocketNotifier : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void wakeUpOneOfMany_data();
+    void wakeUpOneOfMany();
+    void toggleNotifier_data();
+    void toggleNotifier();
+
+private:
+    bool createPairs(int count);
+    void destroyPairs();
+
+    QVector<int> readFds;
+    QVector<int> writeFds;
+};
+
+class ReadReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    int fired = 0;
+
+public slots:
+    void readyRead(int fd)
+    {
+        char c;
+        if (::read(fd, &c, 1) == 1)
+            ++fired;
+    }
+};
+
+void tst_QSocketNotifier::initTestCase()
+{
+    // don't benchmark the default dispatcher in place of a requested one
+    const QByteArray requested = qgetenv("QT_EVENT_DISPATCHER");
+    if (requested == "epoll" || requested == "epoll-et") {
+        QCOMPARE(QAbstractEventDispatcher::instance()->metaObject()->className(),
+                 "QEventDispatcherEpoll");
+    }
+}
+
+bool tst_QSocketNotifier::createPairs(int count)
+{
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY
+            && rlim_t(2 * count + 64) > limit.rlim_cur)
+        return false;
+
+    for (int i = 0; i < count; ++i) {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1) {
+            destroyPairs();
+            return false;
+        }
+        readFds << fds[0];
+        writeFds << fds[1];
+    }
+    return true;
+}
+
+void tst_QSocketNotifier::destroyPairs()
+{
+    for (int fd : qAsConst(readFds))
+        ::close(fd);
+    for (int fd : qAsConst(writeFds))
+        ::close(fd);
+    readFds.clear();
+    writeFds.clear();
+}
+
+void tst_QSocketNotifier::wakeUpOneOfMany_data()
+{
+    QTest::addColumn<int>("notifierCount");
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+// cost of one wakeup for one ready socket among many idle ones
+void tst_QSocketNotifier::wakeUpOneOfMany()
+{
+    QFETCH(int, notifierCount);
+    if (!createPairs(notifierCount))
+        QSKIP("Not enough file descriptors available");
+
+    ReadReceiver receiver;
+    QVector<QSocketNotifier *> notifiers;
+    notifiers.reserve(notifierCount);
+    for (int fd : qAsConst(readFds)) {
+        QSocketNotifier *notifier = new QSocketNotifier(fd, QSocketNotifier::Read);
+        connect(notifier, SIGNAL(activated(int)), &receiver, SLOT(readyRead(int)));
+        notifiers << notifier;
+    }
+
+    const int active = writeFds.at(notifierCount / 2);
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+    QBENCHMARK {
+        const int expected = receiver.fired + 1;
+        QCOMPARE(::write(active, "x", 1), ssize_t(1));
+        while (receiver.fired < expected)
+            dispatcher->processEvents(QEventLoop::WaitForMoreEvents);
+    }
+
+    qDeleteAll(notifiers);
+    destroyPairs();
+}
+
+void tst_QSocketNotifier::toggleNotifier_data()
+{
+    wakeUpOneOfMany_data();
+}
+
+// cost of enabling and disabling a notifier with many others registered
+void tst_QSocketNotifier::toggleNotifier()
+{
+    QFETCH(int, notifierCount);
+    if (!createPairs(notifierCount))
+        QSKIP("Not enough file descriptors available");
+
+    QVector<QSocketNotifier *> notifiers;
+    notifiers.reserve(notifierCount);
+    for (int fd : qAsConst(readFds))
+        notifiers << new QSocketNotifier(fd, QSocketNotifier::Read);
+
+    QSocketNotifier *notifier = notifiers.at(notifierCount / 2);
+    QBENCHMARK {
+        notifier->setEnabled(false);
+        notifier->setEnabled(true);
+    }
+
+    qDeleteAll(notifiers);
+    destroyPairs();
+}
+
+QTEST_MAIN(tst_QSocketNotifier)
+#include "tst_qsocketnotifier.moc"
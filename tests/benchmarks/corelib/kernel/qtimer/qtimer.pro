@@ -0,0 +1,6 @@
+QT = core testlib
+
+TEMPLATE = app
+TARGET = tst_bench_qtimer
+
+SOURCES += tst_qtimer.cpp
@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtCore/qbasictimer.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qvector.h>
+
+Q_DECLARE_METATYPE(Qt::TimerType)
+
+// Models a server with one idle or keep-alive timeout per connection, where
+// the timeouts are mostly restarted long before they fire.
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void restart_data();
+    void restart();
+    void processEventsWithLiveTimers_data();
+    void processEventsWithLiveTimers();
+
+protected:
+    void timerEvent(QTimerEvent *) Q_DECL_OVERRIDE { ++fired; }
+
+private:
+    void startTimers(QVector<QBasicTimer> &timers, Qt::TimerType timerType);
+
+    int fired = 0;
+};
+
+static const int Interval = 5000;
+
+static void addData()
+{
+    QTest::addColumn<int>("liveTimers");
+    QTest::addColumn<Qt::TimerType>("timerType");
+
+    const int counts[] = { 1000, 10000, 100000 };
+    for (int count : counts) {
+        QTest::newRow(qPrintable(QString::fromLatin1("%1-precise").arg(count)))
+                << count << Qt::PreciseTimer;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1-coarse").arg(count)))
+                << count << Qt::CoarseTimer;
+        QTest::newRow(qPrintable(QString::fromLatin1("%1-verycoarse").arg(count)))
+                << count << Qt::VeryCoarseTimer;
+    }
+}
+
+void tst_QTimer::startTimers(QVector<QBasicTimer> &timers, Qt::TimerType timerType)
+{
+    // spread the deadlines over a second
+    for (int i = 0; i < timers.size(); ++i)
+        timers[i].start(Interval + i % 1000, timerType, this);
+}
+
+void tst_QTimer::restart_data()
+{
+    addData();
+}
+
+void tst_QTimer::restart()
+{
+    QFETCH(int, liveTimers);
+    QFETCH(Qt::TimerType, timerType);
+
+    QVector<QBasicTimer> timers(liveTimers);
+    startTimers(timers, timerType);
+
+    // restart 1000 timers per iteration, round-robin
+    int next = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            timers[next].start(Interval, timerType, this);
+            if (++next == liveTimers)
+                next = 0;
+        }
+    }
+    QCOMPARE(fired, 0);
+}
+
+void tst_QTimer::processEventsWithLiveTimers_data()
+{
+    addData();
+}
+
+void tst_QTimer::processEventsWithLiveTimers()
+{
+    QFETCH(int, liveTimers);
+    QFETCH(Qt::TimerType, timerType);
+
+    QVector<QBasicTimer> timers(liveTimers);
+    startTimers(timers, timerType);
+
+    // every pass of the event loop asks for the next deadline and checks
+    // for expired timers, with timers being restarted in between
+    int next = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            timers[next].start(Interval, timerType, this);
+            if (++next == liveTimers)
+                next = 0;
+            QCoreApplication::processEvents();
+        }
+    }
+    QCOMPARE(fired, 0);
+}
+
+QTEST_MAIN(tst_QTimer)
+
+#include "tst_qtimer.moc"
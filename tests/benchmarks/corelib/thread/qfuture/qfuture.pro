@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qfuture
+
+SOURCES += tst_qfuture.cpp
+QT = core testlib
@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtCore>
+
+class tst_QFuture : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pipelineLatency_data();
+    void pipelineLatency();
+};
+
+enum { Stages = 10 };
+
+enum Executor {
+    Inline,
+    ThreadPool,
+    Context,
+    Watcher
+};
+Q_DECLARE_METATYPE(Executor)
+
+void tst_QFuture::pipelineLatency_data()
+{
+    QTest::addColumn<Executor>("executor");
+
+    QTest::newRow("then, inline") << Inline;
+    QTest::newRow("then, thread pool") << ThreadPool;
+    QTest::newRow("then, context") << Context;
+    QTest::newRow("QFutureWatcher") << Watcher;
+}
+
+static int stage(int value)
+{
+    return value + 1;
+}
+
+// Measures the time between the first stage of a pipeline getting its input
+// and the last one producing the output.
+void tst_QFuture::pipelineLatency()
+{
+    QFETCH(Executor, executor);
+
+    QThreadPool pool;
+    QObject context;
+
+    switch (executor) {
+    case Inline:
+    case ThreadPool:
+    case Context:
+        QBENCHMARK {
+            QFutureInterface<int> input;
+            input.reportStarted();
+            QFuture<int> output = input.future();
+            for (int i = 0; i < Stages; ++i) {
+                if (executor == Inline)
+                    output = output.then(stage);
+                else if (executor == ThreadPool)
+                    output = output.then(&pool, stage);
+                else
+                    output = output.then(&context, stage);
+            }
+
+            input.reportResult(0);
+            input.reportFinished();
+            if (executor == Context) {
+                // every stage posts the next one, so there is always
+                // something to deliver until the output is ready
+                while (!output.isFinished())
+                    QCoreApplication::processEvents();
+            } else {
+                output.waitForFinished();
+            }
+            QCOMPARE(output.result(), int(Stages));
+        }
+        break;
+
+    case Watcher:
+        // one QFutureWatcher per stage, each one starting the next stage
+        QBENCHMARK {
+            QVector<QFutureInterface<int> > stages(Stages + 1);
+            QVector<QFutureWatcher<int> *> watchers;
+            for (int i = 0; i < Stages; ++i) {
+                QFutureWatcher<int> *watcher = new QFutureWatcher<int>;
+                QFutureInterface<int> next = stages[i + 1];
+                connect(watcher, &QFutureWatcherBase::finished, [watcher, next]() mutable {
+                    next.reportResult(stage(watcher->result()));
+                    next.reportFinished();
+                });
+                stages[i].reportStarted();
+                watcher->setFuture(stages[i].future());
+                watchers.append(watcher);
+            }
+            stages[Stages].reportStarted();
+
+            QFuture<int> output = stages[Stages].future();
+            stages[0].reportResult(0);
+            stages[0].reportFinished();
+            while (!output.isFinished())
+                QCoreApplication::processEvents();
+            QCOMPARE(output.result(), int(Stages));
+            qDeleteAll(watchers);
+        }
+        break;
+    }
+
+    QVERIFY(pool.waitForDone());
+}
+
+QTEST_MAIN(tst_QFuture)
+
+#include "tst_qfuture.moc"
@@ -63,6 +63,8 @@ private slots:
     void uncontended();
     void readOnly_data();
     void readOnly();
+    void readScaling_data();
+    void readScaling();
     // void readWrite();
 };
 
@@ -179,5 +181,85 @@ void tst_QReadWriteLock::readOnly()
     holder.value();
 }
 
+void tst_QReadWriteLock::readScaling_data()
+{
+    QTest::addColumn<int>("readers");
+    QTest::addColumn<bool>("withWriter");
+
+    for (int readers = 1; readers <= 64; readers *= 2) {
+        const QByteArray name = QByteArray::number(readers) + " readers";
+        QTest::newRow(name.constData()) << readers << false;
+        QTest::newRow((name + ", one writer").constData()) << readers << true;
+    }
+}
+
+// Every reader takes the lock the same number of times, so as long as there are
+// enough cores, the time per iteration stays constant unless the readers
+// serialize on the lock.
+void tst_QReadWriteLock::readScaling()
+{
+    QFETCH(int, readers);
+    QFETCH(bool, withWriter);
+
+    enum { ReadIterations = 100000 };
+    struct Reader : QThread
+    {
+        QReadWriteLock *lock;
+        QHash<int, int> *hash;
+        void run() override
+        {
+            for (int i = 0; i < ReadIterations; ++i) {
+                QReadLocker locker(lock);
+                hash->contains(i & 0xff);
+            }
+        }
+    };
+    struct Writer : QThread
+    {
+        QReadWriteLock *lock;
+        QHash<int, int> *hash;
+        QAtomicInt stop;
+        void run() override
+        {
+            for (int i = 0; !stop.load(); ++i) {
+                {
+                    QWriteLocker locker(lock);
+                    hash->insert(i & 0xff, i);
+                }
+                QThread::usleep(100);
+            }
+        }
+    };
+
+    QReadWriteLock lock;
+    QHash<int, int> hash;
+    for (int i = 0; i < 0x100; ++i)
+        hash.insert(i, i);
+
+    QVector<Reader *> threads;
+    for (int i = 0; i < readers; ++i) {
+        auto t = new Reader;
+        t->lock = &lock;
+        t->hash = &hash;
+        threads.append(t);
+    }
+    Writer writer;
+    writer.lock = &lock;
+    writer.hash = &hash;
+    if (withWriter)
+        writer.start();
+
+    QBENCHMARK {
+        for (auto t : threads)
+            t->start();
+        for (auto t : threads)
+            t->wait();
+    }
+
+    writer.stop.store(1);
+    writer.wait();
+    qDeleteAll(threads);
+}
+
 QTEST_MAIN(tst_QReadWriteLock)
 #include "tst_qreadwritelock.moc"
@@ -40,6 +40,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void throughput_data();
+    void throughput();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +77,66 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+class CountingRunnable : public QRunnable
+{
+public:
+    explicit CountingRunnable(QAtomicInt *counter) : counter(counter) {}
+    void run() Q_DECL_OVERRIDE { counter->ref(); }
+
+    QAtomicInt *counter;
+};
+
+// starts a batch of small runnables from within the pool, the way
+// Qt Concurrent algorithms fan out their work
+class SpawningRunnable : public QRunnable
+{
+public:
+    SpawningRunnable(QThreadPool *pool, QAtomicInt *counter, int children)
+        : pool(pool), counter(counter), children(children) {}
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < children; ++i)
+            pool->start(new CountingRunnable(counter));
+    }
+
+    QThreadPool *pool;
+    QAtomicInt *counter;
+    int children;
+};
+
+void tst_QThreadPool::throughput_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("workStealing");
+
+    for (int threads = 1; threads <= qMax(1, QThread::idealThreadCount()); threads *= 2) {
+        const QByteArray name = QByteArray::number(threads);
+        QTest::newRow((name + "-locked").constData()) << threads << false;
+        QTest::newRow((name + "-workstealing").constData()) << threads << true;
+    }
+}
+
+// tasks/sec against thread count, with and without work stealing
+void tst_QThreadPool::throughput()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, workStealing);
+
+    const int producers = 64;
+    const int childrenPerProducer = 2000;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+
+    QBENCHMARK {
+        QAtomicInt counter;
+        for (int i = 0; i < producers; ++i)
+            threadPool.start(new SpawningRunnable(&threadPool, &counter, childrenPerProducer));
+        threadPool.waitForDone();
+        QCOMPARE(counter.load(), producers * childrenPerProducer);
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
@@ -29,7 +29,9 @@
 #include <QByteArray>
 #include <QCryptographicHash>
 #include <QFile>
+#include <QMessageAuthenticationCode>
 #include <QString>
+#include <QVector>
 #include <QtTest>
 
 #include <time.h>
@@ -49,6 +51,10 @@ private Q_SLOTS:
     void addData();
     void addDataChunked_data() { hash_data(); }
     void addDataChunked();
+    void hashMany_data();
+    void hashMany();
+    void hmac_data() { hash_data(); }
+    void hmac();
 };
 
 const int MaxCryptoAlgorithm = QCryptographicHash::Sha3_512;
@@ -159,6 +165,46 @@ void tst_bench_QCryptographicHash::addDataChunked()
     }
 }
 
+void tst_bench_QCryptographicHash::hashMany_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<int>("size");
+
+    static const int datasizes[] = { 64, 512, 4096 };
+    for (uint i = 0; i < sizeof(datasizes)/sizeof(datasizes[0]); ++i) {
+        for (int algo = QCryptographicHash::Md4; algo <= MaxCryptoAlgorithm; ++algo)
+            QTest::newRow(algoname(algo) + QByteArray::number(datasizes[i])) << algo << datasizes[i];
+    }
+}
+
+void tst_bench_QCryptographicHash::hashMany()
+{
+    QFETCH(int, algorithm);
+    QFETCH(int, size);
+
+    // 16 buffers of the same size, e.g. the blobs of one batch of writes
+    QVector<QByteArray> data;
+    for (int i = 0; i < 16; ++i)
+        data.append(QByteArray::fromRawData(blockOfData.constData() + i * size, size));
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        QCryptographicHash::hashMany(data, algo);
+    }
+}
+
+void tst_bench_QCryptographicHash::hmac()
+{
+    QFETCH(int, algorithm);
+    QFETCH(QByteArray, data);
+
+    static const QByteArray key = QByteArrayLiteral("a secret key of medium length");
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        QMessageAuthenticationCode::hash(data, key, algo);
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_bench_QCryptographicHash)
 
 #include "main.moc"
@@ -95,9 +95,11 @@ private Q_SLOTS:
     void fromString();
     void fromStringText();
     void fromStringIso();
+    void fromStringIsoOffset();
     void fromMSecsSinceEpoch();
     void fromMSecsSinceEpochUtc();
     void fromMSecsSinceEpochTz();
+    void offsetFromUtcTz2050();
 };
 
 void tst_QDateTime::create()
@@ -573,6 +575,15 @@ void tst_QDateTime::fromStringIso()
     }
 }
 
+void tst_QDateTime::fromStringIsoOffset()
+{
+    QString input = "2010-01-01T13:28:34.999+02:00";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTime::fromString(input, Qt::ISODate);
+    }
+}
+
 void tst_QDateTime::fromMSecsSinceEpoch()
 {
     QBENCHMARK {
@@ -598,6 +609,18 @@ void tst_QDateTime::fromMSecsSinceEpochTz()
     }
 }
 
+void tst_QDateTime::offsetFromUtcTz2050()
+{
+    QTimeZone cet = QTimeZone("Europe/Oslo");
+    QList<QDateTime> list;
+    for (int jd = JULIAN_DAY_2050; jd < JULIAN_DAY_2060; ++jd)
+        list.append(QDateTime(QDate::fromJulianDay(jd), QTime(12, 0), Qt::UTC));
+    QBENCHMARK {
+        foreach (const QDateTime &test, list)
+            int result = cet.offsetFromUtc(test);
+    }
+}
+
 QTEST_MAIN(tst_QDateTime)
 
 #include "main.moc"
@@ -0,0 +1,267 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QFlatHash>
+#include <QHash>
+#include <QTest>
+#include <QVector>
+
+#include <algorithm>
+#include <random>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+// The record of the use case the container is meant for: many small
+// values under integer keys.
+struct Record
+{
+    quint64 id;
+    int count;
+    float weight;
+};
+Q_DECLARE_TYPEINFO(Record, Q_PRIMITIVE_TYPE);
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insert_data() { data(); }
+    void insert();
+    void lookup_data() { data(); }
+    void lookup();
+    void lookupMissing_data() { data(); }
+    void lookupMissing();
+    void erase_data() { data(); }
+    void erase();
+    void iterate_data() { data(); }
+    void iterate();
+    void memory_data() { data(); }
+    void memory();
+
+private:
+    void data();
+};
+
+enum Container { Hash, FlatHash };
+
+void tst_QFlatHash::data()
+{
+    QTest::addColumn<int>("container");
+    QTest::addColumn<int>("size");
+
+    static const int sizes[] = { 1000, 100000, 1000000 };
+    for (int size : sizes) {
+        const QByteArray sizeString = QByteArray::number(size);
+        QTest::newRow(QByteArray("QHash--" + sizeString).constData()) << int(Hash) << size;
+        QTest::newRow(QByteArray("QFlatHash--" + sizeString).constData()) << int(FlatHash) << size;
+    }
+}
+
+// spread the keys, ids are rarely dense
+static inline quint64 keyAt(int i)
+{
+    return quint64(i) * Q_UINT64_C(0x9e3779b97f4a7c15) >> 16;
+}
+
+template <typename Container>
+static Container filled(int size)
+{
+    Container container;
+    for (int i = 0; i < size; ++i) {
+        const Record record = { keyAt(i), i, 1.0f };
+        container.insert(record.id, record);
+    }
+    return container;
+}
+
+template <typename Container>
+static void insertTemplate(int size)
+{
+    QBENCHMARK {
+        Container container;
+        for (int i = 0; i < size; ++i) {
+            const Record record = { keyAt(i), i, 1.0f };
+            container.insert(record.id, record);
+        }
+        QCOMPARE(container.size(), size);
+    }
+}
+
+void tst_QFlatHash::insert()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+
+    if (container == Hash)
+        insertTemplate<QHash<quint64, Record> >(size);
+    else
+        insertTemplate<QFlatHash<quint64, Record> >(size);
+}
+
+// In insertion order QHash finds its nodes next to each other in memory,
+// which real lookups don't.
+static QVector<quint64> shuffledKeys(int size, quint64 offset)
+{
+    QVector<quint64> keys;
+    keys.reserve(size);
+    for (int i = 0; i < size; ++i)
+        keys.append(keyAt(i) + offset);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(size));
+    return keys;
+}
+
+template <typename Container>
+static void lookupTemplate(int size, quint64 offset)
+{
+    const Container container = filled<Container>(size);
+    const QVector<quint64> keys = shuffledKeys(size, offset);
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (quint64 key : keys)
+            found += container.contains(key);
+    }
+    QCOMPARE(found, offset ? 0 : size);
+}
+
+void tst_QFlatHash::lookup()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+
+    if (container == Hash)
+        lookupTemplate<QHash<quint64, Record> >(size, 0);
+    else
+        lookupTemplate<QFlatHash<quint64, Record> >(size, 0);
+}
+
+void tst_QFlatHash::lookupMissing()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+
+    // keyAt() shifts the high bits away, so all of these are missing
+    const quint64 offset = Q_UINT64_C(1) << 60;
+    if (container == Hash)
+        lookupTemplate<QHash<quint64, Record> >(size, offset);
+    else
+        lookupTemplate<QFlatHash<quint64, Record> >(size, offset);
+}
+
+template <typename Container>
+static void eraseTemplate(int size)
+{
+    const Container full = filled<Container>(size);
+    const QVector<quint64> keys = shuffledKeys(size, 0);
+    QBENCHMARK {
+        Container container = full;
+        for (quint64 key : keys)
+            container.remove(key);
+        QVERIFY(container.isEmpty());
+    }
+}
+
+void tst_QFlatHash::erase()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+
+    if (container == Hash)
+        eraseTemplate<QHash<quint64, Record> >(size);
+    else
+        eraseTemplate<QFlatHash<quint64, Record> >(size);
+}
+
+template <typename Container>
+static void iterateTemplate(int size)
+{
+    const Container container = filled<Container>(size);
+    qint64 sum = 0;
+    QBENCHMARK {
+        sum = 0;
+        for (typename Container::const_iterator it = container.begin(), end = container.end(); it != end; ++it)
+            sum += it->count;
+    }
+    QCOMPARE(sum, qint64(size) * (size - 1) / 2);
+}
+
+void tst_QFlatHash::iterate()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+
+    if (container == Hash)
+        iterateTemplate<QHash<quint64, Record> >(size);
+    else
+        iterateTemplate<QFlatHash<quint64, Record> >(size);
+}
+
+static qint64 heapInUse()
+{
+    // large blocks are mapped rather than taken from the heap
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+#elif defined(__GLIBC__)
+    const struct mallinfo info = mallinfo();
+    return qint64(uint(info.uordblks)) + qint64(uint(info.hblkhd));
+#else
+    return -1;
+#endif
+}
+
+template <typename Container>
+static void memoryTemplate(int size)
+{
+    const qint64 before = heapInUse();
+    if (before < 0)
+        QSKIP("The heap usage is not known on this platform");
+    const Container container = filled<Container>(size);
+    const qint64 used = heapInUse() - before;
+    QCOMPARE(container.size(), size);
+
+    QTest::setBenchmarkResult(qreal(used) / size, QTest::BytesAllocated);
+}
+
+// heap bytes per entry, including the slack left for growth
+void tst_QFlatHash::memory()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+
+    if (container == Hash)
+        memoryTemplate<QHash<quint64, Record> >(size);
+    else
+        memoryTemplate<QFlatHash<quint64, Record> >(size);
+}
+
+QTEST_MAIN(tst_QFlatHash)
+#include "main.moc"
@@ -27,6 +27,7 @@
 ****************************************************************************/
 
 #include <QLocale>
+#include <QVector>
 #include <QTest>
 
 class tst_QLocale : public QObject
@@ -37,6 +38,11 @@ private Q_SLOTS:
     void toUpper_QLocale_1();
     void toUpper_QLocale_2();
     void toUpper_QString();
+    void toDouble_data();
+    void toDouble();
+    void toString_double_data();
+    void toString_double();
+    void byteArrayNumber_double();
 };
 
 static QString data()
@@ -65,6 +71,87 @@ void tst_QLocale::toUpper_QString()
     QBENCHMARK { LOOP(s.toUpper()) }
 }
 
+static QVector<double> doubles()
+{
+    QVector<double> result;
+    result.reserve(1000);
+    double d = 0.1;
+    for (int i = 0; i < 1000; ++i) {
+        result.append(i % 2 ? -d : d);
+        d = d * 1.37 + 0.0125;
+        if (d > 1e12)
+            d = 0.1;
+    }
+    return result;
+}
+
+void tst_QLocale::toDouble_data()
+{
+    QTest::addColumn<QLocale>("locale");
+
+    QTest::newRow("C") << QLocale::c();
+    QTest::newRow("German") << QLocale(QLocale::German, QLocale::Germany);
+}
+
+void tst_QLocale::toDouble()
+{
+    QFETCH(QLocale, locale);
+    locale.setNumberOptions(QLocale::OmitGroupSeparator);
+    QStringList strings;
+    for (double d : doubles())
+        strings << locale.toString(d, 'g', QLocale::FloatingPointShortest);
+
+    double sum = 0;
+    QBENCHMARK {
+        for (const QString &s : qAsConst(strings))
+            sum += locale.toDouble(s);
+    }
+    QVERIFY(sum != 0);
+}
+
+void tst_QLocale::toString_double_data()
+{
+    QTest::addColumn<QLocale>("locale");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    const QLocale c = QLocale::c();
+    const QLocale german(QLocale::German, QLocale::Germany);
+    QTest::newRow("C-shortest") << c << 'g' << int(QLocale::FloatingPointShortest);
+    QTest::newRow("C-f6") << c << 'f' << 6;
+    QTest::newRow("C-e6") << c << 'e' << 6;
+    QTest::newRow("German-shortest") << german << 'g' << int(QLocale::FloatingPointShortest);
+    QTest::newRow("German-f6") << german << 'f' << 6;
+}
+
+void tst_QLocale::toString_double()
+{
+    QFETCH(QLocale, locale);
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    locale.setNumberOptions(QLocale::OmitGroupSeparator);
+    const QVector<double> values = doubles();
+
+    int length = 0;
+    QBENCHMARK {
+        for (double d : values)
+            length += locale.toString(d, format, precision).size();
+    }
+    QVERIFY(length);
+}
+
+void tst_QLocale::byteArrayNumber_double()
+{
+    const QVector<double> values = doubles();
+
+    int length = 0;
+    QBENCHMARK {
+        for (double d : values)
+            length += QByteArray::number(d, 'g', QLocale::FloatingPointShortest).size();
+    }
+    QVERIFY(length);
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "main.moc"
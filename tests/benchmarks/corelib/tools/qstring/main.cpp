@@ -65,6 +65,8 @@ private slots:
     void ucstrncmp_data() const;
     void ucstrncmp() const;
     void fromUtf8() const;
+    void fromUtf8Scripts_data() const;
+    void fromUtf8Scripts() const;
     void fromLatin1_data() const;
     void fromLatin1() const;
     void fromLatin1Alternatives_data() const;
@@ -90,6 +92,8 @@ private slots:
     void toLower();
     void toCaseFolded_data();
     void toCaseFolded();
+    void splitCsv_data();
+    void splitCsv();
 
 private:
     void section_data_impl(bool includeRegExOnly = true);
@@ -942,6 +946,34 @@ void tst_QString::fromUtf8() const
     }
 }
 
+void tst_QString::fromUtf8Scripts_data() const
+{
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("ascii") << QStringLiteral("The quick brown fox jumps over the lazy dog. ");
+    QTest::newRow("latin") << QStringLiteral("Voix ambigu\u00eb d'un c\u0153ur qui au z\u00e9phyr pr\u00e9f\u00e8re les jattes de kiwis. ");
+    QTest::newRow("cyrillic") << QStringLiteral("\u0421\u044a\u0435\u0448\u044c \u0436\u0435 \u0435\u0449\u0451 \u044d\u0442\u0438\u0445 \u043c\u044f\u0433\u043a\u0438\u0445 \u0444\u0440\u0430\u043d\u0446\u0443\u0437\u0441\u043a\u0438\u0445 \u0431\u0443\u043b\u043e\u043a, \u0434\u0430 \u0432\u044b\u043f\u0435\u0439 \u0447\u0430\u044e. ");
+    QTest::newRow("greek") << QStringLiteral("\u039e\u03b5\u03c3\u03ba\u03b5\u03c0\u03ac\u03b6\u03c9 \u03c4\u03b7\u03bd \u03c8\u03c5\u03c7\u03bf\u03c6\u03b8\u03cc\u03c1\u03b1 \u03b2\u03b4\u03b5\u03bb\u03c5\u03b3\u03bc\u03af\u03b1. ");
+    QTest::newRow("cjk") << QStringLiteral("\u6211\u80fd\u541e\u4e0b\u73bb\u7483\u800c\u4e0d\u4f24\u8eab\u4f53\u3002\u8272\u306f\u5302\u3078\u3069\u6563\u308a\u306c\u308b\u3092\u3002");
+    QTest::newRow("mixed") << QStringLiteral("Hello, \u043c\u0438\u0440! \u4f60\u597d\uff0c\u4e16\u754c! \u0393\u03b5\u03b9\u03ac \u03c3\u03bf\u03c5! ");
+    QTest::newRow("emoji") << QStringLiteral("Fun \U0001f600 with \U0001f389 emoji \U0001f44d! ");
+}
+
+void tst_QString::fromUtf8Scripts() const
+{
+    QFETCH(QString, text);
+
+    // about 64 kB of UTF-8 of each kind
+    QByteArray data = text.toUtf8();
+    data = data.repeated(64 * 1024 / data.size() + 1);
+    const char *d = data.constData();
+    int size = data.size();
+
+    QBENCHMARK {
+        QString::fromUtf8(d, size);
+    }
+}
+
 void tst_QString::fromLatin1_data() const
 {
     QTest::addColumn<QByteArray>("latin1");
@@ -2548,6 +2580,48 @@ void tst_QString::toCaseFolded()
     }
 }
 
+enum SplitMode { Split, SplitRef, Tokenize };
+
+void tst_QString::splitCsv_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("split") << int(Split);
+    QTest::newRow("splitRef") << int(SplitRef);
+    QTest::newRow("tokenize") << int(Tokenize);
+}
+
+void tst_QString::splitCsv()
+{
+    QFETCH(int, mode);
+
+    QStringList lines;
+    for (int i = 0; i < 1000; ++i)
+        lines << QString::fromLatin1("%1,Smith,John,,%2,Springfield,%3.5,yes").arg(i).arg(i * 7).arg(i % 97);
+
+    int fields = 0;
+    QBENCHMARK {
+        fields = 0;
+        for (const QString &line : qAsConst(lines)) {
+            switch (mode) {
+            case Split:
+                for (const QString &field : line.split(QLatin1Char(',')))
+                    fields += field.size();
+                break;
+            case SplitRef:
+                for (const QStringRef &field : line.splitRef(QLatin1Char(',')))
+                    fields += field.size();
+                break;
+            case Tokenize:
+                for (const QStringRef &field : line.tokenize(QLatin1Char(',')))
+                    fields += field.size();
+                break;
+            }
+        }
+    }
+    QVERIFY(fields > 0);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
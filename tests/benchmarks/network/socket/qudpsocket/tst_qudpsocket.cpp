@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <qudpsocket.h>
+#include <qnetworkdatagram.h>
+
+class tst_QUdpSocket : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void pingPong_data();
+    void pingPong();
+
+private:
+    QUdpSocket sender;
+    QUdpSocket receiver;
+};
+
+enum { BatchCount = 32 };
+
+void tst_QUdpSocket::initTestCase()
+{
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    QVERIFY(sender.bind(QHostAddress(QHostAddress::LocalHost), 0));
+}
+
+void tst_QUdpSocket::pingPong_data()
+{
+    QTest::addColumn<int>("payloadSize");
+    QTest::addColumn<bool>("batched");
+
+    for (int size : { 64, 512, 1400 }) {
+        QTest::newRow(qPrintable(QString("single-%1").arg(size))) << size << false;
+        QTest::newRow(qPrintable(QString("batched-%1").arg(size))) << size << true;
+    }
+}
+
+// sends BatchCount datagrams over the loopback and reads them back
+void tst_QUdpSocket::pingPong()
+{
+    QFETCH(int, payloadSize);
+    QFETCH(bool, batched);
+
+    QVector<QNetworkDatagram> outgoing;
+    for (int i = 0; i < BatchCount; ++i)
+        outgoing << QNetworkDatagram(QByteArray(payloadSize, 'a'), receiver.localAddress(),
+                                     receiver.localPort());
+    QVector<QNetworkDatagram> incoming(BatchCount);
+
+    QBENCHMARK {
+        int sent = 0;
+        int received = 0;
+        if (batched) {
+            while (sent < BatchCount) {
+                int n = sender.writeDatagrams(outgoing.mid(sent));
+                QVERIFY(n >= 0);
+                sent += n;
+            }
+            while (received < BatchCount) {
+                int n = receiver.receiveDatagrams(incoming);
+                QVERIFY(n >= 0);
+                received += n;
+            }
+        } else {
+            for ( ; sent < BatchCount; ++sent)
+                QCOMPARE(sender.writeDatagram(outgoing.at(sent)), qint64(payloadSize));
+            while (received < BatchCount) {
+                QNetworkDatagram datagram = receiver.receiveDatagram();
+                if (datagram.isValid())
+                    ++received;
+            }
+        }
+    }
+}
+
+QTEST_MAIN(tst_QUdpSocket)
+
+#include "tst_qudpsocket.moc"